@@ -194,7 +194,7 @@ std::shared_ptr<Analyzer::Expr> OffsetInFragment::deep_copy() const {
 
 std::shared_ptr<Analyzer::Expr> WindowFunction::deep_copy() const {
   return makeExpr<WindowFunction>(
-      type_info, kind_, args_, partition_keys_, order_keys_, collation_);
+      type_info, kind_, args_, partition_keys_, order_keys_, collation_, frame_);
 }
 
 ExpressionPtr ArrayExpr::deep_copy() const {
@@ -2203,6 +2203,9 @@ bool WindowFunction::operator==(const Expr& rhs) const {
       order_keys_.size() != rhs_window->order_keys_.size()) {
     return false;
   }
+  if (!frame_ != !rhs_window->frame_ || (frame_ && !(*frame_ == *rhs_window->frame_))) {
+    return false;
+  }
   return expr_list_match(args_, rhs_window->args_) &&
          expr_list_match(partition_keys_, rhs_window->partition_keys_) &&
          expr_list_match(order_keys_, rhs_window->order_keys_);
@@ -2518,9 +2521,41 @@ std::string WindowFunction::toString() const {
   for (const auto& arg : args_) {
     result += " " + arg->toString();
   }
+  if (frame_) {
+    result += " " + frame_->toString();
+  }
   return result + ") ";
 }
 
+std::string WindowFrameBound::toString() const {
+  switch (type) {
+    case Type::UnboundedPreceding: {
+      return "UNBOUNDED PRECEDING";
+    }
+    case Type::Preceding: {
+      return std::to_string(offset) + "/" + std::to_string(fp_offset) +
+             " PRECEDING";
+    }
+    case Type::CurrentRow: {
+      return "CURRENT ROW";
+    }
+    case Type::Following: {
+      return std::to_string(offset) + "/" + std::to_string(fp_offset) +
+             " FOLLOWING";
+    }
+    case Type::UnboundedFollowing: {
+      return "UNBOUNDED FOLLOWING";
+    }
+    default: { CHECK(false); }
+  }
+  return "";
+}
+
+std::string WindowFrame::toString() const {
+  return std::string(is_rows ? "ROWS" : "RANGE") + " BETWEEN " + lower_bound.toString() +
+         " AND " + upper_bound.toString();
+}
+
 std::string ArrayExpr::toString() const {
   std::string str{"ARRAY["};
 
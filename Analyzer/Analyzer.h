@@ -1265,9 +1265,43 @@ struct OrderEntry {
   bool nulls_first; /* true if nulls are ordered first.  otherwise last. */
 };
 
+/*
+ * @type WindowFrameBound
+ * @brief A bound of the frame of a window function. The offset is a number of rows for
+ * ROWS frames. For RANGE frames, it's the distance from the value of the order key in
+ * the units the order key is stored in, in fp_offset for floating point order keys.
+ */
+struct WindowFrameBound {
+  enum class Type {
+    UnboundedPreceding,
+    Preceding,
+    CurrentRow,
+    Following,
+    UnboundedFollowing
+  };
+  Type type;
+  int64_t offset;
+  double fp_offset;
+  std::string toString() const;
+};
+
+/*
+ * @type WindowFrame
+ * @brief The ROWS or RANGE frame of an aggregate window function.
+ */
+struct WindowFrame {
+  bool is_rows;
+  WindowFrameBound lower_bound;
+  WindowFrameBound upper_bound;
+  std::string toString() const;
+  bool operator==(const WindowFrame& rhs) const { return toString() == rhs.toString(); }
+};
+
 /*
  * @type WindowFunction
- * @brief A window function.
+ * @brief A window function. Aggregate window functions without a frame aggregate over
+ * the whole partition without ORDER BY, over the rows up to the last peer of the
+ * current row otherwise.
  */
 class WindowFunction : public Expr {
  public:
@@ -1276,13 +1310,15 @@ class WindowFunction : public Expr {
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& args,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& partition_keys,
                  const std::vector<std::shared_ptr<Analyzer::Expr>>& order_keys,
-                 const std::vector<OrderEntry>& collation)
+                 const std::vector<OrderEntry>& collation,
+                 const std::shared_ptr<const WindowFrame>& frame = nullptr)
       : Expr(ti)
       , kind_(kind)
       , args_(args)
       , partition_keys_(partition_keys)
       , order_keys_(order_keys)
-      , collation_(collation){};
+      , collation_(collation)
+      , frame_(frame){};
 
   std::shared_ptr<Analyzer::Expr> deep_copy() const override;
 
@@ -1303,12 +1339,15 @@ class WindowFunction : public Expr {
 
   const std::vector<OrderEntry>& getCollation() const { return collation_; }
 
+  const std::shared_ptr<const WindowFrame>& getFrame() const { return frame_; }
+
  private:
   const SqlWindowFunctionKind kind_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> args_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> partition_keys_;
   const std::vector<std::shared_ptr<Analyzer::Expr>> order_keys_;
   const std::vector<OrderEntry> collation_;
+  const std::shared_ptr<const WindowFrame> frame_;
 };
 
 /*
@@ -0,0 +1,9 @@
+CREATE TABLE ##TAB##
+  (
+    id BIGINT,
+    ts TIMESTAMP(0),
+    price DOUBLE,
+    qty INTEGER,
+    category TEXT ENCODING DICT(32),
+    note TEXT ENCODING DICT(32)
+  )
@@ -4,6 +4,7 @@ import logging
 import uuid
 import datetime
 import json
+import random
 import pymapd
 import pandas
 import re
@@ -51,6 +52,61 @@ def json_format_handler(x):
     raise TypeError("Unknown type")
 
 
+def generate_import_file(file_path, size_gb):
+    """
+      Writes a synthetic csv matching import_table_schemas/synthetic.sql. A
+      third of the notes are quoted, with delimiters and escaped quotes in
+      them, so that the import has to unescape fields as well as split them.
+
+      Args:
+        file_path(str): Path of the csv to write
+        size_gb(float): Approximate size of the csv in GB
+
+      Returns:
+        rows(int): Number of rows written
+    """
+    target_bytes = int(size_gb * (1 << 30))
+    categories = ["alpha", "bravo", "charlie", "delta", "echo", "foxtrot"]
+    words = ["lorem", "ipsum", "dolor", "sit", "amet", "consectetur"]
+    rng = random.Random(0)
+    rows = 0
+    written = 0
+    logging.info(
+        "Generating %.1f GB of import data at %s" % (size_gb, file_path)
+    )
+    with open(file_path, "w") as f:
+        header = "id,ts,price,qty,category,note\n"
+        f.write(header)
+        written += len(header)
+        while written < target_bytes:
+            lines = []
+            for _ in range(100000):
+                note = " ".join(rng.sample(words, 3))
+                if rows % 3 == 0:
+                    note = '"%s, ""%s"""' % (note, rng.choice(words))
+                lines.append(
+                    "%d,2019-%02d-%02d %02d:%02d:%02d,%.2f,%d,%s,%s\n"
+                    % (
+                        rows,
+                        rng.randint(1, 12),
+                        rng.randint(1, 28),
+                        rng.randint(0, 23),
+                        rng.randint(0, 59),
+                        rng.randint(0, 59),
+                        rng.uniform(0, 10000),
+                        rng.randint(-1000, 1000),
+                        rng.choice(categories),
+                        note,
+                    )
+                )
+                rows += 1
+            chunk = "".join(lines)
+            f.write(chunk)
+            written += len(chunk)
+    logging.info("Generated %d rows, %d bytes" % (rows, written))
+    return rows
+
+
 # Parse input parameters
 parser = ArgumentParser()
 optional = parser._action_groups.pop()
@@ -131,6 +187,17 @@ optional.add_argument(
     + "script will use the COPY FROM command with the default default "
     + "delimiter (,).",
 )
+optional.add_argument(
+    "-g",
+    "--generate-import-file-gb",
+    dest="generate_import_file_gb",
+    type=float,
+    help="Generate a synthetic csv of about this many GB at the import_file "
+    + "path before the import, unless a file at least that large is already "
+    + "there. The path must be reachable from both this machine and "
+    + "omnisci_server. Use with "
+    + "--table-schema-file=import_table_schemas/synthetic.sql",
+)
 optional.add_argument(
     "--no-drop-table-before",
     dest="no_drop_table_before",
@@ -250,6 +317,7 @@ source_db_port = args.port
 source_db_name = args.name
 label = args.label
 import_file = args.import_file
+generate_import_file_gb = args.generate_import_file_gb
 table_schema_file = args.table_schema_file
 import_table_name = args.import_table_name
 import_query_template_file = args.import_query_template_file
@@ -308,6 +376,17 @@ if not valid_destination_set:
     exit(1)
 
 
+# Generate the import file, the import itself is timed separately below
+if generate_import_file_gb:
+    if (
+        os.path.exists(import_file)
+        and os.path.getsize(import_file)
+        >= generate_import_file_gb * (1 << 30)
+    ):
+        logging.info("Reusing existing import file " + import_file)
+    else:
+        generate_import_file(import_file, generate_import_file_gb)
+
 # Establish connection to mapd db
 con = get_connection(
     db_user=source_db_user,
@@ -418,6 +497,16 @@ res_output = str(res.fetchall()[0])
 logging.debug("Query result output: " + res_output)
 rows_loaded = re.search(r"Loaded: (.*?) recs, R", res_output).group(1)
 rows_rejected = re.search(r"Rejected: (.*?) recs i", res_output).group(1)
+if execution_time > 0:
+    logging.info(
+        "Import throughput: %.0f rows/s"
+        % (int(rows_loaded) * 1000 / execution_time)
+    )
+    if os.path.exists(import_file):
+        logging.info(
+            "Import throughput: %.1f MB/s"
+            % (os.path.getsize(import_file) / (1 << 20) * 1000 / execution_time)
+        )
 
 # Done with import. Dropping table and closing connection
 if not no_drop_table_after:
@@ -251,16 +251,25 @@ Calcite::Calcite(const int mapd_port,
                  const std::string& session_prefix,
                  const std::string& udf_filename)
     : server_available_(false), session_prefix_(session_prefix) {
-  init(mapd_port, calcite_port, data_dir, calcite_max_mem, udf_filename);
+  init(mapd_port,
+       calcite_port,
+       data_dir,
+       calcite_max_mem,
+       MapDParameters().calcite_plan_cache_size,
+       udf_filename);
 }
 
 void Calcite::init(const int mapd_port,
                    const int calcite_port,
                    const std::string& data_dir,
                    const size_t calcite_max_mem,
+                   const size_t plan_cache_size,
                    const std::string& udf_filename) {
   LOG(INFO) << "Creating Calcite Handler,  Calcite Port is " << calcite_port
             << " base data dir is " << data_dir;
+  if (plan_cache_size) {
+    plan_cache_.reset(new CalcitePlanCache(plan_cache_size));
+  }
   if (calcite_port < 0) {
     CHECK(false) << "JNI mode no longer supported.";
   }
@@ -286,10 +295,17 @@ Calcite::Calcite(const MapDParameters& mapd_parameter,
        mapd_parameter.calcite_port,
        data_dir,
        mapd_parameter.calcite_max_mem,
+       mapd_parameter.calcite_plan_cache_size,
        udf_filename);
 }
 
 void Calcite::updateMetadata(std::string catalog, std::string table) {
+  // Invalidated before the server update so that the cached plans stop being served,
+  // and again after it since queries planned in between, against the stale metadata of
+  // the server, are cached under the epoch of the first invalidation.
+  if (plan_cache_) {
+    plan_cache_->invalidate(catalog);
+  }
   if (server_available_) {
     auto ms = measure<>::execution([&]() {
       std::pair<mapd::shared_ptr<CalciteServerClient>, mapd::shared_ptr<TTransport>>
@@ -301,6 +317,9 @@ void Calcite::updateMetadata(std::string catalog, std::string table) {
   } else {
     LOG(INFO) << "Not routing to Calcite, server is not up";
   }
+  if (plan_cache_) {
+    plan_cache_->invalidate(catalog);
+  }
 }
 
 void checkPermissionForTables(const Catalog_Namespace::SessionInfo& session_info,
@@ -346,12 +365,35 @@ TPlanResult Calcite::process(
     const bool legacy_syntax,
     const bool is_explain,
     const bool is_view_optimize) {
-  TPlanResult result = processImpl(session_info,
-                                   sql_string,
-                                   filter_push_down_info,
-                                   legacy_syntax,
-                                   is_explain,
-                                   is_view_optimize);
+  TPlanResult result;
+  // The plans pushing filters down depend on more than the query, they aren't cached.
+  const bool use_plan_cache =
+      plan_cache_ && server_available_ && filter_push_down_info.empty();
+  CalcitePlanCache::Key plan_cache_key;
+  const auto& current_db = session_info.getCatalog().getCurrentDB();
+  const auto plan_cache_options = std::to_string(current_db.dbId) + " " +
+                                  std::to_string(legacy_syntax) +
+                                  std::to_string(is_explain) +
+                                  std::to_string(is_view_optimize);
+  if (use_plan_cache && plan_cache_->get(current_db.dbName,
+                                         plan_cache_options,
+                                         sql_string,
+                                         result,
+                                         plan_cache_key)) {
+    LOG(INFO) << "User " << session_info.get_currentUser().userName << " catalog "
+              << current_db.dbName << " sql '" << sql_string
+              << "' planned from the cache";
+  } else {
+    result = processImpl(session_info,
+                         sql_string,
+                         filter_push_down_info,
+                         legacy_syntax,
+                         is_explain,
+                         is_view_optimize);
+    if (use_plan_cache) {
+      plan_cache_->put(plan_cache_key, result);
+    }
+  }
 
   AccessPrivileges NOOP;
 
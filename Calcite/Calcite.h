@@ -24,9 +24,11 @@
 #ifndef CALCITE_H
 #define CALCITE_H
 
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
+#include "CalcitePlanCache.h"
 #include "Shared/MapDParameters.h"
 #include "rapidjson/document.h"
 
@@ -76,11 +78,15 @@ class Calcite {
 
   std::string& get_session_prefix() { return session_prefix_; }
 
+  // Null if the plan cache is disabled.
+  const CalcitePlanCache* getPlanCache() const { return plan_cache_.get(); }
+
  private:
   void init(const int mapd_port,
             const int port,
             const std::string& data_dir,
             const size_t calcite_max_mem,
+            const size_t plan_cache_size,
             const std::string& udf_filename);
   void runServer(const int mapd_port,
                  const int port,
@@ -103,6 +109,7 @@ class Calcite {
   std::string ssl_trust_store_;
   std::string ssl_trust_password_;
   std::string session_prefix_;
+  std::unique_ptr<CalcitePlanCache> plan_cache_;
 };
 
 #endif /* CALCITE_H */
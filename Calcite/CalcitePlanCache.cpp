@@ -0,0 +1,437 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CalcitePlanCache.h"
+
+#include <glog/logging.h>
+#include <rapidjson/document.h>
+#include <rapidjson/pointer.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "Shared/fixautotools.h"
+
+#include "gen-cpp/CalciteServer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+struct CalcitePlanCache::CachedPlan {
+  TPlanResult plan;
+  // Empty unless the plan is a template for other literals.
+  std::vector<std::string> literal_pointers;
+};
+
+namespace {
+
+bool is_identifier_char(const char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+// Whether the string literal about to be appended to text belongs to a typed literal,
+// DATE '2019-01-01' or X'ff' for instance, which is kept as is.
+bool is_typed_string_literal(const std::string& text) {
+  if (text.empty()) {
+    return false;
+  }
+  if (is_identifier_char(text.back())) {
+    return true;
+  }
+  auto word_end = text.size();
+  if (text[word_end - 1] == ' ') {
+    --word_end;
+  }
+  auto word_begin = word_end;
+  while (word_begin > 0 && is_identifier_char(text[word_begin - 1])) {
+    --word_begin;
+  }
+  const auto word = text.substr(word_begin, word_end - word_begin);
+  for (const auto keyword : {"DATE", "TIME", "TIMESTAMP", "INTERVAL"}) {
+    if (boost::iequals(word, keyword)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Skips a quoted string or identifier starting at pos, the quote is escaped by
+// doubling it. Returns the position past the closing quote.
+size_t skip_quoted(const std::string& sql, const size_t pos, std::string& value) {
+  const char quote = sql[pos];
+  size_t i = pos + 1;
+  while (i < sql.size()) {
+    if (sql[i] == quote) {
+      if (i + 1 < sql.size() && sql[i + 1] == quote) {
+        value += quote;
+        i += 2;
+        continue;
+      }
+      return i + 1;
+    }
+    value += sql[i];
+    ++i;
+  }
+  return i;
+}
+
+size_t utf8_length(const std::string& str) {
+  size_t len{0};
+  for (const auto c : str) {
+    if ((static_cast<unsigned char>(c) & 0xc0) != 0x80) {
+      ++len;
+    }
+  }
+  return len;
+}
+
+size_t digit_count(int64_t val) {
+  size_t count{1};
+  while (val <= -10 || val >= 10) {
+    val /= 10;
+    ++count;
+  }
+  return count;
+}
+
+std::string escape_pointer_token(const std::string& token) {
+  std::string escaped;
+  for (const auto c : token) {
+    if (c == '~') {
+      escaped += "~0";
+    } else if (c == '/') {
+      escaped += "~1";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+int64_t get_int_member(const rapidjson::Value& obj, const char* name) {
+  const auto it = obj.FindMember(name);
+  return it != obj.MemberEnd() && it->value.IsInt64()
+             ? it->value.GetInt64()
+             : std::numeric_limits<int64_t>::min();
+}
+
+struct PlanLiteral {
+  std::string pointer;
+  const rapidjson::Value* value;
+};
+
+void collect_plan_literals(const rapidjson::Value& value,
+                           const std::string& pointer,
+                           std::vector<PlanLiteral>& plan_literals) {
+  if (value.IsObject()) {
+    const auto type_it = value.FindMember("type");
+    if (value.HasMember("literal") && type_it != value.MemberEnd() &&
+        type_it->value.IsString()) {
+      plan_literals.push_back({pointer, &value});
+      return;
+    }
+    for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it) {
+      collect_plan_literals(
+          it->value,
+          pointer + "/" + escape_pointer_token(it->name.GetString()),
+          plan_literals);
+    }
+  } else if (value.IsArray()) {
+    for (rapidjson::SizeType i = 0; i < value.Size(); ++i) {
+      collect_plan_literals(value[i], pointer + "/" + std::to_string(i), plan_literals);
+    }
+  }
+}
+
+enum class PlanLiteralKind { OTHER, QUERY, FOLDED };
+
+// Reads the literal of the plan as one of the query. A literal with the type of the
+// integer or string literals of the query which can't be one could be the result of
+// folding literals of the query.
+PlanLiteralKind to_sql_literal(const rapidjson::Value& plan_literal,
+                               CalcitePlanCache::SqlLiteral& sql_literal) {
+  const auto& literal = plan_literal["literal"];
+  const std::string type = plan_literal["type"].GetString();
+  const auto precision = get_int_member(plan_literal, "precision");
+  if (type == "DECIMAL") {
+    if (get_int_member(plan_literal, "scale") != 0) {
+      return PlanLiteralKind::OTHER;
+    }
+    if (!literal.IsInt64() ||
+        precision != static_cast<int64_t>(digit_count(literal.GetInt64()))) {
+      return PlanLiteralKind::FOLDED;
+    }
+    sql_literal.kind = literal.GetInt64() > std::numeric_limits<int32_t>::max()
+                           ? CalcitePlanCache::SqlLiteral::Kind::BIGINT
+                           : CalcitePlanCache::SqlLiteral::Kind::INTEGER;
+    sql_literal.value = std::to_string(literal.GetInt64());
+    return PlanLiteralKind::QUERY;
+  }
+  if (type == "CHAR") {
+    if (!literal.IsString()) {
+      return PlanLiteralKind::FOLDED;
+    }
+    sql_literal.kind = CalcitePlanCache::SqlLiteral::Kind::STRING;
+    sql_literal.value.assign(literal.GetString(), literal.GetStringLength());
+    const auto len = static_cast<int64_t>(utf8_length(sql_literal.value));
+    if (precision != len || get_int_member(plan_literal, "type_precision") != len) {
+      return PlanLiteralKind::FOLDED;
+    }
+    return PlanLiteralKind::QUERY;
+  }
+  return PlanLiteralKind::OTHER;
+}
+
+bool operator==(const CalcitePlanCache::SqlLiteral& lhs,
+                const CalcitePlanCache::SqlLiteral& rhs) {
+  return lhs.kind == rhs.kind && lhs.value == rhs.value;
+}
+
+}  // namespace
+
+CalcitePlanCache::CalcitePlanCache(const size_t max_bytes) : plans_(max_bytes) {}
+
+bool CalcitePlanCache::get(const std::string& catalog,
+                           const std::string& options,
+                           const std::string& sql,
+                           TPlanResult& plan,
+                           Key& key) {
+  auto normalized = normalize(sql);
+  const auto prefix =
+      catalog + "\n" + std::to_string(getEpoch(catalog)) + "\n" + options + "\n";
+  key.template_key = prefix + "T" + normalized.text;
+  key.literal_key = prefix + "L" + normalized.literal_text;
+  key.literals = std::move(normalized.literals);
+  if (!key.literals.empty()) {
+    const auto cached = plans_.get(key.template_key);
+    if (cached) {
+      plan = cached->plan;
+      plan.plan_result = substituteLiterals(
+          cached->plan.plan_result, cached->literal_pointers, key.literals);
+      plan.execution_time_ms = 0;
+      return true;
+    }
+  }
+  const auto cached = plans_.get(key.literal_key);
+  if (cached) {
+    plan = cached->plan;
+    plan.execution_time_ms = 0;
+    return true;
+  }
+  return false;
+}
+
+void CalcitePlanCache::put(const Key& key, const TPlanResult& plan) {
+  auto cached = std::make_shared<CachedPlan>();
+  cached->plan = plan;
+  if (!key.literals.empty()) {
+    cached->literal_pointers = findLiterals(plan.plan_result, key.literals);
+  }
+  const auto& cache_key =
+      cached->literal_pointers.empty() ? key.literal_key : key.template_key;
+  size_t num_bytes = cache_key.size() + plan.plan_result.size();
+  for (const auto& pointer : cached->literal_pointers) {
+    num_bytes += pointer.size();
+  }
+  plans_.put(cache_key, cached, num_bytes);
+}
+
+void CalcitePlanCache::invalidate(const std::string& catalog) {
+  std::lock_guard<std::mutex> lock(catalog_epochs_mutex_);
+  ++catalog_epochs_[catalog];
+}
+
+LruCacheStats CalcitePlanCache::getStats() const {
+  return plans_.getStats();
+}
+
+uint64_t CalcitePlanCache::getEpoch(const std::string& catalog) {
+  std::lock_guard<std::mutex> lock(catalog_epochs_mutex_);
+  return catalog_epochs_[catalog];
+}
+
+CalcitePlanCache::NormalizedSql CalcitePlanCache::normalize(const std::string& sql) {
+  NormalizedSql normalized;
+  auto& text = normalized.text;
+  auto& literal_text = normalized.literal_text;
+  const auto append = [&text, &literal_text](const std::string& str) {
+    text += str;
+    literal_text += str;
+  };
+  bool pending_space{false};
+  size_t i = 0;
+  while (i < sql.size()) {
+    const char c = sql[i];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      pending_space = true;
+      ++i;
+      continue;
+    }
+    if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+      const auto eol = sql.find('\n', i);
+      i = eol == std::string::npos ? sql.size() : eol;
+      pending_space = true;
+      continue;
+    }
+    if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*') {
+      const auto comment_end = sql.find("*/", i + 2);
+      i = comment_end == std::string::npos ? sql.size() : comment_end + 2;
+      pending_space = true;
+      continue;
+    }
+    if (pending_space && !literal_text.empty()) {
+      append(" ");
+    }
+    pending_space = false;
+    if (c == '\'') {
+      std::string value;
+      const auto end = skip_quoted(sql, i, value);
+      const auto quoted = sql.substr(i, end - i);
+      if (is_typed_string_literal(literal_text) || sql[end - 1] != '\'' ||
+          end == i + 1) {
+        append(quoted);
+      } else {
+        text += "?s";
+        literal_text += quoted;
+        normalized.literals.push_back({SqlLiteral::Kind::STRING, value});
+      }
+      i = end;
+      continue;
+    }
+    if (c == '"' || c == '`') {
+      std::string value;
+      const auto end = skip_quoted(sql, i, value);
+      append(sql.substr(i, end - i));
+      i = end;
+      continue;
+    }
+    if (is_identifier_char(c)) {
+      auto end = i;
+      while (end < sql.size() && is_identifier_char(sql[end])) {
+        ++end;
+      }
+      const auto token = sql.substr(i, end - i);
+      const bool is_integer =
+          std::all_of(token.begin(),
+                      token.end(),
+                      [](const char ch) { return std::isdigit(ch); }) &&
+          (literal_text.empty() || literal_text.back() != '.') &&
+          (end == sql.size() || sql[end] != '.');
+      int64_t val{0};
+      bool fits{is_integer};
+      if (is_integer) {
+        try {
+          val = std::stoll(token);
+        } catch (const std::out_of_range&) {
+          fits = false;
+        }
+      }
+      if (fits) {
+        const bool is_bigint = val > std::numeric_limits<int32_t>::max();
+        text += is_bigint ? "?l" : "?i";
+        literal_text += token;
+        normalized.literals.push_back(
+            {is_bigint ? SqlLiteral::Kind::BIGINT : SqlLiteral::Kind::INTEGER,
+             std::to_string(val)});
+      } else {
+        append(token);
+      }
+      i = end;
+      continue;
+    }
+    append(std::string(1, c));
+    ++i;
+  }
+  return normalized;
+}
+
+std::vector<std::string> CalcitePlanCache::findLiterals(
+    const std::string& ra,
+    const std::vector<SqlLiteral>& literals) {
+  rapidjson::Document ra_doc;
+  ra_doc.Parse(ra.c_str());
+  if (ra_doc.HasParseError()) {
+    return {};
+  }
+  std::vector<PlanLiteral> plan_literals;
+  collect_plan_literals(ra_doc, "", plan_literals);
+  std::vector<std::string> pointers(literals.size());
+  size_t matched_count{0};
+  for (const auto& plan_literal : plan_literals) {
+    SqlLiteral sql_literal;
+    const auto plan_literal_kind = to_sql_literal(*plan_literal.value, sql_literal);
+    if (plan_literal_kind == PlanLiteralKind::OTHER) {
+      continue;
+    }
+    if (plan_literal_kind == PlanLiteralKind::FOLDED) {
+      return {};
+    }
+    size_t match_count{0};
+    for (size_t i = 0; i < literals.size(); ++i) {
+      if (literals[i] == sql_literal) {
+        ++match_count;
+        pointers[i] = plan_literal.pointer;
+      }
+    }
+    // Every literal of the plan must be exactly one of the query.
+    if (match_count != 1) {
+      return {};
+    }
+    ++matched_count;
+  }
+  // And every literal of the query must be in the plan.
+  if (matched_count != literals.size()) {
+    return {};
+  }
+  for (const auto& pointer : pointers) {
+    if (pointer.empty()) {
+      return {};
+    }
+  }
+  return pointers;
+}
+
+std::string CalcitePlanCache::substituteLiterals(
+    const std::string& ra,
+    const std::vector<std::string>& pointers,
+    const std::vector<SqlLiteral>& literals) {
+  CHECK_EQ(pointers.size(), literals.size());
+  rapidjson::Document ra_doc;
+  ra_doc.Parse(ra.c_str());
+  CHECK(!ra_doc.HasParseError());
+  auto& allocator = ra_doc.GetAllocator();
+  for (size_t i = 0; i < pointers.size(); ++i) {
+    auto plan_literal = rapidjson::Pointer(pointers[i].c_str()).Get(ra_doc);
+    CHECK(plan_literal && plan_literal->IsObject());
+    const auto& literal = literals[i];
+    if (literal.kind == SqlLiteral::Kind::STRING) {
+      (*plan_literal)["literal"].SetString(
+          literal.value.data(), literal.value.size(), allocator);
+      const auto len = static_cast<int64_t>(utf8_length(literal.value));
+      (*plan_literal)["precision"].SetInt64(len);
+      (*plan_literal)["type_precision"].SetInt64(len);
+    } else {
+      const auto val = std::stoll(literal.value);
+      (*plan_literal)["literal"].SetInt64(val);
+      (*plan_literal)["precision"].SetInt64(digit_count(val));
+    }
+  }
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  ra_doc.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CalcitePlanCache.h
+ * @brief   Cache of the relational algebra Calcite returns for the queries, which saves
+ *          the round-trip to the Calcite server for the repeated ones.
+ *
+ * The queries are keyed by their text with the whitespace and the comments normalized
+ * and the integer and string literals pulled out. When each literal of the query shows
+ * up exactly once in the plan, the plan is a template for every query which only
+ * differs in these literals, they are substituted in on lookup. Otherwise the plan
+ * only serves the queries with the same literals. The plans are kept per database and
+ * dropped when its metadata changes.
+ */
+
+#ifndef CALCITE_CALCITEPLANCACHE_H
+#define CALCITE_CALCITEPLANCACHE_H
+
+#include "StringDictionary/ConcurrentLruCache.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TPlanResult;
+
+class CalcitePlanCache {
+ public:
+  struct SqlLiteral {
+    enum class Kind { INTEGER, BIGINT, STRING };
+
+    Kind kind;
+    // The digits of the integers, the unescaped bytes of the strings.
+    std::string value;
+  };
+
+  struct NormalizedSql {
+    // The text with the literals replaced by placeholders.
+    std::string text;
+    // The text with the literals in place, which keys the plans that aren't templates.
+    std::string literal_text;
+    std::vector<SqlLiteral> literals;
+  };
+
+  struct Key {
+    std::string template_key;
+    std::string literal_key;
+    std::vector<SqlLiteral> literals;
+  };
+
+  explicit CalcitePlanCache(const size_t max_bytes);
+
+  // Looks up the plan of sql in the database, along with the options it was planned
+  // with. On a miss, key is what the plan Calcite returns should be put under.
+  bool get(const std::string& catalog,
+           const std::string& options,
+           const std::string& sql,
+           TPlanResult& plan,
+           Key& key);
+
+  void put(const Key& key, const TPlanResult& plan);
+
+  // Drops the plans of the database.
+  void invalidate(const std::string& catalog);
+
+  LruCacheStats getStats() const;
+
+  static NormalizedSql normalize(const std::string& sql);
+
+  // JSON pointers to the literals of the plan, in the order of the literals of the
+  // query. Empty if the literals can't be told apart in the plan.
+  static std::vector<std::string> findLiterals(const std::string& ra,
+                                               const std::vector<SqlLiteral>& literals);
+
+  // The plan with the literals at the pointers replaced.
+  static std::string substituteLiterals(const std::string& ra,
+                                        const std::vector<std::string>& pointers,
+                                        const std::vector<SqlLiteral>& literals);
+
+ private:
+  struct CachedPlan;
+
+  uint64_t getEpoch(const std::string& catalog);
+
+  ConcurrentLruCache<std::string, CachedPlan> plans_;
+  std::unordered_map<std::string, uint64_t> catalog_epochs_;
+  std::mutex catalog_epochs_mutex_;
+};
+
+#endif  // CALCITE_CALCITEPLANCACHE_H
@@ -213,6 +213,11 @@ void Catalog::updateTableDescriptorSchema() {
                          std::to_string(MAPD_ROOT_USER_ID));
       sqliteConnector_.query(queryString);
     }
+    if (std::find(cols.begin(), cols.end(), std::string("page_compression")) ==
+        cols.end()) {
+      string queryString("ALTER TABLE mapd_tables ADD page_compression TEXT DEFAULT ''");
+      sqliteConnector_.query(queryString);
+    }
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     throw;
@@ -839,8 +844,8 @@ void Catalog::buildMaps() {
   string tableQuery(
       "SELECT tableid, name, ncolumns, isview, fragments, frag_type, max_frag_rows, "
       "max_chunk_size, frag_page_size, "
-      "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid "
-      "from mapd_tables");
+      "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid, "
+      "page_compression from mapd_tables");
   sqliteConnector_.query(tableQuery);
   numRows = sqliteConnector_.getNumRows();
   for (size_t r = 0; r < numRows; ++r) {
@@ -862,8 +867,12 @@ void Catalog::buildMaps() {
     td->nShards = sqliteConnector_.getData<int>(r, 13);
     td->keyMetainfo = sqliteConnector_.getData<string>(r, 14);
     td->userId = sqliteConnector_.getData<int>(r, 15);
+    td->pageCompression = sqliteConnector_.getData<string>(r, 16);
     if (!td->isView) {
       td->fragmenter = nullptr;
+      if (!td->pageCompression.empty()) {
+        dataMgr_->setTableCompression(currentDB_.dbId, td->tableId, td->pageCompression);
+      }
     }
     td->hasDeletedCol = false;
     tableDescriptorMap_[to_upper(td->tableName)] = td;
@@ -1918,8 +1927,8 @@ void Catalog::createTable(
           "frag_type, max_frag_rows, "
           "max_chunk_size, "
           "frag_page_size, max_rows, partitions, shard_column_id, shard, num_shards, "
-          "key_metainfo) VALUES (?, ?, ?, "
-          "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+          "key_metainfo, page_compression) VALUES (?, ?, ?, "
+          "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
 
           std::vector<std::string>{td.tableName,
                                    std::to_string(td.userId),
@@ -1935,12 +1944,17 @@ void Catalog::createTable(
                                    std::to_string(td.shardedColumnId),
                                    std::to_string(td.shard),
                                    std::to_string(td.nShards),
-                                   td.keyMetainfo});
+                                   td.keyMetainfo,
+                                   td.pageCompression});
 
       // now get the auto generated tableid
       sqliteConnector_.query_with_text_param(
           "SELECT tableid FROM mapd_tables WHERE name = ?", td.tableName);
       td.tableId = sqliteConnector_.getData<int>(0, 0);
+      if (!td.isView) {
+        // Also clears the compressor of a dropped table with the same id.
+        dataMgr_->setTableCompression(currentDB_.dbId, td.tableId, td.pageCompression);
+      }
       int colId = 1;
       for (auto cd : columns) {
         if (cd.columnType.get_compression() == kENCODING_DICT) {
@@ -47,6 +47,7 @@ struct TableDescriptor {
   std::string partitions;  // distributed partition scheme
   std::string
       keyMetainfo;  // meta-information about shard keys and shared dictionary, as JSON
+  std::string pageCompression;  // blosc compressor of the pages on disk, empty for none
 
   Fragmenter_Namespace::AbstractFragmenter*
       fragmenter;  // point to fragmenter object for the table.  it's instantiated upon
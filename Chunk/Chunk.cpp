@@ -22,6 +22,7 @@
 #include "Chunk.h"
 #include "../DataMgr/ArrayNoneEncoder.h"
 #include "../DataMgr/FixedLengthArrayNoneEncoder.h"
+#include "../DataMgr/PackedIntChunk.h"
 #include "../DataMgr/StringNoneEncoder.h"
 
 namespace Chunk_NS {
@@ -268,6 +269,12 @@ ChunkIter Chunk::begin_iterator(const ChunkMetadata& chunk_metadata,
         index_buf->getMemoryPtr() + start_idx * sizeof(StringOffsetT);
     it.end_pos = index_buf->getMemoryPtr() + index_buf->size() - sizeof(StringOffsetT);
     it.second_buf = buffer->getMemoryPtr();
+  } else if (it.type_info.is_packed_int()) {
+    // Past the header, at the positions the values have in the RAW format.
+    it.second_buf = buffer->getMemoryPtr();
+    const auto payload = it.second_buf + PACKED_INT_HEADER_SIZE;
+    it.current_pos = it.start_pos = payload + start_idx * it.skip_size;
+    it.end_pos = payload + chunk_metadata.numElements * it.skip_size;
   } else {
     it.current_pos = it.start_pos = buffer->getMemoryPtr() + start_idx * it.skip_size;
     it.end_pos = buffer->getMemoryPtr() + buffer->size();
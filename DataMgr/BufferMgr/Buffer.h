@@ -25,6 +25,7 @@
 #include "../AbstractBuffer.h"
 #include "BufferSeg.h"
 
+#include <atomic>
 #include <iostream>
 #include <mutex>
 //#include <boost/thread/locks.hpp>
@@ -131,19 +132,10 @@ class Buffer : public AbstractBuffer {
   /// Returns whether or not the buffer has been modified since the last flush/checkpoint.
   inline bool isDirty() const override { return isDirty_; }
 
-  inline int pin() override {
-    std::lock_guard<std::mutex> pinLock(pinMutex_);
-    return (++pinCount_);
-  }
+  inline int pin() override { return (++pinCount_); }
 
-  inline int unPin() override {
-    std::lock_guard<std::mutex> pinLock(pinMutex_);
-    return (--pinCount_);
-  }
-  inline int getPinCount() override {
-    std::lock_guard<std::mutex> pinLock(pinMutex_);
-    return (pinCount_);
-  }
+  inline int unPin() override { return (--pinCount_); }
+  inline int getPinCount() override { return (pinCount_.load()); }
 
  protected:
   int8_t* mem_;  /// pointer to beginning of buffer's memory
@@ -171,8 +163,7 @@ class Buffer : public AbstractBuffer {
   // std::vector<Page> pages_;   /// a vector of pages (page metadata) that compose the
   // buffer
   std::vector<bool> pageDirtyFlags_;
-  int pinCount_;
-  std::mutex pinMutex_;
+  std::atomic<int> pinCount_;
 };
 
 }  // namespace Buffer_Namespace
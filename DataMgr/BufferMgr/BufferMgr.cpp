@@ -50,6 +50,46 @@ void oom_trace_pop() {
 
 namespace Buffer_Namespace {
 
+namespace {
+
+// Bounds the number of evicted chunk keys remembered by EvictionPolicy::TWO_Q.
+constexpr size_t max_ghost_keys{8192};
+
+bool is_table_chunk(const ChunkKey& key) {
+  return key.size() >= 2 && key[0] >= 0;
+}
+
+bool has_key_prefix(const ChunkKey& key, const ChunkKey& keyPrefix) {
+  return key.size() >= keyPrefix.size() &&
+         std::equal(keyPrefix.begin(), keyPrefix.end(), key.begin());
+}
+
+}  // namespace
+
+thread_local bool ScopedLargeScan::is_active_{false};
+
+EvictionPolicy eviction_policy_from_string(const std::string& policy) {
+  if (policy == "lru") {
+    return EvictionPolicy::LRU;
+  }
+  if (policy == "2q") {
+    return EvictionPolicy::TWO_Q;
+  }
+  throw std::runtime_error("Unknown buffer eviction policy '" + policy +
+                           "', expected 'lru' or '2q'");
+}
+
+std::string to_string(const EvictionPolicy policy) {
+  switch (policy) {
+    case EvictionPolicy::LRU:
+      return "lru";
+    case EvictionPolicy::TWO_Q:
+      return "2q";
+  }
+  CHECK(false);
+  return "";
+}
+
 std::string BufferMgr::keyToString(const ChunkKey& key) {
   std::ostringstream oss;
 
@@ -65,7 +105,8 @@ BufferMgr::BufferMgr(const int deviceId,
                      const size_t maxBufferSize,
                      const size_t maxSlabSize,
                      const size_t pageSize,
-                     AbstractBufferMgr* parentMgr)
+                     AbstractBufferMgr* parentMgr,
+                     const EvictionPolicy evictionPolicy)
     : AbstractBufferMgr(deviceId)
     , pageSize_(pageSize)
     , maxBufferSize_(maxBufferSize)
@@ -74,7 +115,10 @@ BufferMgr::BufferMgr(const int deviceId,
     , allocationsCapped_(false)
     , parentMgr_(parentMgr)
     , maxBufferId_(0)
-    , bufferEpoch_(0) {
+    , bufferEpoch_(0)
+    , evictionPolicy_(evictionPolicy)
+    , usedPages_(0)
+    , hotPages_(0) {
   CHECK(maxBufferSize_ > 0 && maxSlabSize_ > 0 && pageSize_ > 0 &&
         maxSlabSize_ % pageSize_ == 0);
   maxNumPages_ = maxBufferSize_ / pageSize_;
@@ -97,61 +141,89 @@ void BufferMgr::reinit() {
   allocationsCapped_ = false;
 }
 
+size_t BufferMgr::getChunkIndexShardId(const ChunkKey& key) const {
+  return boost::hash<ChunkKey>()(key) % numChunkIndexShards_;
+}
+
+BufferMgr::ChunkIndexShard& BufferMgr::getChunkIndexShard(const ChunkKey& key) {
+  return chunkIndexShards_[getChunkIndexShardId(key)];
+}
+
 void BufferMgr::clear() {
   std::lock_guard<std::mutex> sizedSegsLock(sizedSegsMutex_);
-  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
-  std::lock_guard<std::mutex> unsizedSegsLock(unsizedSegsMutex_);
-  for (auto bufferIt = chunkIndex_.begin(); bufferIt != chunkIndex_.end(); ++bufferIt) {
-    delete bufferIt->second->buffer;
+  for (auto& shard : chunkIndexShards_) {
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    for (auto& kv : shard.index) {
+      delete kv.second.segIt->buffer;
+    }
+    shard.index.clear();
   }
-  chunkIndex_.clear();
+  std::lock_guard<std::mutex> unsizedSegsLock(unsizedSegsMutex_);
   slabs_.clear();
   slabSegments_.clear();
   unsizedSegs_.clear();
   bufferEpoch_ = 0;
+  usedPages_ = 0;
+  std::lock_guard<std::mutex> statsLock(statsMutex_);
+  hotPages_ = 0;
+  ghostKeys_.clear();
+  ghostIndex_.clear();
 }
 
 /// Throws a runtime_error if the Chunk already exists
 AbstractBuffer* BufferMgr::createBuffer(const ChunkKey& chunkKey,
                                         const size_t chunkPageSize,
                                         const size_t initialSize) {
+  return createBuffer(chunkKey, chunkPageSize, initialSize, true);
+}
+
+AbstractBuffer* BufferMgr::createBuffer(const ChunkKey& chunkKey,
+                                        const size_t chunkPageSize,
+                                        const size_t initialSize,
+                                        const bool loaded) {
   // LOG(INFO) << printMap();
   size_t actualChunkPageSize = chunkPageSize;
   if (actualChunkPageSize == 0) {
     actualChunkPageSize = pageSize_;
   }
 
+  auto& shard = getChunkIndexShard(chunkKey);
+  BufferList::iterator segIt;
   // ChunkPageSize here is just for recording dirty pages
   {
-    std::lock_guard<std::mutex> lock(chunkIndexMutex_);
-    CHECK(chunkIndex_.find(chunkKey) == chunkIndex_.end());
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    CHECK(shard.index.find(chunkKey) == shard.index.end());
     BufferSeg bufferSeg(BufferSeg(-1, 0, USED));
     bufferSeg.chunkKey = chunkKey;
     std::lock_guard<std::mutex> unsizedSegsLock(unsizedSegsMutex_);
     unsizedSegs_.push_back(bufferSeg);  // race condition?
-    chunkIndex_[chunkKey] =
-        std::prev(unsizedSegs_.end(),
-                  1);  // need to do this before allocating Buffer because doing so could
-                       // change the segment used
+    segIt = std::prev(unsizedSegs_.end(),
+                      1);  // need to do this before allocating Buffer because doing so
+                           // could change the segment used
+    shard.index[chunkKey] = {segIt, loaded};
   }
   // following should be safe outside the lock b/c first thing Buffer
   // constructor does is pin (and its still in unsized segs at this point
   // so can't be evicted)
   try {
-    allocateBuffer(chunkIndex_[chunkKey], actualChunkPageSize, initialSize);
+    allocateBuffer(segIt, actualChunkPageSize, initialSize);
   } catch (const OutOfMemory&) {
-    auto bufferIt = chunkIndex_.find(chunkKey);
-    CHECK(bufferIt != chunkIndex_.end());
-    bufferIt->second->buffer =
-        0;  // constructor failed for the buffer object so make sure to mark it zero so
-            // deleteBuffer doesn't try to delete it
+    {
+      std::lock_guard<std::mutex> shardLock(shard.mutex);
+      auto bufferIt = shard.index.find(chunkKey);
+      CHECK(bufferIt != shard.index.end());
+      bufferIt->second.segIt->buffer =
+          0;  // constructor failed for the buffer object so make sure to mark it zero so
+              // deleteBuffer doesn't try to delete it
+    }
     deleteBuffer(chunkKey);
     throw;
   }
-  CHECK(initialSize == 0 || chunkIndex_[chunkKey]->buffer->getMemoryPtr());
-  // chunkIndex_[chunkKey]->buffer->pin();
-  std::lock_guard<std::mutex> lock(chunkIndexMutex_);
-  return chunkIndex_[chunkKey]->buffer;
+  std::lock_guard<std::mutex> shardLock(shard.mutex);
+  auto bufferIt = shard.index.find(chunkKey);
+  CHECK(bufferIt != shard.index.end());
+  CHECK(initialSize == 0 || bufferIt->second.segIt->buffer->getMemoryPtr());
+  return bufferIt->second.segIt->buffer;
 }
 
 BufferList::iterator BufferMgr::evict(BufferList::iterator& evictStart,
@@ -160,16 +232,48 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evictStart,
   // We can assume here that buffer for evictStart either doesn't exist
   // (evictStart is first buffer) or was not free, so don't need ot merge
   // it
+
+  // Lookups pin buffers without the global lock, so lock the index shards of the
+  // segments to evict (in shard order) and make sure none got pinned since the
+  // caller has chosen them before taking them out of the index.
+  std::vector<size_t> shardIds;
+  {
+    size_t numPages = 0;
+    for (auto evictIt = evictStart; numPages < numPagesRequested; ++evictIt) {
+      numPages += evictIt->numPages;
+      if (evictIt->memStatus == USED && evictIt->chunkKey.size() > 0) {
+        shardIds.push_back(getChunkIndexShardId(evictIt->chunkKey));
+      }
+    }
+  }
+  std::sort(shardIds.begin(), shardIds.end());
+  shardIds.erase(std::unique(shardIds.begin(), shardIds.end()), shardIds.end());
+  std::vector<std::unique_lock<std::mutex>> shardLocks;
+  for (const auto shardId : shardIds) {
+    shardLocks.emplace_back(chunkIndexShards_[shardId].mutex);
+  }
+  {
+    size_t numPages = 0;
+    for (auto evictIt = evictStart; numPages < numPagesRequested; ++evictIt) {
+      numPages += evictIt->numPages;
+      if (evictIt->memStatus == USED && evictIt->buffer->getPinCount() > 0) {
+        return slabSegments_[slabNum].end();
+      }
+    }
+  }
+
   auto evictIt = evictStart;
   size_t numPages = 0;
   size_t startPage = evictStart->startPage;
   while (numPages < numPagesRequested) {
+    numPages += evictIt->numPages;
     if (evictIt->memStatus == USED) {
-      CHECK(evictIt->buffer->getPinCount() < 1);
+      uncountUsedPages(evictIt);
     }
-    numPages += evictIt->numPages;
     if (evictIt->memStatus == USED && evictIt->chunkKey.size() > 0) {
-      chunkIndex_.erase(evictIt->chunkKey);
+      chunkIndexShards_[getChunkIndexShardId(evictIt->chunkKey)].index.erase(
+          evictIt->chunkKey);
+      recordEviction(evictIt->chunkKey);
     }
     evictIt = slabSegments_[slabNum].erase(
         evictIt);  // erase operations returns next iterator - safe if we ever move
@@ -178,6 +282,7 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evictStart,
   BufferSeg dataSeg(startPage, numPagesRequested, USED, bufferEpoch_++);  // until we can
   // dataSeg.pinCount++;
   dataSeg.slabNum = slabNum;
+  usedPages_ += numPagesRequested;
   auto dataSegIt =
       slabSegments_[slabNum].insert(evictIt, dataSeg);  // Will insert before evictIt
   if (numPagesRequested < numPages) {
@@ -213,7 +318,12 @@ BufferList::iterator BufferMgr::reserveBuffer(
         nextIt->numPages >= numPagesExtraNeeded) {  // Then we can just use the next
                                                     // BufferSeg which happens to be free
       size_t leftoverPages = nextIt->numPages - numPagesExtraNeeded;
-      segIt->numPages = numPagesRequested;
+      usedPages_ += numPagesExtraNeeded;
+      {
+        std::lock_guard<std::mutex> statsLock(statsMutex_);
+        segIt->numPages = numPagesRequested;
+        hotPages_ += segIt->hot ? numPagesExtraNeeded : 0;
+      }
       nextIt->numPages = leftoverPages;
       nextIt->startPage = segIt->startPage + segIt->numPages;
       return segIt;
@@ -231,6 +341,12 @@ BufferList::iterator BufferMgr::reserveBuffer(
   newSegIt->buffer = segIt->buffer;
   // newSegIt->buffer->segIt_ = newSegIt;
   newSegIt->chunkKey = segIt->chunkKey;
+  {
+    std::lock_guard<std::mutex> statsLock(statsMutex_);
+    if (segIt->hot) {
+      markHot(newSegIt);
+    }
+  }
   int8_t* oldMem = newSegIt->buffer->mem_;
   newSegIt->buffer->mem_ = slabs_[newSegIt->slabNum] + newSegIt->startPage * pageSize_;
 
@@ -241,11 +357,14 @@ BufferList::iterator BufferMgr::reserveBuffer(
     newSegIt->buffer->writeData(
         oldMem, newSegIt->buffer->size(), 0, newSegIt->buffer->getType(), deviceId_);
   }
-  // Deincrement pin count to reverse effect above
-  removeSegment(segIt);
+  // Point the index to the new segment before the old one is freed, in the same
+  // critical section, so that lookups under the shard lock never see a stale segment.
   {
-    std::lock_guard<std::mutex> lock(chunkIndexMutex_);
-    chunkIndex_[newSegIt->chunkKey] = newSegIt;
+    auto& shard = getChunkIndexShard(newSegIt->chunkKey);
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    shard.index.emplace(newSegIt->chunkKey, ChunkIndexEntry{newSegIt, true})
+        .first->second.segIt = newSegIt;
+    removeSegment(segIt);
   }
 
   return newSegIt;
@@ -262,7 +381,9 @@ BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slabNum,
       bufferIt->numPages = numPagesRequested;
       bufferIt->memStatus = USED;
       bufferIt->lastTouched = bufferEpoch_++;
+      bufferIt->hot = false;
       bufferIt->slabNum = slabNum;
+      usedPages_ += numPagesRequested;
       if (excessPages > 0) {
         BufferSeg freeSeg(bufferIt->startPage + numPagesRequested, excessPages, FREE);
         auto tempIt = bufferIt;  // this should make a copy and not be a reference
@@ -350,85 +471,109 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t numBytes) {
 
   // If here then we can't add a slab - so we need to evict
 
-  size_t minScore = std::numeric_limits<size_t>::max();
-  // We're going for lowest score here, like golf
-  // This is because score is the sum of the lastTouched score for all
-  // pages evicted. Evicting less pages and older pages will lower the
-  // score
-  BufferList::iterator bestEvictionStart = slabSegments_[0].end();
-  int bestEvictionStartSlab = -1;
-  int slabNum = 0;
-
-  for (auto slabIt = slabSegments_.begin(); slabIt != slabSegments_.end();
-       ++slabIt, ++slabNum) {
-    for (auto bufferIt = slabIt->begin(); bufferIt != slabIt->end(); ++bufferIt) {
-      /* Note there are some shortcuts we could take here - like we
-       * should never consider a USED buffer coming after a free buffer
-       * as we would have used the FREE buffer, but we won't worry about
-       * this for now
-       */
-
-      // We can't evict pinned  buffers - only normal used
-      // buffers
-
-      // if (bufferIt->memStatus == FREE || bufferIt->buffer->getPinCount() == 0) {
-      size_t pageCount = 0;
-      size_t score = 0;
-      bool solutionFound = false;
-      auto evictIt = bufferIt;
-      for (; evictIt != slabSegments_[slabNum].end(); ++evictIt) {
-        // pinCount should never go up - only down because we have
-        // global lock on buffer pool and pin count only increments
-        // on getChunk
-        if (evictIt->memStatus == USED && evictIt->buffer->getPinCount() > 0) {
-          break;
-        }
-        pageCount += evictIt->numPages;
-        if (evictIt->memStatus == USED) {
-          // MAT changed from
-          // score += evictIt->lastTouched;
-          // Issue was thrashing when going from 8M fragment size chunks back to 64M
-          // basically the large chunks were being evicted prior to small as many small
-          // chunk score was larger than one large chunk so it always would evict a large
-          // chunk so under memory pressure a query would evict its own current chunks and
-          // cause reloads rather than evict several smaller unused older chunks.
-          score = std::max(score, static_cast<size_t>(evictIt->lastTouched));
+  // evict() gives up when one of the chosen buffers got pinned in the meantime, pick
+  // another run a bounded number of times rather than spinning under contention.
+  for (size_t retry = 0; retry < maxEvictionRetries_; ++retry) {
+    size_t minScore = std::numeric_limits<size_t>::max();
+    // We're going for lowest score here, like golf
+    // This is because score is the sum of the lastTouched score for all
+    // pages evicted. Evicting less pages and older pages will lower the
+    // score
+    BufferList::iterator bestEvictionStart = slabSegments_[0].end();
+    int bestEvictionStartSlab = -1;
+    int slabNum = 0;
+
+    // With the 2Q policy, runs holding hot segments score above any probationary only run
+    // as long as the probationary queue isn't below a quarter of the used pages.
+    bool protectHot = false;
+    if (evictionPolicy_ == EvictionPolicy::TWO_Q) {
+      std::lock_guard<std::mutex> statsLock(statsMutex_);
+      const size_t usedPages = usedPages_;
+      const size_t probationaryPages = usedPages - std::min(hotPages_, usedPages);
+      protectHot = probationaryPages * 4 > usedPages;
+    }
+    const size_t hotPenalty = size_t(1) << (8 * sizeof(unsigned int));
+
+    for (auto slabIt = slabSegments_.begin(); slabIt != slabSegments_.end();
+         ++slabIt, ++slabNum) {
+      for (auto bufferIt = slabIt->begin(); bufferIt != slabIt->end(); ++bufferIt) {
+        /* Note there are some shortcuts we could take here - like we
+         * should never consider a USED buffer coming after a free buffer
+         * as we would have used the FREE buffer, but we won't worry about
+         * this for now
+         */
+
+        // We can't evict pinned  buffers - only normal used
+        // buffers
+
+        // if (bufferIt->memStatus == FREE || bufferIt->buffer->getPinCount() == 0) {
+        size_t pageCount = 0;
+        size_t score = 0;
+        bool solutionFound = false;
+        auto evictIt = bufferIt;
+        for (; evictIt != slabSegments_[slabNum].end(); ++evictIt) {
+          // pinCount can go up concurrently since lookups pin buffers without
+          // the global lock, evict() checks the chosen run again
+          if (evictIt->memStatus == USED && evictIt->buffer->getPinCount() > 0) {
+            break;
+          }
+          pageCount += evictIt->numPages;
+          if (evictIt->memStatus == USED) {
+            // MAT changed from
+            // score += evictIt->lastTouched;
+            // Issue was thrashing when going from 8M fragment size chunks back to
+            // 64M basically the large chunks were being evicted prior to small as
+            // many small chunk score was larger than one large chunk so it always
+            // would evict a large chunk so under memory pressure a query would evict
+            // its own current chunks and cause reloads rather than evict several
+            // smaller unused older chunks.
+            score = std::max(score,
+                             static_cast<size_t>(evictIt->lastTouched) +
+                                 (protectHot && evictIt->hot ? hotPenalty : 0));
+          }
+          if (pageCount >= numPagesRequested) {
+            solutionFound = true;
+            break;
+          }
         }
-        if (pageCount >= numPagesRequested) {
-          solutionFound = true;
+        if (solutionFound && score < minScore) {
+          minScore = score;
+          bestEvictionStart = bufferIt;
+          bestEvictionStartSlab = slabNum;
+        } else if (evictIt == slabSegments_[slabNum].end()) {
+          // this means that every segment after this will fail as
+          // well, so our search has proven futile
+          // throw std::runtime_error ("Couldn't evict chunks to get free space");
           break;
+          // in reality we should try to rearrange the buffer to get
+          // more contiguous free space
         }
+        // other possibility is ending at PINNED - do nothing in this
+        // case
+        //}
       }
-      if (solutionFound && score < minScore) {
-        minScore = score;
-        bestEvictionStart = bufferIt;
-        bestEvictionStartSlab = slabNum;
-      } else if (evictIt == slabSegments_[slabNum].end()) {
-        // this means that every segment after this will fail as
-        // well, so our search has proven futile
-        // throw std::runtime_error ("Couldn't evict chunks to get free space");
-        break;
-        // in reality we should try to rearrange the buffer to get
-        // more contiguous free space
-      }
-      // other possibility is ending at PINNED - do nothing in this
-      // case
-      //}
+    }
+    if (bestEvictionStart == slabSegments_[0].end()) {
+      LOG(ERROR) << "ALLOCATION failed to find " << numBytes
+                 << "B throwing out of memory " << getStringMgrType() << ":"
+                 << deviceId_;
+      printSlabs();
+      throw OutOfMemory();
+    }
+    LOG(INFO) << "ALLOCATION failed to find " << numBytes << "B free. Forcing Eviction."
+              << " Eviction start " << bestEvictionStart->startPage
+              << " Number pages requested " << numPagesRequested
+              << " Best Eviction Start Slab " << bestEvictionStartSlab << " "
+              << getStringMgrType() << ":" << deviceId_;
+    auto dataSegIt = evict(bestEvictionStart, numPagesRequested, bestEvictionStartSlab);
+    if (dataSegIt != slabSegments_[bestEvictionStartSlab].end()) {
+      return dataSegIt;
     }
   }
-  if (bestEvictionStart == slabSegments_[0].end()) {
-    LOG(ERROR) << "ALLOCATION failed to find " << numBytes << "B throwing out of memory "
-               << getStringMgrType() << ":" << deviceId_;
-    printSlabs();
-    throw OutOfMemory();
-  }
-  LOG(INFO) << "ALLOCATION failed to find " << numBytes << "B free. Forcing Eviction."
-            << " Eviction start " << bestEvictionStart->startPage
-            << " Number pages requested " << numPagesRequested
-            << " Best Eviction Start Slab " << bestEvictionStartSlab << " "
-            << getStringMgrType() << ":" << deviceId_;
-  bestEvictionStart = evict(bestEvictionStart, numPagesRequested, bestEvictionStartSlab);
-  return bestEvictionStart;
+  LOG(ERROR) << "ALLOCATION failed to evict " << numBytes << "B after "
+             << maxEvictionRetries_ << " attempts, throwing out of memory "
+             << getStringMgrType() << ":" << deviceId_;
+  throw OutOfMemory();
 }
 
 std::string BufferMgr::printSlab(size_t slabNum) {
@@ -560,14 +705,17 @@ std::string BufferMgr::printMap() {
   tss << std::endl
       << "Map Contents: "
       << " " << getStringMgrType() << ":" << deviceId_ << std::endl;
-  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
-  for (auto segIt = chunkIndex_.begin(); segIt != chunkIndex_.end(); ++segIt, ++segNum) {
-    //    tss << "Map Entry " << segNum << ": ";
-    //    for (auto vecIt = segIt->first.begin(); vecIt != segIt->first.end(); ++vecIt) {
-    //      tss << *vecIt << ",";
-    //    }
-    //    tss << " " << std::endl;
-    tss << printSeg(segIt->second);
+  for (auto& shard : chunkIndexShards_) {
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    for (auto& kv : shard.index) {
+      //    tss << "Map Entry " << segNum << ": ";
+      //    for (auto vecIt = kv.first.begin(); vecIt != kv.first.end(); ++vecIt) {
+      //      tss << *vecIt << ",";
+      //    }
+      //    tss << " " << std::endl;
+      tss << printSeg(kv.second.segIt);
+      ++segNum;
+    }
   }
   tss << "--------------------" << std::endl;
   return tss.str();
@@ -591,26 +739,54 @@ void BufferMgr::printSegs() {
 }
 
 bool BufferMgr::isBufferOnDevice(const ChunkKey& key) {
-  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
-  if (chunkIndex_.find(key) == chunkIndex_.end()) {
+  auto& shard = getChunkIndexShard(key);
+  std::lock_guard<std::mutex> shardLock(shard.mutex);
+  if (shard.index.find(key) == shard.index.end()) {
     return false;
   } else {
     return true;
   }
 }
 
+bool BufferMgr::isBufferWithPrefixOnDevice(const ChunkKey& keyPrefix) {
+  if (keyPrefix.size() == 4) {
+    // The key of a fragment's column, the chunks of a varlen column add the data (1) or
+    // index (2) buffer to it; look those up rather than scanning the whole index.
+    auto key = keyPrefix;
+    if (isBufferOnDevice(key)) {
+      return true;
+    }
+    key.push_back(1);
+    if (isBufferOnDevice(key)) {
+      return true;
+    }
+    key.back() = 2;
+    return isBufferOnDevice(key);
+  }
+  for (auto& shard : chunkIndexShards_) {
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    for (const auto& kv : shard.index) {
+      if (has_key_prefix(kv.first, keyPrefix)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 /// This method throws a runtime_error when deleting a Chunk that does not exist.
 void BufferMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
-  std::unique_lock<std::mutex> chunkIndexLock(chunkIndexMutex_);
+  auto& shard = getChunkIndexShard(key);
+  std::unique_lock<std::mutex> shardLock(shard.mutex);
   // Note: purge is currently unused
 
-  // lookup the buffer for the Chunk in chunkIndex_
-  auto bufferIt = chunkIndex_.find(key);
+  // lookup the buffer for the Chunk in the index
+  auto bufferIt = shard.index.find(key);
   // Buffer *buffer = bufferIt->second->buffer;
-  CHECK(bufferIt != chunkIndex_.end());
-  auto segIt = bufferIt->second;
-  chunkIndex_.erase(bufferIt);
-  chunkIndexLock.unlock();
+  CHECK(bufferIt != shard.index.end());
+  auto segIt = bufferIt->second.segIt;
+  shard.index.erase(bufferIt);
+  shardLock.unlock();
   std::lock_guard<std::mutex> sizedSegsLock(sizedSegsMutex_);
   if (segIt->buffer) {
     delete segIt->buffer;  // Delete Buffer for segment
@@ -621,30 +797,26 @@ void BufferMgr::deleteBuffer(const ChunkKey& key, const bool purge) {
 
 void BufferMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purge) {
   // Note: purge is unused
-  // lookup the buffer for the Chunk in chunkIndex_
+  // lookup the buffer for the Chunk in the index
   std::lock_guard<std::mutex> sizedSegsLock(
       sizedSegsMutex_);  // Take this lock early to prevent deadlock with
                          // reserveBuffer which needs segsMutex_ and then
-                         // chunkIndexMutex_
-  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
-  auto startChunkIt = chunkIndex_.lower_bound(keyPrefix);
-  if (startChunkIt == chunkIndex_.end()) {
-    return;
-  }
-
-  auto bufferIt = startChunkIt;
-  while (bufferIt != chunkIndex_.end() &&
-         std::search(bufferIt->first.begin(),
-                     bufferIt->first.begin() + keyPrefix.size(),
-                     keyPrefix.begin(),
-                     keyPrefix.end()) != bufferIt->first.begin() + keyPrefix.size()) {
-    auto segIt = bufferIt->second;
-    if (segIt->buffer) {
-      delete segIt->buffer;  // Delete Buffer for segment
-      segIt->buffer = 0;
+                         // the index shard mutex
+  for (auto& shard : chunkIndexShards_) {
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    for (auto bufferIt = shard.index.begin(); bufferIt != shard.index.end();) {
+      if (!has_key_prefix(bufferIt->first, keyPrefix)) {
+        ++bufferIt;
+        continue;
+      }
+      auto segIt = bufferIt->second.segIt;
+      if (segIt->buffer) {
+        delete segIt->buffer;  // Delete Buffer for segment
+        segIt->buffer = 0;
+      }
+      removeSegment(segIt);
+      bufferIt = shard.index.erase(bufferIt);
     }
-    removeSegment(segIt);
-    chunkIndex_.erase(bufferIt++);
   }
 }
 
@@ -656,6 +828,9 @@ void BufferMgr::removeSegment(BufferList::iterator& segIt) {
     std::lock_guard<std::mutex> unsizedSegsLock(unsizedSegsMutex_);
     unsizedSegs_.erase(segIt);
   } else {
+    if (segIt->memStatus == USED) {
+      uncountUsedPages(segIt);
+    }
     if (segIt != slabSegments_[slabNum].begin()) {
       auto prevIt = std::prev(segIt);
       // LOG(INFO) << "PrevIt: " << " " << getStringMgrType() << ":" << deviceId_;
@@ -674,6 +849,7 @@ void BufferMgr::removeSegment(BufferList::iterator& segIt) {
       }
     }
     segIt->memStatus = FREE;
+    segIt->hot = false;
     // segIt->pinCount = 0;
     segIt->buffer = 0;
   }
@@ -681,72 +857,114 @@ void BufferMgr::removeSegment(BufferList::iterator& segIt) {
 
 void BufferMgr::checkpoint() {
   std::lock_guard<std::mutex> lock(globalMutex_);  // granular lock
-  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
 
-  for (auto bufferIt = chunkIndex_.begin(); bufferIt != chunkIndex_.end(); ++bufferIt) {
-    if (bufferIt->second->chunkKey[0] != -1 &&
-        bufferIt->second->buffer->isDirty_) {  // checks that buffer is actual chunk (not
-                                               // just buffer) and is dirty
+  for (auto& shard : chunkIndexShards_) {
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    for (auto& kv : shard.index) {
+      auto segIt = kv.second.segIt;
+      if (segIt->chunkKey[0] != -1 &&
+          segIt->buffer->isDirty_) {  // checks that buffer is actual chunk (not
+                                      // just buffer) and is dirty
 
-      parentMgr_->putBuffer(bufferIt->second->chunkKey, bufferIt->second->buffer);
-      bufferIt->second->buffer->clearDirtyBits();
+        parentMgr_->putBuffer(segIt->chunkKey, segIt->buffer);
+        segIt->buffer->clearDirtyBits();
+      }
     }
   }
 }
 
 void BufferMgr::checkpoint(const int db_id, const int tb_id) {
   std::lock_guard<std::mutex> lock(globalMutex_);  // granular lock
-  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
 
   ChunkKey keyPrefix;
   keyPrefix.push_back(db_id);
   keyPrefix.push_back(tb_id);
-  auto startChunkIt = chunkIndex_.lower_bound(keyPrefix);
-  if (startChunkIt == chunkIndex_.end()) {
-    return;
+  for (auto& shard : chunkIndexShards_) {
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    for (auto& kv : shard.index) {
+      auto segIt = kv.second.segIt;
+      if (has_key_prefix(kv.first, keyPrefix) && segIt->chunkKey[0] != -1 &&
+          segIt->buffer->isDirty_) {  // checks that buffer is actual chunk (not
+                                      // just buffer) and is dirty
+
+        parentMgr_->putBuffer(segIt->chunkKey, segIt->buffer);
+        segIt->buffer->clearDirtyBits();
+      }
+    }
   }
+}
 
-  auto bufferIt = startChunkIt;
-  while (bufferIt != chunkIndex_.end() &&
-         std::search(bufferIt->first.begin(),
-                     bufferIt->first.begin() + keyPrefix.size(),
-                     keyPrefix.begin(),
-                     keyPrefix.end()) != bufferIt->first.begin() + keyPrefix.size()) {
-    if (bufferIt->second->chunkKey[0] != -1 &&
-        bufferIt->second->buffer->isDirty_) {  // checks that buffer is actual chunk (not
-                                               // just buffer) and is dirty
+/// Pins and returns the buffer of a chunk which is resident with at least numBytes,
+/// without taking the global lock. Returns nullptr if the slow path is needed.
+AbstractBuffer* BufferMgr::getBufferIfLoaded(const ChunkKey& key, const size_t numBytes) {
+  auto& shard = getChunkIndexShard(key);
+  std::unique_lock<std::mutex> shardLock(shard.mutex);
+  auto bufferIt = shard.index.find(key);
+  if (bufferIt == shard.index.end() || !bufferIt->second.loaded) {
+    return nullptr;
+  }
+  // Check the size, pin and touch the segment under the shard lock: reserveBuffer()
+  // moves a growing buffer to a new segment and updates the index under the same lock,
+  // evict() re-checks the pin count under it too.
+  auto segIt = bufferIt->second.segIt;
+  auto buffer = segIt->buffer;
+  CHECK(buffer);
+  if (buffer->size() < numBytes) {
+    return nullptr;
+  }
+  buffer->pin();
+  segIt->lastTouched = bufferEpoch_++;
+  recordHit(segIt);
+  return buffer;
+}
 
-      parentMgr_->putBuffer(bufferIt->second->chunkKey, bufferIt->second->buffer);
-      bufferIt->second->buffer->clearDirtyBits();
-    }
-    bufferIt++;
+void BufferMgr::markLoaded(const ChunkKey& key, const AbstractBuffer* buffer) {
+  auto& shard = getChunkIndexShard(key);
+  std::lock_guard<std::mutex> shardLock(shard.mutex);
+  auto bufferIt = shard.index.find(key);
+  // The chunk may have been deleted while it was fetched, don't mark a buffer which
+  // has been replaced since.
+  if (bufferIt == shard.index.end() || bufferIt->second.segIt->buffer != buffer) {
+    return;
   }
+  bufferIt->second.loaded = true;
 }
 
 /// Returns a pointer to the Buffer holding the chunk, if it exists; otherwise,
 /// throws a runtime_error.
 AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t numBytes) {
+  auto buffer = getBufferIfLoaded(key, numBytes);
+  if (buffer) {
+    return buffer;
+  }
+
   std::lock_guard<std::mutex> lock(globalMutex_);  // granular lock
 
   std::unique_lock<std::mutex> sizedSegsLock(sizedSegsMutex_);
-  std::unique_lock<std::mutex> chunkIndexLock(chunkIndexMutex_);
-  auto bufferIt = chunkIndex_.find(key);
-  bool foundBuffer = bufferIt != chunkIndex_.end();
-  chunkIndexLock.unlock();
+  auto& shard = getChunkIndexShard(key);
+  std::unique_lock<std::mutex> shardLock(shard.mutex);
+  auto bufferIt = shard.index.find(key);
+  bool foundBuffer = bufferIt != shard.index.end();
   if (foundBuffer) {
-    CHECK(bufferIt->second->buffer);
-    bufferIt->second->buffer->pin();
+    // Loaded by another thread in the meantime or too small, the miss paths run under
+    // the global lock so the buffer is complete here.
+    auto segIt = bufferIt->second.segIt;
+    CHECK(segIt->buffer);
+    segIt->buffer->pin();
+    shardLock.unlock();
     sizedSegsLock.unlock();
-    bufferIt->second->lastTouched = bufferEpoch_++;  // race
-    if (bufferIt->second->buffer->size() <
+    segIt->lastTouched = bufferEpoch_++;  // race
+    recordHit(segIt);
+    if (segIt->buffer->size() <
         numBytes) {  // need to fetch part of buffer we don't have - up to numBytes
-      parentMgr_->fetchBuffer(key, bufferIt->second->buffer, numBytes);
+      parentMgr_->fetchBuffer(key, segIt->buffer, numBytes);
     }
-    return bufferIt->second->buffer;
+    return segIt->buffer;
   } else {  // If wasn't in pool then we need to fetch it
+    shardLock.unlock();
     sizedSegsLock.unlock();
-    AbstractBuffer* buffer =
-        createBuffer(key, pageSize_, numBytes);  // createChunk pins for us
+    buffer = createBuffer(key, pageSize_, numBytes, false);  // createChunk pins for us
+    recordMiss(key, buffer);
     try {
       parentMgr_->fetchBuffer(
           key, buffer, numBytes);  // this should put buffer in a BufferSegment
@@ -754,6 +972,7 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t numBytes)
       LOG(FATAL) << "Get chunk - Could not find chunk " << keyToString(key)
                  << " in buffer pool or parent buffer pools. Error was " << error.what();
     }
+    markLoaded(key, buffer);
     return buffer;
   }
 }
@@ -763,24 +982,30 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
                             const size_t numBytes) {
   std::unique_lock<std::mutex> lock(globalMutex_);  // granular lock
   std::unique_lock<std::mutex> sizedSegsLock(sizedSegsMutex_);
-  std::unique_lock<std::mutex> chunkIndexLock(chunkIndexMutex_);
+  auto& shard = getChunkIndexShard(key);
+  std::unique_lock<std::mutex> shardLock(shard.mutex);
 
-  auto bufferIt = chunkIndex_.find(key);
-  bool foundBuffer = bufferIt != chunkIndex_.end();
-  chunkIndexLock.unlock();
+  auto bufferIt = shard.index.find(key);
+  bool foundBuffer = bufferIt != shard.index.end();
   AbstractBuffer* buffer;
   if (!foundBuffer) {
+    shardLock.unlock();
     sizedSegsLock.unlock();
     CHECK(parentMgr_ != 0);
-    buffer = createBuffer(key, pageSize_, numBytes);  // will pin buffer
+    buffer = createBuffer(key, pageSize_, numBytes, false);  // will pin buffer
+    recordMiss(key, buffer);
     try {
       parentMgr_->fetchBuffer(key, buffer, numBytes);
     } catch (std::runtime_error& error) {
       LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
     }
+    markLoaded(key, buffer);
   } else {
-    buffer = bufferIt->second->buffer;
+    auto segIt = bufferIt->second.segIt;
+    buffer = segIt->buffer;
     buffer->pin();
+    shardLock.unlock();
+    recordHit(segIt);
     if (numBytes > buffer->size()) {
       try {
         parentMgr_->fetchBuffer(key, buffer, numBytes);
@@ -814,15 +1039,14 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
 AbstractBuffer* BufferMgr::putBuffer(const ChunkKey& key,
                                      AbstractBuffer* srcBuffer,
                                      const size_t numBytes) {
-  std::unique_lock<std::mutex> chunkIndexLock(chunkIndexMutex_);
-  auto bufferIt = chunkIndex_.find(key);
-  bool foundBuffer = bufferIt != chunkIndex_.end();
-  chunkIndexLock.unlock();
-  AbstractBuffer* buffer;
+  auto& shard = getChunkIndexShard(key);
+  std::unique_lock<std::mutex> shardLock(shard.mutex);
+  auto bufferIt = shard.index.find(key);
+  bool foundBuffer = bufferIt != shard.index.end();
+  AbstractBuffer* buffer = foundBuffer ? bufferIt->second.segIt->buffer : nullptr;
+  shardLock.unlock();
   if (!foundBuffer) {
     buffer = createBuffer(key, pageSize_);
-  } else {
-    buffer = bufferIt->second->buffer;
   }
   size_t oldBufferSize = buffer->size();
   size_t newBufferSize = numBytes == 0 ? srcBuffer->size() : numBytes;
@@ -870,8 +1094,12 @@ void BufferMgr::free(AbstractBuffer* buffer) {
 }
 
 size_t BufferMgr::getNumChunks() {
-  std::lock_guard<std::mutex> chunkIndexLock(chunkIndexMutex_);
-  return chunkIndex_.size();
+  size_t numChunks = 0;
+  for (auto& shard : chunkIndexShards_) {
+    std::lock_guard<std::mutex> shardLock(shard.mutex);
+    numChunks += shard.index.size();
+  }
+  return numChunks;
 }
 
 size_t BufferMgr::size() {
@@ -900,4 +1128,98 @@ void BufferMgr::getChunkMetadataVecForKeyPrefix(
 const std::vector<BufferList>& BufferMgr::getSlabSegments() {
   return slabSegments_;
 }
+
+std::vector<TableBufferStats> BufferMgr::getTableBufferStats() {
+  std::lock_guard<std::mutex> statsLock(statsMutex_);
+  std::vector<TableBufferStats> tableStats;
+  for (const auto& kv : tableStats_) {
+    tableStats.push_back(kv.second);
+  }
+  return tableStats;
+}
+
+void BufferMgr::recordHit(BufferList::iterator segIt) {
+  const bool promote =
+      evictionPolicy_ == EvictionPolicy::TWO_Q && !ScopedLargeScan::isActive();
+  const auto& key = segIt->chunkKey;
+  if (!promote && !is_table_chunk(key)) {
+    return;
+  }
+  std::lock_guard<std::mutex> statsLock(statsMutex_);
+  if (promote) {
+    markHot(segIt);
+  }
+  if (!is_table_chunk(key)) {
+    return;
+  }
+  auto& stats = tableStats_[std::make_pair(key[0], key[1])];
+  stats.db_id = key[0];
+  stats.table_id = key[1];
+  ++stats.hits;
+}
+
+void BufferMgr::recordMiss(const ChunkKey& key, AbstractBuffer* buffer) {
+  if (!is_table_chunk(key)) {
+    return;
+  }
+  std::lock_guard<std::mutex> statsLock(statsMutex_);
+  auto& stats = tableStats_[std::make_pair(key[0], key[1])];
+  stats.db_id = key[0];
+  stats.table_id = key[1];
+  ++stats.misses;
+  auto ghostIt = ghostIndex_.find(key);
+  if (ghostIt != ghostIndex_.end()) {
+    // Evicted recently and needed again, skip the probationary queue.
+    if (!ScopedLargeScan::isActive()) {
+      auto castedBuffer = dynamic_cast<Buffer*>(buffer);
+      CHECK(castedBuffer);
+      markHot(castedBuffer->segIt_);
+    }
+    ghostKeys_.erase(ghostIt->second);
+    ghostIndex_.erase(ghostIt);
+  }
+}
+
+void BufferMgr::markHot(BufferList::iterator segIt) {
+  if (segIt->hot) {
+    return;
+  }
+  segIt->hot = true;
+  if (segIt->slabNum >= 0) {
+    hotPages_ += segIt->numPages;
+  }
+}
+
+void BufferMgr::uncountUsedPages(BufferList::iterator segIt) {
+  {
+    std::lock_guard<std::mutex> statsLock(statsMutex_);
+    if (segIt->hot) {
+      CHECK_GE(hotPages_, segIt->numPages);
+      hotPages_ -= segIt->numPages;
+      segIt->hot = false;
+    }
+  }
+  CHECK_GE(usedPages_.load(), segIt->numPages);
+  usedPages_ -= segIt->numPages;
+}
+
+void BufferMgr::recordEviction(const ChunkKey& key) {
+  if (!is_table_chunk(key)) {
+    return;
+  }
+  std::lock_guard<std::mutex> statsLock(statsMutex_);
+  auto& stats = tableStats_[std::make_pair(key[0], key[1])];
+  stats.db_id = key[0];
+  stats.table_id = key[1];
+  ++stats.evictions;
+  if (evictionPolicy_ != EvictionPolicy::TWO_Q || ghostIndex_.count(key)) {
+    return;
+  }
+  ghostKeys_.push_back(key);
+  ghostIndex_[key] = std::prev(ghostKeys_.end());
+  if (ghostKeys_.size() > max_ghost_keys) {
+    ghostIndex_.erase(ghostKeys_.front());
+    ghostKeys_.pop_front();
+  }
+}
 }  // namespace Buffer_Namespace
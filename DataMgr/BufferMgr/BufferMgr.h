@@ -25,10 +25,15 @@
 #ifndef DATAMGR_MEMORY_BUFFER_BUFFERMGR_H
 #define DATAMGR_MEMORY_BUFFER_BUFFERMGR_H
 
+#include <boost/functional/hash.hpp>
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <list>
 #include <map>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "../AbstractBuffer.h"
 #include "../AbstractBufferMgr.h"
 #include "../Shared/types.h"
@@ -60,6 +65,45 @@ using namespace Data_Namespace;
 
 namespace Buffer_Namespace {
 
+/**
+ * LRU evicts the least recently touched run of unpinned segments which fits the
+ * request. TWO_Q splits the segments into a probationary queue of chunks referenced
+ * once since they were loaded and a hot queue of chunks referenced again; while the
+ * probationary queue holds more than a quarter of the used pages, it is evicted first,
+ * so that a single pass over a cold table cannot flush the hot columns. Chunks evicted
+ * recently are remembered and go straight to the hot queue when loaded again.
+ */
+enum class EvictionPolicy { LRU, TWO_Q };
+
+EvictionPolicy eviction_policy_from_string(const std::string& policy);
+std::string to_string(const EvictionPolicy policy);
+
+struct TableBufferStats {
+  int db_id;
+  int table_id;
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+};
+
+/**
+ * Marks the chunks requested by the current thread as part of a large sequential scan
+ * for its lifetime: they are not promoted to the hot queue of EvictionPolicy::TWO_Q.
+ */
+class ScopedLargeScan {
+ public:
+  ScopedLargeScan(const bool large_scan) : saved_(is_active_) {
+    is_active_ = saved_ || large_scan;
+  }
+  ~ScopedLargeScan() { is_active_ = saved_; }
+
+  static bool isActive() { return is_active_; }
+
+ private:
+  const bool saved_;
+  static thread_local bool is_active_;
+};
+
 /**
  * @class   BufferMgr
  * @brief
@@ -77,7 +121,8 @@ class BufferMgr : public AbstractBufferMgr {  // implements
             const size_t maxBufferSize,
             const size_t maxSlabSize = 2147483648,
             const size_t pageSize = 512,
-            AbstractBufferMgr* parentMgr = 0);
+            AbstractBufferMgr* parentMgr = 0,
+            const EvictionPolicy evictionPolicy = EvictionPolicy::LRU);
 
   /// Destructor
   ~BufferMgr() override;
@@ -100,6 +145,8 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   size_t getPageSize();
   bool isAllocationCapped() override;
   const std::vector<BufferList>& getSlabSegments();
+  EvictionPolicy getEvictionPolicy() const { return evictionPolicy_; }
+  std::vector<TableBufferStats> getTableBufferStats();
 
   /// Creates a chunk with the specified key and page size.
   AbstractBuffer* createBuffer(const ChunkKey& key,
@@ -121,6 +168,8 @@ class BufferMgr : public AbstractBufferMgr {  // implements
    * @return AbstractBuffer*
    */
   bool isBufferOnDevice(const ChunkKey& key) override;
+  /// Whether any chunk whose key starts with keyPrefix is in the pool.
+  bool isBufferWithPrefixOnDevice(const ChunkKey& keyPrefix);
   void fetchBuffer(const ChunkKey& key,
                    AbstractBuffer* destBuffer,
                    const size_t numBytes = 0) override;
@@ -164,13 +213,49 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   virtual void allocateBuffer(BufferList::iterator segIt,
                               const size_t pageSize,
                               const size_t numBytes) = 0;
-  std::mutex chunkIndexMutex_;
+  AbstractBuffer* createBuffer(const ChunkKey& key,
+                               const size_t pageSize,
+                               const size_t initialSize,
+                               const bool loaded);
+  AbstractBuffer* getBufferIfLoaded(const ChunkKey& key, const size_t numBytes);
+  void markLoaded(const ChunkKey& key, const AbstractBuffer* buffer);
+  void recordHit(BufferList::iterator segIt);
+  void recordMiss(const ChunkKey& key, AbstractBuffer* buffer);
+  void recordEviction(const ChunkKey& key);
+  // Moves the segment to the hot queue of EvictionPolicy::TWO_Q, the caller holds
+  // statsMutex_.
+  void markHot(BufferList::iterator segIt);
+  // Takes the pages of a slab segment which is about to be freed off the counters.
+  void uncountUsedPages(BufferList::iterator segIt);
   std::mutex sizedSegsMutex_;
   std::mutex unsizedSegsMutex_;
   std::mutex bufferIdMutex_;
   std::mutex globalMutex_;
+  std::mutex statsMutex_;
 
-  std::map<ChunkKey, BufferList::iterator> chunkIndex_;
+  struct ChunkIndexEntry {
+    BufferList::iterator segIt;
+    // False while the miss path which created the buffer fetches its contents from the
+    // parent manager, the lookups without the global lock must not return it yet.
+    bool loaded;
+  };
+
+  // The chunk index is split in shards by the hash of the key, so that lookups of
+  // different chunks don't contend on a single mutex. Pinning a buffer happens under
+  // the lock of its shard, eviction and deletion remove buffers from their shard first.
+  struct ChunkIndexShard {
+    std::mutex mutex;
+    std::unordered_map<ChunkKey, ChunkIndexEntry, boost::hash<ChunkKey>> index;
+  };
+
+  static constexpr size_t numChunkIndexShards_{64};
+  // Runs picked by findFreeBuffer() before giving up when they keep getting pinned.
+  static constexpr size_t maxEvictionRetries_{8};
+
+  size_t getChunkIndexShardId(const ChunkKey& key) const;
+  ChunkIndexShard& getChunkIndexShard(const ChunkKey& key);
+
+  std::array<ChunkIndexShard, numChunkIndexShards_> chunkIndexShards_;
   size_t maxBufferSize_;  /// max number of bytes allocated for the buffer pool
   size_t maxNumPages_;
   size_t numPagesAllocated_;
@@ -181,9 +266,22 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   bool allocationsCapped_;
   AbstractBufferMgr* parentMgr_;
   int maxBufferId_;
-  unsigned int bufferEpoch_;
+  std::atomic<unsigned int> bufferEpoch_;
+  const EvictionPolicy evictionPolicy_;
+  // Pages of the used slab segments and of the hot ones among them, kept up to date as
+  // segments are allocated, grown, promoted and freed so that findFreeBuffer() doesn't
+  // have to scan the slabs for them. The hot flags and hotPages_ are guarded by
+  // statsMutex_.
+  std::atomic<size_t> usedPages_;
+  size_t hotPages_;
   // File_Namespace::FileMgr *fileMgr_;
 
+  // Keyed by {db_id, table_id}, guarded by statsMutex_ along with the ghost queue.
+  std::map<std::pair<int, int>, TableBufferStats> tableStats_;
+  // Keys of the chunks evicted last, oldest first.
+  std::list<ChunkKey> ghostKeys_;
+  std::map<ChunkKey, std::list<ChunkKey>::iterator> ghostIndex_;
+
   /// Maps sizes of free memory areas to host buffer pool memory addresses
   //@todo change this to multimap
   // std::multimap<size_t, int8_t *> freeMem_;
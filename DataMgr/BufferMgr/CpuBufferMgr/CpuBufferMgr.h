@@ -32,7 +32,8 @@ class CpuBufferMgr : public BufferMgr {
                CudaMgr_Namespace::CudaMgr* cudaMgr,
                const size_t bufferAllocIncrement = 2147483648,
                const size_t pageSize = 512,
-               AbstractBufferMgr* parentMgr = 0);
+               AbstractBufferMgr* parentMgr = 0,
+               const EvictionPolicy evictionPolicy = EvictionPolicy::LRU);
   inline MgrType getMgrType() override { return CPU_MGR; }
   inline std::string getStringMgrType() override { return ToString(CPU_MGR); }
   ~CpuBufferMgr() override;
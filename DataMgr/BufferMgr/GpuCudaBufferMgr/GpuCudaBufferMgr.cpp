@@ -27,8 +27,14 @@ GpuCudaBufferMgr::GpuCudaBufferMgr(const int deviceId,
                                    CudaMgr_Namespace::CudaMgr* cudaMgr,
                                    const size_t bufferAllocIncrement,
                                    const size_t pageSize,
-                                   AbstractBufferMgr* parentMgr)
-    : BufferMgr(deviceId, maxBufferSize, bufferAllocIncrement, pageSize, parentMgr)
+                                   AbstractBufferMgr* parentMgr,
+                                   const EvictionPolicy evictionPolicy)
+    : BufferMgr(deviceId,
+                maxBufferSize,
+                bufferAllocIncrement,
+                pageSize,
+                parentMgr,
+                evictionPolicy)
     , cudaMgr_(cudaMgr) {}
 
 GpuCudaBufferMgr::~GpuCudaBufferMgr() {
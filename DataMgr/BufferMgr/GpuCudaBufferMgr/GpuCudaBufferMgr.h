@@ -32,7 +32,8 @@ class GpuCudaBufferMgr : public BufferMgr {
                    CudaMgr_Namespace::CudaMgr* cudaMgr,
                    const size_t bufferAllocIncrement = 1073741824,
                    const size_t pageSize = 512,
-                   AbstractBufferMgr* parentMgr = 0);
+                   AbstractBufferMgr* parentMgr = 0,
+                   const EvictionPolicy evictionPolicy = EvictionPolicy::LRU);
   inline MgrType getMgrType() override { return GPU_MGR; }
   inline std::string getStringMgrType() override { return ToString(GPU_MGR); }
   ~GpuCudaBufferMgr() override;
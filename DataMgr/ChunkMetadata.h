@@ -21,6 +21,9 @@
 #include "../Shared/sqltypes.h"
 
 #include <glog/logging.h>
+#include <memory>
+
+class ChunkSketch;
 
 struct ChunkStats {
   Datum min;
@@ -33,6 +36,12 @@ struct ChunkMetadata {
   size_t numBytes;
   size_t numElements;
   ChunkStats chunkStats;
+  // Size of the chunk on disk when its pages are compressed, 0 otherwise, and the time
+  // spent decompressing it since the server started. Only the FileMgr fills them in.
+  size_t numCompressedBytes{0};
+  int64_t decompressMicros{0};
+  // Bloom filter and distinct count sketch of the values, null if the chunk has none.
+  std::shared_ptr<const ChunkSketch> sketch;
 
   template <typename T>
   void fillChunkStats(const T min, const T max, const bool has_nulls) {
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChunkSketch.h"
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 2^20 bits and 3 probes: about 2% false positives at 100K distinct values per chunk.
+constexpr size_t bloom_bits_log2{20};
+constexpr size_t bloom_probes{3};
+// 2^12 registers: about 1.6% standard error on the distinct count.
+constexpr size_t hll_precision{12};
+
+struct ChunkSketchHeader {
+  uint64_t num_elems;
+  uint32_t bloom_words;  // 0 for a sketch which no longer covers its chunk
+  uint32_t hll_registers;
+};
+
+uint64_t hash_value(const int64_t val) {
+  uint64_t h = static_cast<uint64_t>(val);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Double hashing over the two halves of the hash for the probes.
+template <typename F>
+void for_each_probe(const uint64_t hash, F f) {
+  const uint64_t mask = (uint64_t(1) << bloom_bits_log2) - 1;
+  const uint32_t h1 = static_cast<uint32_t>(hash);
+  const uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (size_t i = 0; i < bloom_probes; ++i) {
+    f((h1 + i * h2) & mask);
+  }
+}
+
+}  // namespace
+
+ChunkSketch::ChunkSketch()
+    : bloom_((size_t(1) << bloom_bits_log2) / 64, 0)
+    , hll_(size_t(1) << hll_precision, 0) {}
+
+bool ChunkSketch::isSupportedType(const SQLTypeInfo& ti) {
+  if (ti.is_string()) {
+    return ti.get_compression() == kENCODING_DICT;
+  }
+  return ti.is_integer() || ti.is_time();
+}
+
+void ChunkSketch::add(const int64_t val) {
+  const auto hash = hash_value(val);
+  for_each_probe(hash, [this](const uint64_t bit) {
+    bloom_[bit >> 6] |= uint64_t(1) << (bit & 63);
+  });
+  const auto reg = hash >> (64 - hll_precision);
+  const auto rest = hash << hll_precision;
+  const uint8_t rank =
+      rest ? __builtin_clzll(rest) + 1 : static_cast<uint8_t>(64 - hll_precision + 1);
+  hll_[reg] = std::max(hll_[reg], rank);
+}
+
+bool ChunkSketch::mayContain(const int64_t val) const {
+  bool found{true};
+  for_each_probe(hash_value(val), [this, &found](const uint64_t bit) {
+    found = found && (bloom_[bit >> 6] & (uint64_t(1) << (bit & 63)));
+  });
+  return found;
+}
+
+void ChunkSketch::mergeDistinctRegisters(std::vector<uint8_t>& dest,
+                                         const std::vector<uint8_t>& src) {
+  if (dest.empty()) {
+    dest = src;
+    return;
+  }
+  CHECK_EQ(dest.size(), src.size());
+  for (size_t i = 0; i < dest.size(); ++i) {
+    dest[i] = std::max(dest[i], src[i]);
+  }
+}
+
+size_t ChunkSketch::estimateDistinct(const std::vector<uint8_t>& registers) {
+  const double m = registers.size();
+  CHECK_GT(m, 0);
+  double sum{0};
+  size_t zeros{0};
+  for (const auto reg : registers) {
+    sum += std::ldexp(1.0, -reg);
+    zeros += reg == 0;
+  }
+  const double alpha = 0.7213 / (1 + 1.079 / m);
+  const double raw = alpha * m * m / sum;
+  // Linear counting for the small cardinalities, the 64 bit hashes don't saturate.
+  if (raw <= 2.5 * m && zeros) {
+    return std::llround(m * std::log(m / zeros));
+  }
+  return std::llround(raw);
+}
+
+std::vector<int8_t> ChunkSketch::serialize(const uint64_t num_elems) const {
+  ChunkSketchHeader header{num_elems,
+                           static_cast<uint32_t>(bloom_.size()),
+                           static_cast<uint32_t>(hll_.size())};
+  const size_t bloom_bytes = bloom_.size() * sizeof(uint64_t);
+  std::vector<int8_t> serialized(sizeof(header) + bloom_bytes + hll_.size());
+  auto ptr = serialized.data();
+  memcpy(ptr, &header, sizeof(header));
+  ptr += sizeof(header);
+  memcpy(ptr, bloom_.data(), bloom_bytes);
+  ptr += bloom_bytes;
+  memcpy(ptr, hll_.data(), hll_.size());
+  return serialized;
+}
+
+std::vector<int8_t> ChunkSketch::serializeInvalid() {
+  ChunkSketchHeader header{0, 0, 0};
+  std::vector<int8_t> serialized(sizeof(header));
+  memcpy(serialized.data(), &header, sizeof(header));
+  return serialized;
+}
+
+std::shared_ptr<ChunkSketch> ChunkSketch::deserialize(const int8_t* data,
+                                                      const size_t size,
+                                                      const uint64_t num_elems) {
+  ChunkSketchHeader header;
+  if (size < sizeof(header)) {
+    return nullptr;
+  }
+  memcpy(&header, data, sizeof(header));
+  auto sketch = std::make_shared<ChunkSketch>();
+  const size_t bloom_bytes = sketch->bloom_.size() * sizeof(uint64_t);
+  if (header.num_elems != num_elems || header.bloom_words != sketch->bloom_.size() ||
+      header.hll_registers != sketch->hll_.size() ||
+      size < sizeof(header) + bloom_bytes + sketch->hll_.size()) {
+    return nullptr;
+  }
+  data += sizeof(header);
+  memcpy(sketch->bloom_.data(), data, bloom_bytes);
+  data += bloom_bytes;
+  memcpy(sketch->hll_.data(), data, sketch->hll_.size());
+  return sketch;
+}
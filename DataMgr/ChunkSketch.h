@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkSketch.h
+ * @brief   Bloom filter and HyperLogLog sketch of the values of a chunk.
+ *
+ * The sketches complement the min / max chunk stats: the bloom filter rules out the
+ * fragments which can't match an equality or IN predicate and the distinct count
+ * estimates of the chunks are merged into the group by cardinality estimations.
+ * They are kept for the integer, time and dictionary encoded string columns, over the
+ * logical values (the dictionary ids for strings), nulls aside. A chunk only has a
+ * sketch if it has been built with chunk sketches enabled since its first value.
+ *
+ * A sketch has a fixed size of about 132KB (a 128KB bloom filter and 4KB of registers)
+ * whatever the number of values, held with the chunk metadata for the lifetime of the
+ * FileMgr and written next to the chunk. With the default fragment size of 32M rows this
+ * is well below the size of the chunk itself, small fragments pay relatively more.
+ */
+
+#ifndef DATAMGR_CHUNKSKETCH_H
+#define DATAMGR_CHUNKSKETCH_H
+
+#include "../Shared/sqltypes.h"
+
+#include <memory>
+#include <vector>
+
+// Last element of the keys of the FileMgr buffers holding the serialized sketch of the
+// chunk keyed by the remaining elements.
+#define CHUNK_SKETCH_KEY_SUFFIX 3
+
+class ChunkSketch {
+ public:
+  ChunkSketch();
+
+  static bool isSupportedType(const SQLTypeInfo& ti);
+
+  void add(const int64_t val);
+
+  // False if val is certainly not in the chunk.
+  bool mayContain(const int64_t val) const;
+
+  // HyperLogLog registers, merged across chunks by taking the maximum of each.
+  const std::vector<uint8_t>& getDistinctRegisters() const { return hll_; }
+  static void mergeDistinctRegisters(std::vector<uint8_t>& dest,
+                                     const std::vector<uint8_t>& src);
+  static size_t estimateDistinct(const std::vector<uint8_t>& registers);
+  size_t estimateDistinct() const { return estimateDistinct(hll_); }
+
+  // The sketch of a chunk of num_elems values. Sketches which don't match the number of
+  // values of their chunk when read back are discarded.
+  std::vector<int8_t> serialize(const uint64_t num_elems) const;
+  static std::vector<int8_t> serializeInvalid();
+  static std::shared_ptr<ChunkSketch> deserialize(const int8_t* data,
+                                                  const size_t size,
+                                                  const uint64_t num_elems);
+
+ private:
+  std::vector<uint64_t> bloom_;
+  std::vector<uint8_t> hll_;
+};
+
+#endif  // DATAMGR_CHUNKSKETCH_H
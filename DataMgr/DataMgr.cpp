@@ -21,6 +21,7 @@
 
 #include "DataMgr.h"
 #include "../CudaMgr/CudaMgr.h"
+#include "../Shared/Compressor.h"
 #include "BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
 #include "BufferMgr/GpuCudaBufferMgr/GpuCudaBufferMgr.h"
 #include "FileMgr/GlobalFileMgr.h"
@@ -105,6 +106,10 @@ void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
     cpuBufferSize = getTotalSystemMemory() *
                     0.8;  // should get free memory instead of this ugly heuristic
   }
+  const auto cpuEvictionPolicy =
+      eviction_policy_from_string(mapd_parameters.cpu_buffer_eviction_policy);
+  const auto gpuEvictionPolicy =
+      eviction_policy_from_string(mapd_parameters.gpu_buffer_eviction_policy);
   size_t cpuSlabSize = std::min(static_cast<size_t>(1L << 32), cpuBufferSize);
   // cpuSlabSize -= cpuSlabSize % 512 == 0 ? 0 : 512 - (cpuSlabSize % 512);
   cpuSlabSize = (cpuSlabSize / 512) * 512;
@@ -113,8 +118,13 @@ void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
     LOG(INFO) << "reserved GPU memory is " << (float)reservedGpuMem_ / (1024 * 1024)
               << "M includes render buffer allocation";
     bufferMgrs_.resize(3);
-    bufferMgrs_[1].push_back(new CpuBufferMgr(
-        0, cpuBufferSize, cudaMgr_.get(), cpuSlabSize, 512, bufferMgrs_[0][0]));
+    bufferMgrs_[1].push_back(new CpuBufferMgr(0,
+                                              cpuBufferSize,
+                                              cudaMgr_.get(),
+                                              cpuSlabSize,
+                                              512,
+                                              bufferMgrs_[0][0],
+                                              cpuEvictionPolicy));
     levelSizes_.push_back(1);
     int numGpus = cudaMgr_->getDeviceCount();
     for (int gpuNum = 0; gpuNum < numGpus; ++gpuNum) {
@@ -125,13 +135,23 @@ void DataMgr::populateMgrs(const MapDParameters& mapd_parameters,
       size_t gpuSlabSize = std::min(static_cast<size_t>(1L << 31), gpuMaxMemSize);
       gpuSlabSize -= gpuSlabSize % 512 == 0 ? 0 : 512 - (gpuSlabSize % 512);
       LOG(INFO) << "gpuSlabSize is " << (float)gpuSlabSize / (1024 * 1024) << "M";
-      bufferMgrs_[2].push_back(new GpuCudaBufferMgr(
-          gpuNum, gpuMaxMemSize, cudaMgr_.get(), gpuSlabSize, 512, bufferMgrs_[1][0]));
+      bufferMgrs_[2].push_back(new GpuCudaBufferMgr(gpuNum,
+                                                    gpuMaxMemSize,
+                                                    cudaMgr_.get(),
+                                                    gpuSlabSize,
+                                                    512,
+                                                    bufferMgrs_[1][0],
+                                                    gpuEvictionPolicy));
     }
     levelSizes_.push_back(numGpus);
   } else {
-    bufferMgrs_[1].push_back(new CpuBufferMgr(
-        0, cpuBufferSize, cudaMgr_.get(), cpuSlabSize, 512, bufferMgrs_[0][0]));
+    bufferMgrs_[1].push_back(new CpuBufferMgr(0,
+                                              cpuBufferSize,
+                                              cudaMgr_.get(),
+                                              cpuSlabSize,
+                                              512,
+                                              bufferMgrs_[0][0],
+                                              cpuEvictionPolicy));
     levelSizes_.push_back(1);
   }
 }
@@ -185,6 +205,8 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
     mi.maxNumPages = cpuBuffer->getMaxSize() / mi.pageSize;
     mi.isAllocationCapped = cpuBuffer->isAllocationCapped();
     mi.numPageAllocated = cpuBuffer->getAllocated() / mi.pageSize;
+    mi.evictionPolicy = cpuBuffer->getEvictionPolicy();
+    mi.tableStats = cpuBuffer->getTableBufferStats();
 
     const std::vector<BufferList> slab_segments = cpuBuffer->getSlabSegments();
     size_t numSlabs = slab_segments.size();
@@ -214,6 +236,8 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
       mi.maxNumPages = gpuBuffer->getMaxSize() / mi.pageSize;
       mi.isAllocationCapped = gpuBuffer->isAllocationCapped();
       mi.numPageAllocated = gpuBuffer->getAllocated() / mi.pageSize;
+      mi.evictionPolicy = gpuBuffer->getEvictionPolicy();
+      mi.tableStats = gpuBuffer->getTableBufferStats();
       const std::vector<BufferList> slab_segments = gpuBuffer->getSlabSegments();
       size_t numSlabs = slab_segments.size();
 
@@ -351,6 +375,27 @@ AbstractBuffer* DataMgr::getChunkBuffer(const ChunkKey& key,
   return bufferMgrs_[level][deviceId]->getBuffer(key, numBytes);
 }
 
+void DataMgr::readaheadChunks(const std::vector<ChunkKey>& keyPrefixes) {
+  auto gfm = dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0]);
+  CHECK(gfm);
+  auto cpuBufferMgr =
+      dynamic_cast<CpuBufferMgr*>(bufferMgrs_[MemoryLevel::CPU_LEVEL][0]);
+  CHECK(cpuBufferMgr);
+  for (const auto& keyPrefix : keyPrefixes) {
+    CHECK_GE(keyPrefix.size(), size_t(2));
+    if (cpuBufferMgr->isBufferWithPrefixOnDevice(keyPrefix)) {
+      continue;
+    }
+    gfm->readaheadBuffersWithPrefix(keyPrefix);
+  }
+}
+
+size_t DataMgr::getBufferPoolMaxSize(const MemoryLevel memLevel, const int deviceId) {
+  CHECK_NE(memLevel, MemoryLevel::DISK_LEVEL);
+  CHECK_LT(static_cast<size_t>(deviceId), bufferMgrs_[memLevel].size());
+  return bufferMgrs_[memLevel][deviceId]->getMaxSize();
+}
+
 void DataMgr::deleteChunksWithPrefix(const ChunkKey& keyPrefix) {
   int numLevels = bufferMgrs_.size();
   for (int level = numLevels - 1; level >= 0; --level) {
@@ -430,6 +475,20 @@ void DataMgr::setTableEpoch(const int db_id, const int tb_id, const int start_ep
       ->setTableEpoch(db_id, tb_id, start_epoch);
 }
 
+void DataMgr::setTableCompression(const int db_id,
+                                  const int tb_id,
+                                  const std::string& compressor_name) {
+  int compression_code = -1;
+  if (!compressor_name.empty()) {
+    compression_code = BloscCompressor::getCompressorCode(compressor_name);
+    if (compression_code < 0) {
+      throw std::runtime_error("Compressor " + compressor_name + " is not supported.");
+    }
+  }
+  dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])
+      ->setTableCompression(db_id, tb_id, compression_code);
+}
+
 size_t DataMgr::getTableEpoch(const int db_id, const int tb_id) {
   return dynamic_cast<GlobalFileMgr*>(bufferMgrs_[0][0])->getTableEpoch(db_id, tb_id);
 }
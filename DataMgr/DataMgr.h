@@ -60,6 +60,8 @@ struct MemoryInfo {
   size_t numPageAllocated;
   bool isAllocationCapped;
   std::vector<MemoryData> nodeMemoryData;
+  Buffer_Namespace::EvictionPolicy evictionPolicy;
+  std::vector<Buffer_Namespace::TableBufferStats> tableStats;
 };
 
 class DataMgr {
@@ -84,6 +86,9 @@ class DataMgr {
                                  const int deviceId = 0,
                                  const size_t numBytes = 0);
   void deleteChunksWithPrefix(const ChunkKey& keyPrefix);
+  // Starts reading the chunks with the given key prefixes from disk into the page
+  // cache, skipping the chunks already in the CPU buffer pool. Doesn't wait.
+  void readaheadChunks(const std::vector<ChunkKey>& keyPrefixes);
   void deleteChunksWithPrefix(const ChunkKey& keyPrefix, const MemoryLevel memLevel);
   AbstractBuffer* alloc(const MemoryLevel memoryLevel,
                         const int deviceId,
@@ -96,6 +101,7 @@ class DataMgr {
                         const MemoryLevel memLevel,
                         const int deviceId);
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
+  size_t getBufferPoolMaxSize(const MemoryLevel memLevel, const int deviceId = 0);
   std::string dumpLevel(const MemoryLevel memLevel);
   void clearMemory(const MemoryLevel memLevel);
 
@@ -112,6 +118,11 @@ class DataMgr {
   void removeTableRelatedDS(const int db_id, const int tb_id);
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  // Compresses the pages of the chunks of the table written from now on with the given
+  // blosc compressor, they aren't compressed if empty.
+  void setTableCompression(const int db_id,
+                           const int tb_id,
+                           const std::string& compressor_name);
 
   CudaMgr_Namespace::CudaMgr* getCudaMgr() const { return cudaMgr_.get(); }
 
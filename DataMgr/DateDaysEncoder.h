@@ -41,6 +41,7 @@ class DateDaysEncoder : public Encoder {
     CHECK(ti.is_date_in_days());
     T* unencodedData = reinterpret_cast<T*>(srcData);
     auto encodedData = std::make_unique<V[]>(numAppendElems);
+    auto sketch = getSketchForAppend();
     for (size_t i = 0; i < numAppendElems; ++i) {
       size_t ri = replicating ? 0 : i;
       if (unencodedData[ri] == std::numeric_limits<V>::min()) {
@@ -53,6 +54,9 @@ class DateDaysEncoder : public Encoder {
         const T data = DateConverters::get_epoch_seconds_from_days(encodedData.get()[i]);
         dataMax = std::max(dataMax, data);
         dataMin = std::min(dataMin, data);
+        if (sketch) {
+          sketch->add(static_cast<int64_t>(data));
+        }
       }
     }
     num_elems_ += numAppendElems;
@@ -115,6 +119,7 @@ class DateDaysEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    copySketch(copyFromEncoder);
   }
 
   void writeMetadata(FILE* f) override {
@@ -21,8 +21,11 @@
 #include "FixedLengthArrayNoneEncoder.h"
 #include "FixedLengthEncoder.h"
 #include "NoneEncoder.h"
+#include "PackedIntEncoder.h"
 #include "StringNoneEncoder.h"
 
+bool g_enable_chunk_sketches{false};
+
 Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
                          const SQLTypeInfo sqlType) {
   switch (sqlType.get_compression()) {
@@ -168,6 +171,28 @@ Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
       }  // switch (sqlType)
       break;
     }  // Case: kENCODING_FIXED
+    case kENCODING_RL:
+    case kENCODING_DIFF:
+    case kENCODING_BITPACK: {
+      switch (sqlType.get_type()) {
+        case kTINYINT:
+          return new PackedIntEncoder<int8_t>(buffer);
+        case kSMALLINT:
+          return new PackedIntEncoder<int16_t>(buffer);
+        case kINT:
+          return new PackedIntEncoder<int32_t>(buffer);
+        case kBIGINT:
+        case kNUMERIC:
+        case kDECIMAL:
+        case kTIME:
+        case kTIMESTAMP:
+        case kDATE:
+          return new PackedIntEncoder<int64_t>(buffer);
+        default:
+          return 0;
+      }
+      break;
+    }
     case kENCODING_DICT: {
       if (sqlType.get_type() == kARRAY) {
         CHECK(IS_STRING(sqlType.get_subtype()));
@@ -221,4 +246,19 @@ void Encoder::getMetadata(ChunkMetadata& chunkMetadata) {
   chunkMetadata.sqlType = buffer_->sqlType;
   chunkMetadata.numBytes = buffer_->size();
   chunkMetadata.numElements = num_elems_;
+  chunkMetadata.sketch = sketch_;
+}
+
+ChunkSketch* Encoder::getSketchForAppend() {
+  if (!sketch_) {
+    // A sketch which misses values of its chunk would rule them out.
+    if (num_elems_ || !g_enable_chunk_sketches || !buffer_ ||
+        !ChunkSketch::isSupportedType(buffer_->sqlType)) {
+      return nullptr;
+    }
+    sketch_ = std::make_shared<ChunkSketch>();
+  } else if (sketch_.use_count() > 1) {
+    sketch_ = std::make_shared<ChunkSketch>(*sketch_);
+  }
+  return sketch_.get();
 }
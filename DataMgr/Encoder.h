@@ -21,10 +21,12 @@
 #include "../Shared/sqltypes.h"
 #include "../Shared/types.h"
 #include "ChunkMetadata.h"
+#include "ChunkSketch.h"
 
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 #include <vector>
 
@@ -172,7 +174,19 @@ class Encoder {
   size_t getNumElems() const { return num_elems_; }
   void setNumElems(const size_t num_elems) { num_elems_ = num_elems; }
 
+  std::shared_ptr<const ChunkSketch> getSketch() const { return sketch_; }
+  void setSketch(std::shared_ptr<ChunkSketch> sketch) { sketch_ = sketch; }
+  // Called when values of the chunk are overwritten, the sketch no longer covers them.
+  void dropSketch() { sketch_.reset(); }
+
  protected:
+  /**
+   * @brief: Returns the sketch to add the values being appended to, null if the chunk
+   * has none. Chunks get one on their first append, when chunk sketches are enabled.
+   */
+  ChunkSketch* getSketchForAppend();
+  void copySketch(const Encoder* copyFromEncoder) { sketch_ = copyFromEncoder->sketch_; }
+
   size_t num_elems_;
 
   Data_Namespace::AbstractBuffer* buffer_;
@@ -180,6 +194,10 @@ class Encoder {
 
   DecimalOverflowValidator decimal_overflow_validator_;
   DateDaysOverflowValidator date_days_overflow_validator_;
+
+ private:
+  // Shared with the chunk metadata handed out, copied on write.
+  std::shared_ptr<ChunkSketch> sketch_;
 };
 
 #endif  // Encoder_h
@@ -0,0 +1,337 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AsyncFileReader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <glog/logging.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef HAVE_IO_URING
+#include <liburing.h>
+#endif
+
+namespace File_Namespace {
+
+namespace {
+
+// Readahead hints beyond this many queued ones are dropped, they are only hints.
+constexpr size_t max_queued_readaheads_per_slot{4};
+
+}  // namespace
+
+AsyncFileReader::AsyncFileReader(const size_t numThreads,
+                                 const size_t queueDepth,
+                                 const bool tryIoUring)
+    : queueDepth_(std::max(queueDepth, size_t(1))), useIoUring_(false), shutdown_(false) {
+#ifdef HAVE_IO_URING
+  ringInFlight_ = 0;
+  if (tryIoUring) {
+    ring_.reset(new io_uring());
+    // Twice the queue depth, the completion thread resubmits short reads past the limit.
+    const int ret = io_uring_queue_init(2 * queueDepth_, ring_.get(), 0);
+    if (ret == 0) {
+      if (ringSupportsOps()) {
+        useIoUring_ = true;
+        completionThread_ = std::thread([this] { completionLoop(); });
+        LOG(INFO) << "FileMgr reads use io_uring with a queue depth of " << queueDepth_;
+        return;
+      }
+      io_uring_queue_exit(ring_.get());
+      LOG(INFO) << "io_uring doesn't support reads and fadvise on this kernel, FileMgr "
+                   "reads use a pool of "
+                << numThreads << " I/O threads";
+    } else {
+      LOG(INFO) << "io_uring not available (" << std::strerror(-ret)
+                << "), FileMgr reads use a pool of " << numThreads << " I/O threads";
+    }
+    ring_.reset();
+  }
+#endif
+  for (size_t i = 0; i < std::max(numThreads, size_t(1)); ++i) {
+    workers_.emplace_back([this] { workerLoop(); });
+  }
+}
+
+AsyncFileReader::~AsyncFileReader() {
+#ifdef HAVE_IO_URING
+  if (useIoUring_) {
+    {
+      std::lock_guard<std::mutex> lock(ringMutex_);
+      shutdown_ = true;
+      // Wakes up the completion thread, it exits once all the operations are reaped.
+      auto sqe = io_uring_get_sqe(ring_.get());
+      CHECK(sqe);
+      io_uring_prep_nop(sqe);
+      io_uring_sqe_set_data(sqe, nullptr);
+      ++ringInFlight_;
+      io_uring_submit(ring_.get());
+    }
+    completionThread_.join();
+    io_uring_queue_exit(ring_.get());
+    return;
+  }
+#endif
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    shutdown_ = true;
+  }
+  workAvailable_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void AsyncFileReader::read(const std::vector<FileReadRequest>& requests) {
+  if (requests.empty()) {
+    return;
+  }
+  if (requests.size() == 1) {
+    // Not worth a round trip to the I/O threads or the ring.
+    const int error = readSync(requests.front(), 0);
+    CHECK_EQ(error, 0) << "Error trying to read from file: " << std::strerror(error);
+    return;
+  }
+  Batch batch;
+  batch.pending = requests.size();
+  batch.error = 0;
+  std::vector<Op> ops(requests.size());
+  std::vector<Op*> opPtrs;
+  opPtrs.reserve(ops.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    ops[i] = Op{requests[i], 0, &batch};
+    opPtrs.push_back(&ops[i]);
+  }
+#ifdef HAVE_IO_URING
+  if (useIoUring_) {
+    submitRing(opPtrs, true);
+  } else
+#endif
+  {
+    {
+      std::lock_guard<std::mutex> lock(queueMutex_);
+      readQueue_.insert(readQueue_.end(), opPtrs.begin(), opPtrs.end());
+    }
+    workAvailable_.notify_all();
+  }
+  std::unique_lock<std::mutex> lock(batch.mutex);
+  batch.done.wait(lock, [&batch] { return batch.pending == 0; });
+  CHECK_EQ(batch.error, 0) << "Error trying to read from file: "
+                           << std::strerror(batch.error);
+}
+
+void AsyncFileReader::readahead(const std::vector<FileReadRequest>& requests) {
+  if (requests.empty()) {
+    return;
+  }
+#ifdef HAVE_IO_URING
+  if (useIoUring_) {
+    std::vector<Op*> ops;
+    for (const auto& request : requests) {
+      ops.push_back(new Op{request, 0, nullptr});  // deleted once completed
+      ops.back()->request.buf = nullptr;
+    }
+    const auto numQueued = submitRing(ops, false);
+    // Ring full, the remaining hints are dropped rather than waited for.
+    for (size_t i = numQueued; i < ops.size(); ++i) {
+      delete ops[i];
+    }
+    return;
+  }
+#endif
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    for (const auto& request : requests) {
+      if (readaheadQueue_.size() >= max_queued_readaheads_per_slot * queueDepth_) {
+        break;
+      }
+      readaheadQueue_.push_back(request);
+    }
+  }
+  workAvailable_.notify_all();
+}
+
+void AsyncFileReader::completeOp(Op* op, const int error) {
+  if (!op->batch) {
+    delete op;
+    return;
+  }
+  auto batch = op->batch;
+  std::lock_guard<std::mutex> lock(batch->mutex);
+  if (error && !batch->error) {
+    batch->error = error;
+  }
+  CHECK_GT(batch->pending, size_t(0));
+  if (--batch->pending == 0) {
+    batch->done.notify_one();
+  }
+}
+
+int AsyncFileReader::readSync(const FileReadRequest& request, size_t bytesDone) {
+  while (bytesDone < request.size) {
+    const auto bytesRead = pread(request.fd,
+                                 request.buf + bytesDone,
+                                 request.size - bytesDone,
+                                 request.offset + bytesDone);
+    if (bytesRead < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno;
+    }
+    if (bytesRead == 0) {
+      return EIO;  // the page should have been there
+    }
+    bytesDone += bytesRead;
+  }
+  return 0;
+}
+
+void AsyncFileReader::readaheadSync(const FileReadRequest& request) {
+#ifndef __APPLE__
+  posix_fadvise(request.fd, request.offset, request.size, POSIX_FADV_WILLNEED);
+#endif
+}
+
+void AsyncFileReader::workerLoop() {
+  while (true) {
+    Op* op{nullptr};
+    FileReadRequest readaheadRequest;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex_);
+      workAvailable_.wait(lock, [this] {
+        return shutdown_ || !readQueue_.empty() || !readaheadQueue_.empty();
+      });
+      // Reads first, someone is waiting for them.
+      if (!readQueue_.empty()) {
+        op = readQueue_.front();
+        readQueue_.pop_front();
+      } else if (!readaheadQueue_.empty()) {
+        readaheadRequest = readaheadQueue_.front();
+        readaheadQueue_.pop_front();
+      } else {
+        CHECK(shutdown_);
+        return;
+      }
+    }
+    if (op) {
+      completeOp(op, readSync(op->request, 0));
+    } else {
+      readaheadSync(readaheadRequest);
+    }
+  }
+}
+
+#ifdef HAVE_IO_URING
+
+bool AsyncFileReader::ringSupportsOps() {
+  // IORING_OP_READ and IORING_OP_FADVISE only exist from Linux 5.6 on, older kernels
+  // fail every such request with -EINVAL. Probing itself needs 5.6 as well.
+  auto probe = io_uring_get_probe_ring(ring_.get());
+  if (!probe) {
+    return false;
+  }
+  const bool supported = io_uring_opcode_supported(probe, IORING_OP_READ) &&
+                         io_uring_opcode_supported(probe, IORING_OP_FADVISE);
+  io_uring_free_probe(probe);
+  return supported;
+}
+
+size_t AsyncFileReader::submitRing(const std::vector<Op*>& ops, const bool blocking) {
+  size_t opIdx = 0;
+  while (opIdx < ops.size()) {
+    std::unique_lock<std::mutex> lock(ringMutex_);
+    const bool isCompletionThread =
+        std::this_thread::get_id() == completionThread_.get_id();
+    if (!isCompletionThread) {
+      if (!blocking && ringInFlight_ >= queueDepth_) {
+        break;
+      }
+      ringSpaceAvailable_.wait(lock, [this] { return ringInFlight_ < queueDepth_; });
+    }
+    size_t numQueued = 0;
+    while (opIdx < ops.size() && (isCompletionThread || ringInFlight_ < queueDepth_)) {
+      auto sqe = io_uring_get_sqe(ring_.get());
+      CHECK(sqe);
+      auto op = ops[opIdx++];
+      const auto& request = op->request;
+      if (request.buf) {
+        io_uring_prep_read(sqe,
+                           request.fd,
+                           request.buf + op->bytesDone,
+                           request.size - op->bytesDone,
+                           request.offset + op->bytesDone);
+      } else {
+        io_uring_prep_fadvise(
+            sqe, request.fd, request.offset, request.size, POSIX_FADV_WILLNEED);
+      }
+      io_uring_sqe_set_data(sqe, op);
+      ++ringInFlight_;
+      ++numQueued;
+    }
+    if (numQueued) {
+      const int ret = io_uring_submit(ring_.get());
+      CHECK_GE(ret, 0) << "io_uring_submit failed: " << std::strerror(-ret);
+    }
+  }
+  return opIdx;
+}
+
+void AsyncFileReader::completionLoop() {
+  while (true) {
+    io_uring_cqe* cqe{nullptr};
+    const int ret = io_uring_wait_cqe(ring_.get(), &cqe);
+    if (ret == -EINTR) {
+      continue;
+    }
+    CHECK_EQ(ret, 0) << "io_uring_wait_cqe failed: " << std::strerror(-ret);
+    auto op = static_cast<Op*>(io_uring_cqe_get_data(cqe));
+    const int res = cqe->res;
+    io_uring_cqe_seen(ring_.get(), cqe);
+    {
+      std::lock_guard<std::mutex> lock(ringMutex_);
+      --ringInFlight_;
+    }
+    ringSpaceAvailable_.notify_one();
+    if (op) {
+      if (!op->request.buf) {
+        completeOp(op, 0);  // a failed hint is no error
+      } else if (res == -EAGAIN || res == -EINTR) {
+        submitRing({op}, true);
+      } else if (res < 0) {
+        completeOp(op, -res);
+      } else if (res == 0) {
+        completeOp(op, EIO);
+      } else if (op->bytesDone + res < op->request.size) {
+        op->bytesDone += res;
+        submitRing({op}, true);
+      } else {
+        completeOp(op, 0);
+      }
+    }
+    std::lock_guard<std::mutex> lock(ringMutex_);
+    if (shutdown_ && ringInFlight_ == 0) {
+      return;
+    }
+  }
+}
+
+#endif  // HAVE_IO_URING
+
+}  // namespace File_Namespace
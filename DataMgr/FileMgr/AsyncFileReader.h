@@ -0,0 +1,113 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file        AsyncFileReader.h
+ * @brief       Keeps many page reads of the FileMgr in flight at a time.
+ *
+ * Reads are submitted through io_uring when the server is built with liburing and the
+ * kernel supports it, otherwise they are spread over a dedicated pool of I/O threads
+ * doing blocking preads. Besides the reads a caller waits for, readahead hints can be
+ * queued to bring the pages of chunks which are about to be scanned into the page cache.
+ */
+
+#ifndef ASYNCFILEREADER_H
+#define ASYNCFILEREADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_IO_URING
+struct io_uring;
+#endif
+
+namespace File_Namespace {
+
+struct FileReadRequest {
+  int fd;
+  size_t offset;
+  size_t size;
+  int8_t* buf;  /// destination, unused for readahead requests
+};
+
+class AsyncFileReader {
+ public:
+  /// Falls back to the I/O threads when tryIoUring is false or io_uring is unavailable.
+  AsyncFileReader(const size_t numThreads,
+                  const size_t queueDepth,
+                  const bool tryIoUring = true);
+  ~AsyncFileReader();
+
+  /// Reads all the requests and returns once they have completed.
+  void read(const std::vector<FileReadRequest>& requests);
+
+  /// Queues readahead hints for the requests and returns immediately.
+  void readahead(const std::vector<FileReadRequest>& requests);
+
+  bool usesIoUring() const { return useIoUring_; }
+
+ private:
+  struct Batch {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t pending;
+    int error;
+  };
+
+  struct Op {
+    FileReadRequest request;
+    size_t bytesDone;
+    Batch* batch;  /// nullptr for readahead requests
+  };
+
+  static void completeOp(Op* op, const int error);
+  static int readSync(const FileReadRequest& request, size_t bytesDone);
+  static void readaheadSync(const FileReadRequest& request);
+
+  void workerLoop();
+
+  const size_t queueDepth_;
+  bool useIoUring_;
+
+  // I/O thread pool, used when io_uring isn't available
+  std::mutex queueMutex_;
+  std::condition_variable workAvailable_;
+  std::deque<Op*> readQueue_;
+  std::deque<FileReadRequest> readaheadQueue_;
+  std::vector<std::thread> workers_;
+  bool shutdown_;
+
+#ifdef HAVE_IO_URING
+  bool ringSupportsOps();
+  /// Returns the number of ops submitted, all of them unless not blocking on a full ring.
+  size_t submitRing(const std::vector<Op*>& ops, const bool blocking);
+  void completionLoop();
+
+  std::unique_ptr<io_uring> ring_;
+  std::mutex ringMutex_;
+  std::condition_variable ringSpaceAvailable_;
+  size_t ringInFlight_;
+  std::thread completionThread_;
+#endif
+};
+
+}  // namespace File_Namespace
+
+#endif  // ASYNCFILEREADER_H
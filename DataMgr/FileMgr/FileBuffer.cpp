@@ -22,10 +22,12 @@
 
 #include "FileBuffer.h"
 #include <glog/logging.h>
-#include <future>
+#include <cstring>
 #include <map>
-#include <thread>
+#include "../../Shared/Compressor.h"
 #include "../../Shared/File.h"
+#include "../../Shared/TaskPool.h"
+#include "../../Shared/measure.h"
 #include "FileMgr.h"
 
 #define METADATA_PAGE_SIZE 4096
@@ -33,17 +35,30 @@
 using namespace std;
 
 namespace File_Namespace {
+
+namespace {
+
+// Bytes of data per compressed frame. Small enough for the frames of a chunk to be
+// decompressed in parallel, and for an append to recompress only the tail of the chunk.
+constexpr size_t compressed_frame_bytes{1 << 20};
+
+}  // namespace
+
 size_t FileBuffer::headerBufferOffset_ = 32;
 
 FileBuffer::FileBuffer(FileMgr* fm,
                        const size_t pageSize,
                        const ChunkKey& chunkKey,
-                       const size_t initialSize)
+                       const size_t initialSize,
+                       const int compressionCode)
     : AbstractBuffer(fm->getDeviceId())
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
     , pageSize_(pageSize)
-    , chunkKey_(chunkKey) {
+    , chunkKey_(chunkKey)
+    , compressionCode_(compressionCode)
+    , compressedSize_(0)
+    , decompressMicros_(0) {
   // Create a new FileBuffer
   CHECK(fm_);
   calcHeaderBuffer();
@@ -72,7 +87,10 @@ FileBuffer::FileBuffer(FileMgr* fm,
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
     , pageSize_(pageSize)
-    , chunkKey_(chunkKey) {
+    , chunkKey_(chunkKey)
+    , compressionCode_(-1)
+    , compressedSize_(0)
+    , decompressMicros_(0) {
   CHECK(fm_);
   calcHeaderBuffer();
   pageDataSize_ = pageSize_ - reservedHeaderSize_;
@@ -86,7 +104,10 @@ FileBuffer::FileBuffer(FileMgr* fm,
     , fm_(fm)
     , metadataPages_(METADATA_PAGE_SIZE)
     , pageSize_(0)
-    , chunkKey_(chunkKey) {
+    , chunkKey_(chunkKey)
+    , compressionCode_(-1)
+    , compressedSize_(0)
+    , decompressMicros_(0) {
   // We are being assigned an existing FileBuffer on disk
 
   CHECK(fm_);
@@ -182,56 +203,38 @@ void FileBuffer::freePages() {
   }
 }
 
-struct readThreadDS {
-  FileMgr* t_fm;       // ptr to FileMgr
-  size_t t_startPage;  // start page for the thread
-  size_t t_endPage;    // last page for the thread
-  int8_t* t_curPtr;    // pointer to the current location of the target for the thread
-  size_t t_bytesLeft;  // number of bytes to be read in the thread
-  size_t t_startPageOffset;  // offset - used for the first page of the buffer
-  bool t_isFirstPage;        // true - for first page of the buffer, false - otherwise
-  std::vector<MultiPage> multiPages;  // MultiPages of the FileBuffer passed to the thread
-};
-
-static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS) {
-  size_t startPage = threadDS.t_startPage;  // start reading at startPage, including it
-  size_t endPage = threadDS.t_endPage;      // stop reading at endPage, not including it
-  int8_t* curPtr = threadDS.t_curPtr;
-  size_t bytesLeft = threadDS.t_bytesLeft;
-  size_t totalBytesRead = 0;
-  bool isFirstPage = threadDS.t_isFirstPage;
-
-  // Traverse the logical pages
-  for (size_t pageNum = startPage; pageNum < endPage; ++pageNum) {
-    CHECK(threadDS.multiPages[pageNum].pageSize == fileBuffer->pageSize());
-    Page page = threadDS.multiPages[pageNum].current();
-
-    FileInfo* fileInfo = threadDS.t_fm->getFileInfoForFileId(page.fileId);
-    CHECK(fileInfo);
+std::vector<FileReadRequest> FileBuffer::getReadRequests(int8_t* const dst,
+                                                         const size_t numBytes,
+                                                         const size_t offset) {
+  size_t startPage = offset / pageDataSize_;
+  size_t startPageOffset = offset % pageDataSize_;
+  size_t numPagesToRead =
+      (numBytes + startPageOffset + pageDataSize_ - 1) / pageDataSize_;
+  const auto multiPages = getMultiPage();
+  CHECK(startPage + numPagesToRead <= multiPages.size());
 
-    // Read the page into the destination (dst) buffer at its
-    // current (cur) location
-    size_t bytesRead = 0;
-    if (isFirstPage) {
-      bytesRead = fileInfo->read(
-          page.pageNum * fileBuffer->pageSize() + threadDS.t_startPageOffset +
-              fileBuffer->reservedHeaderSize(),
-          min(fileBuffer->pageDataSize() - threadDS.t_startPageOffset, bytesLeft),
-          curPtr);
-      isFirstPage = false;
-    } else {
-      bytesRead = fileInfo->read(
-          page.pageNum * fileBuffer->pageSize() + fileBuffer->reservedHeaderSize(),
-          min(fileBuffer->pageDataSize(), bytesLeft),
-          curPtr);
+  std::vector<FileReadRequest> requests;
+  int8_t* curPtr = dst;
+  size_t bytesLeft = numBytes;
+  for (size_t pageNum = startPage; pageNum < startPage + numPagesToRead; ++pageNum) {
+    CHECK(multiPages[pageNum].pageSize == pageSize_);
+    Page page = multiPages[pageNum].current();
+    FileInfo* fileInfo = fm_->getFileInfoForFileId(page.fileId);
+    CHECK(fileInfo);
+    // Only the first page starts at an offset into its data
+    const size_t pageOffset = pageNum == startPage ? startPageOffset : 0;
+    const size_t bytesToRead = min(pageDataSize_ - pageOffset, bytesLeft);
+    requests.push_back({fileInfo->getReadFd(),
+                        page.pageNum * pageSize_ + pageOffset + reservedHeaderSize_,
+                        bytesToRead,
+                        curPtr});
+    if (curPtr) {
+      curPtr += bytesToRead;
     }
-    curPtr += bytesRead;
-    bytesLeft -= bytesRead;
-    totalBytesRead += bytesRead;
+    bytesLeft -= bytesToRead;
   }
   CHECK(bytesLeft == 0);
-
-  return (totalBytesRead);
+  return requests;
 }
 
 void FileBuffer::read(int8_t* const dst,
@@ -242,99 +245,220 @@ void FileBuffer::read(int8_t* const dst,
   if (dstBufferType != CPU_LEVEL) {
     LOG(FATAL) << "Unsupported Buffer type";
   }
+  if (numBytes == 0) {
+    return;
+  }
+  if (isCompressed()) {
+    readCompressed(dst, numBytes, offset);
+    return;
+  }
+  // All the pages are read at once, the reader keeps as many of them in flight as
+  // its queue depth allows.
+  fm_->getAsyncReader()->read(getReadRequests(dst, numBytes, offset));
+}
 
-  // variable declarations
-  size_t startPage = offset / pageDataSize_;
-  size_t startPageOffset = offset % pageDataSize_;
-  size_t numPagesToRead =
-      (numBytes + startPageOffset + pageDataSize_ - 1) / pageDataSize_;
-  /*
-  if (startPage + numPagesToRead > multiPages_.size()) {
-      cout << "Start page: " << startPage << endl;
-      cout << "Num pages to read: " << numPagesToRead << endl;
-      cout << "Num multipages: " << multiPages_.size() << endl;
-      cout << "Offset: " << offset << endl;
-      cout << "Num bytes: " << numBytes << endl;
+void FileBuffer::readahead() {
+  const size_t streamSize = isCompressed() ? compressedSize_ : size_;
+  if (streamSize == 0) {
+    return;
   }
-  */
+  fm_->getAsyncReader()->readahead(getReadRequests(nullptr, streamSize, 0));
+}
 
-  CHECK(startPage + numPagesToRead <= multiPages_.size());
-
-  size_t numPagesPerThread = 0;
-  size_t numBytesCurrent = numBytes;  // total number of bytes still to be read
-  size_t bytesRead = 0;               // total number of bytes already being read
-  size_t bytesLeftForThread = 0;      // number of bytes to be read in the thread
-  size_t numExtraPages = 0;  // extra pages to be assigned one per thread as needed
-  size_t numThreads = fm_->getNumReaderThreads();
-  std::vector<readThreadDS>
-      threadDSArr;  // array of threadDS, needed to avoid racing conditions
-
-  if (numPagesToRead > numThreads) {
-    numPagesPerThread = numPagesToRead / numThreads;
-    numExtraPages = numPagesToRead - (numThreads * numPagesPerThread);
-  } else {
-    numThreads = numPagesToRead;
-    numPagesPerThread = 1;
-  }
-
-  /* set threadDS for the first thread */
-  readThreadDS threadDS;
-  threadDS.t_fm = fm_;
-  threadDS.t_startPage = offset / pageDataSize_;
-  if (numExtraPages > 0) {
-    threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread + 1;
-    numExtraPages--;
-  } else {
-    threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread;
-  }
-  threadDS.t_curPtr = dst;
-  threadDS.t_startPageOffset = offset % pageDataSize_;
-  threadDS.t_isFirstPage = true;
-
-  bytesLeftForThread = min(((threadDS.t_endPage - threadDS.t_startPage) * pageDataSize_ -
-                            threadDS.t_startPageOffset),
-                           numBytesCurrent);
-  threadDS.t_bytesLeft = bytesLeftForThread;
-  threadDS.multiPages = getMultiPage();
-
-  if (numThreads == 1) {
-    bytesRead += readForThread(this, threadDS);
-  } else {
-    std::vector<std::future<size_t>> threads;
-
-    for (size_t i = 0; i < numThreads; i++) {
-      threadDSArr.push_back(threadDS);
-      threads.push_back(
-          std::async(std::launch::async, readForThread, this, threadDSArr[i]));
-
-      // calculate elements of threadDS
-      threadDS.t_fm = fm_;
-      threadDS.t_isFirstPage = false;
-      threadDS.t_curPtr += bytesLeftForThread;
-      threadDS.t_startPage +=
-          threadDS.t_endPage -
-          threadDS.t_startPage;  // based on # of pages read on previous iteration
-      if (numExtraPages > 0) {
-        threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread + 1;
-        numExtraPages--;
-      } else {
-        threadDS.t_endPage = threadDS.t_startPage + numPagesPerThread;
-      }
-      numBytesCurrent -= bytesLeftForThread;
-      bytesLeftForThread = min(
-          ((threadDS.t_endPage - threadDS.t_startPage) * pageDataSize_), numBytesCurrent);
-      threadDS.t_bytesLeft = bytesLeftForThread;
-      threadDS.multiPages = getMultiPage();
-    }
+std::vector<uint64_t> FileBuffer::getFrameEnds() {
+  std::lock_guard<std::mutex> frameEndsLock(frameEndsMutex_);
+  if (frameEnds_.empty() && compressedSize_ > 0) {
+    uint64_t frameCount{0};
+    CHECK_GE(compressedSize_, sizeof(frameCount));
+    fm_->getAsyncReader()->read(getReadRequests(reinterpret_cast<int8_t*>(&frameCount),
+                                                sizeof(frameCount),
+                                                compressedSize_ - sizeof(frameCount)));
+    const size_t indexSize = frameCount * sizeof(uint64_t);
+    CHECK_GE(compressedSize_, indexSize + sizeof(frameCount));
+    frameEnds_.resize(frameCount);
+    fm_->getAsyncReader()->read(
+        getReadRequests(reinterpret_cast<int8_t*>(frameEnds_.data()),
+                        indexSize,
+                        compressedSize_ - sizeof(frameCount) - indexSize));
+  }
+  return frameEnds_;
+}
 
-    for (auto& p : threads) {
-      p.wait();
+void FileBuffer::readCompressed(int8_t* const dst,
+                                const size_t numBytes,
+                                const size_t offset) {
+  CHECK_LE(offset + numBytes, size_);
+  // The appended bytes which aren't compressed yet are copied from memory.
+  const size_t pendingBegin = size_ - pendingTail_.size();
+  size_t framedBytes = numBytes;
+  if (offset + numBytes > pendingBegin) {
+    const size_t copyBegin = std::max(offset, pendingBegin);
+    memcpy(dst + copyBegin - offset,
+           pendingTail_.data() + copyBegin - pendingBegin,
+           offset + numBytes - copyBegin);
+    if (offset >= pendingBegin) {
+      return;
     }
-    for (auto& p : threads) {
-      bytesRead += p.get();
+    framedBytes = pendingBegin - offset;
+  }
+  const auto frameEnds = getFrameEnds();
+  const size_t firstFrame = offset / compressed_frame_bytes;
+  const size_t lastFrame = (offset + framedBytes - 1) / compressed_frame_bytes;
+  CHECK_LT(lastFrame, frameEnds.size());
+  const size_t streamBegin = firstFrame ? frameEnds[firstFrame - 1] : 0;
+  std::vector<int8_t> stream(frameEnds[lastFrame] - streamBegin);
+  fm_->getAsyncReader()->read(getReadRequests(stream.data(), stream.size(), streamBegin));
+
+  auto compressor = BloscCompressor::getCompressor();
+  const auto decompressMicros = measure<std::chrono::microseconds>::execution([&]() {
+    std::vector<TaskPool_NS::TaskFuture<void>> frameDecoders;
+    for (size_t frame = firstFrame; frame <= lastFrame; ++frame) {
+      frameDecoders.push_back(TaskPool_NS::async([&, frame] {
+        const size_t frameBegin = frame * compressed_frame_bytes;
+        const size_t frameSize = std::min(compressed_frame_bytes, size_ - frameBegin);
+        const auto compressedFrame = reinterpret_cast<const uint8_t*>(
+            stream.data() + (frame ? frameEnds[frame - 1] : 0) - streamBegin);
+        const size_t copyBegin = std::max(frameBegin, offset);
+        const size_t copyEnd = std::min(frameBegin + frameSize, offset + framedBytes);
+        if (copyBegin == frameBegin && copyEnd == frameBegin + frameSize) {
+          compressor->decompressWithContext(
+              compressedFrame,
+              reinterpret_cast<uint8_t*>(dst + frameBegin - offset),
+              frameSize);
+          return;
+        }
+        // Only part of the first or the last frame is read.
+        std::vector<uint8_t> frameData(frameSize);
+        compressor->decompressWithContext(compressedFrame, frameData.data(), frameSize);
+        memcpy(dst + copyBegin - offset,
+               frameData.data() + copyBegin - frameBegin,
+               copyEnd - copyBegin);
+      }));
+    }
+    // All the frames must be done before an error is thrown, they write to dst.
+    for (const auto& frameDecoder : frameDecoders) {
+      frameDecoder.wait();
+    }
+    for (auto& frameDecoder : frameDecoders) {
+      frameDecoder.get();
     }
+  });
+  decompressMicros_ += decompressMicros;
+}
+
+void FileBuffer::writeCompressed(const int8_t* src,
+                                 const size_t numBytes,
+                                 const size_t offset) {
+  if (numBytes == 0) {
+    return;
   }
-  CHECK(bytesRead == numBytes);
+  compressPendingTail();
+  const auto frameEnds = getFrameEnds();
+  const size_t newSize = std::max(size_, offset + numBytes);
+  // The frames from the first one the write changes on are compressed again, including
+  // those past the written bytes since their place in the stream moves.
+  const size_t firstFrame = std::min(offset, size_) / compressed_frame_bytes;
+  CHECK_LE(firstFrame, frameEnds.size());
+  const size_t dataBegin = firstFrame * compressed_frame_bytes;
+  std::vector<int8_t> data(newSize - dataBegin, 0);
+  if (std::min(offset, size_) > dataBegin) {
+    readCompressed(data.data(), std::min(offset, size_) - dataBegin, dataBegin);
+  }
+  if (offset + numBytes < size_) {
+    readCompressed(data.data() + offset + numBytes - dataBegin,
+                   size_ - offset - numBytes,
+                   offset + numBytes);
+  }
+  memcpy(data.data() + offset - dataBegin, src, numBytes);
+  compressFrames(data.data(), data.size(), firstFrame);
+  size_ = newSize;
+}
+
+void FileBuffer::appendCompressed(const int8_t* src, const size_t numBytes) {
+  if (pendingTail_.empty()) {
+    // The last frame is read back once, it's compressed again with the appended bytes.
+    const size_t tailBegin = size_ / compressed_frame_bytes * compressed_frame_bytes;
+    std::vector<int8_t> tail(size_ - tailBegin);
+    if (!tail.empty()) {
+      readCompressed(tail.data(), tail.size(), tailBegin);
+    }
+    pendingTail_ = std::move(tail);
+  }
+  const size_t pendingBegin = size_ - pendingTail_.size();
+  pendingTail_.insert(pendingTail_.end(), src, src + numBytes);
+  size_ += numBytes;
+  // Full frames don't change with later appends, they go to the stream right away.
+  const size_t fullFrameBytes =
+      pendingTail_.size() / compressed_frame_bytes * compressed_frame_bytes;
+  if (fullFrameBytes > 0) {
+    compressFrames(
+        pendingTail_.data(), fullFrameBytes, pendingBegin / compressed_frame_bytes);
+    pendingTail_.erase(pendingTail_.begin(), pendingTail_.begin() + fullFrameBytes);
+  }
+}
+
+void FileBuffer::compressPendingTail() {
+  if (pendingTail_.empty()) {
+    return;
+  }
+  const size_t pendingBegin = size_ - pendingTail_.size();
+  compressFrames(
+      pendingTail_.data(), pendingTail_.size(), pendingBegin / compressed_frame_bytes);
+  pendingTail_.clear();
+  pendingTail_.shrink_to_fit();
+}
+
+void FileBuffer::compressFrames(const int8_t* data,
+                                const size_t dataSize,
+                                const size_t firstFrame) {
+  const auto frameEnds = getFrameEnds();
+  CHECK_LE(firstFrame, frameEnds.size());
+  std::vector<std::vector<uint8_t>> frames(
+      (dataSize + compressed_frame_bytes - 1) / compressed_frame_bytes);
+  // Shuffling the bytes of the values helps the compression of fixed width columns.
+  const size_t typeSize = hasEncoder && sqlType.get_size() > 0 ? sqlType.get_size() : 1;
+  auto compressor = BloscCompressor::getCompressor();
+  std::vector<TaskPool_NS::TaskFuture<void>> frameEncoders;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    frameEncoders.push_back(TaskPool_NS::async([&, i] {
+      const size_t frameBegin = i * compressed_frame_bytes;
+      const size_t frameSize = std::min(compressed_frame_bytes, dataSize - frameBegin);
+      auto& frame = frames[i];
+      frame.resize(BloscCompressor::getMaxCompressedSize(frameSize));
+      frame.resize(compressor->compressWithContext(
+          reinterpret_cast<const uint8_t*>(data + frameBegin),
+          frameSize,
+          frame.data(),
+          frame.size(),
+          compressionCode_,
+          typeSize));
+    }));
+  }
+  for (const auto& frameEncoder : frameEncoders) {
+    frameEncoder.wait();
+  }
+  for (auto& frameEncoder : frameEncoders) {
+    frameEncoder.get();
+  }
+
+  const size_t streamBegin = firstFrame ? frameEnds[firstFrame - 1] : 0;
+  std::vector<uint64_t> newFrameEnds(frameEnds.begin(), frameEnds.begin() + firstFrame);
+  std::vector<int8_t> stream;
+  for (const auto& frame : frames) {
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    newFrameEnds.push_back(streamBegin + stream.size());
+  }
+  const uint64_t newFrameCount = newFrameEnds.size();
+  const auto indexBegin = reinterpret_cast<const int8_t*>(newFrameEnds.data());
+  stream.insert(stream.end(), indexBegin, indexBegin + newFrameCount * sizeof(uint64_t));
+  const auto countBegin = reinterpret_cast<const int8_t*>(&newFrameCount);
+  stream.insert(stream.end(), countBegin, countBegin + sizeof(newFrameCount));
+
+  // The stream is rewritten from streamBegin to its end.
+  writePages(stream.data(), stream.size(), streamBegin);
+  compressedSize_ = streamBegin + stream.size();
+  std::lock_guard<std::mutex> frameEndsLock(frameEndsMutex_);
+  frameEnds_ = std::move(newFrameEnds);
 }
 
 void FileBuffer::copyPage(Page& srcPage,
@@ -394,7 +518,11 @@ void FileBuffer::readMetadata(const Page& page) {
                                        // encodingType, encodingBits all as int
   fread((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
   int version = typeData[0];
-  CHECK(version == METADATA_VERSION);  // add backward compatibility code here
+  CHECK_LE(version, METADATA_VERSION);  // add backward compatibility code here
+  if (version >= 1) {
+    fread((int8_t*)&compressionCode_, sizeof(int), 1, f);
+    fread((int8_t*)&compressedSize_, sizeof(size_t), 1, f);
+  }
   hasEncoder = static_cast<bool>(typeData[1]);
   if (hasEncoder) {
     sqlType.set_type(static_cast<SQLTypes>(typeData[2]));
@@ -434,6 +562,8 @@ void FileBuffer::writeMetadata(const int epoch) {
     typeData[9] = sqlType.get_size();
   }
   fwrite((int8_t*)&(typeData[0]), sizeof(int), typeData.size(), f);
+  fwrite((int8_t*)&compressionCode_, sizeof(int), 1, f);
+  fwrite((int8_t*)&compressedSize_, sizeof(size_t), 1, f);
   if (hasEncoder) {  // redundant
     encoder->writeMetadata(f);
   }
@@ -459,6 +589,10 @@ void FileBuffer::append(int8_t* src,
                         const int deviceId) {
   isDirty_ = true;
   isAppended_ = true;
+  if (isCompressed()) {
+    appendCompressed(src, numBytes);
+    return;
+  }
 
   size_t startPage = size_ / pageDataSize_;
   size_t startPageOffset = size_ % pageDataSize_;
@@ -516,9 +650,18 @@ void FileBuffer::write(int8_t* src,
     tempIsAppended = true;  // because isAppended_ could have already been true - to avoid
                             // rewriting header
     isAppended_ = true;
+  }
+  if (isCompressed()) {
+    writeCompressed(src, numBytes, offset);
+    return;
+  }
+  if (tempIsAppended) {
     size_ = offset + numBytes;
   }
+  writePages(src, numBytes, offset);
+}
 
+void FileBuffer::writePages(int8_t* src, const size_t numBytes, const size_t offset) {
   size_t startPage = offset / pageDataSize_;
   size_t startPageOffset = offset % pageDataSize_;
   size_t numPagesToWrite =
@@ -582,11 +725,6 @@ void FileBuffer::write(int8_t* src,
     }
     curPtr += bytesWritten;
     bytesLeft -= bytesWritten;
-    if (tempIsAppended && pageNum == startPage + numPagesToWrite - 1) {  // if last page
-      //@todo below can lead to undefined - we're overwriting num
-      // bytes valid at checkpoint
-      writeHeader(page, 0, multiPages_[0].epochs.back(), true);
-    }
   }
   CHECK(bytesLeft == 0);
 }
@@ -24,15 +24,19 @@
 #define DATAMGR_MEMORY_FILE_FILEBUFFER_H
 
 #include "../AbstractBuffer.h"
+#include "AsyncFileReader.h"
 #include "Page.h"
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 
 using namespace Data_Namespace;
 
 #define NUM_METADATA 10
-#define METADATA_VERSION 0
+// Version 1 adds the compressor and the compressed size of the chunk.
+#define METADATA_VERSION 1
 
 namespace File_Namespace {
 
@@ -49,6 +53,13 @@ class FileMgr;  // forward declaration
  *
  * Note that a "Chunk" is brought into a FileBuffer by the FileMgr.
  *
+ * The pages of a compressed FileBuffer hold a stream of frames instead of the data, each
+ * frame compresses compressed_frame_bytes of the data with blosc. The stream ends with
+ * the end offsets of the frames and their count. Writes recompress the frames from the
+ * first one they change on, reads decompress the frames they overlap in parallel.
+ * Appends are kept uncompressed in memory from the last partial frame on, only the full
+ * frames are compressed right away, the rest on checkpoint.
+ *
  * Note(s): Forbid Copying Idiom 4.1
  */
 class FileBuffer : public AbstractBuffer {
@@ -61,7 +72,8 @@ class FileBuffer : public AbstractBuffer {
   FileBuffer(FileMgr* fm,
              const size_t pageSize,
              const ChunkKey& chunkKey,
-             const size_t initialSize = 0);
+             const size_t initialSize = 0,
+             const int compressionCode = -1);
 
   FileBuffer(FileMgr* fm,
              const size_t pageSize,
@@ -89,6 +101,9 @@ class FileBuffer : public AbstractBuffer {
             const MemoryLevel dstMemoryLevel = CPU_LEVEL,
             const int deviceId = -1) override;
 
+  /// Queues readahead hints for all the pages of the buffer, without waiting.
+  void readahead();
+
   /**
    * @brief Writes the contents of source (src) into new versions of the affected logical
    * pages.
@@ -144,6 +159,18 @@ class FileBuffer : public AbstractBuffer {
   /// flush/checkpoint.
   bool isDirty() const override { return isDirty_; }
 
+  /// Returns whether the pages hold blosc compressed frames of the data.
+  inline bool isCompressed() const { return compressionCode_ >= 0; }
+
+  /// Returns the blosc compressor of the pages, -1 if they aren't compressed.
+  inline int compressionCode() const { return compressionCode_; }
+
+  /// Returns the number of bytes of the compressed stream, 0 if not compressed.
+  inline size_t compressedSize() const { return compressedSize_; }
+
+  /// Returns the total time spent decompressing the FileBuffer, in microseconds.
+  inline int64_t decompressMicros() const { return decompressMicros_; }
+
  private:
   // FileBuffer(const FileBuffer&);      // private copy constructor
   // FileBuffer& operator=(const FileBuffer&); // private overloaded assignment operator
@@ -159,6 +186,22 @@ class FileBuffer : public AbstractBuffer {
   void writeMetadata(const int epoch);
   void readMetadata(const Page& page);
   void calcHeaderBuffer();
+  /// Reads of the pages holding numBytes from offset on, into dst if not null.
+  std::vector<FileReadRequest> getReadRequests(int8_t* const dst,
+                                               const size_t numBytes,
+                                               const size_t offset);
+  void writePages(int8_t* src, const size_t numBytes, const size_t offset);
+  void readCompressed(int8_t* const dst, const size_t numBytes, const size_t offset);
+  void writeCompressed(const int8_t* src, const size_t numBytes, const size_t offset);
+  void appendCompressed(const int8_t* src, const size_t numBytes);
+  /// Compresses the data from firstFrame on into the frames which replace the ones in
+  /// the stream from there on.
+  void compressFrames(const int8_t* data, const size_t dataSize, const size_t firstFrame);
+  /// Compresses the appended bytes not in the stream yet, before a checkpoint.
+  void compressPendingTail();
+  /// Returns the end offsets of the frames in the compressed stream, they're read in the
+  /// first time.
+  std::vector<uint64_t> getFrameEnds();
 
   FileMgr* fm_;  // a reference to FileMgr is needed for writing to new pages in available
                  // files
@@ -169,6 +212,12 @@ class FileBuffer : public AbstractBuffer {
   size_t pageDataSize_;
   size_t reservedHeaderSize_;  // lets make this a constant now for simplicity - 128 bytes
   ChunkKey chunkKey_;
+  int compressionCode_;
+  size_t compressedSize_;
+  std::vector<uint64_t> frameEnds_;  // empty until read in from the compressed stream
+  std::vector<int8_t> pendingTail_;  // the last size of it bytes, not compressed yet
+  std::mutex frameEndsMutex_;
+  std::atomic<int64_t> decompressMicros_;
 };
 
 }  // namespace File_Namespace
@@ -67,6 +67,15 @@ size_t FileInfo::read(const size_t offset, const size_t size, int8_t* buf) {
   return File_Namespace::read(f, offset, size, buf);
 }
 
+int FileInfo::getReadFd() {
+  std::lock_guard<std::mutex> lock(readWriteMutex_);
+  if (fflush(f) != 0) {
+    LOG(FATAL) << "Error trying to flush changes to disk, the error was: "
+               << std::strerror(errno);
+  }
+  return fileno(f);
+}
+
 void FileInfo::openExistingFile(std::vector<HeaderInfo>& headerVec,
                                 const int fileMgrEpoch) {
   // HeaderInfo is defined in Page.h
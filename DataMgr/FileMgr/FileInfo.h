@@ -80,6 +80,9 @@ struct FileInfo {
   int getFreePage();
   size_t write(const size_t offset, const size_t size, int8_t* buf);
   size_t read(const size_t offset, const size_t size, int8_t* buf);
+  /// Flushes the buffered writes to the file and returns its descriptor, for the
+  /// positional reads of the AsyncFileReader which bypass the file stream.
+  int getReadFd();
 
   void openExistingFile(std::vector<HeaderInfo>& headerVec, const int fileMgrEpoch);
   /// Prints a summary of the file to stdout
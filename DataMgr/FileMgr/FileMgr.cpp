@@ -25,6 +25,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/system/error_code.hpp>
 #include <string>
+#include "../ChunkSketch.h"
 #include "GlobalFileMgr.h"
 #include "Shared/File.h"
 #include "Shared/measure.h"
@@ -39,6 +40,10 @@
 
 #define EPOCH_FILENAME "epoch"
 #define DB_META_FILENAME "dbmeta"
+// The sketches are about 130KB, their pages go to the files of the metadata pages.
+#define CHUNK_SKETCH_PAGE_SIZE 4096
+
+extern bool g_enable_chunk_sketches;
 
 using namespace std;
 
@@ -73,7 +78,8 @@ FileMgr::FileMgr(const int deviceId,
     , fileMgrKey_(fileMgrKey)
     , defaultPageSize_(defaultPageSize)
     , nextFileId_(0)
-    , epoch_(epoch) {
+    , epoch_(epoch)
+    , compressionCode_(-1) {
   init(num_reader_threads);
 }
 
@@ -87,7 +93,8 @@ FileMgr::FileMgr(const int deviceId,
     , fileMgrKey_(fileMgrKey)
     , defaultPageSize_(0)
     , nextFileId_(0)
-    , epoch_(0) {
+    , epoch_(0)
+    , compressionCode_(-1) {
   const std::string fileMgrDirPrefix("table");
   const std::string FileMgrDirDelim("_");
   fileMgrBasePath_ = (gfm_->getBasePath() + fileMgrDirPrefix + FileMgrDirDelim +
@@ -104,7 +111,8 @@ FileMgr::FileMgr(GlobalFileMgr* gfm, const size_t defaultPageSize, std::string b
     , fileMgrBasePath_(basePath)
     , defaultPageSize_(defaultPageSize)
     , nextFileId_(0)
-    , epoch_(-1) {
+    , epoch_(-1)
+    , compressionCode_(-1) {
   init(basePath);
 }
 
@@ -255,6 +263,9 @@ void FileMgr::init(const size_t num_reader_threads) {
       //}
     }
     nextFileId_ = maxFileId + 1;
+    if (g_enable_chunk_sketches) {
+      loadChunkSketches();
+    }
     // std::cout << "next file id: " << nextFileId_ << std::endl;
   } else {
     if (!boost::filesystem::create_directory(path)) {
@@ -583,6 +594,9 @@ void FileMgr::checkpoint() {
     cout << "Is dirty: " << chunkIt->second->isDirty_ << endl;
     */
     if (chunkIt->second->isDirty_) {
+      // Adds the sketch buffer of the chunk to the index if needed, it comes next.
+      writeChunkSketch(chunkIt->first, chunkIt->second);
+      chunkIt->second->compressPendingTail();
       chunkIt->second->writeMetadata(epoch_);
       chunkIt->second->clearDirtyBits();
     }
@@ -621,7 +635,8 @@ AbstractBuffer* FileMgr::createBuffer(const ChunkKey& key,
   if (chunkIndex_.find(key) != chunkIndex_.end()) {
     LOG(FATAL) << "Chunk already exists for key: " << showChunk(key);
   }
-  chunkIndex_[key] = new FileBuffer(this, actualPageSize, key, numBytes);
+  chunkIndex_[key] =
+      new FileBuffer(this, actualPageSize, key, numBytes, compressionCode_);
   chunkIndexWriteLock.unlock();
   return (chunkIndex_[key]);
 }
@@ -675,6 +690,65 @@ void FileMgr::deleteBuffersWithPrefix(const ChunkKey& keyPrefix, const bool purg
   }
 }
 
+void FileMgr::readaheadBuffersWithPrefix(const ChunkKey& keyPrefix) {
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
+  for (auto chunkIt = chunkIndex_.lower_bound(keyPrefix);
+       chunkIt != chunkIndex_.end() && chunkIt->first.size() >= keyPrefix.size() &&
+       std::equal(keyPrefix.begin(), keyPrefix.end(), chunkIt->first.begin());
+       ++chunkIt) {
+    if (chunkIt->first.back() == CHUNK_SKETCH_KEY_SUFFIX &&
+        chunkIt->first.size() == keyPrefix.size() + 1) {
+      continue;
+    }
+    chunkIt->second->readahead();
+  }
+}
+
+void FileMgr::writeChunkSketch(const ChunkKey& key, FileBuffer* buffer) {
+  if (!buffer->hasEncoder || key.size() != 4) {
+    return;
+  }
+  auto sketchKey = key;
+  sketchKey.push_back(CHUNK_SKETCH_KEY_SUFFIX);
+  auto sketchIt = chunkIndex_.find(sketchKey);
+  const auto sketch = buffer->encoder->getSketch();
+  if (!sketch && sketchIt == chunkIndex_.end()) {
+    return;
+  }
+  // A chunk without a sketch invalidates the one written for its previous version.
+  auto serialized = sketch ? sketch->serialize(buffer->encoder->getNumElems())
+                           : ChunkSketch::serializeInvalid();
+  if (sketchIt == chunkIndex_.end()) {
+    auto sketchBuffer = new FileBuffer(this, CHUNK_SKETCH_PAGE_SIZE, sketchKey);
+    sketchIt = chunkIndex_.emplace(sketchKey, sketchBuffer).first;
+  }
+  sketchIt->second->write(serialized.data(), serialized.size(), 0);
+}
+
+void FileMgr::loadChunkSketches() {
+  for (auto& chunk : chunkIndex_) {
+    const auto& sketchKey = chunk.first;
+    if (sketchKey.size() != 5 || sketchKey.back() != CHUNK_SKETCH_KEY_SUFFIX) {
+      continue;
+    }
+    auto chunkIt = chunkIndex_.find(ChunkKey(sketchKey.begin(), sketchKey.end() - 1));
+    if (chunkIt == chunkIndex_.end() || !chunkIt->second->hasEncoder) {
+      continue;
+    }
+    auto sketchBuffer = chunk.second;
+    std::vector<int8_t> serialized(sketchBuffer->size());
+    sketchBuffer->read(serialized.data(), serialized.size());
+    auto& encoder = chunkIt->second->encoder;
+    encoder->setSketch(ChunkSketch::deserialize(
+        serialized.data(), serialized.size(), encoder->getNumElems()));
+  }
+}
+
+AsyncFileReader* FileMgr::getAsyncReader() {
+  CHECK(gfm_);
+  return gfm_->getAsyncReader();
+}
+
 AbstractBuffer* FileMgr::getBuffer(const ChunkKey& key, const size_t numBytes) {
   mapd_shared_lock<mapd_shared_mutex> chunkIndexReadLock(chunkIndexMutex_);
   auto chunkIt = chunkIndex_.find(key);
@@ -928,6 +1002,8 @@ void FileMgr::getChunkMetadataVec(
     if (chunkIt->second->hasEncoder) {
       ChunkMetadata chunkMetadata;
       chunkIt->second->encoder->getMetadata(chunkMetadata);
+      chunkMetadata.numCompressedBytes = chunkIt->second->compressedSize();
+      chunkMetadata.decompressMicros = chunkIt->second->decompressMicros();
       chunkMetadataVec.emplace_back(chunkIt->first, chunkMetadata);
     }
   }
@@ -957,6 +1033,8 @@ void FileMgr::getChunkMetadataVecForKeyPrefix(
     if (chunkIt->second->hasEncoder) {
       ChunkMetadata chunkMetadata;
       chunkIt->second->encoder->getMetadata(chunkMetadata);
+      chunkMetadata.numCompressedBytes = chunkIt->second->compressedSize();
+      chunkMetadata.decompressMicros = chunkIt->second->decompressMicros();
       chunkMetadataVec.emplace_back(chunkIt->first, chunkMetadata);
     }
     chunkIt++;
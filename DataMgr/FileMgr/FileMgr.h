@@ -124,6 +124,9 @@ class FileMgr : public AbstractBufferMgr {  // implements
   /// Returns the a pointer to the chunk with the specified key.
   AbstractBuffer* getBuffer(const ChunkKey& key, const size_t numBytes = 0) override;
 
+  /// Queues readahead hints for the pages of the chunks with the given key prefix.
+  void readaheadBuffersWithPrefix(const ChunkKey& keyPrefix);
+
   void fetchBuffer(const ChunkKey& key,
                    AbstractBuffer* destBuffer,
                    const size_t numBytes) override;
@@ -211,6 +214,15 @@ class FileMgr : public AbstractBufferMgr {  // implements
    */
   inline size_t getNumReaderThreads() { return num_reader_threads_; }
 
+  /// Returns the reader shared by the FileMgrs of the GlobalFileMgr.
+  AsyncFileReader* getAsyncReader();
+
+  /// Sets the blosc compressor of the chunks created from now on, -1 for none.
+  inline void setCompressionCode(const int compressionCode) {
+    compressionCode_ = compressionCode;
+  }
+  inline int getCompressionCode() const { return compressionCode_; }
+
   /**
    * @brief Returns FILE pointer associated with
    * requested fileId
@@ -246,6 +258,7 @@ class FileMgr : public AbstractBufferMgr {  // implements
   size_t defaultPageSize_;
   unsigned nextFileId_;  /// the index of the next file id
   int epoch_;            /// the current epoch (time of last checkpoint)
+  int compressionCode_;  /// blosc compressor of the pages of new chunks, -1 for none
   FILE* epochFile_;
   int db_version_;    /// DB version from dbmeta file, should be compatible with
                       /// GlobalFileMgr::mapd_db_version_
@@ -280,6 +293,9 @@ class FileMgr : public AbstractBufferMgr {  // implements
                              const size_t pageSize,
                              const size_t numPages,
                              std::vector<HeaderInfo>& headerVec);
+  // Writes the sketch of a dirty chunk to its sketch buffer, under the chunk index lock.
+  void writeChunkSketch(const ChunkKey& key, FileBuffer* buffer);
+  void loadChunkSketches();
   void createEpochFile(const std::string& epochFileName);
   void openEpochFile(const std::string& epochFileName);
   void writeAndSyncEpochToDisk();
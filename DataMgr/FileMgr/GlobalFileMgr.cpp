@@ -37,6 +37,13 @@ using namespace std;
 
 namespace File_Namespace {
 
+namespace {
+
+// Enough page reads in flight to keep NVMe devices and network block storage busy.
+constexpr size_t async_read_queue_depth{256};
+
+}  // namespace
+
 GlobalFileMgr::GlobalFileMgr(const int deviceId,
                              std::string basePath,
                              const size_t num_reader_threads,
@@ -51,6 +58,10 @@ GlobalFileMgr::GlobalFileMgr(const int deviceId,
   mapd_db_version_ =
       1;  // DS changes triggered by individual FileMgr per table project (release 2.1.0)
   dbConvert_ = false;
+  const size_t num_io_threads = num_reader_threads_
+                                    ? num_reader_threads_
+                                    : std::max(std::thread::hardware_concurrency(), 1u);
+  asyncReader_.reset(new AsyncFileReader(num_io_threads, async_read_queue_depth));
   init();
 }
 
@@ -162,6 +173,10 @@ FileMgr* GlobalFileMgr::getFileMgr(const int db_id, const int tb_id) {
     }
     FileMgr* fm =
         new FileMgr(0, this, file_mgr_key, num_reader_threads_, epoch_, defaultPageSize_);
+    const auto compression_it = tableCompressionCodes_.find(file_mgr_key);
+    if (compression_it != tableCompressionCodes_.end()) {
+      fm->setCompressionCode(compression_it->second);
+    }
     auto it_ok = fileMgrs_.insert(std::make_pair(file_mgr_key, fm));
     CHECK(it_ok.second);
 
@@ -221,6 +236,18 @@ void GlobalFileMgr::setTableEpoch(const int db_id,
   }
 }
 
+void GlobalFileMgr::setTableCompression(const int db_id,
+                                        const int tb_id,
+                                        const int compression_code) {
+  const auto file_mgr_key = std::make_pair(db_id, tb_id);
+  mapd_lock_guard<mapd_shared_mutex> write_lock(fileMgrs_mutex_);
+  tableCompressionCodes_[file_mgr_key] = compression_code;
+  auto it = fileMgrs_.find(file_mgr_key);
+  if (it != fileMgrs_.end()) {
+    it->second->setCompressionCode(compression_code);
+  }
+}
+
 size_t GlobalFileMgr::getTableEpoch(const int db_id, const int tb_id) {
   FileMgr* fm = getFileMgr(db_id, tb_id);
 
@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include "../Shared/mapd_shared_mutex.h"
@@ -142,6 +143,13 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
    */
   inline size_t getNumReaderThreads() { return num_reader_threads_; }
 
+  inline AsyncFileReader* getAsyncReader() { return asyncReader_.get(); }
+
+  /// Queues readahead hints for the pages of the chunks with the given key prefix.
+  void readaheadBuffersWithPrefix(const ChunkKey& keyPrefix) {
+    getFileMgr(keyPrefix)->readaheadBuffersWithPrefix(keyPrefix);
+  }
+
   size_t getNumChunks() override;
 
   FileMgr* findFileMgr(const int db_id,
@@ -161,10 +169,13 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
   void removeTableRelatedDS(const int db_id, const int tb_id);
   void setTableEpoch(const int db_id, const int tb_id, const int start_epoch);
   size_t getTableEpoch(const int db_id, const int tb_id);
+  /// Sets the blosc compressor of the pages of the table, -1 for none.
+  void setTableCompression(const int db_id, const int tb_id, const int compression_code);
 
  private:
   std::string basePath_;       /// The OS file system path containing the files.
   size_t num_reader_threads_;  /// number of threads used when loading data
+  std::unique_ptr<AsyncFileReader> asyncReader_;  /// reads the pages of all FileMgrs
   int epoch_; /* the current epoch (time of last checkpoint) will be used for all
                * tables except of the one for which the value of the epoch has been reset
                * using --start-epoch option at start up to rollback this table's updates.
@@ -180,6 +191,8 @@ class GlobalFileMgr : public AbstractBufferMgr {  // implements
   bool dbConvert_;  /// true if conversion should be done between different
                     /// "mapd_db_version_"
   std::map<std::pair<int, int>, FileMgr*> fileMgrs_;
+  /// blosc compressors of the tables, they may be set before their FileMgrs are created
+  std::map<std::pair<int, int>, int> tableCompressionCodes_;
   mapd_shared_mutex fileMgrs_mutex_;
 };
 
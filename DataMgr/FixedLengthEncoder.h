@@ -40,6 +40,7 @@ class FixedLengthEncoder : public Encoder {
                            const bool replicating = false) override {
     T* unencodedData = reinterpret_cast<T*>(srcData);
     auto encodedData = std::make_unique<V[]>(numAppendElems);
+    auto sketch = getSketchForAppend();
     for (size_t i = 0; i < numAppendElems; ++i) {
       size_t ri = replicating ? 0 : i;
       encodedData.get()[i] = static_cast<V>(unencodedData[ri]);
@@ -56,6 +57,9 @@ class FixedLengthEncoder : public Encoder {
           decimal_overflow_validator_.validate(data);
           dataMin = std::min(dataMin, data);
           dataMax = std::max(dataMax, data);
+          if (sketch) {
+            sketch->add(static_cast<int64_t>(data));
+          }
         }
       }
     }
@@ -121,6 +125,7 @@ class FixedLengthEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    copySketch(copyFromEncoder);
   }
 
   void writeMetadata(FILE* f) override {
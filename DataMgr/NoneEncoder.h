@@ -46,6 +46,7 @@ class NoneEncoder : public Encoder {
     if (replicating) {
       encoded_data.resize(numAppendElems);
     }
+    auto sketch = getSketchForAppend();
     for (size_t i = 0; i < numAppendElems; ++i) {
       size_t ri = replicating ? 0 : i;
       T data = unencodedData[ri];
@@ -58,6 +59,9 @@ class NoneEncoder : public Encoder {
         decimal_overflow_validator_.validate(data);
         dataMin = std::min(dataMin, data);
         dataMax = std::max(dataMax, data);
+        if (sketch) {
+          sketch->add(static_cast<int64_t>(data));
+        }
       }
     }
     num_elems_ += numAppendElems;
@@ -151,6 +155,7 @@ class NoneEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    copySketch(copyFromEncoder);
   }
 
   T dataMin;
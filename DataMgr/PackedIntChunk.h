@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PackedIntChunk.h
+ * @brief   Layout of the chunks of integer columns with RL, DIFF or BITPACK encoding.
+ *
+ * A chunk starts with a PackedIntChunkHeader followed by the payload of its format:
+ *
+ *   RAW      the values at their logical width, with the logical null sentinel.
+ *   RLE      {value, end position} pairs of int64_t, the header base is the run count.
+ *   BITPACK  bit_width wide offsets from the header base, little endian bit order.
+ *   DELTA    blocks of packed_int_delta_block_rows rows, each an int64_t base followed
+ *            by the bit_width wide offsets of its rows from that base.
+ *
+ * The all ones offset stands for null. Chunks are appended to in the RAW format and
+ * packed into the format of the column encoding once they no longer receive inserts.
+ * The kernels decode every format, see packed_int_decode in DecodersImpl.h.
+ */
+
+#ifndef DATAMGR_PACKEDINTCHUNK_H
+#define DATAMGR_PACKEDINTCHUNK_H
+
+#include <stdint.h>
+#include "../Shared/funcannotations.h"
+
+enum PackedIntFormat {
+  kPACKED_RAW = 0,
+  kPACKED_RLE = 1,
+  kPACKED_BITPACK = 2,
+  kPACKED_DELTA = 3
+};
+
+struct PackedIntChunkHeader {
+  int32_t format;
+  int32_t bit_width;
+  int64_t base;
+};
+
+#define PACKED_INT_HEADER_SIZE 16
+#define PACKED_INT_DELTA_BLOCK_ROWS 1024
+// Offsets are read eight bytes at a time, an offset can't straddle more than that.
+#define PACKED_INT_MAX_BIT_WIDTH 56
+// Padding at the end of the bit packed payloads, for the eight byte reads.
+#define PACKED_INT_PADDING 8
+
+HOST DEVICE inline int64_t packed_int_delta_block_size(const int32_t bit_width) {
+  return sizeof(int64_t) + PACKED_INT_DELTA_BLOCK_ROWS / 8 * bit_width;
+}
+
+// Byte by byte, the offsets are not aligned and the GPUs don't do unaligned loads.
+HOST DEVICE inline uint64_t packed_int_unpack(const int8_t* payload,
+                                              const int32_t bit_width,
+                                              const int64_t idx) {
+  const int64_t bit_pos = idx * bit_width;
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(payload) + (bit_pos >> 3);
+  uint64_t word = 0;
+  for (int i = 0; i < 8; ++i) {
+    word |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+  }
+  return (word >> (bit_pos & 7)) & ((uint64_t(1) << bit_width) - 1);
+}
+
+HOST DEVICE inline int64_t packed_int_rle_decode(const int8_t* payload,
+                                                 const int64_t run_count,
+                                                 const int64_t pos) {
+  const int64_t* runs = reinterpret_cast<const int64_t*>(payload);
+  int64_t lo = 0;
+  int64_t hi = run_count - 1;
+  // First run which ends after pos.
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo) / 2;
+    if (runs[2 * mid + 1] <= pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return runs[2 * lo];
+}
+
+#endif  // DATAMGR_PACKEDINTCHUNK_H
@@ -0,0 +1,300 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PackedIntCodec.h"
+
+#include <glog/logging.h>
+#include <cstring>
+
+namespace {
+
+int64_t read_int(const int8_t* values, const size_t byte_width, const size_t idx) {
+  switch (byte_width) {
+    case 1:
+      return reinterpret_cast<const int8_t*>(values)[idx];
+    case 2:
+      return reinterpret_cast<const int16_t*>(values)[idx];
+    case 4:
+      return reinterpret_cast<const int32_t*>(values)[idx];
+    case 8:
+      return reinterpret_cast<const int64_t*>(values)[idx];
+    default:
+      CHECK(false);
+  }
+  return 0;
+}
+
+void write_int(int8_t* values,
+               const size_t byte_width,
+               const size_t idx,
+               const int64_t val) {
+  switch (byte_width) {
+    case 1:
+      reinterpret_cast<int8_t*>(values)[idx] = val;
+      break;
+    case 2:
+      reinterpret_cast<int16_t*>(values)[idx] = val;
+      break;
+    case 4:
+      reinterpret_cast<int32_t*>(values)[idx] = val;
+      break;
+    case 8:
+      reinterpret_cast<int64_t*>(values)[idx] = val;
+      break;
+    default:
+      CHECK(false);
+  }
+}
+
+// Bits needed for the offsets in [0, range] plus the all ones null offset.
+int32_t bit_width_for_range(const uint64_t range) {
+  int32_t bit_width = 1;
+  while (bit_width < 64 && (uint64_t(1) << bit_width) - 1 <= range) {
+    ++bit_width;
+  }
+  return bit_width;
+}
+
+void pack_bits(int8_t* payload,
+               const int32_t bit_width,
+               const size_t idx,
+               const uint64_t offset) {
+  auto bytes = reinterpret_cast<uint8_t*>(payload);
+  const size_t bit_pos = idx * bit_width;
+  size_t byte_idx = bit_pos >> 3;
+  uint64_t word = offset << (bit_pos & 7);
+  // The offset and its shift fit in eight bytes, PACKED_INT_MAX_BIT_WIDTH makes sure.
+  for (size_t i = 0; i < 8 && word; ++i, ++byte_idx, word >>= 8) {
+    bytes[byte_idx] |= static_cast<uint8_t>(word);
+  }
+}
+
+std::vector<int8_t> make_chunk(const PackedIntChunkHeader& header,
+                               const size_t payload_size) {
+  std::vector<int8_t> chunk(PACKED_INT_HEADER_SIZE + payload_size, 0);
+  memcpy(chunk.data(), &header, sizeof(header));
+  return chunk;
+}
+
+std::vector<int8_t> pack_rle(const int8_t* values,
+                             const size_t num_elems,
+                             const size_t byte_width) {
+  std::vector<int64_t> runs;
+  for (size_t i = 0; i < num_elems; ++i) {
+    const auto val = read_int(values, byte_width, i);
+    if (runs.empty() || runs[runs.size() - 2] != val) {
+      runs.push_back(val);
+      runs.push_back(0);
+    }
+    runs.back() = i + 1;
+  }
+  const size_t num_runs = runs.size() / 2;
+  if (sizeof(int64_t) * runs.size() >= num_elems * byte_width) {
+    return {};
+  }
+  auto chunk = make_chunk({kPACKED_RLE, 0, static_cast<int64_t>(num_runs)},
+                          sizeof(int64_t) * runs.size());
+  memcpy(chunk.data() + PACKED_INT_HEADER_SIZE,
+         runs.data(),
+         sizeof(int64_t) * runs.size());
+  return chunk;
+}
+
+// Offsets of the values in [begin, end) from their minimum, nulls map to all ones.
+void pack_frame(int8_t* payload,
+                const int32_t bit_width,
+                const int64_t base,
+                const int8_t* values,
+                const size_t begin,
+                const size_t end,
+                const size_t byte_width,
+                const int64_t null_val) {
+  const uint64_t null_offset = (uint64_t(1) << bit_width) - 1;
+  for (size_t i = begin; i < end; ++i) {
+    const auto val = read_int(values, byte_width, i);
+    pack_bits(payload,
+              bit_width,
+              i - begin,
+              val == null_val ? null_offset
+                              : static_cast<uint64_t>(val) - static_cast<uint64_t>(base));
+  }
+}
+
+struct Frame {
+  int64_t min;
+  uint64_t range;
+};
+
+Frame frame_of(const int8_t* values,
+               const size_t begin,
+               const size_t end,
+               const size_t byte_width,
+               const int64_t null_val) {
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  for (size_t i = begin; i < end; ++i) {
+    const auto val = read_int(values, byte_width, i);
+    if (val != null_val) {
+      min = std::min(min, val);
+      max = std::max(max, val);
+    }
+  }
+  if (min > max) {
+    // Only nulls.
+    return {0, 0};
+  }
+  return {min, static_cast<uint64_t>(max) - static_cast<uint64_t>(min)};
+}
+
+std::vector<int8_t> pack_bitpack(const int8_t* values,
+                                 const size_t num_elems,
+                                 const size_t byte_width,
+                                 const int64_t null_val) {
+  const auto frame = frame_of(values, 0, num_elems, byte_width, null_val);
+  const auto bit_width = bit_width_for_range(frame.range);
+  const size_t payload_size = (num_elems * bit_width + 7) / 8 + PACKED_INT_PADDING;
+  if (bit_width > PACKED_INT_MAX_BIT_WIDTH ||
+      PACKED_INT_HEADER_SIZE + payload_size >= num_elems * byte_width) {
+    return {};
+  }
+  auto chunk = make_chunk({kPACKED_BITPACK, bit_width, frame.min}, payload_size);
+  pack_frame(chunk.data() + PACKED_INT_HEADER_SIZE,
+             bit_width,
+             frame.min,
+             values,
+             0,
+             num_elems,
+             byte_width,
+             null_val);
+  return chunk;
+}
+
+std::vector<int8_t> pack_delta(const int8_t* values,
+                               const size_t num_elems,
+                               const size_t byte_width,
+                               const int64_t null_val) {
+  const size_t num_blocks =
+      (num_elems + PACKED_INT_DELTA_BLOCK_ROWS - 1) / PACKED_INT_DELTA_BLOCK_ROWS;
+  std::vector<Frame> frames;
+  int32_t bit_width = 1;
+  for (size_t block = 0; block < num_blocks; ++block) {
+    const size_t begin = block * PACKED_INT_DELTA_BLOCK_ROWS;
+    const size_t end = std::min(begin + PACKED_INT_DELTA_BLOCK_ROWS, num_elems);
+    frames.push_back(frame_of(values, begin, end, byte_width, null_val));
+    bit_width = std::max(bit_width, bit_width_for_range(frames.back().range));
+  }
+  const size_t payload_size =
+      num_blocks * packed_int_delta_block_size(bit_width) + PACKED_INT_PADDING;
+  if (bit_width > PACKED_INT_MAX_BIT_WIDTH ||
+      PACKED_INT_HEADER_SIZE + payload_size >= num_elems * byte_width) {
+    return {};
+  }
+  auto chunk = make_chunk({kPACKED_DELTA, bit_width, 0}, payload_size);
+  for (size_t block = 0; block < num_blocks; ++block) {
+    auto block_ptr = chunk.data() + PACKED_INT_HEADER_SIZE +
+                     block * packed_int_delta_block_size(bit_width);
+    memcpy(block_ptr, &frames[block].min, sizeof(int64_t));
+    const size_t begin = block * PACKED_INT_DELTA_BLOCK_ROWS;
+    pack_frame(block_ptr + sizeof(int64_t),
+               bit_width,
+               frames[block].min,
+               values,
+               begin,
+               std::min(begin + PACKED_INT_DELTA_BLOCK_ROWS, num_elems),
+               byte_width,
+               null_val);
+  }
+  return chunk;
+}
+
+}  // namespace
+
+std::vector<int8_t> pack_int_chunk(const int8_t* values,
+                                   const size_t num_elems,
+                                   const size_t byte_width,
+                                   const int64_t null_val,
+                                   const EncodingType encoding) {
+  if (!num_elems) {
+    return {};
+  }
+  switch (encoding) {
+    case kENCODING_RL:
+      return pack_rle(values, num_elems, byte_width);
+    case kENCODING_DIFF:
+      return pack_delta(values, num_elems, byte_width, null_val);
+    case kENCODING_BITPACK:
+      return pack_bitpack(values, num_elems, byte_width, null_val);
+    default:
+      CHECK(false);
+  }
+  return {};
+}
+
+void unpack_int_chunk(int8_t* dest,
+                      const int8_t* chunk,
+                      const size_t num_elems,
+                      const size_t byte_width,
+                      const int64_t null_val) {
+  const auto header = reinterpret_cast<const PackedIntChunkHeader*>(chunk);
+  const auto payload = chunk + PACKED_INT_HEADER_SIZE;
+  const uint64_t null_offset = (uint64_t(1) << header->bit_width) - 1;
+  switch (header->format) {
+    case kPACKED_RAW: {
+      memcpy(dest, payload, num_elems * byte_width);
+      break;
+    }
+    case kPACKED_RLE: {
+      const auto runs = reinterpret_cast<const int64_t*>(payload);
+      size_t i = 0;
+      for (int64_t run = 0; run < header->base; ++run) {
+        for (; i < static_cast<size_t>(runs[2 * run + 1]); ++i) {
+          write_int(dest, byte_width, i, runs[2 * run]);
+        }
+      }
+      CHECK_EQ(i, num_elems);
+      break;
+    }
+    case kPACKED_BITPACK: {
+      for (size_t i = 0; i < num_elems; ++i) {
+        const auto offset = packed_int_unpack(payload, header->bit_width, i);
+        write_int(dest,
+                  byte_width,
+                  i,
+                  offset == null_offset ? null_val
+                                        : header->base + static_cast<int64_t>(offset));
+      }
+      break;
+    }
+    case kPACKED_DELTA: {
+      const auto block_size = packed_int_delta_block_size(header->bit_width);
+      for (size_t i = 0; i < num_elems; ++i) {
+        const auto block = payload + (i / PACKED_INT_DELTA_BLOCK_ROWS) * block_size;
+        const auto offset = packed_int_unpack(
+            block + sizeof(int64_t), header->bit_width, i % PACKED_INT_DELTA_BLOCK_ROWS);
+        int64_t block_base;
+        memcpy(&block_base, block, sizeof(int64_t));
+        write_int(dest,
+                  byte_width,
+                  i,
+                  offset == null_offset ? null_val
+                                        : block_base + static_cast<int64_t>(offset));
+      }
+      break;
+    }
+    default:
+      CHECK(false);
+  }
+}
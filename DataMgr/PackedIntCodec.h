@@ -0,0 +1,46 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PACKED_INT_CODEC_H
+#define PACKED_INT_CODEC_H
+
+#include "../Shared/sqltypes.h"
+#include "PackedIntChunk.h"
+
+#include <vector>
+
+/**
+ * Packs the plain values of a sealed chunk into the format of the given encoding, see
+ * PackedIntChunk.h. Returns an empty vector if the packed chunk wouldn't be smaller than
+ * the plain one or the values are too far apart to be bit packed.
+ */
+std::vector<int8_t> pack_int_chunk(const int8_t* values,
+                                   const size_t num_elems,
+                                   const size_t byte_width,
+                                   const int64_t null_val,
+                                   const EncodingType encoding);
+
+/**
+ * Decodes num_elems values of a chunk in any of the formats into plain values of the
+ * given byte width, with the logical null sentinel.
+ */
+void unpack_int_chunk(int8_t* dest,
+                      const int8_t* chunk,
+                      const size_t num_elems,
+                      const size_t byte_width,
+                      const int64_t null_val);
+
+#endif  // PACKED_INT_CODEC_H
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PACKED_INT_ENCODER_H
+#define PACKED_INT_ENCODER_H
+
+#include "NoneEncoder.h"
+#include "PackedIntChunk.h"
+
+// Integer columns with RL, DIFF or BITPACK encoding. The chunks get a RAW header on the
+// first append and hold plain values until packed, packed chunks can't be appended to.
+template <typename T>
+class PackedIntEncoder : public NoneEncoder<T> {
+ public:
+  PackedIntEncoder(Data_Namespace::AbstractBuffer* buffer) : NoneEncoder<T>(buffer) {}
+
+  ChunkMetadata appendData(int8_t*& srcData,
+                           const size_t numAppendElems,
+                           const SQLTypeInfo& ti,
+                           const bool replicating = false) override {
+    if (this->buffer_->size() == 0) {
+      PackedIntChunkHeader header{kPACKED_RAW, 0, 0};
+      this->buffer_->append(reinterpret_cast<int8_t*>(&header), sizeof(header));
+    } else {
+      PackedIntChunkHeader header;
+      this->buffer_->read(reinterpret_cast<int8_t*>(&header), sizeof(header));
+      if (header.format != kPACKED_RAW) {
+        throw std::runtime_error("Cannot append to a packed " +
+                                 std::string(ti.get_compression_name()) + " chunk.");
+      }
+    }
+    return NoneEncoder<T>::appendData(srcData, numAppendElems, ti, replicating);
+  }
+};  // class PackedIntEncoder
+
+#endif  // PACKED_INT_ENCODER_H
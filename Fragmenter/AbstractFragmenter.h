@@ -122,6 +122,12 @@ class AbstractFragmenter {
       const ColumnDescriptor* cd,
       std::unordered_map</*fragment_id*/ int, ChunkStats>& stats_map) = 0;
 
+  /**
+   * @brief Packs the plain chunks of a RL, DIFF or BITPACK encoded column in the
+   * fragments which no longer receive inserts
+   */
+  virtual void packChunks(const ColumnDescriptor* cd) = 0;
+
   /**
    * @brief Gets the id of the partitioner
    */
@@ -26,6 +26,7 @@
 #include "../DataMgr/AbstractBuffer.h"
 #include "../DataMgr/DataMgr.h"
 #include "../DataMgr/LockMgr.h"
+#include "../DataMgr/PackedIntCodec.h"
 #include "../Shared/checked_alloc.h"
 #include "../Shared/thread_count.h"
 
@@ -312,6 +313,77 @@ void InsertOrderFragmenter::updateChunkStats(
   }
 }
 
+void InsertOrderFragmenter::packChunks(const ColumnDescriptor* cd) {
+  /**
+   * WARNING: This method is entirely unlocked, like updateChunkStats. The chunks are
+   * rewritten in place, higher level locks must keep out any table read or write.
+   */
+  CHECK(cd);
+  const auto& ti = cd->columnType;
+  CHECK(ti.is_packed_int());
+  const auto column_id = cd->columnId;
+  CHECK(columnMap_.find(column_id) != columnMap_.end());
+
+  size_t packed_chunks{0};
+  size_t plain_bytes{0};
+  size_t packed_bytes{0};
+  for (auto& fragment : fragmentInfoVec_) {
+    // The last fragment receives the inserts until it's full.
+    if (&fragment == &fragmentInfoVec_.back() &&
+        fragment.getPhysicalNumTuples() < maxFragmentRows_) {
+      continue;
+    }
+    auto chunk_meta_it = fragment.getChunkMetadataMapPhysical().find(column_id);
+    CHECK(chunk_meta_it != fragment.getChunkMetadataMapPhysical().end());
+    const auto num_bytes = chunk_meta_it->second.numBytes;
+    const auto num_elems = chunk_meta_it->second.numElements;
+    if (num_bytes < PACKED_INT_HEADER_SIZE) {
+      continue;
+    }
+    ChunkKey chunk_key{
+        catalog_->getCurrentDB().dbId, physicalTableId_, column_id, fragment.fragmentId};
+    auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                           &catalog_->getDataMgr(),
+                                           chunk_key,
+                                           Data_Namespace::MemoryLevel::DISK_LEVEL,
+                                           0,
+                                           num_bytes,
+                                           num_elems);
+    auto buf = chunk->get_buffer();
+    CHECK(buf);
+    std::vector<int8_t> plain_chunk(num_bytes);
+    buf->read(plain_chunk.data(), num_bytes, 0, Data_Namespace::CPU_LEVEL, -1);
+    const auto header = reinterpret_cast<const PackedIntChunkHeader*>(plain_chunk.data());
+    if (header->format != kPACKED_RAW) {
+      continue;
+    }
+    auto packed_chunk = pack_int_chunk(plain_chunk.data() + PACKED_INT_HEADER_SIZE,
+                                       num_elems,
+                                       ti.get_size(),
+                                       inline_int_null_val(ti),
+                                       ti.get_compression());
+    if (packed_chunk.empty()) {
+      VLOG(2) << "Keeping the plain chunk " << showChunk(chunk_key);
+      continue;
+    }
+    // Like vacuuming, the trailing pages of the chunk stay allocated.
+    buf->write(
+        packed_chunk.data(), packed_chunk.size(), 0, Data_Namespace::CPU_LEVEL, -1);
+    buf->setSize(packed_chunk.size());
+    ChunkMetadata new_metadata;
+    buf->encoder->getMetadata(new_metadata);
+    fragment.setChunkMetadata(column_id, new_metadata);
+    fragment.shadowChunkMetadataMap = fragment.getChunkMetadataMap();
+    ++packed_chunks;
+    plain_bytes += num_bytes;
+    packed_bytes += packed_chunk.size();
+  }
+  if (packed_chunks) {
+    LOG(INFO) << "Packed " << packed_chunks << " chunks of column " << cd->columnName
+              << " from " << plain_bytes << " to " << packed_bytes << " bytes";
+  }
+}
+
 void InsertOrderFragmenter::insertData(InsertData& insertDataStruct) {
   // TODO: this local lock will need to be centralized when ALTER COLUMN is added, bc
   try {
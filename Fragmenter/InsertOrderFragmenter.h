@@ -95,6 +95,8 @@ class InsertOrderFragmenter : public AbstractFragmenter {
       const ColumnDescriptor* cd,
       std::unordered_map</*fragment_id*/ int, ChunkStats>& stats_map) override;
 
+  void packChunks(const ColumnDescriptor* cd) override;
+
   /**
    * @brief get fragmenter's id
    */
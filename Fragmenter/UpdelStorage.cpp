@@ -28,6 +28,7 @@
 #include "QueryEngine/TargetValue.h"
 #include "Shared/ConfigResolve.h"
 #include "Shared/DateConverters.h"
+#include "Shared/TaskPool.h"
 #include "Shared/TypedDataAccessors.h"
 #include "Shared/thread_count.h"
 #include "Shared/unreachable.h"
@@ -35,7 +36,7 @@
 
 namespace Fragmenter_Namespace {
 
-inline void wait_cleanup_threads(std::vector<std::future<void>>& threads) {
+inline void wait_cleanup_threads(std::vector<TaskPool_NS::TaskFuture<void>>& threads) {
   for (auto& t : threads) {
     t.get();
   }
@@ -101,6 +102,15 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
                updel_roll);
 }
 
+// The chunks of packed columns are rewritten as a whole by OPTIMIZE only.
+static void check_not_packed(const ColumnDescriptor* cd, const std::string& operation) {
+  if (cd->columnType.is_packed_int()) {
+    throw std::runtime_error(operation + " is not supported on the " +
+                             cd->columnType.get_compression_name() +
+                             " encoded column " + cd->columnName + ".");
+  }
+}
+
 static int get_chunks(const Catalog_Namespace::Catalog* catalog,
                       const TableDescriptor* td,
                       const FragmentInfo& fragment,
@@ -319,6 +329,9 @@ void InsertOrderFragmenter::updateColumns(
   auto& fragment = getFragmentInfoFromId(fragmentId);
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks;
   get_chunks(catalog, td, fragment, memoryLevel, chunks);
+  for (const auto& chunk : chunks) {
+    check_not_packed(chunk->get_column_desc(), "UPDATE");
+  }
   std::vector<std::unique_ptr<TargetValueConverter>> sourceDataConverters(
       columnDescriptors.size());
   std::vector<std::unique_ptr<ChunkToInsertDataConverter>> chunkConverters;
@@ -513,22 +526,21 @@ void InsertOrderFragmenter::updateColumns(
 
   if (can_go_parallel) {
     const size_t num_worker_threads = cpu_threads();
-    std::vector<std::future<void>> worker_threads;
+    std::vector<TaskPool_NS::TaskFuture<void>> worker_threads;
     for (size_t i = 0,
                 start_entry = 0,
                 stride = (num_rows + num_worker_threads - 1) / num_worker_threads;
          i < num_worker_threads && start_entry < num_rows;
          ++i, start_entry += stride) {
       const auto end_entry = std::min(start_entry + stride, num_rows);
-      worker_threads.push_back(
-          std::async(std::launch::async,
-                     [&row_converter](const size_t start, const size_t end) {
-                       for (size_t indexOfRow = start; indexOfRow < end; ++indexOfRow) {
-                         row_converter(indexOfRow);
-                       }
-                     },
-                     start_entry,
-                     end_entry));
+      worker_threads.push_back(TaskPool_NS::async(
+          [&row_converter](const size_t start, const size_t end) {
+            for (size_t indexOfRow = start; indexOfRow < end; ++indexOfRow) {
+              row_converter(indexOfRow);
+            }
+          },
+          start_entry,
+          end_entry));
     }
 
     for (auto& child : worker_threads) {
@@ -586,6 +598,7 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
                                          const SQLTypeInfo& rhs_type,
                                          const Data_Namespace::MemoryLevel memory_level,
                                          UpdelRoll& updel_roll) {
+  check_not_packed(cd, "UPDATE");
   updel_roll.catalog = catalog;
   updel_roll.logicalTableId = catalog->getLogicalTableId(td->tableId);
   updel_roll.memoryLevel = memory_level;
@@ -618,7 +631,7 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
   std::vector<int64_t> min_int64t_per_thread(ncore, std::numeric_limits<int64_t>::max());
 
   // parallel update elements
-  std::vector<std::future<void>> threads;
+  std::vector<TaskPool_NS::TaskFuture<void>> threads;
 
   const auto segsz = (nrow + ncore - 1) / ncore;
   auto dbuf = chunk->get_buffer();
@@ -637,8 +650,7 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
     updel_roll.dirtyChunkeys.insert(chunkey);
   }
   for (size_t rbegin = 0, c = 0; rbegin < nrow; ++c, rbegin += segsz) {
-    threads.emplace_back(std::async(
-        std::launch::async,
+    threads.emplace_back(TaskPool_NS::async(
         [=,
          &has_null_per_thread,
          &min_int64t_per_thread,
@@ -895,6 +907,8 @@ void InsertOrderFragmenter::updateColumn(const Catalog_Namespace::Catalog* catal
     min_int64t_per_chunk =
         std::min<int64_t>(min_int64t_per_chunk, min_int64t_per_thread[c]);
   }
+  // The new values aren't in the sketch of the chunk.
+  chunk->get_buffer()->encoder->dropSketch();
   updateColumnMetadata(cd,
                        fragment,
                        chunk,
@@ -1024,9 +1038,9 @@ const std::vector<uint64_t> InsertOrderFragmenter::getVacuumOffsets(
   const size_t segsz = (nrows_in_chunk + ncore - 1) / ncore;
   std::vector<std::vector<uint64_t>> deleted_offsets;
   deleted_offsets.resize(ncore);
-  std::vector<std::future<void>> threads;
+  std::vector<TaskPool_NS::TaskFuture<void>> threads;
   for (size_t rbegin = 0; rbegin < nrows_in_chunk; rbegin += segsz) {
-    threads.emplace_back(std::async(std::launch::async, [=, &deleted_offsets] {
+    threads.emplace_back(TaskPool_NS::async([=, &deleted_offsets] {
       const auto rend = std::min<size_t>(rbegin + segsz, nrows_in_chunk);
       const auto ithread = rbegin / segsz;
       CHECK(ithread < deleted_offsets.size());
@@ -1185,6 +1199,9 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
   auto& fragment = getFragmentInfoFromId(fragment_id);
   auto chunks = getChunksForAllColumns(td, fragment, memory_level);
   const auto ncol = chunks.size();
+  for (const auto& chunk : chunks) {
+    check_not_packed(chunk->get_column_desc(), "Vacuuming deleted rows");
+  }
 
   std::vector<int8_t> has_null_per_thread(ncol, 0);
   std::vector<double> max_double_per_thread(ncol, std::numeric_limits<double>::lowest());
@@ -1193,7 +1210,7 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
   std::vector<int64_t> min_int64t_per_thread(ncol, std::numeric_limits<uint64_t>::max());
 
   // parallel delete columns
-  std::vector<std::future<void>> threads;
+  std::vector<TaskPool_NS::TaskFuture<void>> threads;
   auto nrows_to_vacuum = frag_offsets.size();
   auto nrows_in_fragment = fragment.getPhysicalNumTuples();
   auto nrows_to_keep = nrows_in_fragment - nrows_to_vacuum;
@@ -1269,9 +1286,9 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
     };
 
     if (is_varlen) {
-      threads.emplace_back(std::async(std::launch::async, varlen_vacuum));
+      threads.emplace_back(TaskPool_NS::async(varlen_vacuum));
     } else {
-      threads.emplace_back(std::async(std::launch::async, fixlen_vacuum));
+      threads.emplace_back(TaskPool_NS::async(fixlen_vacuum));
     }
     if (threads.size() >= (size_t)cpu_threads()) {
       wait_cleanup_threads(threads);
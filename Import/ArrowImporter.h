@@ -16,8 +16,11 @@
 #ifndef ARROW_IMPORTER_H
 #define ARROW_IMPORTER_H
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <limits>
 #include <map>
 #include <mutex>
 
@@ -497,6 +500,116 @@ inline auto& operator<<(DataBuffer<DATA_TYPE>& data, const VarValue& var) {
   return data;
 }
 
+// the arrow type of the values a column stores as they are, NA if there is none
+inline Type::type get_physical_arrow_type(const SQLTypeInfo& ti) {
+  if (ti.is_decimal()) {
+    return Type::NA;
+  }
+  switch (ti.get_type()) {
+    case kTINYINT:
+      return Type::INT8;
+    case kSMALLINT:
+      return Type::INT16;
+    case kINT:
+      return Type::INT32;
+    case kBIGINT:
+      return Type::INT64;
+    case kFLOAT:
+      return Type::FLOAT;
+    case kDOUBLE:
+      return Type::DOUBLE;
+    default:
+      return Type::NA;
+  }
+}
+
+template <typename DATA_TYPE>
+const DATA_TYPE* get_arrow_values(const Array& array) {
+  return reinterpret_cast<const DATA_TYPE*>(
+             static_cast<const PrimitiveArray&>(array).values()->data()) +
+         array.offset();
+}
+
+// the lowest value of the narrower integers is their null, which can't be imported
+template <typename DATA_TYPE>
+bool has_reserved_null(const DATA_TYPE* values, const int64_t length) {
+  return std::is_integral<DATA_TYPE>::value && !std::is_same<DATA_TYPE, int64_t>::value &&
+         std::find(values, values + length, std::numeric_limits<DATA_TYPE>::lowest()) !=
+             values + length;
+}
+
+// replaces the values which are null in the validity bitmap of the array with the
+// null sentinel. the bitmap is read 64 bits at a time, the words without nulls are
+// skipped and the others patched with a branchless select the compiler vectorizes.
+template <typename DATA_TYPE>
+void patch_arrow_nulls(const Array& array,
+                       DATA_TYPE* values,
+                       const DATA_TYPE null_value) {
+  const uint8_t* bitmap = array.null_bitmap_data();
+  if (!bitmap || !array.null_count()) {
+    return;
+  }
+  const int64_t length = array.length();
+  const int64_t offset = array.offset();
+  int64_t row = 0;
+  // leading bits up to a byte boundary of the bitmap
+  for (; row < length && (offset + row) % 8; ++row) {
+    if (!((bitmap[(offset + row) / 8] >> ((offset + row) % 8)) & 1)) {
+      values[row] = null_value;
+    }
+  }
+  for (; row + 64 <= length; row += 64) {
+    uint64_t valid;
+    memcpy(&valid, bitmap + (offset + row) / 8, sizeof(valid));
+    if (valid == ~uint64_t(0)) {
+      continue;
+    }
+    for (int bit = 0; bit < 64; ++bit) {
+      values[row + bit] = (valid >> bit) & 1 ? values[row + bit] : null_value;
+    }
+  }
+  for (; row < length; ++row) {
+    if (!((bitmap[(offset + row) / 8] >> ((offset + row) % 8)) & 1)) {
+      values[row] = null_value;
+    }
+  }
+}
+
+// appends in bulk the values of an array which already has the physical type of the
+// column, only the nulls are patched to the column null. returns false without
+// appending anything if the array needs converting value by value.
+template <typename DATA_TYPE>
+std::enable_if_t<std::is_arithmetic<DATA_TYPE>::value, bool> append_arrow_values_as_is(
+    const ColumnDescriptor* cd,
+    const Array& array,
+    std::vector<DATA_TYPE>& buffer) {
+  const auto& ti = cd->columnType;
+  const auto physical_type = get_physical_arrow_type(ti);
+  if (physical_type == Type::NA || array.type_id() != physical_type) {
+    return false;
+  }
+  const auto values = get_arrow_values<DATA_TYPE>(array);
+  if (has_reserved_null(values, array.length())) {
+    return false;
+  }
+  const auto begin = buffer.size();
+  buffer.insert(buffer.end(), values, values + array.length());
+  const auto null_value =
+      std::is_floating_point<DATA_TYPE>::value
+          ? static_cast<DATA_TYPE>(inline_fp_null_val(ti))
+          : static_cast<DATA_TYPE>(inline_fixed_encoding_null_val(ti));
+  patch_arrow_nulls(array, buffer.data() + begin, null_value);
+  return true;
+}
+
+template <typename DATA_TYPE>
+std::enable_if_t<!std::is_arithmetic<DATA_TYPE>::value, bool> append_arrow_values_as_is(
+    const ColumnDescriptor* cd,
+    const Array& array,
+    std::vector<DATA_TYPE>& buffer) {
+  return false;
+}
+
 // appends (streams) a Arrow array of values (RHS) to TypedImportBuffer (LHS)
 template <typename DATA_TYPE>
 size_t convert_arrow_val_to_import_buffer(
@@ -507,8 +620,9 @@ size_t convert_arrow_val_to_import_buffer(
   auto data =
       std::make_unique<DataBuffer<DATA_TYPE>>(cd, array, buffer, bad_rows_tracker);
   auto f = value_getter(array, cd, bad_rows_tracker);
-  buffer.reserve(array.length());
-  for (auto row = 0; row < array.length(); ++row) {
+  buffer.reserve(buffer.size() + array.length());
+  const auto as_is = append_arrow_values_as_is(cd, array, buffer);
+  for (auto row = 0; !as_is && row < array.length(); ++row) {
     try {
       *data << (array.IsNull(row) ? nullptr : f(array, row));
     } catch (...) {
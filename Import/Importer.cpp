@@ -27,10 +27,13 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/utility/string_view.hpp>
 #include <boost/variant.hpp>
+#include <algorithm>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <future>
 #include <iomanip>
@@ -64,6 +67,7 @@
 #include <vector>
 #include "DataMgr/LockMgr.h"
 #include "Importer.h"
+#include "StructuralCharScanner.h"
 #include "QueryRunner/QueryRunner.h"
 #include "Utils/ChunkAccessorTable.h"
 #include "gen-cpp/MapD.h"
@@ -206,7 +210,7 @@ void Importer::set_import_status(const std::string& import_id, ImportStatus is)
   import_status_map[import_id] = is;
 }
 
-static const std::string trim_space(const char* field, const size_t len) {
+static boost::string_view trim_space_view(const char* field, const size_t len) {
   size_t i = 0;
   size_t j = len;
   while (i < j && (field[i] == ' ' || field[i] == '\r')) {
@@ -215,25 +219,81 @@ static const std::string trim_space(const char* field, const size_t len) {
   while (i < j && (field[j - 1] == ' ' || field[j - 1] == '\r')) {
     j--;
   }
-  return std::string(field + i, j - i);
+  return boost::string_view(field + i, j - i);
+}
+
+static const std::string trim_space(const char* field, const size_t len) {
+  return trim_space_view(field, len).to_string();
+}
+
+static bool is_eol(const char c, const char line_delim) {
+  return c == line_delim || c == '\r' || c == '\n';
+}
+
+static StructuralCharScanner get_row_scanner(const CopyParams& copy_params,
+                                             const bool* is_array) {
+  std::string chars{copy_params.delimiter, copy_params.escape, copy_params.line_delim};
+  chars += "\r\n";
+  if (copy_params.quoted) {
+    chars += copy_params.quote;
+  }
+  if (is_array) {
+    chars += copy_params.array_begin;
+    chars += copy_params.array_end;
+  }
+  return StructuralCharScanner(chars);
 }
 
-static const bool is_eol(const char& p, const std::string& line_delims) {
-  for (auto i : line_delims) {
-    if (p == i) {
-      return true;
+// Unescapes the field into the arena, strips its quotes and returns its view. When the
+// arena has to grow, the fields of the row already in it are moved along.
+static boost::string_view unescape_field(const char* field,
+                                         const size_t len,
+                                         const bool has_escape,
+                                         const CopyParams& copy_params,
+                                         std::string& arena,
+                                         std::vector<boost::string_view>& row) {
+  if (arena.size() + len > arena.capacity()) {
+    const char* old_begin = arena.data();
+    const char* old_end = old_begin + arena.size();
+    arena.reserve(std::max(2 * arena.capacity(), arena.size() + len));
+    for (auto& field_view : row) {
+      if (field_view.data() >= old_begin && field_view.data() < old_end) {
+        field_view = boost::string_view(arena.data() + (field_view.data() - old_begin),
+                                        field_view.size());
+      }
     }
   }
-  return false;
+  const size_t begin = arena.size();
+  for (size_t i = 0; i < len; i++) {
+    if (has_escape && field[i] == copy_params.escape && i + 1 < len &&
+        field[i + 1] == copy_params.quote) {
+      arena.push_back(copy_params.quote);
+      i++;
+    } else {
+      arena.push_back(field[i]);
+    }
+  }
+  auto s = trim_space_view(arena.data() + begin, arena.size() - begin);
+  if (copy_params.quoted && s.size() > 0 && s.front() == copy_params.quote) {
+    s.remove_prefix(1);
+  }
+  if (copy_params.quoted && s.size() > 0 && s.back() == copy_params.quote) {
+    s.remove_suffix(1);
+  }
+  return s.empty() ? boost::string_view() : s;
 }
 
+// Splits the row starting at buf into fields, jumping from one structural character to
+// the next. The fields are views into buf, or into the arena for the ones which had to
+// be unescaped, valid until the next call.
 static const char* get_row(const char* buf,
                            const char* buf_end,
                            const char* entire_buf_end,
                            const CopyParams& copy_params,
-                           bool is_begin,
                            const bool* is_array,
-                           std::vector<std::string>& row,
+                           const StructuralCharScanner& scanner,
+                           std::vector<boost::string_view>& row,
+                           std::string& arena,
                            bool& try_single_thread) {
   const char* field = buf;
   const char* p;
@@ -242,8 +302,9 @@ static const char* get_row(const char* buf,
   bool has_escape = false;
   bool strip_quotes = false;
   try_single_thread = false;
-  std::string line_endings({copy_params.line_delim, '\r', '\n'});
-  for (p = buf; p < entire_buf_end; p++) {
+  arena.clear();
+  for (p = scanner.find(buf, entire_buf_end); p < entire_buf_end;
+       p = scanner.find(p + 1, entire_buf_end)) {
     if (*p == copy_params.escape && p < entire_buf_end - 1 &&
         *(p + 1) == copy_params.quote) {
       p++;
@@ -259,39 +320,21 @@ static const char* get_row(const char* buf,
     } else if (!in_quote && is_array != nullptr && *p == copy_params.array_end &&
                is_array[row.size()]) {
       in_array = false;
-    } else if (*p == copy_params.delimiter || is_eol(*p, line_endings)) {
+    } else if (*p == copy_params.delimiter || is_eol(*p, copy_params.line_delim)) {
       if (!in_quote && !in_array) {
         if (!has_escape && !strip_quotes) {
-          std::string s = trim_space(field, p - field);
-          row.push_back(s);
+          row.push_back(trim_space_view(field, p - field));
         } else {
-          auto field_buf = std::make_unique<char[]>(p - field + 1);
-          int j = 0, i = 0;
-          for (; i < p - field; i++, j++) {
-            if (has_escape && field[i] == copy_params.escape &&
-                field[i + 1] == copy_params.quote) {
-              field_buf[j] = copy_params.quote;
-              i++;
-            } else {
-              field_buf[j] = field[i];
-            }
-          }
-          std::string s = trim_space(field_buf.get(), j);
-          if (copy_params.quoted && s.size() > 0 && s.front() == copy_params.quote) {
-            s.erase(0, 1);
-          }
-          if (copy_params.quoted && s.size() > 0 && s.back() == copy_params.quote) {
-            s.pop_back();
-          }
-          row.push_back(s);
+          row.push_back(
+              unescape_field(field, p - field, has_escape, copy_params, arena, row));
         }
         field = p + 1;
         has_escape = false;
         strip_quotes = false;
       }
-      if (is_eol(*p, line_endings) &&
+      if (is_eol(*p, copy_params.line_delim) &&
           ((!in_quote && !in_array) || copy_params.threads != 1)) {
-        while (p + 1 < buf_end && is_eol(*(p + 1), line_endings)) {
+        while (p + 1 < buf_end && is_eol(*(p + 1), copy_params.line_delim)) {
           p++;
         }
         break;
@@ -544,14 +587,10 @@ static size_t find_beginning(const char* buffer,
   if (begin == 0 || (begin > 0 && buffer[begin - 1] == copy_params.line_delim)) {
     return 0;
   }
-  size_t i;
   const char* buf = buffer + begin;
-  for (i = 0; i < end - begin; i++) {
-    if (buf[i] == copy_params.line_delim) {
-      return i + 1;
-    }
-  }
-  return i;
+  const auto eol =
+      static_cast<const char*>(memchr(buf, copy_params.line_delim, end - begin));
+  return eol ? eol - buf + 1 : end - begin;
 }
 
 void TypedImportBuffer::add_value(const ColumnDescriptor* cd,
@@ -876,6 +915,58 @@ size_t TypedImportBuffer::add_arrow_values(const ColumnDescriptor* cd,
   }
 }
 
+bool TypedImportBuffer::borrow_arrow_values(const ColumnDescriptor* cd,
+                                            const Array& col) {
+  // Type::NA is the physical type of the columns which are always converted, an empty
+  // NullArray would match it.
+  const auto physical_type = get_physical_arrow_type(cd->columnType);
+  if (borrowed_values_ || col.null_count() || physical_type == Type::NA ||
+      col.type_id() != physical_type) {
+    return false;
+  }
+  switch (cd->columnType.get_type()) {
+    case kTINYINT:
+      if (!tinyint_buffer_->empty() ||
+          has_reserved_null(get_arrow_values<int8_t>(col), col.length())) {
+        return false;
+      }
+      break;
+    case kSMALLINT:
+      if (!smallint_buffer_->empty() ||
+          has_reserved_null(get_arrow_values<int16_t>(col), col.length())) {
+        return false;
+      }
+      break;
+    case kINT:
+      if (!int_buffer_->empty() ||
+          has_reserved_null(get_arrow_values<int32_t>(col), col.length())) {
+        return false;
+      }
+      break;
+    case kBIGINT:
+      if (!bigint_buffer_->empty()) {
+        return false;
+      }
+      break;
+    case kFLOAT:
+      if (!float_buffer_->empty()) {
+        return false;
+      }
+      break;
+    case kDOUBLE:
+      if (!double_buffer_->empty()) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  borrowed_values_ = reinterpret_cast<const int8_t*>(
+                         static_cast<const PrimitiveArray&>(col).values()->data()) +
+                     col.offset() * getElementSize();
+  return true;
+}
+
 size_t TypedImportBuffer::add_values(const ColumnDescriptor* cd, const TColumn& col) {
   size_t dataSize = 0;
   const auto type = cd->columnType.is_decimal() ? decimal_to_int_type(cd->columnType)
@@ -1635,7 +1726,12 @@ static ImportStatus import_thread_delimited(
     for (const auto& p : import_buffers) {
       p->clear();
     }
-    std::vector<std::string> row;
+    const auto scanner = get_row_scanner(copy_params, importer->get_is_array());
+    // The row, the arena of its unescaped fields and the field handed over to the
+    // import buffers keep their memory from one row to the next.
+    std::vector<boost::string_view> row;
+    std::string arena;
+    std::string field;
     size_t row_index_plus_one = 0;
     for (const char* p = thread_buf; p < thread_buf_end; p++) {
       row.clear();
@@ -1645,9 +1741,10 @@ static ImportStatus import_thread_delimited(
                       thread_buf_end,
                       buf_end,
                       copy_params,
-                      p == thread_buf,
                       importer->get_is_array(),
+                      scanner,
                       row,
+                      arena,
                       try_single_thread);
         });
         total_get_row_time_us += us;
@@ -1656,9 +1753,10 @@ static ImportStatus import_thread_delimited(
                     thread_buf_end,
                     buf_end,
                     copy_params,
-                    p == thread_buf,
                     importer->get_is_array(),
+                    scanner,
                     row,
+                    arena,
                     try_single_thread);
       }
       row_index_plus_one++;
@@ -1705,8 +1803,8 @@ static ImportStatus import_thread_delimited(
               if (!cd->columnType.is_string() && row[import_idx].empty()) {
                 is_null = true;
               }
-              import_buffers[col_idx]->add_value(
-                  cd, row[import_idx], is_null, copy_params);
+              field.assign(row[import_idx].data(), row[import_idx].size());
+              import_buffers[col_idx]->add_value(cd, field, is_null, copy_params);
 
               // next
               ++import_idx;
@@ -1719,7 +1817,7 @@ static ImportStatus import_thread_delimited(
                   cd, copy_params.null_str, true, copy_params);
 
               // WKT from string we're not storing
-              std::string wkt{row[import_idx]};
+              std::string wkt = row[import_idx].to_string();
 
               // next
               ++import_idx;
@@ -1741,7 +1839,7 @@ static ImportStatus import_thread_delimited(
                 // string
                 double lon = std::atof(wkt.c_str());
                 double lat = NAN;
-                std::string lat_str{row[import_idx]};
+                std::string lat_str = row[import_idx].to_string();
                 ++import_idx;
                 if (lat_str.size() > 0 &&
                     (lat_str[0] == '.' || isdigit(lat_str[0]) || lat_str[0] == '-')) {
@@ -2097,20 +2195,18 @@ static ImportStatus import_thread_shapefile(
 }
 
 static size_t find_end(const char* buffer, size_t size, const CopyParams& copy_params) {
-  int i;
   // @TODO(wei) line_delim is in quotes note supported
-  for (i = size - 1; i >= 0 && buffer[i] != copy_params.line_delim; i--) {
-    ;
-  }
+  const auto eol =
+      static_cast<const char*>(memrchr(buffer, copy_params.line_delim, size));
 
-  if (i < 0) {
+  if (!eol) {
     int slen = size < 50 ? size : 50;
     std::string showMsgStr(buffer, buffer + slen);
     LOG(ERROR) << "No line delimiter in block. Block was of size " << size
                << " bytes, first few characters " << showMsgStr;
     return size;
   }
-  return i + 1;
+  return eol - buffer + 1;
 }
 
 bool Loader::loadNoCheckpoint(
@@ -2533,10 +2629,27 @@ void Detector::split_raw_data() {
   const char* buf = raw_data.c_str();
   const char* buf_end = buf + raw_data.size();
   bool try_single_thread = false;
+  const auto scanner = get_row_scanner(copy_params, nullptr);
+  std::vector<boost::string_view> row;
+  std::string arena;
+  auto add_raw_row = [&row, this]() {
+    raw_rows.emplace_back();
+    for (const auto& field : row) {
+      raw_rows.back().push_back(field.to_string());
+    }
+  };
   for (const char* p = buf; p < buf_end; p++) {
-    std::vector<std::string> row;
-    p = get_row(p, buf_end, buf_end, copy_params, true, nullptr, row, try_single_thread);
-    raw_rows.push_back(row);
+    row.clear();
+    p = get_row(p,
+                buf_end,
+                buf_end,
+                copy_params,
+                nullptr,
+                scanner,
+                row,
+                arena,
+                try_single_thread);
+    add_raw_row();
     if (try_single_thread) {
       break;
     }
@@ -2545,10 +2658,17 @@ void Detector::split_raw_data() {
     copy_params.threads = 1;
     raw_rows.clear();
     for (const char* p = buf; p < buf_end; p++) {
-      std::vector<std::string> row;
-      p = get_row(
-          p, buf_end, buf_end, copy_params, true, nullptr, row, try_single_thread);
-      raw_rows.push_back(row);
+      row.clear();
+      p = get_row(p,
+                  buf_end,
+                  buf_end,
+                  copy_params,
+                  nullptr,
+                  scanner,
+                  row,
+                  arena,
+                  try_single_thread);
+      add_raw_row();
     }
   }
 }
@@ -2902,29 +3022,30 @@ ImportStatus DataStreamSink::archivePlumber() {
 inline auto open_parquet_table(const std::string& file_path,
                                std::shared_ptr<arrow::io::ReadableFile>& infile,
                                std::unique_ptr<parquet::arrow::FileReader>& reader,
-                               std::shared_ptr<arrow::Table>& table) {
+                               std::shared_ptr<arrow::Schema>& schema) {
   using namespace parquet::arrow;
   using ReadableFile = arrow::io::ReadableFile;
   auto mempool = arrow::default_memory_pool();
   PARQUET_THROW_NOT_OK(ReadableFile::Open(file_path, mempool, &infile));
   PARQUET_THROW_NOT_OK(OpenFile(infile, mempool, &reader));
-  PARQUET_THROW_NOT_OK(reader->ReadTable(&table));
-  const auto num_row_groups = reader->num_row_groups();
-  const auto num_columns = table->num_columns();
-  const auto num_rows = table->num_rows();
+  // only the metadata is read here, the row groups are read as they are imported
+  PARQUET_THROW_NOT_OK(reader->GetSchema(&schema));
+  const int num_row_groups = reader->num_row_groups();
+  const int num_columns = schema->num_fields();
+  const int64_t num_rows = reader->parquet_reader()->metadata()->num_rows();
   LOG(INFO) << "File " << file_path << " has " << num_rows << " rows and " << num_columns
             << " columns in " << num_row_groups << " groups.";
-  return std::tie(num_row_groups, num_columns, num_rows);
+  return std::make_tuple(num_row_groups, num_columns, num_rows);
 }
 
 void Detector::import_local_parquet(const std::string& file_path) {
   std::shared_ptr<arrow::io::ReadableFile> infile;
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  std::shared_ptr<arrow::Table> table;
+  std::shared_ptr<arrow::Schema> schema;
   int num_row_groups, num_columns;
   int64_t num_rows;
   std::tie(num_row_groups, num_columns, num_rows) =
-      open_parquet_table(file_path, infile, reader, table);
+      open_parquet_table(file_path, infile, reader, schema);
   // make up header line if not yet
   if (0 == raw_data.size()) {
     copy_params.has_header = ImportHeaderRow::HAS_HEADER;
@@ -2934,7 +3055,7 @@ void Detector::import_local_parquet(const std::string& file_path) {
       if (c) {
         raw_data += copy_params.delimiter;
       }
-      raw_data += table->column(c)->name();
+      raw_data += schema->field(c)->name();
     }
     raw_data += copy_params.line_delim;
   }
@@ -2949,7 +3070,8 @@ void Detector::import_local_parquet(const std::string& file_path) {
       PARQUET_THROW_NOT_OK(reader->RowGroup(g)->Column(c)->Read(&arrays[c]));
       getters.push_back(value_getter(*arrays[c], nullptr, nullptr));
     }
-    for (int r = 0; r < num_rows; ++r) {
+    const int64_t num_group_rows = num_columns ? arrays[0]->length() : 0;
+    for (int64_t r = 0; r < num_group_rows; ++r) {
       for (int c = 0; c < num_columns; ++c) {
         std::vector<std::string> buffer;
         DataBuffer<std::string> data(&cd, *arrays[c], buffer, nullptr);
@@ -2977,128 +3099,191 @@ void Importer::import_local_parquet(const std::string& file_path) {
 
   std::shared_ptr<arrow::io::ReadableFile> infile;
   std::unique_ptr<parquet::arrow::FileReader> reader;
-  std::shared_ptr<arrow::Table> table;
-  int num_row_groups, num_columns;
+  std::shared_ptr<arrow::Schema> schema;
+  int num_row_groups, num_file_columns;
   int64_t num_rows;
-  std::tie(num_row_groups, num_columns, num_rows) =
-      open_parquet_table(file_path, infile, reader, table);
+  std::tie(num_row_groups, num_file_columns, num_rows) =
+      open_parquet_table(file_path, infile, reader, schema);
 
   // column_list has no $deleted
-  CHECK_EQ(num_columns, column_list.size());
-  std::vector<const ColumnDescriptor*> cds;
-  for (auto& cd : column_list) {
-    cds.push_back(cd);
+  std::vector<const ColumnDescriptor*> cds(column_list.begin(), column_list.end());
+  const int num_columns = cds.size();
+  // Only the file columns of the table are read, looked up by name. A file which
+  // doesn't have all of them by name must have exactly the columns of the table.
+  std::vector<int> file_columns;
+  std::string missing_column;
+  for (const auto cd : cds) {
+    const auto file_column = schema->GetFieldIndex(cd->columnName);
+    if (file_column < 0) {
+      missing_column = cd->columnName;
+      file_columns.clear();
+      break;
+    }
+    file_columns.push_back(file_column);
   }
-
-  std::vector<std::vector<size_t>> nrow(num_row_groups, std::vector<size_t>(num_columns));
-  std::vector<std::unique_ptr<std::atomic<exprtype(num_columns)>>> ncol(num_row_groups);
-  for (auto& p : ncol) {
-    p = std::make_unique<std::atomic<exprtype(num_columns)>>(0);
+  if (file_columns.empty()) {
+    if (num_file_columns != num_columns) {
+      throw std::runtime_error("Parquet file " + file_path + " has no column " +
+                               missing_column + " and its " +
+                               std::to_string(num_file_columns) +
+                               " columns can't be mapped by position to the " +
+                               std::to_string(num_columns) + " columns of the table");
+    }
+    for (int column = 0; column < num_columns; ++column) {
+      file_columns.push_back(column);
+    }
   }
 
-  // orient import_buffers_vec in rowgroup wise not thread wise
-  import_buffers_vec.resize(num_row_groups);
-  for (auto g = 0; g < num_row_groups; g++) {
+  // The row groups are decoded in a window of slots, one row group per slot. The
+  // oldest row group is loaded once all its columns are decoded and its slot reused
+  // for the next one, which bounds the memory to the window rather than the file.
+  const int num_slots =
+      std::max(1, std::min(num_row_groups, int(max_threads) / num_columns + 2));
+  std::vector<std::vector<size_t>> nrow(num_slots, std::vector<size_t>(num_columns));
+  std::vector<int> ncol(num_slots, 0);
+  std::mutex ncol_mutex;
+  std::condition_variable ncol_condv;
+
+  // orient import_buffers_vec in slot wise not thread wise
+  import_buffers_vec.resize(num_slots);
+  for (auto& import_buffers : import_buffers_vec) {
     // unlike csv import that acts as one single stream and initialize this only once,
     // parquet import initialize this for each file, so must clear this
-    import_buffers_vec[g].clear();
+    import_buffers.clear();
     for (const auto cd : cds) {
-      import_buffers_vec[g].emplace_back(
-          new TypedImportBuffer(cd, loader->get_string_dict(cd)));
+      import_buffers.emplace_back(new TypedImportBuffer(cd, loader->get_string_dict(cd)));
     }
   }
 
-  auto flush_row_groups = [&]() {
-    for (auto g = 0; g < num_row_groups; ++g) {
-      if (num_columns == *ncol[g]) {
-        *ncol[g] = 0;
-        load(import_buffers_vec[g], nrow[g][0]);
-      }
-    }
-  };
-
   ThreadController_NS::SimpleRunningThreadController<void> running_thread_controller(
       max_threads);
-  std::vector<BadRowsTracker> bad_rows_trackers(num_row_groups);
-  for (size_t row_group = 0; row_group < bad_rows_trackers.size(); ++row_group) {
-    auto& bad_rows_tracker = bad_rows_trackers[row_group];
-    bad_rows_tracker.ncol = num_columns;
+  std::vector<BadRowsTracker> bad_rows_trackers(num_slots);
+  for (auto& bad_rows_tracker : bad_rows_trackers) {
     bad_rows_tracker.file_name = file_path;
-    bad_rows_tracker.row_group = row_group;
     bad_rows_tracker.running_thread_controller = &running_thread_controller;
   }
 
+  // waits for the row group of the slot to be decoded, loads it and empties the slot
+  auto flush_slot = [&](const int slot) {
+    {
+      std::unique_lock<std::mutex> lock(ncol_mutex);
+      ncol_condv.wait(lock, [&] { return num_columns == ncol[slot]; });
+      ncol[slot] = 0;
+    }
+    if (!load_failed) {
+      load(import_buffers_vec[slot], nrow[slot][0]);
+    }
+    for (auto& import_buffer : import_buffers_vec[slot]) {
+      import_buffer->clear();
+    }
+  };
+
   const auto filesize = get_filesize(file_path);
   size_t rows_completed{0};
   file_offsets.push_back(0);
 
   auto ms_load_a_file = measure<>::execution([&]() {
-    const auto work_for_all = num_row_groups * num_columns;
-    for (auto iwork = 0; iwork < work_for_all && !load_failed; ++iwork) {
-      const auto row_group = iwork / num_columns;
-      const auto column = iwork % num_columns;
-      const auto cd = cds[column];
-      running_thread_controller.startThread([=,
-                                             &ncol,
-                                             &nrow,
-                                             &reader,
-                                             &bad_rows_trackers,
-                                             &rows_completed,
-                                             &running_thread_controller] {
-        std::shared_ptr<arrow::Array> array;
-        PARQUET_THROW_NOT_OK(reader->RowGroup(row_group)->Column(column)->Read(&array));
-        /*
-         * A caveat here is: Parquet files or arrow data is imported column wise.
-         * Unlike importing row-wise csv files, a error on any row of any column
-         * forces to give up entire row group of all columns, unless there is a
-         * sophisticated method to trace erroneous rows in individual columns so that
-         * we can union bad rows and drop them from corresponding import_buffers_vec;
-         * otherwise, we may exceed maximum number of truncated rows easily even with
-         * very sparse errors in the files.
-         */
-        auto& bad_rows_tracker = bad_rows_trackers[row_group];
-        nrow[row_group][column] = import_buffers_vec[row_group][column]->add_arrow_values(
-            cd, *array, false, &bad_rows_tracker);
-        ++*ncol[row_group];
-        if (0 == column) {
-          const auto ndrop = array->length() - nrow[row_group][0];
-          LOG(INFO) << "row group " << row_group << ": add " << nrow[row_group][0]
-                    << " rows, drop " << ndrop << " rows.";
-          mapd_lock_guard<mapd_shared_mutex> write_lock(status_mutex);
-          import_status.rows_completed += nrow[row_group][0];
-          import_status.rows_rejected += ndrop;
-          if (import_status.rows_rejected > copy_params.max_reject) {
-            import_status.load_truncated = true;
-            load_failed = true;
-            LOG(ERROR) << "Maximum (" << copy_params.max_reject
-                       << ") rows rejected exceeded. Halting load.";
-          }
-          // row estimate
-          std::unique_lock<std::mutex> lock(file_offsets_mutex);
-          rows_completed += nrow[row_group][0];
-          file_offsets.back() =
-              num_rows ? (float)filesize * rows_completed / num_rows : 0;
-          // sum up current total file offsets
-          size_t total_file_offset{0};
-          for (const auto file_offset : file_offsets) {
-            total_file_offset += file_offset;
+    int row_group = 0;
+    for (; row_group < num_row_groups && !load_failed; ++row_group) {
+      const auto slot = row_group % num_slots;
+      if (row_group >= num_slots) {
+        flush_slot(slot);
+      }
+      auto& bad_rows_tracker = bad_rows_trackers[slot];
+      bad_rows_tracker.rows.clear();
+      bad_rows_tracker.ncol = num_columns;
+      bad_rows_tracker.row_group = row_group;
+      // all the columns of a row group are started, they wait for each other
+      for (int column = 0; column < num_columns; ++column) {
+        const auto cd = cds[column];
+        const auto file_column = file_columns[column];
+        running_thread_controller.startThread([=,
+                                               &ncol,
+                                               &ncol_mutex,
+                                               &ncol_condv,
+                                               &nrow,
+                                               &reader,
+                                               &bad_rows_trackers,
+                                               &rows_completed,
+                                               &running_thread_controller] {
+          auto& bad_rows_tracker = bad_rows_trackers[slot];
+          ScopeGuard column_done = [&] {
+            std::lock_guard<std::mutex> lock(ncol_mutex);
+            ++ncol[slot];
+            ncol_condv.notify_all();
+          };
+          std::shared_ptr<arrow::Array> array;
+          try {
+            PARQUET_THROW_NOT_OK(
+                reader->RowGroup(row_group)->Column(file_column)->Read(&array));
+          } catch (...) {
+            {
+              mapd_lock_guard<mapd_shared_mutex> write_lock(status_mutex);
+              load_failed = true;
+            }
+            // release the other columns of the row group waiting for this one
+            running_thread_controller.notify_thread_is_completed();
+            {
+              std::lock_guard<std::mutex> lock(bad_rows_tracker.mutex);
+              --bad_rows_tracker.ncol;
+            }
+            bad_rows_tracker.condv.notify_all();
+            throw;
           }
-          // estimate number of rows per current total file offset
-          if (total_file_offset) {
-            import_status.rows_estimated =
-                (float)total_file_size / total_file_offset * import_status.rows_completed;
-            VLOG(3) << "rows_completed " << import_status.rows_completed
-                    << ", rows_estimated " << import_status.rows_estimated
-                    << ", total_file_size " << total_file_size << ", total_file_offset "
-                    << total_file_offset;
+          /*
+           * A caveat here is: Parquet files or arrow data is imported column wise.
+           * Unlike importing row-wise csv files, a error on any row of any column
+           * forces to give up entire row group of all columns, unless there is a
+           * sophisticated method to trace erroneous rows in individual columns so that
+           * we can union bad rows and drop them from corresponding import_buffers_vec;
+           * otherwise, we may exceed maximum number of truncated rows easily even with
+           * very sparse errors in the files.
+           */
+          nrow[slot][column] = import_buffers_vec[slot][column]->add_arrow_values(
+              cd, *array, false, &bad_rows_tracker);
+          if (0 == column) {
+            const auto ndrop = array->length() - nrow[slot][0];
+            LOG(INFO) << "row group " << row_group << ": add " << nrow[slot][0]
+                      << " rows, drop " << ndrop << " rows.";
+            mapd_lock_guard<mapd_shared_mutex> write_lock(status_mutex);
+            import_status.rows_completed += nrow[slot][0];
+            import_status.rows_rejected += ndrop;
+            if (import_status.rows_rejected > copy_params.max_reject) {
+              import_status.load_truncated = true;
+              load_failed = true;
+              LOG(ERROR) << "Maximum (" << copy_params.max_reject
+                         << ") rows rejected exceeded. Halting load.";
+            }
+            // row estimate
+            std::unique_lock<std::mutex> lock(file_offsets_mutex);
+            rows_completed += nrow[slot][0];
+            file_offsets.back() =
+                num_rows ? (float)filesize * rows_completed / num_rows : 0;
+            // sum up current total file offsets
+            size_t total_file_offset{0};
+            for (const auto file_offset : file_offsets) {
+              total_file_offset += file_offset;
+            }
+            // estimate number of rows per current total file offset
+            if (total_file_offset) {
+              import_status.rows_estimated = (float)total_file_size /
+                                             total_file_offset *
+                                             import_status.rows_completed;
+              VLOG(3) << "rows_completed " << import_status.rows_completed
+                      << ", rows_estimated " << import_status.rows_estimated
+                      << ", total_file_size " << total_file_size
+                      << ", total_file_offset " << total_file_offset;
+            }
           }
-        }
-      });
-      running_thread_controller.checkThreadsStatus();
-      flush_row_groups();
+        });
+        running_thread_controller.checkThreadsStatus();
+      }
     }
     running_thread_controller.finish();
-    flush_row_groups();
+    // load the row groups still in the window, oldest first
+    for (int g = std::max(0, row_group - num_slots); g < row_group; ++g) {
+      flush_slot(g % num_slots);
+    }
   });
   LOG(INFO) << "Import " << num_rows << " rows of parquet file " << file_path << " took "
             << (double)ms_load_a_file / 1000.0 << " secs";
@@ -3524,13 +3709,12 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
         // additional cost here is ~1.4ms per chunk and
         // probably free because this thread will spend
         // most of its time waiting for the child threads
-        char* p = scratch_buffer.get() + begin_pos;
-        char* pend = scratch_buffer.get() + end_pos;
-        char d = copy_params.line_delim;
-        while (p < pend) {
-          if (*p++ == d) {
-            num_rows_this_buffer++;
-          }
+        const char* p = scratch_buffer.get() + begin_pos;
+        const char* pend = scratch_buffer.get() + end_pos;
+        const char d = copy_params.line_delim;
+        while ((p = static_cast<const char*>(memchr(p, d, pend - p)))) {
+          num_rows_this_buffer++;
+          p++;
         }
       }
 
@@ -3605,8 +3789,10 @@ ImportStatus Importer::importDelimited(const std::string& file_path,
           }
         }
 
-        if (nready == 0) {
-          std::this_thread::yield();
+        // nothing to do until a thread is done, sleep on the oldest one rather than
+        // spinning on a core the import threads could use
+        if (nready == 0 && (0 == size || threads.size() >= max_threads)) {
+          threads.front().wait_for(std::chrono::milliseconds(1));
         }
 
         // on eof, wait all threads to finish
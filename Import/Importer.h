@@ -388,6 +388,9 @@ class TypedImportBuffer : boost::noncopyable {
   StringDictionary* getStringDictionary() const { return string_dict_; }
 
   int8_t* getAsBytes() const {
+    if (borrowed_values_) {
+      return const_cast<int8_t*>(borrowed_values_);
+    }
     switch (column_desc_->columnType.get_type()) {
       case kBOOLEAN:
         return reinterpret_cast<int8_t*>(&((*bool_buffer_)[0]));
@@ -475,6 +478,7 @@ class TypedImportBuffer : boost::noncopyable {
   }
 
   void clear() {
+    borrowed_values_ = nullptr;
     switch (column_desc_->columnType.get_type()) {
       case kBOOLEAN: {
         bool_buffer_->clear();
@@ -558,6 +562,11 @@ class TypedImportBuffer : boost::noncopyable {
                           const bool exact_type_match,
                           BadRowsTracker* bad_rows_tracker);
 
+  // Makes the buffer refer to the values of the array rather than copy them, for an
+  // empty buffer and an array which has the physical type of the column and no nulls.
+  // The array must stay alive until the buffer is loaded or cleared.
+  bool borrow_arrow_values(const ColumnDescriptor* cd, const arrow::Array& data);
+
   void add_value(const ColumnDescriptor* cd,
                  const std::string& val,
                  const bool is_null,
@@ -597,6 +606,8 @@ class TypedImportBuffer : boost::noncopyable {
   const ColumnDescriptor* column_desc_;
   StringDictionary* string_dict_;
   size_t replicate_count_ = 0;
+  // values borrowed from an arrow array, in place of the typed buffer
+  const int8_t* borrowed_values_ = nullptr;
 };
 
 class Loader {
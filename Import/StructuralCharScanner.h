@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    StructuralCharScanner.h
+ * @brief   Finds the next delimiter, quote, escape or line ending in delimited text.
+ *
+ * The bytes of the fields themselves never change the state of the row parser, which
+ * only needs to look at the structural characters. These are searched for sixteen
+ * bytes at a time with SSE2, a byte at a time through a lookup table otherwise.
+ */
+
+#ifndef IMPORT_STRUCTURALCHARSCANNER_H
+#define IMPORT_STRUCTURALCHARSCANNER_H
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Importer_NS {
+
+class StructuralCharScanner {
+ public:
+  static constexpr size_t kMaxChars = 8;
+
+  explicit StructuralCharScanner(const std::string& chars) : num_chars_(0) {
+    is_structural_.fill(false);
+    for (const auto c : chars) {
+      const auto idx = static_cast<unsigned char>(c);
+      if (is_structural_[idx]) {
+        continue;
+      }
+      CHECK_LT(num_chars_, kMaxChars);
+      is_structural_[idx] = true;
+#ifdef __SSE2__
+      needles_[num_chars_] = _mm_set1_epi8(c);
+#endif
+      ++num_chars_;
+    }
+    CHECK_GT(num_chars_, size_t(0));
+  }
+
+  bool isStructural(const char c) const {
+    return is_structural_[static_cast<unsigned char>(c)];
+  }
+
+  // The first structural character in [p, end), end if there is none.
+  const char* find(const char* p, const char* end) const {
+#ifdef __SSE2__
+    for (; end - p >= 16; p += 16) {
+      const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      auto matches = _mm_cmpeq_epi8(block, needles_[0]);
+      for (size_t i = 1; i < num_chars_; ++i) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles_[i]));
+      }
+      const int mask = _mm_movemask_epi8(matches);
+      if (mask) {
+        return p + __builtin_ctz(mask);
+      }
+    }
+#endif
+    for (; p < end && !isStructural(*p); ++p) {
+    }
+    return p;
+  }
+
+ private:
+  std::array<bool, 256> is_structural_;
+  size_t num_chars_;
+#ifdef __SSE2__
+  __m128i needles_[kMaxChars];
+#endif
+};
+
+}  // namespace Importer_NS
+
+#endif  // IMPORT_STRUCTURALCHARSCANNER_H
@@ -29,6 +29,7 @@
 #include <thrift/transport/TServerSocket.h>
 
 #include "MapDRelease.h"
+#include "QueryEngine/PersistentCodeCache.h"
 
 #include "Shared/MapDParameters.h"
 #include "Shared/MapDProgramOptions.h"
@@ -52,6 +53,9 @@ using namespace ::apache::thrift::server;
 using namespace ::apache::thrift::transport;
 
 extern bool g_cache_string_hash;
+extern bool g_enable_string_dict_trigram_index;
+extern size_t g_string_dict_predicate_cache_size;
+extern size_t g_string_dict_translation_cache_size;
 extern size_t g_leaf_count;
 
 TableGenerations table_generations_from_thrift(
@@ -264,10 +268,26 @@ void MapDProgramOptions::fillOptions(po::options_description& desc) {
                      po::value<size_t>(&mapd_parameters.gpu_buffer_mem_bytes)
                          ->default_value(mapd_parameters.gpu_buffer_mem_bytes),
                      "Size of memory reserved for GPU buffers [bytes] (per GPU)");
+  desc.add_options()("cpu-buffer-eviction-policy",
+                     po::value<std::string>(&mapd_parameters.cpu_buffer_eviction_policy)
+                         ->default_value(mapd_parameters.cpu_buffer_eviction_policy),
+                     "Eviction policy of the CPU buffer pool: lru or the scan resistant "
+                     "2q");
+  desc.add_options()("gpu-buffer-eviction-policy",
+                     po::value<std::string>(&mapd_parameters.gpu_buffer_eviction_policy)
+                         ->default_value(mapd_parameters.gpu_buffer_eviction_policy),
+                     "Eviction policy of the GPU buffer pools: lru or the scan resistant "
+                     "2q");
   desc.add_options()("calcite-max-mem",
                      po::value<size_t>(&mapd_parameters.calcite_max_mem)
                          ->default_value(mapd_parameters.calcite_max_mem),
                      "Max memory available to calcite JVM");
+  desc.add_options()("calcite-plan-cache-size",
+                     po::value<size_t>(&mapd_parameters.calcite_plan_cache_size)
+                         ->default_value(mapd_parameters.calcite_plan_cache_size),
+                     "Size in bytes of the relational algebra returned by calcite kept "
+                     "for the repeated queries, which may differ in their literals. 0 "
+                     "disables the cache.");
   desc.add_options()(
       "res-gpu-mem",
       po::value<size_t>(&reserved_gpu_mem)->default_value(reserved_gpu_mem),
@@ -462,11 +482,88 @@ void MapDProgramOptions::fillAdvancedOptions(po::options_description& desc_adv)
                              ->implicit_value(true),
                          "Remove quals from the filtered count if they are covered by a "
                          "join condition (currently only ST_Contains)");
+  desc_adv.add_options()(
+      "enable-string-dict-trigram-index",
+      po::value<bool>(&g_enable_string_dict_trigram_index)
+          ->default_value(g_enable_string_dict_trigram_index)
+          ->implicit_value(true),
+      "Narrow down the dictionary scans of LIKE and REGEXP with a trigram index, kept "
+      "next to the dictionary files");
+  desc_adv.add_options()("string-dict-predicate-cache-size",
+                         po::value<size_t>(&g_string_dict_predicate_cache_size)
+                             ->default_value(g_string_dict_predicate_cache_size),
+                         "Size in bytes of the cache of the LIKE and REGEXP results of "
+                         "each string dictionary");
+  desc_adv.add_options()("string-dict-translation-cache-size",
+                         po::value<size_t>(&g_string_dict_translation_cache_size)
+                             ->default_value(g_string_dict_translation_cache_size),
+                         "Size in bytes of the cache of the id translation maps from "
+                         "each string dictionary to the others");
   desc_adv.add_options()("enable-window-functions",
                          po::value<bool>(&g_enable_window_functions)
                              ->default_value(g_enable_window_functions)
                              ->implicit_value(true),
                          "Enable experimental window function support");
+  desc_adv.add_options()("num-executors",
+                         po::value<size_t>(&g_num_executors)
+                             ->default_value(g_num_executors),
+                         "Number of executors per database which can run read-only "
+                         "queries concurrently. CPU worker threads are divided evenly "
+                         "between the running queries.");
+  desc_adv.add_options()("large-scan-row-threshold",
+                         po::value<size_t>(&g_large_scan_row_threshold)
+                             ->default_value(g_large_scan_row_threshold),
+                         "Scans over tables with at least this many rows don't promote "
+                         "the chunks they read to the hot queue of the 2q buffer "
+                         "eviction policy. 0 disables the check.");
+  desc_adv.add_options()("enable-fragment-readahead",
+                         po::value<bool>(&g_enable_fragment_readahead)
+                             ->default_value(g_enable_fragment_readahead)
+                             ->implicit_value(true),
+                         "Read the chunks of the fragments waiting for a CPU kernel "
+                         "slot ahead from disk while the running kernels execute.");
+  desc_adv.add_options()("fragment-prefetch-depth",
+                         po::value<size_t>(&g_fragment_prefetch_depth)
+                             ->default_value(g_fragment_prefetch_depth),
+                         "Number of fragments waiting for a CPU kernel slot whose chunks "
+                         "are fetched into the CPU buffer pool while the running kernels "
+                         "execute. 0 disables the prefetch.");
+  desc_adv.add_options()("enable-chunk-sketches",
+                         po::value<bool>(&g_enable_chunk_sketches)
+                             ->default_value(g_enable_chunk_sketches)
+                             ->implicit_value(true),
+                         "Keep a bloom filter and a distinct count sketch of the "
+                         "integer, time and dictionary encoded columns of new chunks, to "
+                         "skip fragments on equality and IN filters and estimate group "
+                         "by cardinalities. Each sketch takes about 132KB, in memory "
+                         "and on disk, per chunk of such a column.");
+  desc_adv.add_options()("enable-result-spill",
+                         po::value<bool>(&g_enable_result_spill)
+                             ->default_value(g_enable_result_spill)
+                             ->implicit_value(true),
+                         "Reduce and sort the results of CPU queries which don't fit in "
+                         "the result spill memory budget through scratch files.");
+  desc_adv.add_options()("result-spill-memory-budget",
+                         po::value<size_t>(&g_result_spill_memory_budget)
+                             ->default_value(g_result_spill_memory_budget),
+                         "Size in bytes of the memory a reduction or a sort of a result "
+                         "set may use before spilling to the scratch files.");
+  desc_adv.add_options()("result-spill-path",
+                         po::value<std::string>(&g_result_spill_path),
+                         "Directory of the result spill scratch files, mapd_spill under "
+                         "the data directory by default.");
+  desc_adv.add_options()("count-distinct-max-bytes",
+                         po::value<size_t>(&g_count_distinct_max_bytes)
+                             ->default_value(g_count_distinct_max_bytes),
+                         "Size in bytes of the COUNT(DISTINCT) bitmaps and hash sets a "
+                         "query may hold, over it the query fails as out of host memory. "
+                         "0 means no limit.");
+  desc_adv.add_options()("persistent-code-cache-size",
+                         po::value<size_t>(&persistent_code_cache_size)
+                             ->default_value(persistent_code_cache_size),
+                         "Size in bytes of the native code of the CPU queries kept in "
+                         "mapd_code_cache under the data directory across restarts, "
+                         "least recently used first out. 0 disables the cache.");
 };
 
 namespace {
@@ -702,6 +799,7 @@ bool MapDProgramOptions::parse_command_line(int argc, char** argv, int& return_c
   LOG(INFO) << " cuda block size " << mapd_parameters.cuda_block_size;
   LOG(INFO) << " cuda grid size  " << mapd_parameters.cuda_grid_size;
   LOG(INFO) << " calcite JVM max memory  " << mapd_parameters.calcite_max_mem;
+  LOG(INFO) << " calcite plan cache size  " << mapd_parameters.calcite_plan_cache_size;
   LOG(INFO) << " OmniSci Server Port  " << mapd_parameters.omnisci_server_port;
   LOG(INFO) << " OmniSci Calcite Port  " << mapd_parameters.calcite_port;
   LOG(INFO) << " Enable Calcite view optimize "
@@ -740,6 +838,15 @@ int main(int argc, char** argv) {
   std::thread file_delete_thread(
       file_delete, std::ref(running), wait_interval, desc_all.base_path + "/mapd_data");
 
+  if (g_result_spill_path.empty()) {
+    g_result_spill_path = desc_all.base_path + "/mapd_spill";
+  }
+
+  if (desc_all.persistent_code_cache_size > 0) {
+    PersistentCodeCache::init(desc_all.base_path + "/mapd_code_cache",
+                              desc_all.persistent_code_cache_size);
+  }
+
   g_mapd_handler = mapd::make_shared<MapDHandler>(desc_all.db_leaves,
                                                   desc_all.string_leaves,
                                                   desc_all.base_path,
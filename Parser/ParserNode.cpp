@@ -44,6 +44,7 @@
 #include "../QueryEngine/Execute.h"
 #include "../QueryEngine/ExtensionFunctionsWhitelist.h"
 #include "../QueryEngine/RelAlgExecutor.h"
+#include "../Shared/Compressor.h"
 #include "../Shared/TimeGM.h"
 #include "../Shared/geo_types.h"
 #include "../Shared/mapd_glob.h"
@@ -2160,6 +2161,30 @@ std::string serialize_key_metainfo(
   return buffer.GetString();
 }
 
+std::string get_page_compression(const NameValueAssign& p, const bool is_temporary) {
+  if (!dynamic_cast<const StringLiteral*>(p.get_value())) {
+    throw std::runtime_error("COMPRESSION must be a string literal.");
+  }
+  const auto compression =
+      static_cast<const StringLiteral*>(p.get_value())->get_stringval();
+  CHECK(compression);
+  const auto compression_lc = boost::to_lower_copy<std::string>(*compression);
+  if (compression_lc == "none") {
+    return "";
+  }
+  if (compression_lc != "lz4" && compression_lc != "lz4hc" && compression_lc != "zstd") {
+    throw std::runtime_error("COMPRESSION must be NONE, LZ4, LZ4HC or ZSTD");
+  }
+  if (BloscCompressor::getCompressorCode(compression_lc) < 0) {
+    throw std::runtime_error("COMPRESSION " + compression_lc +
+                             " is not supported by this server.");
+  }
+  if (is_temporary) {
+    throw std::runtime_error("Temporary tables cannot be compressed.");
+  }
+  return compression_lc;
+}
+
 }  // namespace
 
 void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
@@ -2321,10 +2346,12 @@ void CreateTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
         } else {
           td.hasDeletedCol = true;
         }
+      } else if (boost::iequals(*p->get_name(), "compression")) {
+        td.pageCompression = get_page_compression(*p, is_temporary_);
       } else {
         throw std::runtime_error("Invalid CREATE TABLE option " + *p->get_name() +
                                  ".  Should be FRAGMENT_SIZE, PAGE_SIZE, MAX_ROWS, "
-                                 "PARTITIONS, VACUUM or SHARD_COUNT.");
+                                 "PARTITIONS, VACUUM, SHARD_COUNT or COMPRESSION.");
       }
     }
   }
@@ -2529,11 +2556,13 @@ void CreateTableAsSelectStmt::execute(const Catalog_Namespace::SessionInfo& sess
         } else {
           td.hasDeletedCol = true;
         }
+      } else if (boost::iequals(*p->get_name(), "compression")) {
+        td.pageCompression = get_page_compression(*p, is_temporary_);
       } else {
         throw std::runtime_error(
             "Invalid CREATE TABLE option " + *p->get_name() +
             ".  Should be FRAGMENT_SIZE, PAGE_SIZE, MAX_CHUNK_SIZE, MAX_ROWS, "
-            "PARTITIONS or VACUUM.");
+            "PARTITIONS, VACUUM or COMPRESSION.");
       }
     }
   }
@@ -2875,16 +2904,28 @@ void DDLStmt::setColumnDescriptor(ColumnDescriptor& cd, const ColumnDef* coldef)
         cd.columnType.set_compression(kENCODING_FIXED);
         cd.columnType.set_comp_param(compression->get_encoding_param());
       }
-    } else if (boost::iequals(comp, "rl")) {
-      // run length encoding
-      cd.columnType.set_compression(kENCODING_RL);
-      cd.columnType.set_comp_param(0);
-      // throw std::runtime_error("RL(Run Length) encoding not supported yet.");
-    } else if (boost::iequals(comp, "diff")) {
-      // differential encoding
-      cd.columnType.set_compression(kENCODING_DIFF);
+    } else if (boost::iequals(comp, "rl") || boost::iequals(comp, "diff") ||
+               boost::iequals(comp, "bitpack")) {
+      if (!cd.columnType.is_integer() && !cd.columnType.is_time() &&
+          !cd.columnType.is_decimal()) {
+        throw std::runtime_error(cd.columnName + ": " + comp +
+                                 " encoding is only supported for integer, decimal or "
+                                 "time columns.");
+      }
+      if (compression->get_encoding_param() != 0) {
+        throw std::runtime_error(cd.columnName + ": " + comp +
+                                 " encoding does not take a parameter.");
+      }
+      // run length encoding, differential encoding or frame of reference bit packing,
+      // chunks are appended to as plain values and packed by OPTIMIZE TABLE
+      if (boost::iequals(comp, "rl")) {
+        cd.columnType.set_compression(kENCODING_RL);
+      } else if (boost::iequals(comp, "diff")) {
+        cd.columnType.set_compression(kENCODING_DIFF);
+      } else {
+        cd.columnType.set_compression(kENCODING_BITPACK);
+      }
       cd.columnType.set_comp_param(0);
-      // throw std::runtime_error("DIFF(differential) encoding not supported yet.");
     } else if (boost::iequals(comp, "dict")) {
       if (!cd.columnType.is_string() && !cd.columnType.is_string_array()) {
         throw std::runtime_error(
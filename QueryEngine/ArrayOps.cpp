@@ -225,7 +225,7 @@ extern "C" DEVICE int8_t* array_buff(int8_t* chunk_iter_, const uint64_t row_pos
 
 #ifndef __CUDACC__
 
-#include <set>
+#include "CountDistinctSet.h"
 
 extern "C" ALWAYS_INLINE int64_t elem_bitcast_int8_t(const int8_t val) {
   return val;
@@ -263,7 +263,7 @@ extern "C" ALWAYS_INLINE int64_t elem_bitcast_double(const double val) {
     for (size_t i = 0; i < elem_count; ++i) {                                           \
       const auto val = reinterpret_cast<type*>(ad.pointer)[i];                          \
       if (val != null_val) {                                                            \
-        reinterpret_cast<std::set<int64_t>*>(*agg)->insert(elem_bitcast_##type(val));   \
+        reinterpret_cast<CountDistinctSet*>(*agg)->insert(elem_bitcast_##type(val));    \
       }                                                                                 \
     }                                                                                   \
   }
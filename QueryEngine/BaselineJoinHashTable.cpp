@@ -134,8 +134,7 @@ int64_t BaselineJoinHashTable::getJoinHashBuffer(const ExecutorDeviceType device
 
 BaselineJoinHashTable::CompositeKeyInfo BaselineJoinHashTable::getCompositeKeyInfo(
     const std::vector<InnerOuter>& inner_outer_pairs) const {
-  std::vector<const void*> sd_inner_proxy_per_key;
-  std::vector<const void*> sd_outer_proxy_per_key;
+  std::vector<const void*> sd_translation_map_per_key;
   std::vector<ChunkKey> cache_key_chunks;  // used for the cache key
   for (const auto& inner_outer_pair : inner_outer_pairs) {
     const auto inner_col = inner_outer_pair.first;
@@ -154,16 +153,17 @@ BaselineJoinHashTable::CompositeKeyInfo BaselineJoinHashTable::getCompositeKeyIn
       const auto sd_outer_proxy = executor_->getStringDictionaryProxy(
           outer_ti.get_comp_param(), executor_->getRowSetMemoryOwner(), true);
       CHECK(sd_inner_proxy && sd_outer_proxy);
-      sd_inner_proxy_per_key.push_back(sd_inner_proxy);
-      sd_outer_proxy_per_key.push_back(sd_outer_proxy);
+      sd_translation_map_per_key.push_back(
+          sd_inner_proxy == sd_outer_proxy
+              ? nullptr
+              : sd_inner_proxy->getTranslationMap(sd_outer_proxy));
       cache_key_chunks_for_column.push_back(sd_outer_proxy->getGeneration());
     } else {
-      sd_inner_proxy_per_key.emplace_back();
-      sd_outer_proxy_per_key.emplace_back();
+      sd_translation_map_per_key.emplace_back();
     }
     cache_key_chunks.push_back(cache_key_chunks_for_column);
   }
-  return {sd_inner_proxy_per_key, sd_outer_proxy_per_key, cache_key_chunks};
+  return {sd_translation_map_per_key, cache_key_chunks};
 }
 
 void BaselineJoinHashTable::reify(const int device_count) {
@@ -325,7 +325,6 @@ std::pair<size_t, size_t> BaselineJoinHashTable::approximateTupleCount(
                                 true,
                                 join_columns_gpu,
                                 join_column_types_gpu,
-                                nullptr,
                                 nullptr);
           const auto key_handler_gpu = transfer_object_to_gpu(key_handler, allocator);
           approximate_distinct_tuples_on_device(
@@ -647,8 +646,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(
                                     true,
                                     &join_columns[0],
                                     &join_column_types[0],
-                                    &composite_key_info.sd_inner_proxy_per_key[0],
-                                    &composite_key_info.sd_outer_proxy_per_key[0]);
+                                    &composite_key_info.sd_translation_map_per_key[0]);
               return fill_baseline_hash_join_buff_32(
                   &(*cpu_hash_table_buff_)[0],
                   entry_count_,
@@ -666,8 +664,7 @@ int BaselineJoinHashTable::initHashTableOnCpu(
                                     true,
                                     &join_columns[0],
                                     &join_column_types[0],
-                                    &composite_key_info.sd_inner_proxy_per_key[0],
-                                    &composite_key_info.sd_outer_proxy_per_key[0]);
+                                    &composite_key_info.sd_translation_map_per_key[0]);
               return fill_baseline_hash_join_buff_64(
                   &(*cpu_hash_table_buff_)[0],
                   entry_count_,
@@ -704,33 +701,33 @@ int BaselineJoinHashTable::initHashTableOnCpu(
       case 4: {
         const auto composite_key_dict =
             reinterpret_cast<int32_t*>(&(*cpu_hash_table_buff_)[0]);
-        fill_one_to_many_baseline_hash_table_32(one_to_many_buff,
-                                                composite_key_dict,
-                                                entry_count_,
-                                                -1,
-                                                key_component_count,
-                                                join_columns,
-                                                join_column_types,
-                                                join_bucket_info,
-                                                composite_key_info.sd_inner_proxy_per_key,
-                                                composite_key_info.sd_outer_proxy_per_key,
-                                                thread_count);
+        fill_one_to_many_baseline_hash_table_32(
+            one_to_many_buff,
+            composite_key_dict,
+            entry_count_,
+            -1,
+            key_component_count,
+            join_columns,
+            join_column_types,
+            join_bucket_info,
+            composite_key_info.sd_translation_map_per_key,
+            thread_count);
         break;
       }
       case 8: {
         const auto composite_key_dict =
             reinterpret_cast<int64_t*>(&(*cpu_hash_table_buff_)[0]);
-        fill_one_to_many_baseline_hash_table_64(one_to_many_buff,
-                                                composite_key_dict,
-                                                entry_count_,
-                                                -1,
-                                                key_component_count,
-                                                join_columns,
-                                                join_column_types,
-                                                join_bucket_info,
-                                                composite_key_info.sd_inner_proxy_per_key,
-                                                composite_key_info.sd_outer_proxy_per_key,
-                                                thread_count);
+        fill_one_to_many_baseline_hash_table_64(
+            one_to_many_buff,
+            composite_key_dict,
+            entry_count_,
+            -1,
+            key_component_count,
+            join_columns,
+            join_column_types,
+            join_bucket_info,
+            composite_key_info.sd_translation_map_per_key,
+            thread_count);
         break;
       }
       default:
@@ -792,7 +789,6 @@ int BaselineJoinHashTable::initHashTableOnGpu(
                                              true,
                                              join_columns_gpu,
                                              join_column_types_gpu,
-                                             nullptr,
                                              nullptr);
   const auto key_handler_gpu = transfer_object_to_gpu(key_handler, allocator);
   switch (key_component_width) {
@@ -146,8 +146,8 @@ class BaselineJoinHashTable : public JoinHashTableInterface {
       const std::vector<InnerOuter>& inner_outer_pairs) const;
 
   struct CompositeKeyInfo {
-    std::vector<const void*> sd_inner_proxy_per_key;
-    std::vector<const void*> sd_outer_proxy_per_key;
+    // From the inner to the outer dictionary, null for the keys which aren't strings.
+    std::vector<const void*> sd_translation_map_per_key;
     std::vector<ChunkKey> cache_key_chunks;  // used for the cache key
   };
 
@@ -18,6 +18,53 @@
 #include "ExpressionRewrite.h"
 #include "RelAlgExecutor.h"
 
+#include "../DataMgr/ChunkSketch.h"
+
+namespace {
+
+// Number of distinct group by keys from the chunk sketches of the key columns, 0 unless
+// the query groups the unfiltered rows of a single table by columns which have sketches
+// for all their chunks. Tuples of several columns get the product of their estimates.
+size_t get_ndv_from_chunk_sketches(const RelAlgExecutionUnit& ra_exe_unit,
+                                   const std::vector<InputTableInfo>& table_infos) {
+  if (ra_exe_unit.input_descs.size() != 1 || table_infos.size() != 1 ||
+      ra_exe_unit.input_descs.front().getSourceType() != InputSourceType::TABLE ||
+      !ra_exe_unit.simple_quals.empty() || !ra_exe_unit.quals.empty() ||
+      !ra_exe_unit.join_quals.empty() || ra_exe_unit.groupby_exprs.empty()) {
+    return 0;
+  }
+  size_t ndv{1};
+  for (const auto& groupby_expr : ra_exe_unit.groupby_exprs) {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(groupby_expr.get());
+    if (!col_var || dynamic_cast<const Analyzer::Var*>(col_var) ||
+        col_var->get_rte_idx()) {
+      return 0;
+    }
+    std::vector<uint8_t> registers;
+    bool has_nulls{false};
+    for (const auto& fragment : table_infos.front().info.fragments) {
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+      const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+      if (chunk_meta_it == chunk_metadata_map.end() || !chunk_meta_it->second.sketch) {
+        return 0;
+      }
+      ChunkSketch::mergeDistinctRegisters(
+          registers, chunk_meta_it->second.sketch->getDistinctRegisters());
+      has_nulls = has_nulls || chunk_meta_it->second.chunkStats.has_nulls;
+    }
+    if (registers.empty()) {
+      return 0;
+    }
+    const auto col_ndv = ChunkSketch::estimateDistinct(registers) + (has_nulls ? 1 : 0);
+    ndv = col_ndv && ndv > std::numeric_limits<size_t>::max() / col_ndv
+              ? std::numeric_limits<size_t>::max()
+              : ndv * col_ndv;
+  }
+  return ndv;
+}
+
+}  // namespace
+
 size_t ResultSet::getNDVEstimator() const {
   CHECK(dynamic_cast<const Analyzer::NDVEstimator*>(estimator_.get()));
   CHECK(host_estimator_buffer_);
@@ -36,6 +83,12 @@ size_t RelAlgExecutor::getNDVEstimation(const WorkUnit& work_unit,
                                         const bool is_agg,
                                         const CompilationOptions& co,
                                         const ExecutionOptions& eo) {
+  const auto sketch_ndv = get_ndv_from_chunk_sketches(
+      work_unit.exe_unit, get_table_infos(work_unit.exe_unit, executor_));
+  if (sketch_ndv) {
+    VLOG(1) << "Cardinality estimation from chunk sketches: " << sketch_ndv;
+    return sketch_ndv;
+  }
   const auto estimator_exe_unit = create_ndv_execution_unit(work_unit.exe_unit);
   int32_t error_code{0};
   size_t one{1};
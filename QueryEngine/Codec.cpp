@@ -71,6 +71,23 @@ llvm::Instruction* DiffFixedWidthInt::codegenDecode(llvm::Value* byte_stream,
   return llvm::CallInst::Create(f, args);
 }
 
+PackedInt::PackedInt(const size_t byte_width, const int64_t null_val)
+    : byte_width_{byte_width}, null_val_{null_val} {}
+
+llvm::Instruction* PackedInt::codegenDecode(llvm::Value* byte_stream,
+                                            llvm::Value* pos,
+                                            llvm::Module* module) const {
+  auto& context = getGlobalLLVMContext();
+  auto f = module->getFunction("packed_int_decode");
+  CHECK(f);
+  llvm::Value* args[] = {
+      byte_stream,
+      llvm::ConstantInt::get(llvm::Type::getInt32Ty(context), byte_width_),
+      llvm::ConstantInt::get(llvm::Type::getInt64Ty(context), null_val_),
+      pos};
+  return llvm::CallInst::Create(f, args);
+}
+
 FixedWidthReal::FixedWidthReal(const bool is_double) : is_double_(is_double) {}
 
 llvm::Instruction* FixedWidthReal::codegenDecode(llvm::Value* byte_stream,
@@ -65,6 +65,19 @@ class DiffFixedWidthInt : public Decoder {
   const int64_t baseline_;
 };
 
+// Run length encoded, delta encoded or bit packed integers, the chunk header tells which.
+class PackedInt : public Decoder {
+ public:
+  PackedInt(const size_t byte_width, const int64_t null_val);
+  llvm::Instruction* codegenDecode(llvm::Value* byte_stream,
+                                   llvm::Value* pos,
+                                   llvm::Module* module) const override;
+
+ private:
+  const size_t byte_width_;
+  const int64_t null_val_;
+};
+
 class FixedWidthReal : public Decoder {
  public:
   FixedWidthReal(const bool is_double);
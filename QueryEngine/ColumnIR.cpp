@@ -72,6 +72,16 @@ std::shared_ptr<Decoder> get_col_decoder(const Analyzer::ColumnVar* col_var) {
       return col_var->get_comp_param() == 16 ? std::make_shared<FixedWidthSmallDate>(2)
                                              : std::make_shared<FixedWidthSmallDate>(4);
     }
+    case kENCODING_RL:
+    case kENCODING_DIFF:
+    case kENCODING_BITPACK: {
+      // Only the chunks of the tables are packed, the columnarized intermediate
+      // results hold the plain values.
+      if (col_var->get_table_id() < 0) {
+        return std::make_shared<FixedWidthInt>(ti.get_size());
+      }
+      return std::make_shared<PackedInt>(ti.get_size(), inline_int_null_val(ti));
+    }
     default:
       abort();
   }
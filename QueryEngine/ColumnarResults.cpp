@@ -17,6 +17,8 @@
 #include "ColumnarResults.h"
 #include "ResultRows.h"
 
+#include "../DataMgr/PackedIntCodec.h"
+#include "../Shared/TaskPool.h"
 #include "../Shared/thread_count.h"
 
 #include <atomic>
@@ -26,7 +28,7 @@
 namespace {
 
 int64_t fixed_encoding_nullable_val(const int64_t val, const SQLTypeInfo& type_info) {
-  if (type_info.get_compression() != kENCODING_NONE) {
+  if (type_info.get_compression() != kENCODING_NONE && !type_info.is_packed_int()) {
     CHECK(type_info.get_compression() == kENCODING_FIXED ||
           type_info.get_compression() == kENCODING_DICT);
     auto logical_ti = get_logical_type_info(type_info);
@@ -48,7 +50,8 @@ ColumnarResults::ColumnarResults(
     , num_rows_(use_parallel_algorithms(rows) || rows.isFastColumnarConversionPossible()
                     ? rows.entryCount()
                     : rows.rowCount())
-    , target_types_(target_types) {
+    , target_types_(target_types)
+    , has_chunk_headers_(false) {
   column_buffers_.resize(num_columns);
   for (size_t i = 0; i < num_columns; ++i) {
     const bool is_varlen = target_types[i].is_array() ||
@@ -75,7 +78,7 @@ ColumnarResults::ColumnarResults(
   } else {
     if (use_parallel_algorithms(rows)) {
       const size_t worker_count = cpu_threads();
-      std::vector<std::future<void>> conversion_threads;
+      std::vector<TaskPool_NS::TaskFuture<void>> conversion_threads;
       const auto entry_count = rows.entryCount();
       for (size_t i = 0,
                   start_entry = 0,
@@ -83,18 +86,17 @@ ColumnarResults::ColumnarResults(
            i < worker_count && start_entry < entry_count;
            ++i, start_entry += stride) {
         const auto end_entry = std::min(start_entry + stride, entry_count);
-        conversion_threads.push_back(
-            std::async(std::launch::async,
-                       [&rows, &do_work, &row_idx](const size_t start, const size_t end) {
-                         for (size_t i = start; i < end; ++i) {
-                           const auto crt_row = rows.getRowAtNoTranslations(i);
-                           if (!crt_row.empty()) {
-                             do_work(crt_row, row_idx.fetch_add(1));
-                           }
-                         }
-                       },
-                       start_entry,
-                       end_entry));
+        conversion_threads.push_back(TaskPool_NS::async(
+            [&rows, &do_work, &row_idx](const size_t start, const size_t end) {
+              for (size_t i = start; i < end; ++i) {
+                const auto crt_row = rows.getRowAtNoTranslations(i);
+                if (!crt_row.empty()) {
+                  do_work(crt_row, row_idx.fetch_add(1));
+                }
+              }
+            },
+            start_entry,
+            end_entry));
       }
       for (auto& child : conversion_threads) {
         child.wait();
@@ -123,7 +125,10 @@ ColumnarResults::ColumnarResults(
     const int8_t* one_col_buffer,
     const size_t num_rows,
     const SQLTypeInfo& target_type)
-    : column_buffers_(1), num_rows_(num_rows), target_types_{target_type} {
+    : column_buffers_(1)
+    , num_rows_(num_rows)
+    , target_types_{target_type}
+    , has_chunk_headers_(target_type.is_packed_int()) {
   const bool is_varlen =
       target_type.is_array() ||
       (target_type.is_string() && target_type.get_compression() == kENCODING_NONE) ||
@@ -131,6 +136,21 @@ ColumnarResults::ColumnarResults(
   if (is_varlen) {
     throw ColumnarConversionNotSupported();
   }
+  if (target_type.is_packed_int()) {
+    // Still a column of the table for the kernels, decode it into a plain chunk.
+    auto col_buffer = reinterpret_cast<int8_t*>(
+        checked_malloc(PACKED_INT_HEADER_SIZE + num_rows * target_type.get_size()));
+    const PackedIntChunkHeader header{kPACKED_RAW, 0, 0};
+    memcpy(col_buffer, &header, sizeof(header));
+    unpack_int_chunk(col_buffer + PACKED_INT_HEADER_SIZE,
+                     one_col_buffer,
+                     num_rows,
+                     target_type.get_size(),
+                     inline_int_null_val(target_type));
+    column_buffers_[0] = col_buffer;
+    row_set_mem_owner->addColBuffer(column_buffers_[0]);
+    return;
+  }
   const auto buf_size = num_rows * target_type.get_size();
   column_buffers_[0] = reinterpret_cast<const int8_t*>(checked_malloc(buf_size));
   memcpy(((void*)column_buffers_[0]), one_col_buffer, buf_size);
@@ -152,6 +172,7 @@ std::unique_ptr<ColumnarResults> ColumnarResults::mergeResults(
       });
   std::unique_ptr<ColumnarResults> merged_results(
       new ColumnarResults(total_row_count, sub_results[0]->target_types_));
+  merged_results->has_chunk_headers_ = sub_results[0]->has_chunk_headers_;
   const auto col_count = sub_results[0]->column_buffers_.size();
   const auto nonempty_it = std::find_if(
       sub_results.begin(),
@@ -162,17 +183,23 @@ std::unique_ptr<ColumnarResults> ColumnarResults::mergeResults(
   }
   for (size_t col_idx = 0; col_idx < col_count; ++col_idx) {
     const auto byte_width = (*nonempty_it)->getColumnType(col_idx).get_size();
-    auto write_ptr =
-        reinterpret_cast<int8_t*>(checked_malloc(byte_width * total_row_count));
+    // The fragments of packed columns are plain chunks, merge them into a single one.
+    const auto header_size = (*nonempty_it)->getColumnHeaderSize(col_idx);
+    auto write_ptr = reinterpret_cast<int8_t*>(
+        checked_malloc(header_size + byte_width * total_row_count));
     merged_results->column_buffers_.push_back(write_ptr);
     row_set_mem_owner->addColBuffer(write_ptr);
+    memcpy(write_ptr, (*nonempty_it)->column_buffers_[col_idx], header_size);
+    write_ptr += header_size;
     for (auto& rs : sub_results) {
       CHECK_EQ(col_count, rs->column_buffers_.size());
       if (!rs->size()) {
         continue;
       }
       CHECK_EQ(byte_width, rs->getColumnType(col_idx).get_size());
-      memcpy(write_ptr, rs->column_buffers_[col_idx], rs->size() * byte_width);
+      memcpy(write_ptr,
+             rs->column_buffers_[col_idx] + header_size,
+             rs->size() * byte_width);
       write_ptr += rs->size() * byte_width;
     }
   }
@@ -273,11 +300,10 @@ void ColumnarResults::copyAllNonLazyColumns(
   };
 
   // parallelized by assigning each column to a thread
-  std::vector<std::future<void>> direct_copy_threads;
+  std::vector<TaskPool_NS::TaskFuture<void>> direct_copy_threads;
   for (size_t col_idx = 0; col_idx < num_columns; col_idx++) {
     if (is_column_non_lazily_fetched(col_idx)) {
-      direct_copy_threads.push_back(std::async(
-          std::launch::async,
+      direct_copy_threads.push_back(TaskPool_NS::async(
           [&rows, this](const size_t column_index) {
             const size_t column_size = num_rows_ * target_types_[column_index].get_size();
             rows.copyColumnIntoBuffer(column_index,
@@ -335,7 +361,7 @@ void ColumnarResults::materializeAllLazyColumns(
   const bool skip_non_lazy_columns = rows.isPermutationBufferEmpty() ? true : false;
   if (contains_lazy_fetched_column(lazy_fetch_info)) {
     const size_t worker_count = use_parallel_algorithms(rows) ? cpu_threads() : 1;
-    std::vector<std::future<void>> conversion_threads;
+    std::vector<TaskPool_NS::TaskFuture<void>> conversion_threads;
     const auto entry_count = rows.entryCount();
     for (size_t i = 0,
                 start_entry = 0,
@@ -343,8 +369,7 @@ void ColumnarResults::materializeAllLazyColumns(
          i < worker_count && start_entry < entry_count;
          ++i, start_entry += stride) {
       const auto end_entry = std::min(start_entry + stride, entry_count);
-      conversion_threads.push_back(std::async(
-          std::launch::async,
+      conversion_threads.push_back(TaskPool_NS::async(
           [&rows, &do_work_just_lazy_columns, &lazy_fetch_info](
               const size_t start, const size_t end, const bool skip_non_lazy_columns) {
             for (size_t i = start; i < end; ++i) {
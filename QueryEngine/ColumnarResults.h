@@ -19,6 +19,7 @@
 #include "ResultSet.h"
 #include "Shared/SqlTypesLayout.h"
 
+#include "../DataMgr/PackedIntChunk.h"
 #include "../Shared/checked_alloc.h"
 
 #include <memory>
@@ -57,9 +58,16 @@ class ColumnarResults {
     return target_types_[col_id];
   }
 
+  // The buffers of packed columns of a table are plain chunks which start with a header.
+  size_t getColumnHeaderSize(const int col_id) const {
+    return has_chunk_headers_ && getColumnType(col_id).is_packed_int()
+               ? PACKED_INT_HEADER_SIZE
+               : 0;
+  }
+
  private:
   ColumnarResults(const size_t num_rows, const std::vector<SQLTypeInfo>& target_types)
-      : num_rows_(num_rows), target_types_(target_types) {}
+      : num_rows_(num_rows), target_types_(target_types), has_chunk_headers_(false) {}
   inline void writeBackCell(const TargetValue& col_val,
                             const size_t row_idx,
                             const size_t column_idx);
@@ -74,6 +82,7 @@ class ColumnarResults {
   std::vector<const int8_t*> column_buffers_;
   size_t num_rows_;
   const std::vector<SQLTypeInfo> target_types_;
+  bool has_chunk_headers_;
 };
 
 typedef std::
@@ -222,6 +222,13 @@ llvm::Value* Executor::codegenCmp(const Analyzer::BinOper* bin_oper,
     }
   }
 
+  if (lhs_ti.is_string() && rhs_ti.is_string() && (optype == kEQ || optype == kNE)) {
+    auto cmp_translated = codegenTranslatedDictStrCmp(optype, lhs, rhs, co);
+    if (cmp_translated) {
+      return cmp_translated;
+    }
+  }
+
   if (lhs_ti.is_decimal()) {
     auto cmp_decimal_const =
         codegenCmpDecimalConst(optype, qualifier, lhs, lhs_ti, rhs, co);
@@ -234,6 +241,45 @@ llvm::Value* Executor::codegenCmp(const Analyzer::BinOper* bin_oper,
   return codegenCmp(optype, qualifier, lhs_lvs, lhs_ti, rhs, co);
 }
 
+// Strings from different dictionaries are compared as none-encoded ones. Translating
+// the ids of the left side to the dictionary of the right side through the dense map
+// compares the ids instead and doesn't decompress anything.
+llvm::Value* Executor::codegenTranslatedDictStrCmp(const SQLOps optype,
+                                                   const Analyzer::Expr* lhs,
+                                                   const Analyzer::Expr* rhs,
+                                                   const CompilationOptions& co) {
+  if (g_cluster || co.device_type_ == ExecutorDeviceType::GPU) {
+    return nullptr;
+  }
+  const auto lhs_cast = dynamic_cast<const Analyzer::UOper*>(lhs);
+  const auto rhs_cast = dynamic_cast<const Analyzer::UOper*>(rhs);
+  if (!lhs_cast || lhs_cast->get_optype() != kCAST || !rhs_cast ||
+      rhs_cast->get_optype() != kCAST) {
+    return nullptr;
+  }
+  const auto lhs_operand = lhs_cast->get_operand();
+  const auto rhs_operand = rhs_cast->get_operand();
+  const auto& lhs_operand_ti = lhs_operand->get_type_info();
+  const auto& rhs_operand_ti = rhs_operand->get_type_info();
+  if (!lhs_operand_ti.is_string() || !rhs_operand_ti.is_string() ||
+      lhs_operand_ti.get_compression() != kENCODING_DICT ||
+      rhs_operand_ti.get_compression() != kENCODING_DICT ||
+      lhs_operand_ti.get_comp_param() == rhs_operand_ti.get_comp_param()) {
+    return nullptr;
+  }
+  const auto lhs_sdp = getStringDictionaryProxy(
+      lhs_operand_ti.get_comp_param(), row_set_mem_owner_, true);
+  const auto rhs_sdp = getStringDictionaryProxy(
+      rhs_operand_ti.get_comp_param(), row_set_mem_owner_, true);
+  const auto lhs_lvs = codegen(lhs_operand, true, co);
+  CHECK_EQ(size_t(1), lhs_lvs.size());
+  const auto translated_lv = cgen_state_->emitExternalCall(
+      "translate_string_id",
+      get_int_type(32, cgen_state_->context_),
+      {lhs_lvs.front(), ll_int(int64_t(lhs_sdp->getTranslationMap(rhs_sdp)))});
+  return codegenCmp(optype, kONE, {translated_lv}, rhs_operand_ti, rhs_operand, co);
+}
+
 llvm::Value* Executor::codegenOverlaps(const SQLOps optype,
                                        const SQLQualifier qualifier,
                                        const std::shared_ptr<Analyzer::Expr> lhs,
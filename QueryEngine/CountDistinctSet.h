@@ -0,0 +1,200 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CountDistinctSet.h
+ * @brief   Hash set used by COUNT(DISTINCT) when the range of the argument is too
+ * large for a bitmap.
+ *
+ * The values live in a flat, power of two sized table with linear probing, at most half
+ * full. A probe sequence is a few contiguous words instead of the pointer chasing of a
+ * tree, and the union of two sets is a linear scan of the smaller one.
+ */
+
+#ifndef QUERYENGINE_COUNTDISTINCTSET_H
+#define QUERYENGINE_COUNTDISTINCTSET_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class CountDistinctSet {
+ public:
+  CountDistinctSet()
+      : key_count_(0), shift_(64), has_empty_key_(false), charged_bytes_(nullptr) {}
+
+  CountDistinctSet(const CountDistinctSet&) = delete;
+
+  // Copies the values only, the set keeps charging its own owner.
+  CountDistinctSet& operator=(const CountDistinctSet& other) {
+    if (this != &other) {
+      const auto old_bytes = memoryBytes();
+      slots_ = other.slots_;
+      key_count_ = other.key_count_;
+      shift_ = other.shift_;
+      has_empty_key_ = other.has_empty_key_;
+      chargeResize(old_bytes);
+    }
+    return *this;
+  }
+
+  ~CountDistinctSet() {
+    if (charged_bytes_) {
+      *charged_bytes_ -= memoryBytes();
+    }
+  }
+
+  // From now on the bytes taken by the set, as it grows, are added to charged_bytes.
+  void setChargedBytes(std::atomic<size_t>* charged_bytes) {
+    charged_bytes_ = charged_bytes;
+    *charged_bytes_ += memoryBytes();
+  }
+
+  void insert(const int64_t val) {
+    if (val == kEmptyKey) {
+      has_empty_key_ = true;
+      return;
+    }
+    if (2 * (key_count_ + 1) > slots_.size()) {
+      rehash(std::max(size_t(kMinSlotCount), 2 * slots_.size()));
+    }
+    insertKey(val, slotOf(val));
+  }
+
+  // Inserts the values in blocks: the slots of a whole block are computed and
+  // prefetched before any of them is probed, which hides most of the cache misses once
+  // the table outgrows the cache. The table is sized for all the values upfront.
+  void insert(const int64_t* vals, const size_t count) {
+    reserve(key_count_ + count);
+    size_t slots[kBlockSize];
+    for (size_t start = 0; start < count; start += kBlockSize) {
+      const auto block_count = std::min(size_t(kBlockSize), count - start);
+      const auto block_vals = vals + start;
+      for (size_t i = 0; i < block_count; ++i) {
+        slots[i] = slotOf(block_vals[i]);
+        __builtin_prefetch(&slots_[slots[i]]);
+      }
+      for (size_t i = 0; i < block_count; ++i) {
+        if (block_vals[i] == kEmptyKey) {
+          has_empty_key_ = true;
+        } else {
+          insertKey(block_vals[i], slots[i]);
+        }
+      }
+    }
+  }
+
+  // Adds the values of other to this set.
+  void unite(const CountDistinctSet& other) {
+    has_empty_key_ = has_empty_key_ || other.has_empty_key_;
+    if (!other.key_count_) {
+      return;
+    }
+    reserve(key_count_ + other.key_count_);
+    int64_t block[kBlockSize];
+    size_t block_count{0};
+    for (const auto val : other.slots_) {
+      if (val == kEmptyKey) {
+        continue;
+      }
+      block[block_count++] = val;
+      if (block_count == kBlockSize) {
+        insert(block, block_count);
+        block_count = 0;
+      }
+    }
+    insert(block, block_count);
+  }
+
+  size_t size() const { return key_count_ + (has_empty_key_ ? 1 : 0); }
+
+  // The bytes taken by the set, for the memory accounting of the owner.
+  size_t memoryBytes() const { return sizeof(*this) + slots_.size() * sizeof(int64_t); }
+
+ private:
+  static constexpr int64_t kEmptyKey = std::numeric_limits<int64_t>::min();
+  static constexpr size_t kMinSlotCount = 16;
+  static constexpr size_t kBlockSize = 16;
+
+  // Fibonacci hashing, the top bits of the product select the slot. Only called once
+  // the table has been allocated, the shift is less than 64 then.
+  size_t slotOf(const int64_t val) const {
+    return (static_cast<uint64_t>(val) * uint64_t(0x9e3779b97f4a7c15)) >> shift_;
+  }
+
+  // Expects a table with room for the value.
+  void insertKey(const int64_t val, size_t slot) {
+    const auto mask = slots_.size() - 1;
+    while (slots_[slot] != kEmptyKey) {
+      if (slots_[slot] == val) {
+        return;
+      }
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot] = val;
+    ++key_count_;
+  }
+
+  void reserve(const size_t key_count) {
+    auto slot_count = std::max(size_t(kMinSlotCount), slots_.size());
+    while (2 * key_count > slot_count) {
+      slot_count *= 2;
+    }
+    if (slot_count != slots_.size()) {
+      rehash(slot_count);
+    }
+  }
+
+  void chargeResize(const size_t old_bytes) {
+    if (!charged_bytes_) {
+      return;
+    }
+    const auto new_bytes = memoryBytes();
+    if (new_bytes > old_bytes) {
+      *charged_bytes_ += new_bytes - old_bytes;
+    } else {
+      *charged_bytes_ -= old_bytes - new_bytes;
+    }
+  }
+
+  void rehash(const size_t slot_count) {
+    const auto old_bytes = memoryBytes();
+    std::vector<int64_t> old_slots(slot_count, int64_t(kEmptyKey));
+    old_slots.swap(slots_);
+    shift_ = 64;
+    for (size_t i = 1; i < slot_count; i *= 2) {
+      --shift_;
+    }
+    key_count_ = 0;
+    for (const auto val : old_slots) {
+      if (val != kEmptyKey) {
+        insertKey(val, slotOf(val));
+      }
+    }
+    chargeResize(old_bytes);
+  }
+
+  std::vector<int64_t> slots_;
+  size_t key_count_;
+  unsigned shift_;
+  bool has_empty_key_;
+  std::atomic<size_t>* charged_bytes_;
+};
+
+#endif  // QUERYENGINE_COUNTDISTINCTSET_H
@@ -25,6 +25,7 @@
 #define QUERYENGINE_DECODERSIMPL_H
 
 #include <stdint.h>
+#include "../DataMgr/PackedIntChunk.h"
 #include "../Shared/funcannotations.h"
 
 extern "C" DEVICE ALWAYS_INLINE int64_t
@@ -147,6 +148,47 @@ SUFFIX(fixed_width_small_date_decode_noinline)(const int8_t* byte_stream,
       byte_stream, byte_width, null_val, ret_null_val, pos);
 }
 
+extern "C" DEVICE ALWAYS_INLINE int64_t
+SUFFIX(packed_int_decode)(const int8_t* chunk,
+                          const int32_t byte_width,
+                          const int64_t null_val,
+                          const int64_t pos) {
+#ifdef WITH_DECODERS_BOUNDS_CHECKING
+  assert(pos >= 0);
+#endif  // WITH_DECODERS_BOUNDS_CHECKING
+  const auto header = reinterpret_cast<const PackedIntChunkHeader*>(chunk);
+  const auto payload = chunk + PACKED_INT_HEADER_SIZE;
+  const uint64_t null_offset = (uint64_t(1) << header->bit_width) - 1;
+  switch (header->format) {
+    case kPACKED_RLE:
+      return packed_int_rle_decode(payload, header->base, pos);
+    case kPACKED_BITPACK: {
+      const auto offset = packed_int_unpack(payload, header->bit_width, pos);
+      return offset == null_offset ? null_val
+                                   : header->base + static_cast<int64_t>(offset);
+    }
+    case kPACKED_DELTA: {
+      const auto block = payload + (pos / PACKED_INT_DELTA_BLOCK_ROWS) *
+                                       packed_int_delta_block_size(header->bit_width);
+      const auto offset = packed_int_unpack(
+          block + sizeof(int64_t), header->bit_width, pos % PACKED_INT_DELTA_BLOCK_ROWS);
+      return offset == null_offset
+                 ? null_val
+                 : *reinterpret_cast<const int64_t*>(block) + static_cast<int64_t>(offset);
+    }
+    default:
+      return SUFFIX(fixed_width_int_decode)(payload, byte_width, pos);
+  }
+}
+
+extern "C" DEVICE NEVER_INLINE int64_t
+SUFFIX(packed_int_decode_noinline)(const int8_t* chunk,
+                                   const int32_t byte_width,
+                                   const int64_t null_val,
+                                   const int64_t pos) {
+  return SUFFIX(packed_int_decode)(chunk, byte_width, null_val, pos);
+}
+
 #undef SUFFIX
 
 #endif  // QUERYENGINE_DECODERSIMPL_H
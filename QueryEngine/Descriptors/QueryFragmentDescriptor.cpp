@@ -91,12 +91,14 @@ void QueryFragmentDescriptor::buildFragmentPerKernelMap(
   outer_fragments_size_ = outer_fragments->size();
 
   const auto num_bytes_for_row = executor->getNumBytesForFetchedRow();
+  const auto sketch_filters =
+      executor->getChunkSketchFilters(ra_exe_unit, *outer_fragments, false);
 
   for (size_t i = 0; i < outer_fragments->size(); ++i) {
     const auto& fragment = (*outer_fragments)[i];
     const auto skip_frag = executor->skipFragment(
         outer_table_desc, fragment, ra_exe_unit.simple_quals, frag_offsets, i);
-    if (skip_frag.first) {
+    if (skip_frag.first || Executor::skipFragmentWithSketches(fragment, sketch_filters)) {
       continue;
     }
     // NOTE: Using kernel index instead of frag index now
@@ -160,6 +162,8 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
 
   const auto inner_table_id_to_join_condition = executor->getInnerTabIdToJoinCond();
   const auto num_bytes_for_row = executor->getNumBytesForFetchedRow();
+  const auto sketch_filters = executor->getChunkSketchFilters(
+      ra_exe_unit, *outer_fragments, enable_inner_join_fragment_skipping);
 
   for (size_t outer_frag_id = 0; outer_frag_id < outer_fragments->size();
        ++outer_frag_id) {
@@ -174,7 +178,7 @@ void QueryFragmentDescriptor::buildMultifragKernelMap(
       skip_frag = executor->skipFragmentInnerJoins(
           outer_table_desc, ra_exe_unit, fragment, frag_offsets, outer_frag_id);
     }
-    if (skip_frag.first) {
+    if (skip_frag.first || Executor::skipFragmentWithSketches(fragment, sketch_filters)) {
       continue;
     }
     const int device_id =
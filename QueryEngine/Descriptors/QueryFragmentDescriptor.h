@@ -100,6 +100,21 @@ class QueryFragmentDescriptor {
     }
   }
 
+  // Non-empty fragment lists of the kernels, in the order assignFragsToKernelDispatch
+  // dispatches them.
+  std::vector<FragmentsList> getKernelFragmentLists() const {
+    std::vector<FragmentsList> kernel_frag_lists;
+    for (const auto& kv : kernels_per_device_) {
+      for (const auto& kernel_id : kv.second) {
+        CHECK_LT(kernel_id, fragments_per_kernel_.size());
+        if (!fragments_per_kernel_[kernel_id].empty()) {
+          kernel_frag_lists.push_back(fragments_per_kernel_[kernel_id]);
+        }
+      }
+    }
+    return kernel_frag_lists;
+  }
+
   bool shouldCheckWorkUnitWatchdog() const {
     return rowid_lookup_key_ < 0 && fragments_per_kernel_.size() > 0;
   }
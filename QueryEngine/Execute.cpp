@@ -30,14 +30,17 @@
 #include "OverlapsJoinHashTable.h"
 #include "QueryRewrite.h"
 #include "QueryTemplateGenerator.h"
+#include "ResultSetSpill.h"
 #include "RuntimeFunctions.h"
 #include "SpeculativeTopN.h"
 
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/ChunkSketch.h"
 #include "Parser/ParserNode.h"
 #include "Shared/ExperimentalTypeUtilities.h"
 #include "Shared/MapDParameters.h"
+#include "Shared/TaskPool.h"
 #include "Shared/TypedDataAccessors.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/measure.h"
@@ -86,6 +89,14 @@ bool g_strip_join_covered_quals{false};
 size_t g_constrained_by_in_threshold{10};
 size_t g_big_group_threshold{20000};
 bool g_enable_window_functions{false};
+size_t g_num_executors{1};
+size_t g_large_scan_row_threshold{100000000};
+bool g_enable_fragment_readahead{true};
+size_t g_fragment_prefetch_depth{2};
+bool g_enable_result_spill{false};
+size_t g_result_spill_memory_budget{size_t(4) << 30};
+std::string g_result_spill_path;
+size_t g_count_distinct_max_bytes{0};  // 0 means no limit
 
 Executor::Executor(const int db_id,
                    const size_t block_size_x,
@@ -97,6 +108,7 @@ Executor::Executor(const int db_id,
     , is_nested_(false)
     , gpu_active_modules_device_mask_(0x0)
     , interrupted_(false)
+    , task_cancellation_flag_(std::make_shared<TaskPool_NS::CancellationFlag>(false))
     , cpu_code_cache_(code_cache_size)
     , gpu_code_cache_(code_cache_size)
     , render_manager_(render_manager)
@@ -114,9 +126,10 @@ std::shared_ptr<Executor> Executor::getExecutor(
     const std::string& debug_dir,
     const std::string& debug_file,
     const MapDParameters mapd_parameters,
-    ::QueryRenderer::QueryRenderManager* render_manager) {
+    ::QueryRenderer::QueryRenderManager* render_manager,
+    const size_t executor_slot) {
   INJECT_TIMER(getExecutor);
-  const auto executor_key = std::make_pair(db_id, render_manager);
+  const auto executor_key = std::make_tuple(db_id, render_manager, executor_slot);
   {
     mapd_shared_lock<mapd_shared_mutex> read_lock(executors_cache_mutex_);
     auto it = executors_.find(executor_key);
@@ -142,6 +155,96 @@ std::shared_ptr<Executor> Executor::getExecutor(
   }
 }
 
+namespace {
+
+size_t get_executor_pool_size() {
+  // The dynamic watchdog deadline and abort flag are process-wide, keep a single
+  // executor per database when it's enabled.
+  return g_enable_dynamic_watchdog ? size_t(1) : std::max(g_num_executors, size_t(1));
+}
+
+}  // namespace
+
+std::shared_ptr<Executor> Executor::acquireExecutor(
+    const int db_id,
+    const std::string& debug_dir,
+    const std::string& debug_file,
+    const MapDParameters mapd_parameters,
+    ::QueryRenderer::QueryRenderManager* render_manager) {
+  INJECT_TIMER(acquireExecutor);
+  size_t executor_slot{0};
+  {
+    std::unique_lock<std::mutex> lock(executor_slots_mutex_);
+    auto& busy_slots = busy_executor_slots_[db_id];
+    busy_slots.resize(std::max(busy_slots.size(), get_executor_pool_size()), false);
+    const auto pool_size = get_executor_pool_size();
+    executor_slot_released_.wait(lock, [&busy_slots, &executor_slot, pool_size] {
+      for (size_t i = 0; i < pool_size; ++i) {
+        if (!busy_slots[i]) {
+          executor_slot = i;
+          return true;
+        }
+      }
+      return false;
+    });
+    busy_slots[executor_slot] = true;
+  }
+  std::shared_ptr<Executor> executor;
+  try {
+    executor = getExecutor(
+        db_id, debug_dir, debug_file, mapd_parameters, render_manager, executor_slot);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(executor_slots_mutex_);
+    busy_executor_slots_[db_id][executor_slot] = false;
+    executor_slot_released_.notify_all();
+    throw;
+  }
+  // Share ownership with a holder which gives the slot back to the pool, but point
+  // to the executor itself.
+  std::shared_ptr<Executor> slot_holder(
+      executor.get(), [executor, db_id, executor_slot](Executor*) {
+        std::lock_guard<std::mutex> lock(executor_slots_mutex_);
+        busy_executor_slots_[db_id][executor_slot] = false;
+        executor_slot_released_.notify_all();
+      });
+  return slot_holder;
+}
+
+void Executor::nukeCacheOfExecutors() {
+  std::vector<std::shared_ptr<Executor>> executors;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(executors_cache_mutex_);
+    for (const auto& kv : executors_) {
+      executors.push_back(kv.second);
+    }
+  }
+  // don't want native code to vanish while executing
+  std::vector<std::unique_lock<std::mutex>> flush_locks;
+  for (const auto& executor : executors) {
+    flush_locks.emplace_back(executor->execute_mutex_);
+  }
+  mapd_unique_lock<mapd_shared_mutex> lock(executors_cache_mutex_);
+  (decltype(executors_){}).swap(executors_);
+}
+
+void Executor::registerRunningQuery() {
+  ++running_query_count_;
+}
+
+void Executor::unregisterRunningQuery() {
+  CHECK_GT(running_query_count_.load(), size_t(0));
+  --running_query_count_;
+}
+
+size_t Executor::getRunningQueryCount() {
+  return running_query_count_.load();
+}
+
+int Executor::getCpuThreadsShare() {
+  const auto running_query_count = std::max(running_query_count_.load(), size_t(1));
+  return std::max(cpu_threads() / static_cast<int>(running_query_count), 1);
+}
+
 StringDictionaryProxy* Executor::getStringDictionaryProxy(
     const int dict_id_in,
     std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
@@ -893,6 +996,14 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
           return init + r->getQueryMemDesc().getEntryCount();
         });
     CHECK(total_entry_count);
+    if (should_spill_reduction(first->getQueryMemDesc(), total_entry_count)) {
+      std::vector<const ResultSet*> results;
+      for (const auto& result : results_per_device) {
+        results.push_back(result.first.get());
+      }
+      return reduce_baseline_hash_with_spill(
+          results, row_set_mem_owner, plan_state_->init_agg_vals_, this);
+    }
     auto query_mem_desc = first->getQueryMemDesc();
     query_mem_desc.setEntryCount(total_entry_count);
     reduced_results = std::make_shared<ResultSet>(first->getTargetInfos(),
@@ -923,6 +1034,16 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
                                           {});
   }
 
+  if (!query_mem_desc.countDistinctDescriptorsLogicallyEmpty()) {
+    // The union of the sets is copied back over both of them, check the limit again.
+    const auto count_distinct_bytes = row_set_mem_owner->getCountDistinctMemoryBytes();
+    VLOG(1) << "Count distinct bitmaps and sets take " << count_distinct_bytes
+            << " bytes after the reduction";
+    if (g_count_distinct_max_bytes && count_distinct_bytes > g_count_distinct_max_bytes) {
+      throw OutOfHostMemory(count_distinct_bytes);
+    }
+  }
+
   return reduced_results;
 }
 
@@ -1135,12 +1256,23 @@ ResultSetPtr Executor::executeWorkUnitImpl(
     CHECK(device_type == ExecutorDeviceType::CPU);
     max_groups_buffer_entry_guess = compute_buffer_entry_guess(query_infos);
   }
+  // The chunks of a large scan are kept from being promoted to the hot queue of the
+  // buffer pool, a one-off pass over a big table would otherwise flush it. Any input
+  // table counts, the big one isn't necessarily the outer table of a join.
+  const bool large_scan =
+      g_large_scan_row_threshold &&
+      std::any_of(query_infos.begin(),
+                  query_infos.end(),
+                  [](const InputTableInfo& query_info) {
+                    return query_info.info.getPhysicalNumTuples() >=
+                           g_large_scan_row_threshold;
+                  });
 
   ColumnCacheMap column_cache;
   int8_t crt_min_byte_width{get_min_byte_width()};
   do {
     *error_code = 0;
-    int available_cpus = cpu_threads();
+    int available_cpus = getCpuThreadsShare();
     auto available_gpus = get_available_gpus(cat);
 
     const auto context_count =
@@ -1179,7 +1311,20 @@ ResultSetPtr Executor::executeWorkUnitImpl(
       plan_state_->target_exprs_.push_back(target_expr);
     }
 
-    auto dispatch = [&execution_dispatch, &eo](
+    if (is_agg && query_comp_desc_owned->getDeviceType() == ExecutorDeviceType::CPU &&
+        !use_speculative_top_n(ra_exe_unit, *query_mem_desc_owned)) {
+      // There's a kernel per fragment on CPU. When reducing their group by buffers
+      // wouldn't fit the budget, their rows go to the scratch files as they finish.
+      const auto kernel_count = query_infos.front().info.fragments.size();
+      const auto max_row_count = kernel_count * query_mem_desc_owned->getEntryCount();
+      if (kernel_count > 1 &&
+          should_spill_reduction(*query_mem_desc_owned, max_row_count)) {
+        execution_dispatch.setResultSpiller(
+            std::make_unique<ResultSetSpiller>(max_row_count));
+      }
+    }
+
+    auto dispatch = [&execution_dispatch, &eo, large_scan](
                         const ExecutorDeviceType chosen_device_type,
                         int chosen_device_id,
                         const QueryCompilationDescriptor& query_comp_desc,
@@ -1188,6 +1333,7 @@ ResultSetPtr Executor::executeWorkUnitImpl(
                         const size_t ctx_idx,
                         const int64_t rowid_lookup_key) {
       INJECT_TIMER(execution_dispatch_run);
+      Buffer_Namespace::ScopedLargeScan scan_hint(large_scan);
       execution_dispatch.run(chosen_device_type,
                              chosen_device_id,
                              eo,
@@ -1207,18 +1353,23 @@ ResultSetPtr Executor::executeWorkUnitImpl(
         eo.gpu_input_mem_limit_percent);
 
     if (!eo.just_validate) {
-      dispatchFragments(dispatch,
-                        execution_dispatch,
-                        query_infos,
-                        eo,
-                        is_agg,
-                        allow_single_frag_table_opt,
-                        context_count,
-                        *query_comp_desc_owned,
-                        *query_mem_desc_owned,
-                        fragment_descriptor,
-                        available_gpus,
-                        available_cpus);
+      try {
+        dispatchFragments(dispatch,
+                          execution_dispatch,
+                          query_infos,
+                          eo,
+                          is_agg,
+                          allow_single_frag_table_opt,
+                          context_count,
+                          *query_comp_desc_owned,
+                          *query_mem_desc_owned,
+                          fragment_descriptor,
+                          available_gpus,
+                          available_cpus);
+      } catch (const TaskPool_NS::TaskCancelled&) {
+        // The query has been interrupted before all its kernels got to run.
+        *error_code = ERR_INTERRUPTED;
+      }
     }
     if (eo.with_dynamic_watchdog && interrupted_ && *error_code == ERR_OUT_OF_TIME) {
       *error_code = ERR_INTERRUPTED;
@@ -1391,8 +1542,8 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_buffer));
         continue;
       }
-      if (count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet) {
-        auto count_distinct_set = new std::set<int64_t>();
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet) {
+        auto count_distinct_set = new CountDistinctSet();
         CHECK(row_set_mem_owner);
         row_set_mem_owner->addCountDistinctSet(count_distinct_set);
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_set));
@@ -1474,6 +1625,14 @@ ResultSetPtr Executor::collectAllDeviceResults(
     execution_dispatch.getFragmentResults().emplace_back(rs, std::vector<size_t>{});
   }
   auto& result_per_device = execution_dispatch.getFragmentResults();
+  const auto result_spiller = execution_dispatch.getResultSpiller();
+  if (result_spiller && !result_spiller->empty()) {
+    for (const auto& result : result_per_device) {
+      result_spiller->spill(*result.first);
+    }
+    result_per_device.clear();
+    return result_spiller->reduce(row_set_mem_owner, plan_state_->init_agg_vals_, this);
+  }
   if (result_per_device.empty() && query_mem_desc.getQueryDescriptionType() ==
                                        QueryDescriptionType::NonGroupedAggregate) {
     return build_row_for_empty_input(target_exprs, query_mem_desc, device_type);
@@ -1566,6 +1725,88 @@ bool has_lazy_fetched_columns(const std::vector<ColumnLazyFetchInfo>& fetched_co
   return false;
 }
 
+// Key prefixes of the chunks of the physical tables a kernel reads, one per input column
+// and fragment; varlen columns have several chunks under the prefix.
+std::vector<ChunkKey> get_kernel_chunk_key_prefixes(
+    const int db_id,
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const std::vector<InputTableInfo>& table_infos,
+    const FragmentsList& frag_list) {
+  std::vector<ChunkKey> key_prefixes;
+  for (const auto& fragments_per_table : frag_list) {
+    const auto table_id = fragments_per_table.table_id;
+    if (table_id <= 0) {
+      continue;
+    }
+    const auto table_info_it = std::find_if(
+        table_infos.begin(), table_infos.end(), [table_id](const InputTableInfo& info) {
+          return info.table_id == table_id;
+        });
+    CHECK(table_info_it != table_infos.end());
+    const auto& fragments = table_info_it->info.fragments;
+    for (const auto& input_col_desc : ra_exe_unit.input_col_descs) {
+      if (input_col_desc->getScanDesc().getTableId() != table_id) {
+        continue;
+      }
+      for (const auto frag_idx : fragments_per_table.fragment_ids) {
+        CHECK_LT(frag_idx, fragments.size());
+        const auto& fragment = fragments[frag_idx];
+        key_prefixes.push_back({db_id,
+                                fragment.physicalTableId,
+                                input_col_desc->getColId(),
+                                fragment.fragmentId});
+      }
+    }
+  }
+  return key_prefixes;
+}
+
+// The CPU threads of a query shared by its kernels, a kernel waiting for one takes the
+// first one any running kernel gives back.
+class KernelSlots {
+ public:
+  explicit KernelSlots(const int slot_count) : free_slots_(slot_count) {}
+
+  bool isFull() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_slots_ <= 0;
+  }
+
+  void acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_released_.wait(lock, [this] { return free_slots_ > 0; });
+    --free_slots_;
+  }
+
+  void release() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++free_slots_;
+    }
+    slot_released_.notify_one();
+  }
+
+ private:
+  int free_slots_;
+  mutable std::mutex mutex_;
+  std::condition_variable slot_released_;
+};
+
+// Captured by the task of a kernel, gives its slot back once the pool is done with the
+// task, whether the task ran or was dropped because the query got cancelled.
+class KernelSlotHolder {
+ public:
+  explicit KernelSlotHolder(std::shared_ptr<KernelSlots> slots)
+      : slots_(std::move(slots)) {
+    slots_->acquire();
+  }
+
+  ~KernelSlotHolder() { slots_->release(); }
+
+ private:
+  std::shared_ptr<KernelSlots> slots_;
+};
+
 }  // namespace
 
 void Executor::dispatchFragments(
@@ -1587,7 +1828,9 @@ void Executor::dispatchFragments(
     QueryFragmentDescriptor& fragment_descriptor,
     std::unordered_set<int>& available_gpus,
     int& available_cpus) {
-  std::vector<std::future<void>> query_threads;
+  std::vector<TaskPool_NS::TaskFuture<void>> query_threads;
+  // Holds the prefetched chunks until the kernels are done.
+  std::unique_ptr<FragmentPrefetcher> prefetcher;
   const auto& ra_exe_unit = execution_dispatch.getExecutionUnit();
   CHECK(!ra_exe_unit.input_descs.empty());
 
@@ -1661,12 +1904,37 @@ void Executor::dispatchFragments(
       }
     }
 
+    // Fetches the chunks of the kernels waiting for a CPU slot, within a share of the
+    // CPU buffer pool so that the queries running on the other executors fit as well.
+    if (device_type == ExecutorDeviceType::CPU && g_fragment_prefetch_depth > 0) {
+      const auto kernel_frag_lists = fragment_descriptor.getKernelFragmentLists();
+      if (kernel_frag_lists.size() > static_cast<size_t>(available_cpus)) {
+        const auto max_pinned_bytes =
+            catalog_->getDataMgr().getBufferPoolMaxSize(Data_Namespace::CPU_LEVEL) /
+            (4 * std::max(g_num_executors, size_t(1)));
+        prefetcher.reset(new FragmentPrefetcher(*catalog_,
+                                                ra_exe_unit,
+                                                table_infos,
+                                                kernel_frag_lists,
+                                                g_fragment_prefetch_depth,
+                                                max_pinned_bytes,
+                                                fetch_compute_stats_));
+      }
+    }
+
+    const auto kernel_slots = std::make_shared<KernelSlots>(available_cpus);
     size_t frag_list_idx{0};
-    auto fragment_per_kernel_dispatch = [&query_threads,
+    auto fragment_per_kernel_dispatch = [this,
+                                         &query_threads,
+                                         &kernel_slots,
+                                         &prefetcher,
                                          &dispatch,
                                          &context_count,
                                          &frag_list_idx,
                                          &device_type,
+                                         &available_cpus,
+                                         &ra_exe_unit,
+                                         &table_infos,
                                          query_comp_desc,
                                          query_mem_desc](const int device_id,
                                                          const FragmentsList& frag_list,
@@ -1676,15 +1944,58 @@ void Executor::dispatchFragments(
       }
       CHECK_GE(device_id, 0);
 
-      query_threads.push_back(std::async(std::launch::async,
-                                         dispatch,
-                                         device_type,
-                                         device_id,
-                                         query_comp_desc,
-                                         query_mem_desc,
-                                         frag_list,
-                                         frag_list_idx % context_count,
-                                         rowid_lookup_key));
+      // Keep at most our share of the CPU threads busy, so that queries running
+      // concurrently on other executors get theirs.
+      if (device_type == ExecutorDeviceType::CPU && kernel_slots->isFull()) {
+        CHECK_EQ(query_threads.size(), frag_list_idx);
+        if (g_enable_fragment_readahead) {
+          // The kernel has to wait for a running one, read its chunks ahead meanwhile.
+          catalog_->getDataMgr().readaheadChunks(get_kernel_chunk_key_prefixes(
+              catalog_->getCurrentDB().dbId, ra_exe_unit, table_infos, frag_list));
+        }
+        if (prefetcher) {
+          prefetcher->releaseFinished(query_threads);
+          prefetcher->prefetch(frag_list_idx);
+        }
+      }
+
+      if (device_type == ExecutorDeviceType::CPU) {
+        // Waits for whichever running kernel finishes first.
+        const auto slot = std::make_shared<KernelSlotHolder>(kernel_slots);
+        query_threads.push_back(TaskPool_NS::async(
+            [slot, dispatch](const ExecutorDeviceType chosen_device_type,
+                             int chosen_device_id,
+                             const QueryCompilationDescriptor& query_comp_desc,
+                             const QueryMemoryDescriptor& query_mem_desc,
+                             const FragmentsList& frag_list,
+                             const size_t ctx_idx,
+                             const int64_t rowid_lookup_key) {
+              dispatch(chosen_device_type,
+                       chosen_device_id,
+                       query_comp_desc,
+                       query_mem_desc,
+                       frag_list,
+                       ctx_idx,
+                       rowid_lookup_key);
+            },
+            device_type,
+            device_id,
+            query_comp_desc,
+            query_mem_desc,
+            frag_list,
+            frag_list_idx % context_count,
+            rowid_lookup_key));
+      } else {
+        query_threads.push_back(std::async(std::launch::async,
+                                           dispatch,
+                                           device_type,
+                                           device_id,
+                                           query_comp_desc,
+                                           query_mem_desc,
+                                           frag_list,
+                                           frag_list_idx % context_count,
+                                           rowid_lookup_key));
+      }
 
       ++frag_list_idx;
     };
@@ -3024,6 +3335,28 @@ int Executor::getLocalColumnId(const Analyzer::ColumnVar* col_var,
   return it->second;
 }
 
+namespace {
+
+// True if the sketch of the chunk of the column rules out every value.
+bool chunk_sketch_rules_out(const Fragmenter_Namespace::FragmentInfo& fragment,
+                            const int col_id,
+                            const std::vector<int64_t>& values) {
+  if (values.empty()) {
+    return false;
+  }
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  const auto chunk_meta_it = chunk_metadata_map.find(col_id);
+  if (chunk_meta_it == chunk_metadata_map.end() || !chunk_meta_it->second.sketch) {
+    return false;
+  }
+  const auto& sketch = *chunk_meta_it->second.sketch;
+  return std::none_of(values.begin(), values.end(), [&sketch](const int64_t val) {
+    return sketch.mayContain(val);
+  });
+}
+
+}  // namespace
+
 std::pair<bool, int64_t> Executor::skipFragment(
     const InputDescriptor& table_desc,
     const Fragmenter_Namespace::FragmentInfo& fragment,
@@ -3129,6 +3462,136 @@ std::pair<bool, int64_t> Executor::skipFragment(
   return {false, -1};
 }
 
+bool Executor::appendChunkSketchValue(std::vector<int64_t>& values,
+                                      const Analyzer::ColumnVar* col_var,
+                                      const Analyzer::Expr* value) {
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(value);
+  if (!constant || constant->get_is_null()) {
+    return false;
+  }
+  const auto& col_ti = col_var->get_type_info();
+  const auto& const_ti = constant->get_type_info();
+  if (col_ti.is_string()) {
+    if (col_ti.get_compression() != kENCODING_DICT || !const_ti.is_string() ||
+        !row_set_mem_owner_) {
+      return false;
+    }
+    const auto sdp =
+        getStringDictionaryProxy(col_ti.get_comp_param(), row_set_mem_owner_, true);
+    CHECK(sdp);
+    const auto str_id = sdp->getIdOfString(*constant->get_constval().stringval);
+    // Transient strings aren't in the chunks, leave them to the kernels anyway.
+    if (str_id < 0) {
+      return false;
+    }
+    values.push_back(str_id);
+    return true;
+  }
+  if ((!col_ti.is_integer() && !col_ti.is_time()) ||
+      col_ti.get_type() != const_ti.get_type() ||
+      col_ti.get_dimension() != const_ti.get_dimension()) {
+    return false;
+  }
+  values.push_back(codegenIntConst(constant)->getSExtValue());
+  return true;
+}
+
+std::vector<Executor::ChunkSketchFilter> Executor::getChunkSketchFilters(
+    const RelAlgExecutionUnit& ra_exe_unit,
+    const TableFragments& outer_fragments,
+    const bool include_inner_joins) {
+  std::vector<ChunkSketchFilter> filters;
+  if (!g_enable_chunk_sketches) {
+    return filters;
+  }
+  // The dictionary lookups are only worth it for the columns which have sketches.
+  auto has_sketches = [&outer_fragments](const int col_id) {
+    return std::any_of(outer_fragments.begin(),
+                       outer_fragments.end(),
+                       [col_id](const Fragmenter_Namespace::FragmentInfo& fragment) {
+                         const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+                         const auto it = chunk_metadata_map.find(col_id);
+                         return it != chunk_metadata_map.end() && it->second.sketch;
+                       });
+  };
+  // Columns of the outer table only, like skipFragment.
+  auto outer_column = [](const Analyzer::Expr* arg) -> const Analyzer::ColumnVar* {
+    const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(arg);
+    if (!col_var || dynamic_cast<const Analyzer::Var*>(col_var) ||
+        !col_var->get_table_id() || col_var->get_rte_idx()) {
+      return nullptr;
+    }
+    return col_var;
+  };
+  auto add_filter = [&](const Analyzer::Expr* qual) {
+    const Analyzer::ColumnVar* col_var{nullptr};
+    std::vector<const Analyzer::Expr*> value_exprs;
+    if (const auto comp_expr = dynamic_cast<const Analyzer::BinOper*>(qual)) {
+      if (comp_expr->get_optype() != kEQ || comp_expr->get_qualifier() != kONE) {
+        return;
+      }
+      col_var = outer_column(comp_expr->get_left_operand());
+      value_exprs.push_back(comp_expr->get_right_operand());
+    } else if (const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual)) {
+      col_var = outer_column(in_values->get_arg());
+      for (const auto& value : in_values->get_value_list()) {
+        value_exprs.push_back(value.get());
+      }
+    } else if (const auto in_integer_set =
+                   dynamic_cast<const Analyzer::InIntegerSet*>(qual)) {
+      // The values are in the domain of the argument already, dictionary ids included.
+      col_var = outer_column(in_integer_set->get_arg());
+      if (col_var && has_sketches(col_var->get_column_id())) {
+        filters.push_back({col_var->get_column_id(), in_integer_set->get_value_list()});
+      }
+      return;
+    }
+    if (!col_var || !has_sketches(col_var->get_column_id())) {
+      return;
+    }
+    ChunkSketchFilter filter{col_var->get_column_id(), {}};
+    for (const auto value : value_exprs) {
+      if (!appendChunkSketchValue(filter.values, col_var, value)) {
+        return;
+      }
+    }
+    filters.push_back(std::move(filter));
+  };
+  for (const auto& qual : ra_exe_unit.simple_quals) {
+    add_filter(qual.get());
+  }
+  for (const auto& qual : ra_exe_unit.quals) {
+    add_filter(qual.get());
+  }
+  if (include_inner_joins) {
+    // The conjuncts of the inner join conditions filter the outer table as well.
+    for (const auto& inner_join : ra_exe_unit.join_quals) {
+      if (inner_join.type != JoinType::INNER) {
+        continue;
+      }
+      for (const auto& qual : inner_join.quals) {
+        const auto conjunctive_form = qual_to_conjunctive_form(qual);
+        for (const auto& simple_qual : conjunctive_form.simple_quals) {
+          add_filter(simple_qual.get());
+        }
+        for (const auto& other_qual : conjunctive_form.quals) {
+          add_filter(other_qual.get());
+        }
+      }
+    }
+  }
+  return filters;
+}
+
+bool Executor::skipFragmentWithSketches(
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::vector<ChunkSketchFilter>& filters) {
+  return std::any_of(
+      filters.begin(), filters.end(), [&fragment](const ChunkSketchFilter& filter) {
+        return chunk_sketch_rules_out(fragment, filter.col_id, filter.values);
+      });
+}
+
 /*
  *   The skipFragmentInnerJoins process all quals stored in the execution unit's
  * join_quals and gather all the ones that meet the "simple_qual" characteristics
@@ -3210,7 +3673,12 @@ llvm::Value* Executor::CgenState::emitCall(const std::string& fname,
   return ir_builder_.CreateCall(func, args);
 }
 
-std::map<std::pair<int, ::QueryRenderer::QueryRenderManager*>, std::shared_ptr<Executor>>
+std::map<std::tuple<int, ::QueryRenderer::QueryRenderManager*, size_t>,
+         std::shared_ptr<Executor>>
     Executor::executors_;
-std::mutex Executor::execute_mutex_;
 mapd_shared_mutex Executor::executors_cache_mutex_;
+std::mutex Executor::compilation_mutex_;
+std::map<int, std::vector<bool>> Executor::busy_executor_slots_;
+std::mutex Executor::executor_slots_mutex_;
+std::condition_variable Executor::executor_slot_released_;
+std::atomic<size_t> Executor::running_query_count_{0};
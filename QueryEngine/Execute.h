@@ -22,6 +22,7 @@
 #include "CartesianProduct.h"
 #include "DateTimeUtils.h"
 #include "Descriptors/QueryFragmentDescriptor.h"
+#include "FragmentPrefetcher.h"
 #include "GroupByAndAggregate.h"
 #include "IRCodegenUtils.h"
 #include "InValuesBitmap.h"
@@ -32,6 +33,7 @@
 #include "NvidiaKernel.h"
 #include "RelAlgExecutionUnit.h"
 #include "RelAlgTranslator.h"
+#include "ResultSetSpill.h"
 #include "StringDictionaryGenerations.h"
 #include "TableGenerations.h"
 #include "TargetMetaInfo.h"
@@ -42,6 +44,7 @@
 #include "../Fragmenter/InsertOrderFragmenter.h"
 #include "../Planner/Planner.h"
 #include "../Shared/MapDParameters.h"
+#include "../Shared/TaskPool.h"
 #include "../Shared/measure.h"
 #include "../Shared/thread_count.h"
 #include "../StringDictionary/LruCache.hpp"
@@ -60,6 +63,7 @@
 
 #include <unistd.h>
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdlib>
@@ -69,6 +73,7 @@
 #include <map>
 #include <mutex>
 #include <stack>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -92,6 +97,15 @@ extern bool g_strip_join_covered_quals;
 extern size_t g_constrained_by_in_threshold;
 extern size_t g_big_group_threshold;
 extern bool g_enable_window_functions;
+extern size_t g_num_executors;
+extern size_t g_large_scan_row_threshold;
+extern bool g_enable_fragment_readahead;
+extern size_t g_fragment_prefetch_depth;
+extern bool g_enable_result_spill;
+extern size_t g_result_spill_memory_budget;
+extern std::string g_result_spill_path;
+extern size_t g_count_distinct_max_bytes;
+extern bool g_enable_chunk_sketches;
 
 class QueryCompilationDescriptor;
 using QueryCompilationDescriptorOwned = std::unique_ptr<QueryCompilationDescriptor>;
@@ -340,18 +354,32 @@ class Executor {
            ::QueryRenderer::QueryRenderManager* render_manager);
 
   static std::shared_ptr<Executor> getExecutor(
+      const int db_id,
+      const std::string& debug_dir = "",
+      const std::string& debug_file = "",
+      const MapDParameters mapd_parameters = MapDParameters(),
+      ::QueryRenderer::QueryRenderManager* render_manager = nullptr,
+      const size_t executor_slot = 0);
+
+  // Returns one of the g_num_executors executors of the given database which isn't
+  // running a query, blocking until one becomes available. The slot is given back
+  // when the last copy of the returned pointer goes away. Queries running on
+  // different executors don't serialize on each other's execute_mutex_.
+  static std::shared_ptr<Executor> acquireExecutor(
       const int db_id,
       const std::string& debug_dir = "",
       const std::string& debug_file = "",
       const MapDParameters mapd_parameters = MapDParameters(),
       ::QueryRenderer::QueryRenderManager* render_manager = nullptr);
 
-  static void nukeCacheOfExecutors() {
-    std::lock_guard<std::mutex> flush_lock(
-        execute_mutex_);  // don't want native code to vanish while executing
-    mapd_unique_lock<mapd_shared_mutex> lock(executors_cache_mutex_);
-    (decltype(executors_){}).swap(executors_);
-  }
+  static void nukeCacheOfExecutors();
+
+  // Bookkeeping of the queries running at a time across all executors, used to
+  // divide the CPU worker threads fairly between them.
+  static void registerRunningQuery();
+  static void unregisterRunningQuery();
+  static size_t getRunningQueryCount();
+  static int getCpuThreadsShare();
 
   typedef std::tuple<std::string, const Analyzer::Expr*, int64_t, const size_t> AggInfo;
 
@@ -609,6 +637,10 @@ class Executor {
                                  const std::shared_ptr<Analyzer::Expr>,
                                  const SQLOps,
                                  const CompilationOptions& co);
+  llvm::Value* codegenTranslatedDictStrCmp(const SQLOps,
+                                           const Analyzer::Expr*,
+                                           const Analyzer::Expr*,
+                                           const CompilationOptions&);
   llvm::Value* codegenQualifierCmp(const SQLOps,
                                    const SQLQualifier,
                                    std::vector<llvm::Value*>,
@@ -701,6 +733,12 @@ class Executor {
                                      const size_t target_index,
                                      const CompilationOptions& co);
 
+  // Generate code for reading the value of an aggregate window function over a ROWS or
+  // RANGE frame, which has been computed before the query.
+  llvm::Value* codegenWindowFramedAggregate(
+      const Analyzer::WindowFunction* window_func,
+      const WindowFunctionContext* window_func_context);
+
   // Generate code for an aggregate window function target.
   llvm::Value* codegenWindowFunctionAggregate(
       const Analyzer::WindowFunction* window_func,
@@ -843,6 +881,9 @@ class Executor {
     int32_t* error_code_;
     RenderInfo* render_info_;
     std::vector<std::pair<ResultSetPtr, std::vector<size_t>>> all_fragment_results_;
+    // Takes the group by results of the kernels instead of all_fragment_results_ when
+    // their reduction spills.
+    std::unique_ptr<ResultSetSpiller> result_spiller_;
     std::atomic_flag dynamic_watchdog_set_ = ATOMIC_FLAG_INIT;
     static std::mutex reduce_mutex_;
 
@@ -952,6 +993,10 @@ class Executor {
 
     std::vector<std::pair<ResultSetPtr, std::vector<size_t>>>& getFragmentResults();
 
+    void setResultSpiller(std::unique_ptr<ResultSetSpiller> result_spiller);
+
+    ResultSetSpiller* getResultSpiller() const;
+
     static std::pair<const int8_t*, size_t> getColumnFragment(
         Executor* executor,
         const Analyzer::ColumnVar& hash_col,
@@ -968,6 +1013,16 @@ class Executor {
         std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner,
         ColumnCacheMap& column_cache);
 
+   private:
+    static const int8_t* getPackedColumnFragment(
+        Executor* executor,
+        const ColumnDescriptor* cd,
+        const Fragmenter_Namespace::FragmentInfo& fragment,
+        const ChunkMetadata& chunk_metadata,
+        const Data_Namespace::MemoryLevel effective_mem_lvl,
+        const int device_id,
+        std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
+
     friend class QueryCompilationDescriptor;
   };
 
@@ -1297,6 +1352,31 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  // Appends the value of a constant as found in the chunk sketches of the column, returns
+  // false for the values which can't be looked up there.
+  bool appendChunkSketchValue(std::vector<int64_t>& values,
+                              const Analyzer::ColumnVar* col_var,
+                              const Analyzer::Expr* value);
+
+  // Values of an equality or IN qual on a column of the outer table, as found in its
+  // chunk sketches.
+  struct ChunkSketchFilter {
+    int col_id;
+    std::vector<int64_t> values;
+  };
+
+  // Computed once for all the fragments of the outer table. Empty unless chunk sketches
+  // are enabled and some of the fragments have sketches of the filtered columns.
+  std::vector<ChunkSketchFilter> getChunkSketchFilters(
+      const RelAlgExecutionUnit& ra_exe_unit,
+      const TableFragments& outer_fragments,
+      const bool include_inner_joins);
+
+  // True if the chunk sketches of the fragment rule out all the values of a filter.
+  static bool skipFragmentWithSketches(
+      const Fragmenter_Namespace::FragmentInfo& fragment,
+      const std::vector<ChunkSketchFilter>& filters);
+
   std::pair<bool, int64_t> skipFragmentInnerJoins(
       const InputDescriptor& table_desc,
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -1698,6 +1778,10 @@ class Executor {
   mutable uint32_t gpu_active_modules_device_mask_;
   mutable void* gpu_active_modules_[max_gpu_count];
   bool interrupted_;
+  // Set along with interrupted_, skips the pool tasks of the query not started yet.
+  std::shared_ptr<TaskPool_NS::CancellationFlag> task_cancellation_flag_;
+  // Fetch and compute times of the kernels of the running query.
+  FetchComputeStats fetch_compute_stats_;
 
   mutable std::shared_ptr<StringDictionaryProxy> lit_str_dict_proxy_;
   mutable std::mutex str_dict_mutex_;
@@ -1727,12 +1811,20 @@ class Executor {
   StringDictionaryGenerations string_dictionary_generations_;
   TableGenerations table_generations_;
 
-  static std::map<std::pair<int, ::QueryRenderer::QueryRenderManager*>,
+  static std::map<std::tuple<int, ::QueryRenderer::QueryRenderManager*, size_t>,
                   std::shared_ptr<Executor>>
       executors_;
-  static std::mutex execute_mutex_;
+  std::mutex execute_mutex_;
   static mapd_shared_mutex executors_cache_mutex_;
 
+  // LLVM contexts aren't thread-safe and all executors share the global one
+  static std::mutex compilation_mutex_;
+
+  static std::map<int, std::vector<bool>> busy_executor_slots_;
+  static std::mutex executor_slots_mutex_;
+  static std::condition_variable executor_slot_released_;
+  static std::atomic<size_t> running_query_count_;
+
   static const int32_t ERR_DIV_BY_ZERO{1};
   static const int32_t ERR_OUT_OF_GPU_MEM{2};
   static const int32_t ERR_OUT_OF_SLOTS{3};
@@ -20,6 +20,7 @@
 #include "Execute.h"
 
 #include "DataMgr/BufferMgr/BufferMgr.h"
+#include "DataMgr/PackedIntCodec.h"
 
 #include <numeric>
 
@@ -179,6 +180,7 @@ void Executor::ExecutionDispatch::runImpl(
         all_tables_fragments, ra_exe_unit_, query_infos_);
 
     OOM_TRACE_PUSH();
+    const auto fetch_clock_begin = timer_start();
     fetch_result = executor_->fetchChunks(*this,
                                           ra_exe_unit_,
                                           chosen_device_id,
@@ -188,6 +190,9 @@ void Executor::ExecutionDispatch::runImpl(
                                           cat_,
                                           *chunk_iterators_ptr,
                                           chunks);
+    executor_->fetch_compute_stats_.fetch_us +=
+        timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+            fetch_clock_begin);
     if (fetch_result.num_rows.empty()) {
       return;
     }
@@ -272,6 +277,7 @@ void Executor::ExecutionDispatch::runImpl(
   }
 
   ResultSetPtr device_results;
+  const auto compute_clock_begin = timer_start();
   if (ra_exe_unit_.groupby_exprs.empty()) {
     OOM_TRACE_PUSH();
     err = executor_->executePlanWithoutGroupBy(ra_exe_unit_,
@@ -310,6 +316,9 @@ void Executor::ExecutionDispatch::runImpl(
                                             ra_exe_unit_.input_descs.size(),
                                             do_render ? render_info_ : nullptr);
   }
+  executor_->fetch_compute_stats_.compute_us +=
+      timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+          compute_clock_begin);
   if (device_results) {
     std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_to_hold;
     for (const auto chunk : chunks) {
@@ -320,6 +329,26 @@ void Executor::ExecutionDispatch::runImpl(
     device_results->holdChunks(chunks_to_hold);
     device_results->holdChunkIterators(chunk_iterators_ptr);
   }
+  if (!err && g_count_distinct_max_bytes &&
+      row_set_mem_owner_->getCountDistinctMemoryBytes() > g_count_distinct_max_bytes) {
+    LOG(ERROR) << "COUNT(DISTINCT) bitmaps and sets take "
+               << row_set_mem_owner_->getCountDistinctMemoryBytes()
+               << " bytes, more than the limit of " << g_count_distinct_max_bytes;
+    err = ERR_OUT_OF_CPU_MEM;
+  }
+  if (!err && result_spiller_ && !needs_skip_result(device_results)) {
+    // Only the partitions of the scratch files keep the rows, the group by buffer of the
+    // kernel goes back to the system before the other kernels allocate theirs.
+    try {
+      result_spiller_->spill(*device_results);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << e.what();
+      err = ERR_OUT_OF_CPU_MEM;
+    }
+    const auto group_by_buffer = device_results->getStorage()->getUnderlyingBuffer();
+    device_results.reset();
+    row_set_mem_owner_->freeGroupByBuffer(reinterpret_cast<int64_t*>(group_by_buffer));
+  }
   {
     std::lock_guard<std::mutex> lock(reduce_mutex_);
     if (err) {
@@ -602,7 +631,8 @@ const int8_t* Executor::ExecutionDispatch::getColumn(
   CHECK_LT(static_cast<size_t>(col_id), col_buffers.size());
   if (memory_level == Data_Namespace::GPU_LEVEL) {
     const auto& col_ti = columnar_results->getColumnType(col_id);
-    const auto num_bytes = columnar_results->size() * col_ti.get_size();
+    const auto num_bytes = columnar_results->getColumnHeaderSize(col_id) +
+                           columnar_results->size() * col_ti.get_size();
     OOM_TRACE_PUSH(+": device_id " + std::to_string(device_id) + ", num_bytes " +
                    std::to_string(num_bytes) + ", col_id " + std::to_string(col_id));
     auto gpu_col_buffer = alloc_gpu_mem(data_mgr, num_bytes, device_id, nullptr);
@@ -639,6 +669,15 @@ Executor::ExecutionDispatch::getFragmentResults() {
   return all_fragment_results_;
 }
 
+void Executor::ExecutionDispatch::setResultSpiller(
+    std::unique_ptr<ResultSetSpiller> result_spiller) {
+  result_spiller_ = std::move(result_spiller);
+}
+
+ResultSetSpiller* Executor::ExecutionDispatch::getResultSpiller() const {
+  return result_spiller_.get();
+}
+
 std::pair<const int8_t*, size_t> Executor::ExecutionDispatch::getColumnFragment(
     Executor* executor,
     const Analyzer::ColumnVar& hash_col,
@@ -658,7 +697,15 @@ std::pair<const int8_t*, size_t> Executor::ExecutionDispatch::getColumnFragment(
       hash_col.get_column_id(), hash_col.get_table_id(), catalog);
   CHECK(!cd || !(cd->isVirtualCol));
   const int8_t* col_buff = nullptr;
-  if (cd) {
+  if (cd && cd->columnType.is_packed_int()) {
+    col_buff = getPackedColumnFragment(executor,
+                                       cd,
+                                       fragment,
+                                       chunk_meta_it->second,
+                                       effective_mem_lvl,
+                                       device_id,
+                                       chunks_owner);
+  } else if (cd) {
     ChunkKey chunk_key{catalog.getCurrentDB().dbId,
                        fragment.physicalTableId,
                        hash_col.get_column_id(),
@@ -707,6 +754,50 @@ std::pair<const int8_t*, size_t> Executor::ExecutionDispatch::getColumnFragment(
   return {col_buff, fragment.getNumTuples()};
 }
 
+const int8_t* Executor::ExecutionDispatch::getPackedColumnFragment(
+    Executor* executor,
+    const ColumnDescriptor* cd,
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const ChunkMetadata& chunk_metadata,
+    const Data_Namespace::MemoryLevel effective_mem_lvl,
+    const int device_id,
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
+  const auto& catalog = *executor->getCatalog();
+  ChunkKey chunk_key{catalog.getCurrentDB().dbId,
+                     fragment.physicalTableId,
+                     cd->columnId,
+                     fragment.fragmentId};
+  OOM_TRACE_PUSH(+": chunk key [" + showChunk(chunk_key) + "]");
+  const auto chunk = Chunk_NS::Chunk::getChunk(cd,
+                                               &catalog.getDataMgr(),
+                                               chunk_key,
+                                               Data_Namespace::CPU_LEVEL,
+                                               0,
+                                               chunk_metadata.numBytes,
+                                               chunk_metadata.numElements);
+  chunks_owner.push_back(chunk);
+  CHECK(chunk);
+  auto ab = chunk->get_buffer();
+  CHECK(ab->getMemoryPtr());
+  // The hash tables are built from the plain values.
+  const auto& col_ti = cd->columnType;
+  const auto num_bytes = fragment.getNumTuples() * col_ti.get_size();
+  auto col_buff = reinterpret_cast<int8_t*>(checked_malloc(num_bytes));
+  executor->row_set_mem_owner_->addColBuffer(col_buff);
+  unpack_int_chunk(col_buff,
+                   ab->getMemoryPtr(),
+                   fragment.getNumTuples(),
+                   col_ti.get_size(),
+                   inline_int_null_val(col_ti));
+  if (effective_mem_lvl == Data_Namespace::GPU_LEVEL) {
+    auto& data_mgr = catalog.getDataMgr();
+    auto gpu_col_buff = alloc_gpu_mem(&data_mgr, num_bytes, device_id, nullptr);
+    copy_to_gpu(&data_mgr, gpu_col_buff, col_buff, num_bytes, device_id);
+    return reinterpret_cast<const int8_t*>(gpu_col_buff);
+  }
+  return col_buff;
+}
+
 std::pair<const int8_t*, size_t> Executor::ExecutionDispatch::getAllColumnFragments(
     Executor* executor,
     const Analyzer::ColumnVar& hash_col,
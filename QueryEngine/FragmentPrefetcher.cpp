@@ -0,0 +1,213 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FragmentPrefetcher.h"
+#include "Execute.h"
+
+#include "../Catalog/Catalog.h"
+#include "../Chunk/Chunk.h"
+#include "../Shared/measure.h"
+
+#include <algorithm>
+
+FragmentPrefetcher::FragmentPrefetcher(const Catalog_Namespace::Catalog& cat,
+                                       const RelAlgExecutionUnit& ra_exe_unit,
+                                       const std::vector<InputTableInfo>& table_infos,
+                                       const std::vector<FragmentsList>& kernel_frag_lists,
+                                       const size_t depth,
+                                       const size_t max_pinned_bytes,
+                                       FetchComputeStats& stats)
+    : cat_(cat)
+    , depth_(depth)
+    , max_pinned_bytes_(max_pinned_bytes)
+    , stats_(stats)
+    , kernels_(kernel_frag_lists.size())
+    , pinned_bytes_(0)
+    , first_unreleased_(0)
+    , failed_(false)
+    , cancelled_(TaskPool_NS::TaskPool::getContext().cancelled)
+    , shutdown_(false) {
+  CHECK(!ra_exe_unit.input_descs.empty());
+  const int outer_table_id = ra_exe_unit.input_descs[0].getTableId();
+  if (outer_table_id <= 0) {
+    return;
+  }
+  const auto table_info_it =
+      std::find_if(table_infos.begin(),
+                   table_infos.end(),
+                   [outer_table_id](const InputTableInfo& table_info) {
+                     return table_info.table_id == outer_table_id;
+                   });
+  CHECK(table_info_it != table_infos.end());
+  const auto& fragments = table_info_it->info.fragments;
+  // Only the fixed width columns of the outer table, the chunks of the inner tables are
+  // shared by all the kernels and varlen chunks are fetched under a lock by the kernels.
+  std::vector<const ColumnDescriptor*> cds;
+  for (const auto& input_col_desc : ra_exe_unit.input_col_descs) {
+    if (input_col_desc->getScanDesc().getTableId() != outer_table_id) {
+      continue;
+    }
+    const auto cd =
+        get_column_descriptor(input_col_desc->getColId(), outer_table_id, cat_);
+    CHECK(cd);
+    if (cd->isVirtualCol || cd->columnType.is_varlen()) {
+      continue;
+    }
+    cds.push_back(cd);
+  }
+  const int db_id = cat_.getCurrentDB().dbId;
+  for (size_t kernel_idx = 0; kernel_idx < kernel_frag_lists.size(); ++kernel_idx) {
+    const auto& frag_list = kernel_frag_lists[kernel_idx];
+    CHECK(!frag_list.empty());
+    CHECK_EQ(frag_list[0].table_id, outer_table_id);
+    auto& kernel = kernels_[kernel_idx];
+    for (const auto frag_idx : frag_list[0].fragment_ids) {
+      CHECK_LT(frag_idx, fragments.size());
+      const auto& fragment = fragments[frag_idx];
+      if (fragment.isEmptyPhysicalFragment()) {
+        continue;
+      }
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+      for (const auto cd : cds) {
+        const auto chunk_meta_it = chunk_metadata_map.find(cd->columnId);
+        CHECK(chunk_meta_it != chunk_metadata_map.end());
+        kernel.chunks.push_back(
+            {cd,
+             {db_id, fragment.physicalTableId, cd->columnId, fragment.fragmentId},
+             chunk_meta_it->second.numBytes,
+             chunk_meta_it->second.numElements});
+        kernel.num_bytes += chunk_meta_it->second.numBytes;
+      }
+    }
+  }
+}
+
+FragmentPrefetcher::~FragmentPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  queued_.notify_one();
+  if (fetch_thread_.joinable()) {
+    fetch_thread_.join();
+  }
+  for (auto& kernel : kernels_) {
+    release(kernel);
+  }
+}
+
+void FragmentPrefetcher::prefetch(const size_t kernel_idx) {
+  bool queued{false};
+  for (size_t i = kernel_idx; i < std::min(kernel_idx + depth_, kernels_.size()); ++i) {
+    auto& kernel = kernels_[i];
+    if (kernel.started || kernel.chunks.empty()) {
+      continue;
+    }
+    if (failed_ || pinned_bytes_ + kernel.num_bytes > max_pinned_bytes_) {
+      // Kernels are prefetched in dispatch order only, the later ones would be evicted
+      // before the earlier ones are done.
+      break;
+    }
+    kernel.started = true;
+    pinned_bytes_ += kernel.num_bytes;
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(i);
+    queued = true;
+  }
+  if (!queued) {
+    return;
+  }
+  if (!fetch_thread_.joinable()) {
+    fetch_thread_ = std::thread([this] { fetchLoop(); });
+  }
+  queued_.notify_one();
+}
+
+void FragmentPrefetcher::fetchLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queued_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    auto& kernel = kernels_[queue_.front()];
+    queue_.pop_front();
+    if (!shutdown_) {
+      lock.unlock();
+      fetch(kernel);
+      lock.lock();
+    }
+    kernel.fetched = true;
+    fetched_.notify_all();
+  }
+}
+
+void FragmentPrefetcher::fetch(KernelPrefetch& kernel) {
+  auto& data_mgr = cat_.getDataMgr();
+  const auto prefetch_us = measure<std::chrono::microseconds>::execution([&]() {
+    for (const auto& chunk : kernel.chunks) {
+      if (failed_ || (cancelled_ && *cancelled_)) {
+        return;
+      }
+      try {
+        kernel.held.push_back(Chunk_NS::Chunk::getChunk(chunk.cd,
+                                                        &data_mgr,
+                                                        chunk.key,
+                                                        Data_Namespace::CPU_LEVEL,
+                                                        0,
+                                                        chunk.num_bytes,
+                                                        chunk.num_elems));
+      } catch (const std::exception& e) {
+        // The kernel fetches the chunk itself and reports the error if it persists.
+        LOG(INFO) << "Stopped prefetching fragments: " << e.what();
+        failed_ = true;
+        return;
+      }
+    }
+  });
+  stats_.prefetch_us += prefetch_us;
+  stats_.prefetched_chunks += kernel.held.size();
+}
+
+void FragmentPrefetcher::releaseFinished(
+    const std::vector<TaskPool_NS::TaskFuture<void>>& kernels) {
+  CHECK_LE(kernels.size(), kernels_.size());
+  for (size_t i = first_unreleased_; i < kernels.size(); ++i) {
+    if (!kernels_[i].released && kernels[i].ready()) {
+      release(kernels_[i]);
+    }
+    if (kernels_[i].released && i == first_unreleased_) {
+      ++first_unreleased_;
+    }
+  }
+}
+
+void FragmentPrefetcher::release(KernelPrefetch& kernel) {
+  if (kernel.released) {
+    return;
+  }
+  kernel.released = true;
+  if (!kernel.started) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    fetched_.wait(lock, [&kernel] { return kernel.fetched; });
+  }
+  kernel.held.clear();  // unpins the chunks
+  CHECK_GE(pinned_bytes_, kernel.num_bytes);
+  pinned_bytes_ -= kernel.num_bytes;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    FragmentPrefetcher.h
+ * @brief   Fetches the chunks of the upcoming fragment kernels into the CPU buffer pool
+ *          while the current ones execute.
+ *
+ * When all the CPU threads of an executor are busy, a fragment kernel has to wait for a
+ * running one before it is dispatched and only then fetches its chunks. The prefetcher
+ * pins the outer table chunks of the next few kernels from a separate fetch stage in the
+ * meantime, so that the kernels find them resident and only compute. The chunks stay
+ * pinned until the kernel which reads them has finished, the total size pinned is capped.
+ *
+ * The fetches block on disk reads, they run on a thread of the prefetcher rather than on
+ * the task pool, whose workers are all busy with the kernels when prefetching matters.
+ */
+
+#ifndef QUERYENGINE_FRAGMENTPREFETCHER_H
+#define QUERYENGINE_FRAGMENTPREFETCHER_H
+
+#include "Descriptors/QueryFragmentDescriptor.h"
+#include "ResultSet.h"
+
+#include "../Shared/TaskPool.h"
+#include "../Shared/types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+struct ColumnDescriptor;
+
+// Accumulated concurrently by the kernels and the fetch stage, in microseconds.
+struct FetchComputeStats {
+  std::atomic<int64_t> fetch_us{0};
+  std::atomic<int64_t> prefetch_us{0};
+  std::atomic<int64_t> compute_us{0};
+  std::atomic<size_t> prefetched_chunks{0};
+  std::atomic<int64_t> compile_saved_us{0};
+
+  void reset() {
+    fetch_us = 0;
+    prefetch_us = 0;
+    compute_us = 0;
+    prefetched_chunks = 0;
+    compile_saved_us = 0;
+  }
+
+  KernelTimes getKernelTimes() const {
+    return {fetch_us / 1000,
+            prefetch_us / 1000,
+            compute_us / 1000,
+            prefetched_chunks,
+            compile_saved_us / 1000};
+  }
+};
+
+class FragmentPrefetcher {
+ public:
+  FragmentPrefetcher(const Catalog_Namespace::Catalog& cat,
+                     const RelAlgExecutionUnit& ra_exe_unit,
+                     const std::vector<InputTableInfo>& table_infos,
+                     const std::vector<FragmentsList>& kernel_frag_lists,
+                     const size_t depth,
+                     const size_t max_pinned_bytes,
+                     FetchComputeStats& stats);
+
+  // Skips the kernels not fetched yet, stops the fetch thread and releases all the
+  // chunks still held.
+  ~FragmentPrefetcher();
+
+  // Starts fetching the chunks of the kernels from kernel_idx on, up to the depth and
+  // as long as the pinned bytes stay under the cap. Kernels already started are skipped.
+  void prefetch(const size_t kernel_idx);
+
+  // Releases the chunks held for the kernels which have finished.
+  void releaseFinished(const std::vector<TaskPool_NS::TaskFuture<void>>& kernels);
+
+ private:
+  struct ChunkToFetch {
+    const ColumnDescriptor* cd;
+    ChunkKey key;
+    size_t num_bytes;
+    size_t num_elems;
+  };
+
+  struct KernelPrefetch {
+    std::vector<ChunkToFetch> chunks;
+    size_t num_bytes{0};
+    bool started{false};
+    bool released{false};
+    bool fetched{false};  // guarded by mutex_
+    std::vector<std::shared_ptr<Chunk_NS::Chunk>> held;
+  };
+
+  void fetchLoop();
+  void fetch(KernelPrefetch& kernel);
+  void release(KernelPrefetch& kernel);
+
+  const Catalog_Namespace::Catalog& cat_;
+  const size_t depth_;
+  const size_t max_pinned_bytes_;
+  FetchComputeStats& stats_;
+  std::vector<KernelPrefetch> kernels_;
+  size_t pinned_bytes_;
+  size_t first_unreleased_;
+  std::atomic<bool> failed_;
+  // The cancellation flag of the query, the fetches don't run on its tasks.
+  const std::shared_ptr<TaskPool_NS::CancellationFlag> cancelled_;
+
+  std::mutex mutex_;
+  std::condition_variable fetched_;
+  std::condition_variable queued_;
+  std::deque<size_t> queue_;  // kernels started but not fetched yet, in dispatch order
+  bool shutdown_;
+  std::thread fetch_thread_;  // started with the first prefetch
+};
+
+#endif  // QUERYENGINE_FRAGMENTPREFETCHER_H
@@ -105,6 +105,7 @@ void Executor::interrupt() {
   dynamic_watchdog_init(static_cast<unsigned>(DW_ABORT));
 
   interrupted_ = true;
+  task_cancellation_flag_->store(true);
   VLOG(1) << "INTERRUPT Executor " << this;
 }
 
@@ -120,5 +121,6 @@ void Executor::resetInterrupt() {
   dynamic_watchdog_init(static_cast<unsigned>(DW_RESET));
 
   interrupted_ = false;
+  task_cancellation_flag_->store(false);
   VLOG(1) << "RESET Executor " << this << " that had previously been interrupted";
 }
@@ -495,7 +495,7 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
       ColRangeInfo no_range_info{QueryDescriptionType::Projection, 0, 0, 0, false};
       auto arg_range_info =
           arg_ti.is_fp() ? no_range_info : getExprRangeInfo(agg_expr->get_arg());
-      CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::StdSet};
+      CountDistinctImplType count_distinct_impl_type{CountDistinctImplType::HashSet};
       int64_t bitmap_sz_bits{0};
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
         const auto error_rate = agg_expr->get_error_rate();
@@ -525,17 +525,17 @@ CountDistinctDescriptors GroupByAndAggregate::initCountDistinctDescriptors() {
           bitmap_sz_bits = arg_range_info.max - arg_range_info.min + 1;
           const int64_t MAX_BITMAP_BITS{8 * 1000 * 1000 * 1000L};
           if (bitmap_sz_bits <= 0 || bitmap_sz_bits > MAX_BITMAP_BITS) {
-            count_distinct_impl_type = CountDistinctImplType::StdSet;
+            count_distinct_impl_type = CountDistinctImplType::HashSet;
           }
         }
       }
       if (agg_info.agg_kind == kAPPROX_COUNT_DISTINCT &&
-          count_distinct_impl_type == CountDistinctImplType::StdSet &&
+          count_distinct_impl_type == CountDistinctImplType::HashSet &&
           !(arg_ti.is_array() || arg_ti.is_geometry())) {
         count_distinct_impl_type = CountDistinctImplType::Bitmap;
       }
       if (g_enable_watchdog &&
-          count_distinct_impl_type == CountDistinctImplType::StdSet) {
+          count_distinct_impl_type == CountDistinctImplType::HashSet) {
         throw WatchdogException("Cannot use a fast path for COUNT distinct");
       }
       const auto sub_bitmap_count =
@@ -1448,7 +1448,10 @@ llvm::Value* GroupByAndAggregate::codegenWindowRowPointer(
     DiamondCodegen& diamond_codegen) {
   const auto window_func_context =
       WindowProjectNodeContext::getActiveWindowFunctionContext();
-  if (window_func_context && window_function_is_aggregate(window_func->getKind())) {
+  // Aggregates over a frame are read by row position like the rank functions, the others
+  // write their output in the iteration order of the window.
+  if (window_func_context && window_function_is_aggregate(window_func->getKind()) &&
+      !window_func->getFrame()) {
     const int32_t row_size_quad =
         outputColumnar() ? 0 : query_mem_desc.getRowSize() / sizeof(int64_t);
     auto arg_it = ROW_FUNC->arg_begin();
@@ -1561,7 +1564,8 @@ bool GroupByAndAggregate::codegenAggCalls(
     if (window_row_ptr) {
       agg_out_ptr_w_idx =
           std::make_tuple(window_row_ptr, std::get<1>(agg_out_ptr_w_idx_in));
-      if (window_function_is_aggregate(window_func->getKind())) {
+      if (window_function_is_aggregate(window_func->getKind()) &&
+          !window_func->getFrame()) {
         out_row_idx = window_row_ptr;
       }
     }
@@ -1934,7 +1938,7 @@ void GroupByAndAggregate::codegenEstimator(
 }
 
 extern "C" void agg_count_distinct(int64_t* agg, const int64_t val) {
-  reinterpret_cast<std::set<int64_t>*>(*agg)->insert(val);
+  reinterpret_cast<CountDistinctSet*>(*agg)->insert(val);
 }
 
 extern "C" void agg_count_distinct_skip_val(int64_t* agg,
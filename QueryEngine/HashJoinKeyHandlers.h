@@ -33,6 +33,24 @@
 
 #include "../Shared/funcannotations.h"
 
+#ifndef __CUDACC__
+// Translation of the ids of the inner dictionary to the outer one, null if the join
+// doesn't go across dictionaries.
+inline const StringDictionaryProxy::TranslationMap* get_translation_map(
+    const void* sd_inner_proxy,
+    const void* sd_outer_proxy) {
+  if (!sd_inner_proxy) {
+    return nullptr;
+  }
+  CHECK(sd_outer_proxy);
+  if (sd_inner_proxy == sd_outer_proxy) {
+    return nullptr;
+  }
+  return static_cast<const StringDictionaryProxy*>(sd_inner_proxy)
+      ->getTranslationMap(static_cast<const StringDictionaryProxy*>(sd_outer_proxy));
+}
+#endif
+
 DEVICE inline int64_t get_join_column_element_value(const JoinColumnTypeInfo& type_info,
                                                     const JoinColumn& join_column,
                                                     const size_t i) {
@@ -67,8 +85,7 @@ struct GenericKeyHandler {
                     const JoinColumnTypeInfo* type_info_per_key
 #ifndef __CUDACC__
                     ,
-                    const void* const* sd_inner_proxy_per_key,
-                    const void* const* sd_outer_proxy_per_key
+                    const void* const* sd_translation_map_per_key
 #endif
                     )
       : key_component_count_(key_component_count)
@@ -76,16 +93,10 @@ struct GenericKeyHandler {
       , join_column_per_key_(join_column_per_key)
       , type_info_per_key_(type_info_per_key) {
 #ifndef __CUDACC__
-    if (sd_inner_proxy_per_key) {
-      CHECK(sd_outer_proxy_per_key);
-      sd_inner_proxy_per_key_ = sd_inner_proxy_per_key;
-      sd_outer_proxy_per_key_ = sd_outer_proxy_per_key;
-    } else
+    sd_translation_map_per_key_ = sd_translation_map_per_key;
+#else
+    sd_translation_map_per_key_ = nullptr;
 #endif
-    {
-      sd_inner_proxy_per_key_ = nullptr;
-      sd_outer_proxy_per_key_ = nullptr;
-    }
   }
 
   template <typename T, typename KEY_BUFF_HANDLER>
@@ -101,20 +112,13 @@ struct GenericKeyHandler {
         break;
       }
 #ifndef __CUDACC__
-      const auto sd_inner_proxy = sd_inner_proxy_per_key_
-                                      ? sd_inner_proxy_per_key_[key_component_index]
-                                      : nullptr;
-      const auto sd_outer_proxy = sd_outer_proxy_per_key_
-                                      ? sd_outer_proxy_per_key_[key_component_index]
-                                      : nullptr;
-      if (sd_inner_proxy && elem != type_info.null_val) {
-        CHECK(sd_outer_proxy);
-        const auto sd_inner_dict_proxy =
-            static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-        const auto sd_outer_dict_proxy =
-            static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-        const auto elem_str = sd_inner_dict_proxy->getString(elem);
-        const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+      const auto translation_map =
+          sd_translation_map_per_key_
+              ? static_cast<const StringDictionaryProxy::TranslationMap*>(
+                    sd_translation_map_per_key_[key_component_index])
+              : nullptr;
+      if (translation_map && elem != type_info.null_val) {
+        const auto outer_id = translation_map->translate(elem);
         if (outer_id == StringDictionary::INVALID_STR_ID) {
           skip_entry = true;
           break;
@@ -136,8 +140,7 @@ struct GenericKeyHandler {
   const bool should_skip_entries_;
   const JoinColumn* join_column_per_key_;
   const JoinColumnTypeInfo* type_info_per_key_;
-  const void* const* sd_inner_proxy_per_key_;
-  const void* const* sd_outer_proxy_per_key_;
+  const void* const* sd_translation_map_per_key_;
 };
 
 struct OverlapsKeyHandler {
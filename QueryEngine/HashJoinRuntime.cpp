@@ -79,6 +79,7 @@ DEVICE int SUFFIX(fill_hash_join_buff)(int32_t* buff,
 #else
   int32_t start = cpu_thread_idx;
   int32_t step = cpu_thread_count;
+  const auto translation_map = get_translation_map(sd_inner_proxy, sd_outer_proxy);
 #endif
   for (size_t i = start; i < join_column.num_elems; i += step) {
     int64_t elem = get_join_column_element_value(type_info, join_column, i);
@@ -90,15 +91,9 @@ DEVICE int SUFFIX(fill_hash_join_buff)(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      CHECK(sd_outer_proxy);
-      const auto sd_inner_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-      const auto sd_outer_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-      const auto elem_str = sd_inner_dict_proxy->getString(elem);
-      const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+      const auto outer_id = translation_map->translate(elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -130,6 +125,7 @@ DEVICE int SUFFIX(fill_hash_join_buff_sharded)(int32_t* buff,
 #else
   int32_t start = cpu_thread_idx;
   int32_t step = cpu_thread_count;
+  const auto translation_map = get_translation_map(sd_inner_proxy, sd_outer_proxy);
 #endif
   for (size_t i = start; i < join_column.num_elems; i += step) {
     int64_t elem = get_join_column_element_value(type_info, join_column, i);
@@ -145,15 +141,9 @@ DEVICE int SUFFIX(fill_hash_join_buff_sharded)(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      CHECK(sd_outer_proxy);
-      const auto sd_inner_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-      const auto sd_outer_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-      const auto elem_str = sd_inner_dict_proxy->getString(elem);
-      const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+      const auto outer_id = translation_map->translate(elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -391,6 +381,7 @@ GLOBAL void SUFFIX(count_matches)(int32_t* count_buff,
 #else
   int32_t start = cpu_thread_idx;
   int32_t step = cpu_thread_count;
+  const auto translation_map = get_translation_map(sd_inner_proxy, sd_outer_proxy);
 #endif
   for (size_t i = start; i < join_column.num_elems; i += step) {
     int64_t elem = get_join_column_element_value(type_info, join_column, i);
@@ -402,15 +393,9 @@ GLOBAL void SUFFIX(count_matches)(int32_t* count_buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      CHECK(sd_outer_proxy);
-      const auto sd_inner_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-      const auto sd_outer_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-      const auto elem_str = sd_inner_dict_proxy->getString(elem);
-      const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+      const auto outer_id = translation_map->translate(elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -443,6 +428,7 @@ GLOBAL void SUFFIX(count_matches_sharded)(int32_t* count_buff,
 #else
   int32_t start = cpu_thread_idx;
   int32_t step = cpu_thread_count;
+  const auto translation_map = get_translation_map(sd_inner_proxy, sd_outer_proxy);
 #endif
   for (size_t i = start; i < join_column.num_elems; i += step) {
     int64_t elem = get_join_column_element_value(type_info, join_column, i);
@@ -454,15 +440,9 @@ GLOBAL void SUFFIX(count_matches_sharded)(int32_t* count_buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      CHECK(sd_outer_proxy);
-      const auto sd_inner_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-      const auto sd_outer_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-      const auto elem_str = sd_inner_dict_proxy->getString(elem);
-      const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+      const auto outer_id = translation_map->translate(elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -572,6 +552,7 @@ GLOBAL void SUFFIX(fill_row_ids)(int32_t* buff,
 #else
   int32_t start = cpu_thread_idx;
   int32_t step = cpu_thread_count;
+  const auto translation_map = get_translation_map(sd_inner_proxy, sd_outer_proxy);
 #endif
   for (size_t i = start; i < join_column.num_elems; i += step) {
     int64_t elem = get_join_column_element_value(type_info, join_column, i);
@@ -583,15 +564,9 @@ GLOBAL void SUFFIX(fill_row_ids)(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      CHECK(sd_outer_proxy);
-      const auto sd_inner_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-      const auto sd_outer_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-      const auto elem_str = sd_inner_dict_proxy->getString(elem);
-      const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+      const auto outer_id = translation_map->translate(elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -634,6 +609,7 @@ GLOBAL void SUFFIX(fill_row_ids_sharded)(int32_t* buff,
 #else
   int32_t start = cpu_thread_idx;
   int32_t step = cpu_thread_count;
+  const auto translation_map = get_translation_map(sd_inner_proxy, sd_outer_proxy);
 #endif
   for (size_t i = start; i < join_column.num_elems; i += step) {
     int64_t elem = get_join_column_element_value(type_info, join_column, i);
@@ -645,15 +621,9 @@ GLOBAL void SUFFIX(fill_row_ids_sharded)(int32_t* buff,
       }
     }
 #ifndef __CUDACC__
-    if (sd_inner_proxy &&
+    if (translation_map &&
         (!type_info.uses_bw_eq || elem != type_info.translated_null_val)) {
-      CHECK(sd_outer_proxy);
-      const auto sd_inner_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_inner_proxy);
-      const auto sd_outer_dict_proxy =
-          static_cast<const StringDictionaryProxy*>(sd_outer_proxy);
-      const auto elem_str = sd_inner_dict_proxy->getString(elem);
-      const auto outer_id = sd_outer_dict_proxy->getIdOfString(elem_str);
+      const auto outer_id = translation_map->translate(elem);
       if (outer_id == StringDictionary::INVALID_STR_ID) {
         continue;
       }
@@ -1185,8 +1155,7 @@ void fill_one_to_many_baseline_hash_table(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_buckets_per_key,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const void*>& sd_translation_map_per_key,
     const int32_t cpu_thread_count) {
   int32_t* pos_buff = buff;
   int32_t* count_buff = buff + hash_entry_count;
@@ -1224,16 +1193,14 @@ void fill_one_to_many_baseline_hash_table(
            &hash_entry_count,
            &join_column_per_key,
            &type_info_per_key,
-           &sd_inner_proxy_per_key,
-           &sd_outer_proxy_per_key,
+           &sd_translation_map_per_key,
            cpu_thread_idx,
            cpu_thread_count] {
             const auto key_handler = GenericKeyHandler(key_component_count,
                                                        true,
                                                        &join_column_per_key[0],
                                                        &type_info_per_key[0],
-                                                       &sd_inner_proxy_per_key[0],
-                                                       &sd_outer_proxy_per_key[0]);
+                                                       &sd_translation_map_per_key[0]);
             count_matches_baseline(count_buff,
                                    composite_key_dict,
                                    hash_entry_count,
@@ -1308,8 +1275,7 @@ void fill_one_to_many_baseline_hash_table(
                                           key_component_count,
                                           &join_column_per_key,
                                           &type_info_per_key,
-                                          &sd_inner_proxy_per_key,
-                                          &sd_outer_proxy_per_key,
+                                          &sd_translation_map_per_key,
                                           cpu_thread_idx,
                                           cpu_thread_count] {
                                            const auto key_handler = GenericKeyHandler(
@@ -1317,8 +1283,7 @@ void fill_one_to_many_baseline_hash_table(
                                                true,
                                                &join_column_per_key[0],
                                                &type_info_per_key[0],
-                                               &sd_inner_proxy_per_key[0],
-                                               &sd_outer_proxy_per_key[0]);
+                                               &sd_translation_map_per_key[0]);
                                            SUFFIX(fill_row_ids_baseline)
                                            (buff,
                                             composite_key_dict,
@@ -1346,8 +1311,7 @@ void fill_one_to_many_baseline_hash_table_32(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const void*>& sd_translation_map_per_key,
     const int32_t cpu_thread_count) {
   fill_one_to_many_baseline_hash_table<int32_t>(buff,
                                                 composite_key_dict,
@@ -1357,8 +1321,7 @@ void fill_one_to_many_baseline_hash_table_32(
                                                 join_column_per_key,
                                                 type_info_per_key,
                                                 join_bucket_info,
-                                                sd_inner_proxy_per_key,
-                                                sd_outer_proxy_per_key,
+                                                sd_translation_map_per_key,
                                                 cpu_thread_count);
 }
 
@@ -1371,8 +1334,7 @@ void fill_one_to_many_baseline_hash_table_64(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const void*>& sd_translation_map_per_key,
     const int32_t cpu_thread_count) {
   fill_one_to_many_baseline_hash_table<int64_t>(buff,
                                                 composite_key_dict,
@@ -1382,8 +1344,7 @@ void fill_one_to_many_baseline_hash_table_64(
                                                 join_column_per_key,
                                                 type_info_per_key,
                                                 join_bucket_info,
-                                                sd_inner_proxy_per_key,
-                                                sd_outer_proxy_per_key,
+                                                sd_translation_map_per_key,
                                                 cpu_thread_count);
 }
 
@@ -1413,7 +1374,6 @@ void approximate_distinct_tuples(uint8_t* hll_buffer_all_cpus,
                                                      false,
                                                      &join_column_per_key[0],
                                                      &type_info_per_key[0],
-                                                     nullptr,
                                                      nullptr);
           approximate_distinct_tuples_impl(hll_buffer,
                                            nullptr,
@@ -260,8 +260,7 @@ void fill_one_to_many_baseline_hash_table_32(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const void*>& sd_translation_map_per_key,
     const int32_t cpu_thread_count);
 
 void fill_one_to_many_baseline_hash_table_64(
@@ -273,8 +272,7 @@ void fill_one_to_many_baseline_hash_table_64(
     const std::vector<JoinColumn>& join_column_per_key,
     const std::vector<JoinColumnTypeInfo>& type_info_per_key,
     const std::vector<JoinBucketInfo>& join_bucket_info,
-    const std::vector<const void*>& sd_inner_proxy_per_key,
-    const std::vector<const void*>& sd_outer_proxy_per_key,
+    const std::vector<const void*>& sd_translation_map_per_key,
     const int32_t cpu_thread_count);
 
 void fill_one_to_many_baseline_hash_table_on_device_32(
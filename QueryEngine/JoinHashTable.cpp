@@ -21,6 +21,8 @@
 #include "RangeTableIndexVisitor.h"
 #include "RuntimeFunctions.h"
 
+#include "Shared/TaskPool.h"
+
 #include <glog/logging.h>
 #include <future>
 #include <numeric>
@@ -457,7 +459,7 @@ void JoinHashTable::reify(const int device_count) {
   gpu_hash_table_buff_.resize(device_count);
   gpu_hash_table_err_buff_.resize(device_count);
 #endif  // HAVE_CUDA
-  std::vector<std::future<void>> init_threads;
+  std::vector<TaskPool_NS::TaskFuture<void>> init_threads;
   const int shard_count = shardCount();
 
   try {
@@ -466,11 +468,8 @@ void JoinHashTable::reify(const int device_count) {
           shard_count
               ? only_shards_for_device(query_info.fragments, device_id, device_count)
               : query_info.fragments;
-      init_threads.push_back(std::async(std::launch::async,
-                                        &JoinHashTable::reifyOneToOneForDevice,
-                                        this,
-                                        fragments,
-                                        device_id));
+      init_threads.push_back(TaskPool_NS::async(
+          &JoinHashTable::reifyOneToOneForDevice, this, fragments, device_id));
     }
     for (auto& init_thread : init_threads) {
       init_thread.wait();
@@ -489,11 +488,8 @@ void JoinHashTable::reify(const int device_count) {
               ? only_shards_for_device(query_info.fragments, device_id, device_count)
               : query_info.fragments;
 
-      init_threads.push_back(std::async(std::launch::async,
-                                        &JoinHashTable::reifyOneToManyForDevice,
-                                        this,
-                                        fragments,
-                                        device_id));
+      init_threads.push_back(TaskPool_NS::async(
+          &JoinHashTable::reifyOneToManyForDevice, this, fragments, device_id));
     }
     for (auto& init_thread : init_threads) {
       init_thread.wait();
@@ -708,33 +704,36 @@ void JoinHashTable::initHashTableOnCpu(
       CHECK(sd_outer_proxy);
     }
     int thread_count = cpu_threads();
-    std::vector<std::thread> init_cpu_buff_threads;
+    std::vector<TaskPool_NS::TaskFuture<void>> init_cpu_buff_threads;
     for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      init_cpu_buff_threads.emplace_back(
+      init_cpu_buff_threads.emplace_back(TaskPool_NS::async(
           [this, hash_entry_count, hash_join_invalid_val, thread_idx, thread_count] {
             init_hash_join_buff(&(*cpu_hash_table_buff_)[0],
                                 hash_entry_count,
                                 hash_join_invalid_val,
                                 thread_idx,
                                 thread_count);
-          });
+          }));
+    }
+    for (auto& t : init_cpu_buff_threads) {
+      t.wait();
     }
     for (auto& t : init_cpu_buff_threads) {
-      t.join();
+      t.get();
     }
     init_cpu_buff_threads.clear();
     int err{0};
     for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      init_cpu_buff_threads.emplace_back([this,
-                                          hash_join_invalid_val,
-                                          col_buff,
-                                          num_elements,
-                                          sd_inner_proxy,
-                                          sd_outer_proxy,
-                                          thread_idx,
-                                          thread_count,
-                                          &ti,
-                                          &err] {
+      init_cpu_buff_threads.emplace_back(TaskPool_NS::async([this,
+                                                             hash_join_invalid_val,
+                                                             col_buff,
+                                                             num_elements,
+                                                             sd_inner_proxy,
+                                                             sd_outer_proxy,
+                                                             thread_idx,
+                                                             thread_count,
+                                                             &ti,
+                                                             &err] {
         int partial_err = fill_hash_join_buff(&(*cpu_hash_table_buff_)[0],
                                               hash_join_invalid_val,
                                               {col_buff, num_elements},
@@ -749,10 +748,13 @@ void JoinHashTable::initHashTableOnCpu(
                                               thread_idx,
                                               thread_count);
         __sync_val_compare_and_swap(&err, 0, partial_err);
-      });
+      }));
+    }
+    for (auto& t : init_cpu_buff_threads) {
+      t.wait();
     }
     for (auto& t : init_cpu_buff_threads) {
-      t.join();
+      t.get();
     }
     if (err) {
       cpu_hash_table_buff_.reset();
@@ -795,15 +797,14 @@ void JoinHashTable::initOneToManyHashTableOnCpu(
     CHECK(sd_outer_proxy);
   }
   int thread_count = cpu_threads();
-  std::vector<std::future<void>> init_threads;
+  std::vector<TaskPool_NS::TaskFuture<void>> init_threads;
   for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-    init_threads.emplace_back(std::async(std::launch::async,
-                                         init_hash_join_buff,
-                                         &(*cpu_hash_table_buff_)[0],
-                                         hash_entry_count,
-                                         hash_join_invalid_val,
-                                         thread_idx,
-                                         thread_count));
+    init_threads.emplace_back(TaskPool_NS::async(init_hash_join_buff,
+                                                 &(*cpu_hash_table_buff_)[0],
+                                                 hash_entry_count,
+                                                 hash_join_invalid_val,
+                                                 thread_idx,
+                                                 thread_count));
   }
   for (auto& child : init_threads) {
     child.wait();
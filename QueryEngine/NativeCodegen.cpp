@@ -17,8 +17,10 @@
 #include "Execute.h"
 #include "ExtensionFunctionsWhitelist.h"
 #include "LLVMFunctionAttributesUtil.h"
+#include "PersistentCodeCache.h"
 #include "QueryTemplateGenerator.h"
 
+#include "MapDRelease.h"
 #include "Shared/mapdpath.h"
 
 #if LLVM_VERSION_MAJOR >= 4
@@ -28,6 +30,7 @@
 #include <llvm/Bitcode/ReaderWriter.h>
 #endif
 #include <llvm/ExecutionEngine/MCJIT.h>
+#include <llvm/ExecutionEngine/ObjectCache.h>
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/GlobalValue.h>
 #include <llvm/IR/InstIterator.h>
@@ -36,6 +39,7 @@
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/FormattedStream.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetRegistry.h>
@@ -148,6 +152,49 @@ std::string serialize_llvm_object(const T* llvm_obj) {
   return ss.str();
 }
 
+// The serialized IR keys the native code within a process, the code persisted across
+// restarts also depends on the UDFs loaded, the compiler and the CPU.
+std::string get_persistent_code_cache_key(const std::vector<std::string>& ir) {
+  std::string key = MAPD_RELEASE + "\n" + LLVM_VERSION_STRING + "\n" +
+                    llvm::sys::getProcessTriple() + "\n" +
+                    llvm::sys::getHostCPUName().str() + "\n";
+  if (is_udf_module_present()) {
+    std::stringstream ss;
+    llvm::raw_os_ostream os(ss);
+    udf_cpu_module->print(os, nullptr);
+    os.flush();
+    key += ss.str();
+  }
+  for (const auto& ir_str : ir) {
+    key += ir_str;
+  }
+  return key;
+}
+
+// Hands MCJIT the persisted object of the module instead of compiling it, or keeps the
+// object compiled to persist it.
+class CpuObjectCache : public llvm::ObjectCache {
+ public:
+  CpuObjectCache(const std::string& cached_object) : cached_object_(cached_object) {}
+
+  void notifyObjectCompiled(const llvm::Module*, llvm::MemoryBufferRef obj) override {
+    compiled_object_ = obj.getBuffer().str();
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module*) override {
+    if (cached_object_.empty()) {
+      return nullptr;
+    }
+    return llvm::MemoryBuffer::getMemBufferCopy(cached_object_);
+  }
+
+  const std::string& getCompiledObject() const { return compiled_object_; }
+
+ private:
+  const std::string& cached_object_;
+  std::string compiled_object_;
+};
+
 }  // namespace
 
 std::vector<std::pair<void*, void*>> Executor::getCodeFromCache(const CodeCacheKey& key,
@@ -202,9 +249,21 @@ std::vector<std::pair<void*, void*>> Executor::optimizeAndCodegenCPU(
     return cached_code;
   }
 
-  // run optimizations
+  auto persistent_cache = PersistentCodeCache::instance();
+  std::string persistent_key;
+  std::string persisted_object;
+  int64_t persisted_compile_us{0};
+  if (persistent_cache) {
+    persistent_key = get_persistent_code_cache_key(key);
+    persistent_cache->get(persistent_key, persisted_object, persisted_compile_us);
+  }
+  auto clock_begin = timer_start();
+
+  // run optimizations, the persisted object has been optimized already
 #ifndef WITH_JIT_DEBUG
-  optimize_ir(query_func, module, live_funcs, co, debug_dir_, debug_file_);
+  if (persisted_object.empty()) {
+    optimize_ir(query_func, module, live_funcs, co, debug_dir_, debug_file_);
+  }
 #endif  // WITH_JIT_DEBUG
 
   llvm::ExecutionEngine* execution_engine{nullptr};
@@ -232,10 +291,26 @@ std::vector<std::pair<void*, void*>> Executor::optimizeAndCodegenCPU(
   execution_engine = eb.create();
   CHECK(execution_engine);
 
+  CpuObjectCache object_cache(persisted_object);
+  if (persistent_cache) {
+    execution_engine->setObjectCache(&object_cache);
+  }
   execution_engine->finalizeObject();
   auto native_code = execution_engine->getPointerToFunction(multifrag_query_func);
+  execution_engine->setObjectCache(nullptr);
 
   CHECK(native_code);
+  if (persistent_cache) {
+    const auto compile_us =
+        timer_stop<std::chrono::steady_clock::time_point, std::chrono::microseconds>(
+            clock_begin);
+    if (!persisted_object.empty()) {
+      fetch_compute_stats_.compile_saved_us +=
+          std::max(persisted_compile_us - compile_us, int64_t(0));
+    } else if (!object_cache.getCompiledObject().empty()) {
+      persistent_cache->put(persistent_key, object_cache.getCompiledObject(), compile_us);
+    }
+  }
   addCodeToCache(key,
                  {{std::make_tuple(native_code, execution_engine, nullptr)}},
                  module,
@@ -1373,6 +1448,7 @@ bool always_clone_runtime_function(const llvm::Function* func) {
          func->getName() == "fixed_width_double_decode" ||
          func->getName() == "fixed_width_float_decode" ||
          func->getName() == "fixed_width_small_date_decode" ||
+         func->getName() == "packed_int_decode" ||
          func->getName() == "record_error_code";
 }
 
@@ -1391,6 +1467,7 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
                           const bool has_cardinality_estimation,
                           ColumnCacheMap& column_cache,
                           RenderInfo* render_info) {
+  std::lock_guard<std::mutex> compilation_lock(compilation_mutex_);
   nukeOldState(allow_lazy_fetch, query_infos, ra_exe_unit);
   OOM_TRACE_PUSH(+": " + (co.device_type_ == ExecutorDeviceType::GPU ? "gpu" : "cpu"));
 
@@ -1418,7 +1495,7 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
     for (size_t i = 0; i < num_count_distinct_descs; i++) {
       const auto& count_distinct_descriptor =
           query_mem_desc->getCountDistinctDescriptor(i);
-      if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet ||
+      if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::HashSet ||
           (count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid &&
            !co.hoist_literals_)) {
         throw QueryMustRunOnCpu();
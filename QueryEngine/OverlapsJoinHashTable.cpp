@@ -466,33 +466,33 @@ int OverlapsJoinHashTable::initHashTableOnCpu(
       case 4: {
         const auto composite_key_dict =
             reinterpret_cast<int32_t*>(&(*cpu_hash_table_buff_)[0]);
-        fill_one_to_many_baseline_hash_table_32(one_to_many_buff,
-                                                composite_key_dict,
-                                                entry_count_,
-                                                -1,
-                                                key_component_count,
-                                                join_columns,
-                                                join_column_types,
-                                                join_bucket_info,
-                                                composite_key_info.sd_inner_proxy_per_key,
-                                                composite_key_info.sd_outer_proxy_per_key,
-                                                thread_count);
+        fill_one_to_many_baseline_hash_table_32(
+            one_to_many_buff,
+            composite_key_dict,
+            entry_count_,
+            -1,
+            key_component_count,
+            join_columns,
+            join_column_types,
+            join_bucket_info,
+            composite_key_info.sd_translation_map_per_key,
+            thread_count);
         break;
       }
       case 8: {
         const auto composite_key_dict =
             reinterpret_cast<int64_t*>(&(*cpu_hash_table_buff_)[0]);
-        fill_one_to_many_baseline_hash_table_64(one_to_many_buff,
-                                                composite_key_dict,
-                                                entry_count_,
-                                                -1,
-                                                key_component_count,
-                                                join_columns,
-                                                join_column_types,
-                                                join_bucket_info,
-                                                composite_key_info.sd_inner_proxy_per_key,
-                                                composite_key_info.sd_outer_proxy_per_key,
-                                                thread_count);
+        fill_one_to_many_baseline_hash_table_64(
+            one_to_many_buff,
+            composite_key_dict,
+            entry_count_,
+            -1,
+            key_component_count,
+            join_columns,
+            join_column_types,
+            join_bucket_info,
+            composite_key_info.sd_translation_map_per_key,
+            thread_count);
         break;
       }
       default:
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PersistentCodeCache.h"
+
+#include <glog/logging.h>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t code_cache_magic{0x4f534343};  // "OSCC"
+constexpr uint32_t code_cache_format_version{1};
+const std::string code_cache_file_suffix{".code"};
+
+struct CodeCacheEntryHeader {
+  uint32_t magic;
+  uint32_t format_version;
+  uint64_t key_size;
+  uint64_t code_size;
+  int64_t compile_us;
+};
+
+}  // namespace
+
+std::unique_ptr<PersistentCodeCache> PersistentCodeCache::instance_;
+
+PersistentCodeCache::PersistentCodeCache(const std::string& path, const size_t max_bytes)
+    : path_(path), max_bytes_(max_bytes), num_bytes_(0), num_hits_(0) {
+  boost::filesystem::create_directories(path_);
+  std::vector<std::pair<std::time_t, Entry>> files;
+  for (boost::filesystem::directory_iterator it(path_), end; it != end; ++it) {
+    const auto& file_path = it->path();
+    if (!boost::filesystem::is_regular_file(file_path)) {
+      continue;
+    }
+    if (file_path.extension() != code_cache_file_suffix) {
+      // Left over by a write which didn't complete.
+      boost::filesystem::remove(file_path);
+      continue;
+    }
+    files.emplace_back(
+        boost::filesystem::last_write_time(file_path),
+        Entry{file_path.filename().string(), boost::filesystem::file_size(file_path)});
+  }
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first > rhs.first;
+  });
+  for (auto& file : files) {
+    num_bytes_ += file.second.num_bytes;
+    lru_.push_back(file.second);
+    entries_.emplace(file.second.file_name, std::prev(lru_.end()));
+  }
+  evict();
+  LOG(INFO) << "Persistent code cache at " << path_ << " has " << entries_.size()
+            << " entries, " << num_bytes_ << " bytes";
+}
+
+PersistentCodeCache* PersistentCodeCache::instance() {
+  return instance_.get();
+}
+
+void PersistentCodeCache::init(const std::string& path, const size_t max_bytes) {
+  instance_.reset(new PersistentCodeCache(path, max_bytes));
+}
+
+bool PersistentCodeCache::get(const std::string& key,
+                              std::string& code,
+                              int64_t& compile_us) {
+  const auto file_name = getFileName(key);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!entries_.count(file_name)) {
+      return false;
+    }
+  }
+  // The file is read without the lock, the entries are only ever replaced by a rename
+  // and an open file stays readable when the entry is evicted meanwhile.
+  const auto file_path = path_ / file_name;
+  auto f = fopen(file_path.c_str(), "rb");
+  if (!f) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase(file_name);
+    return false;
+  }
+  CodeCacheEntryHeader header;
+  std::string stored_key;
+  std::string stored_code;
+  bool valid = fseek(f, 0, SEEK_END) == 0;
+  const auto file_size = ftell(f);
+  valid = valid && fseek(f, 0, SEEK_SET) == 0 &&
+          fread(&header, sizeof(header), 1, f) == 1 &&
+          header.magic == code_cache_magic &&
+          header.format_version == code_cache_format_version &&
+          sizeof(header) + header.key_size + header.code_size ==
+              static_cast<size_t>(file_size);
+  if (valid) {
+    stored_key.resize(header.key_size);
+    stored_code.resize(header.code_size);
+    valid = fread(&stored_key[0], 1, header.key_size, f) == header.key_size &&
+            fread(&stored_code[0], 1, header.code_size, f) == header.code_size;
+  }
+  fclose(f);
+  if (!valid) {
+    LOG(WARNING) << "Removing corrupt code cache entry " << file_path;
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase(file_name);
+    boost::system::error_code ec;
+    boost::filesystem::remove(file_path, ec);
+    return false;
+  }
+  if (stored_key != key) {
+    // Another key with the same hash, it keeps the entry.
+    return false;
+  }
+  code.swap(stored_code);
+  compile_us = header.compile_us;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto entry_it = entries_.find(file_name);
+    if (entry_it != entries_.end()) {
+      touch(entry_it->second);
+    }
+    ++num_hits_;
+  }
+  boost::system::error_code ec;
+  boost::filesystem::last_write_time(file_path, std::time(nullptr), ec);
+  return true;
+}
+
+void PersistentCodeCache::put(const std::string& key,
+                              const std::string& code,
+                              const int64_t compile_us) {
+  const size_t num_bytes = sizeof(CodeCacheEntryHeader) + key.size() + code.size();
+  if (num_bytes > max_bytes_) {
+    return;
+  }
+  const auto file_name = getFileName(key);
+  const auto file_path = path_ / file_name;
+  // Written to a temporary file first, entries are either complete or absent. The name
+  // is unique, concurrent writers of the same entry don't need the lock.
+  const auto tmp_path =
+      path_ / boost::filesystem::unique_path(file_name + ".%%%%-%%%%-%%%%.tmp");
+  auto f = fopen(tmp_path.c_str(), "wb");
+  if (!f) {
+    LOG(WARNING) << "Could not create code cache entry " << tmp_path;
+    return;
+  }
+  CodeCacheEntryHeader header{
+      code_cache_magic, code_cache_format_version, key.size(), code.size(), compile_us};
+  const bool written = fwrite(&header, sizeof(header), 1, f) == 1 &&
+                       fwrite(key.data(), 1, key.size(), f) == key.size() &&
+                       fwrite(code.data(), 1, code.size(), f) == code.size();
+  if (fclose(f) != 0 || !written) {
+    LOG(WARNING) << "Could not write code cache entry " << tmp_path;
+    boost::filesystem::remove(tmp_path);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  boost::filesystem::rename(tmp_path, file_path);
+  erase(file_name);
+  lru_.push_front(Entry{file_name, num_bytes});
+  entries_.emplace(file_name, lru_.begin());
+  num_bytes_ += num_bytes;
+  evict();
+}
+
+size_t PersistentCodeCache::getNumEntries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t PersistentCodeCache::getNumBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_bytes_;
+}
+
+size_t PersistentCodeCache::getNumHits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_hits_;
+}
+
+std::string PersistentCodeCache::getFileName(const std::string& key) {
+  char hex[17];
+  snprintf(hex,
+           sizeof(hex),
+           "%016llx",
+           static_cast<unsigned long long>(std::hash<std::string>{}(key)));
+  return hex + code_cache_file_suffix;
+}
+
+void PersistentCodeCache::touch(std::list<Entry>::iterator it) {
+  lru_.splice(lru_.begin(), lru_, it);
+}
+
+void PersistentCodeCache::erase(const std::string& file_name) {
+  const auto entry_it = entries_.find(file_name);
+  if (entry_it == entries_.end()) {
+    return;
+  }
+  num_bytes_ -= entry_it->second->num_bytes;
+  lru_.erase(entry_it->second);
+  entries_.erase(entry_it);
+}
+
+void PersistentCodeCache::evict() {
+  while (num_bytes_ > max_bytes_) {
+    CHECK(!lru_.empty());
+    const auto file_name = lru_.back().file_name;
+    erase(file_name);
+    boost::system::error_code ec;
+    boost::filesystem::remove(path_ / file_name, ec);
+  }
+}
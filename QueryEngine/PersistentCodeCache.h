@@ -0,0 +1,86 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PersistentCodeCache.h
+ * @brief   On-disk cache of the native code generated for the queries, kept across
+ *          server restarts.
+ *
+ * The in-memory code caches of the executors start out empty with every process, the
+ * entries of this cache outlive it. An entry is keyed by the serialized IR of the query
+ * along with everything else the native code depends on, the versions of LLVM and of the
+ * server and the host CPU, and holds the native code and the time it took to compile.
+ * Each entry is a file named after the hash of its key, which holds the full key to tell
+ * hash collisions apart. Only the names and sizes of the files are listed at startup,
+ * the entries are read on lookup. The least recently used entries are evicted once the
+ * total size goes over the limit.
+ */
+
+#ifndef QUERYENGINE_PERSISTENTCODECACHE_H
+#define QUERYENGINE_PERSISTENTCODECACHE_H
+
+#include <boost/filesystem/path.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class PersistentCodeCache {
+ public:
+  PersistentCodeCache(const std::string& path, const size_t max_bytes);
+
+  // The process-wide cache, null unless enabled with init.
+  static PersistentCodeCache* instance();
+  static void init(const std::string& path, const size_t max_bytes);
+
+  // Reads the code of the entry for key and the time in microseconds it took to
+  // compile, returns false if there is none.
+  bool get(const std::string& key, std::string& code, int64_t& compile_us);
+
+  void put(const std::string& key, const std::string& code, const int64_t compile_us);
+
+  size_t getNumEntries() const;
+  size_t getNumBytes() const;
+  // Number of successful lookups since the cache was opened.
+  size_t getNumHits() const;
+
+ private:
+  struct Entry {
+    std::string file_name;
+    size_t num_bytes;
+  };
+
+  static std::string getFileName(const std::string& key);
+
+  // Moves the entry to the front of the LRU list, the caller holds the mutex.
+  void touch(std::list<Entry>::iterator it);
+  void erase(const std::string& file_name);
+  void evict();
+
+  const boost::filesystem::path path_;
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;  // guards the index only, not the reads of the files
+  std::list<Entry> lru_;  // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+  size_t num_bytes_;
+  size_t num_hits_;
+
+  static std::unique_ptr<PersistentCodeCache> instance_;
+};
+
+#endif  // QUERYENGINE_PERSISTENTCODECACHE_H
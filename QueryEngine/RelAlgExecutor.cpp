@@ -147,9 +147,15 @@ ExecutionResult RelAlgExecutor::executeRelAlgQueryNoRetry(const std::string& que
   auto clock_begin = timer_start();
   std::lock_guard<std::mutex> lock(executor_->execute_mutex_);
   int64_t queue_time_ms = timer_stop(clock_begin);
+  Executor::registerRunningQuery();
+  ScopeGuard unregister_running_query = [] { Executor::unregisterRunningQuery(); };
   if (g_enable_dynamic_watchdog) {
     executor_->resetInterrupt();
   }
+  executor_->fetch_compute_stats_.reset();
+  // CPU work of the query submitted to the shared pool can be cancelled by interrupt().
+  TaskPool_NS::ScopedTaskContext task_context(TaskPool_NS::TaskPriority::NORMAL,
+                                              executor_->task_cancellation_flag_);
   ScopeGuard row_set_holder = [this, &render_info] {
     if (render_info) {
       // need to hold onto the RowSetMemOwner for potential
@@ -389,7 +395,17 @@ ExecutionResult RelAlgExecutor::executeRelAlgSeq(std::vector<RaExecutionDesc>& e
                       queue_time_ms);
   }
 
-  return exec_descs[exec_desc_count - 1].getResult();
+  const auto& result = exec_descs[exec_desc_count - 1].getResult();
+  const auto kernel_times = executor_->fetch_compute_stats_.getKernelTimes();
+  if (result.getRows()) {
+    result.getRows()->setKernelTimes(kernel_times);
+  }
+  LOG_IF(INFO, g_enable_debug_timer)
+      << "Kernels fetched chunks for " << kernel_times.fetch_ms << " ms, computed for "
+      << kernel_times.compute_ms << " ms; prefetched " << kernel_times.prefetched_chunks
+      << " chunks in " << kernel_times.prefetch_ms << " ms; saved "
+      << kernel_times.compile_saved_ms << " ms of compilation";
+  return result;
 }
 
 void RelAlgExecutor::executeRelAlgStep(const size_t i,
@@ -1324,6 +1340,12 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
   }
   query_infos.push_back(query_infos.front());
   auto window_project_node_context = WindowProjectNodeContext::create();
+  // Window functions with the same PARTITION BY share the partitions, the ones which
+  // have the same ORDER BY too share the order of the rows in the partitions.
+  std::unordered_map<std::string, std::shared_ptr<JoinHashTableInterface>>
+      partitions_cache;
+  std::unordered_map<std::string, std::shared_ptr<std::vector<int64_t>>>
+      sorted_partitions_cache;
   for (size_t target_index = 0; target_index < ra_exe_unit.target_exprs.size();
        ++target_index) {
     const auto& target_expr = ra_exe_unit.target_exprs[target_index];
@@ -1347,9 +1369,26 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
                                     kONE,
                                     partition_key_tuple,
                                     transform_to_inner(partition_key_tuple.get()));
-    auto context = createWindowFunctionContext(
-        window_func, partition_key_cond, ra_exe_unit, query_infos, co);
+    auto context = createWindowFunctionContext(window_func,
+                                               partition_key_cond,
+                                               partitions_cache,
+                                               ra_exe_unit,
+                                               query_infos,
+                                               co);
+    auto sorted_partitions_key = partition_key_cond->toString();
+    const auto& collation = window_func->getCollation();
+    CHECK_EQ(window_func->getOrderKeys().size(), collation.size());
+    for (size_t i = 0; i < collation.size(); ++i) {
+      sorted_partitions_key +=
+          window_func->getOrderKeys()[i]->toString() + collation[i].toString();
+    }
+    const auto sorted_partitions_it = sorted_partitions_cache.find(sorted_partitions_key);
+    if (sorted_partitions_it != sorted_partitions_cache.end()) {
+      context->setSortedPartitions(sorted_partitions_it->second);
+    }
     context->compute();
+    sorted_partitions_cache.emplace(sorted_partitions_key,
+                                    context->getSortedPartitions());
     window_project_node_context->addWindowFunctionContext(std::move(context),
                                                           target_index);
   }
@@ -1358,6 +1397,8 @@ void RelAlgExecutor::computeWindow(const RelAlgExecutionUnit& ra_exe_unit,
 std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionContext(
     const Analyzer::WindowFunction* window_func,
     const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
+    std::unordered_map<std::string, std::shared_ptr<JoinHashTableInterface>>&
+        partitions_cache,
     const RelAlgExecutionUnit& ra_exe_unit,
     const std::vector<InputTableInfo>& query_infos,
     const CompilationOptions& co) {
@@ -1365,20 +1406,25 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
                                 ? MemoryLevel::GPU_LEVEL
                                 : MemoryLevel::CPU_LEVEL;
   ColumnCacheMap column_cache_map;
-  const auto join_table_or_err = executor_->buildHashTableForQualifier(
-      partition_key_cond, query_infos, ra_exe_unit, memory_level, column_cache_map);
-  if (!join_table_or_err.fail_reason.empty()) {
-    throw std::runtime_error(join_table_or_err.fail_reason);
-  }
-  if (join_table_or_err.hash_table->getHashType() !=
-      JoinHashTableInterface::HashType::OneToMany) {
-    throw std::runtime_error("One row only partitions not supported");
+  const auto partitions_key = partition_key_cond->toString();
+  auto& partitions = partitions_cache[partitions_key];
+  if (!partitions) {
+    const auto join_table_or_err = executor_->buildHashTableForQualifier(
+        partition_key_cond, query_infos, ra_exe_unit, memory_level, column_cache_map);
+    if (!join_table_or_err.fail_reason.empty()) {
+      throw std::runtime_error(join_table_or_err.fail_reason);
+    }
+    if (join_table_or_err.hash_table->getHashType() !=
+        JoinHashTableInterface::HashType::OneToMany) {
+      throw std::runtime_error("One row only partitions not supported");
+    }
+    partitions = join_table_or_err.hash_table;
   }
   const auto& order_keys = window_func->getOrderKeys();
   std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
   const size_t elem_count = query_infos.front().info.fragments.front().getNumTuples();
   auto context = std::make_unique<WindowFunctionContext>(
-      window_func, join_table_or_err.hash_table, elem_count, co.device_type_);
+      window_func, partitions, elem_count, co.device_type_);
   for (const auto& order_key : order_keys) {
     const auto order_col =
         std::dynamic_pointer_cast<const Analyzer::ColumnVar>(order_key);
@@ -1399,6 +1445,28 @@ std::unique_ptr<WindowFunctionContext> RelAlgExecutor::createWindowFunctionConte
     CHECK_EQ(join_col_elem_count, elem_count);
     context->addOrderColumn(column, order_col.get(), chunks_owner);
   }
+  const auto& args = window_func->getArgs();
+  if (window_func->getFrame() && !args.empty()) {
+    const auto arg_col =
+        std::dynamic_pointer_cast<const Analyzer::ColumnVar>(args.front());
+    if (!arg_col || arg_col->get_type_info().is_varlen()) {
+      throw std::runtime_error(
+          "Only fixed length column arguments supported for window frames for now");
+    }
+    const int8_t* column;
+    size_t join_col_elem_count;
+    std::tie(column, join_col_elem_count) =
+        Executor::ExecutionDispatch::getColumnFragment(
+            executor_,
+            *arg_col,
+            query_infos.front().info.fragments.front(),
+            memory_level,
+            0,
+            chunks_owner,
+            column_cache_map);
+    CHECK_EQ(join_col_elem_count, elem_count);
+    context->setAggregateColumn(column, chunks_owner);
+  }
   return context;
 }
 
@@ -1745,6 +1813,13 @@ RelAlgExecutionUnit decide_approx_count_distinct_implementation(
   return ra_exe_unit;
 }
 
+// Whether the retry on CPU of a query which ran out of group by slots or host memory
+// spills the results of its kernels: only the group bys can, into baseline hash tables.
+bool retry_spills_results(const RelAlgExecutionUnit& ra_exe_unit, const bool is_agg) {
+  return g_enable_result_spill && is_agg && !ra_exe_unit.groupby_exprs.empty() &&
+         !ra_exe_unit.estimator;
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeWorkUnit(
@@ -1879,7 +1954,7 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
   if (!error_code) {
     return result;
   }
-  handlePersistentError(error_code);
+  handlePersistentError(error_code, retry_spills_results(ra_exe_unit, is_agg));
   return handleRetry(error_code,
                      {ra_exe_unit, work_unit.body, max_groups_buffer_entry_guess},
                      targets_meta,
@@ -2022,7 +2097,8 @@ ExecutionResult RelAlgExecutor::handleRetry(
       return result;
     }
   }
-  handlePersistentError(error_code);
+  const bool spills_results = retry_spills_results(work_unit.exe_unit, is_agg);
+  handlePersistentError(error_code, spills_results);
   if (co.device_type_ == ExecutorDeviceType::GPU) {
     std::string out_of_memory{"Query ran out of GPU memory, punt to CPU"};
     LOG(INFO) << out_of_memory;
@@ -2059,7 +2135,12 @@ ExecutionResult RelAlgExecutor::handleRetry(
       if (!error_code) {
         return result;
       }
-      handlePersistentError(error_code);
+      if (spills_results) {
+        // The kernels already had group by buffers of fragment size and their results
+        // spilled, larger buffers wouldn't fit better.
+        throw std::runtime_error(getErrorMessageFromCode(error_code));
+      }
+      handlePersistentError(error_code, false);
       // Even the conservative guess failed; it should only happen when we group
       // by a huge cardinality array. Maybe we should throw an exception instead?
       // Such a heavy query is entirely capable of exhausting all the host memory.
@@ -2073,7 +2154,8 @@ ExecutionResult RelAlgExecutor::handleRetry(
   return result;
 }
 
-void RelAlgExecutor::handlePersistentError(const int32_t error_code) {
+void RelAlgExecutor::handlePersistentError(const int32_t error_code,
+                                           const bool spills_results) {
   if (error_code == Executor::ERR_SPECULATIVE_TOP_OOM) {
     throw SpeculativeTopNFailed();
   }
@@ -2084,6 +2166,13 @@ void RelAlgExecutor::handlePersistentError(const int32_t error_code) {
     // retry on CPU is explicitly allowed through --allow-cpu-retry.
     return;
   }
+  if ((error_code == Executor::ERR_OUT_OF_SLOTS ||
+       error_code == Executor::ERR_OUT_OF_CPU_MEM) &&
+      spills_results) {
+    // Retried on CPU with group by buffers of fragment size per kernel, the reduction
+    // of the results of the kernels then spills to the scratch files.
+    return;
+  }
   throw std::runtime_error(getErrorMessageFromCode(error_code));
 }
 
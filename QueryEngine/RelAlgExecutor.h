@@ -174,10 +174,13 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                      const ExecutionOptions& eo,
                      const int64_t queue_time_ms);
 
-  // Creates the window context for the given window function.
+  // Creates the window context for the given window function. The partitions are taken
+  // from partitions_cache if another window function already built them.
   std::unique_ptr<WindowFunctionContext> createWindowFunctionContext(
       const Analyzer::WindowFunction* window_func,
       const std::shared_ptr<Analyzer::BinOper>& partition_key_cond,
+      std::unordered_map<std::string, std::shared_ptr<JoinHashTableInterface>>&
+          partitions_cache,
       const RelAlgExecutionUnit& ra_exe_unit,
       const std::vector<InputTableInfo>& query_infos,
       const CompilationOptions& co);
@@ -248,7 +251,7 @@ class RelAlgExecutor : private StorageIOFacility<RelAlgExecutorTraits> {
                               const ExecutionOptions& eo,
                               const int64_t queue_time_ms);
 
-  static void handlePersistentError(const int32_t error_code);
+  static void handlePersistentError(const int32_t error_code, const bool spills_results);
 
   WorkUnit createWorkUnit(const RelAlgNode*, const SortInfo&, const bool just_explain);
 
@@ -23,6 +23,7 @@
 #include "ExpressionRewrite.h"
 #include "ExtensionFunctionsWhitelist.h"
 #include "RelAlgAbstractInterpreter.h"
+#include "WindowContext.h"
 
 #include "../Analyzer/Analyzer.h"
 #include "../Parser/ParserNode.h"
@@ -559,6 +560,8 @@ void fill_dictionary_encoded_in_vals(
     const int64_t needle_null_val) {
   CHECK(in_vals.empty());
   bool dicts_are_equal = source_dict == dest_dict;
+  const auto translation_map =
+      dicts_are_equal ? nullptr : source_dict->getTranslationMap(dest_dict);
   for (auto index = values_rowset_slice.first; index < values_rowset_slice.second;
        ++index) {
     const auto row = values_rowset->getOneColRow(index);
@@ -571,7 +574,7 @@ void fill_dictionary_encoded_in_vals(
       const int string_id =
           row.value == needle_null_val
               ? needle_null_val
-              : dest_dict->getIdOfString(source_dict->getString(row.value));
+              : translation_map->translate(row.value);
       if (string_id != StringDictionary::INVALID_STR_ID) {
         in_vals.push_back(string_id);
       }
@@ -1519,14 +1522,142 @@ bool supported_upper_bound(const RexWindowFunctionOperator* rex_window_function)
   }
 }
 
+// The numeric value of a frame offset constant, scaled down for decimals.
+double get_frame_offset_value(const Analyzer::Constant* offset) {
+  const auto& offset_ti = offset->get_type_info();
+  const auto& datum = offset->get_constval();
+  switch (offset_ti.get_type()) {
+    case kTINYINT: {
+      return datum.tinyintval;
+    }
+    case kSMALLINT: {
+      return datum.smallintval;
+    }
+    case kINT: {
+      return datum.intval;
+    }
+    case kBIGINT: {
+      return datum.bigintval;
+    }
+    case kDECIMAL:
+    case kNUMERIC: {
+      return static_cast<double>(datum.bigintval) / exp_to_scale(offset_ti.get_scale());
+    }
+    case kFLOAT: {
+      return datum.floatval;
+    }
+    case kDOUBLE: {
+      return datum.doubleval;
+    }
+    default: { throw std::runtime_error("Window frame offset must be a number"); }
+  }
+  return 0;
+}
+
+// Converts a RANGE frame offset given as a day-time interval in milliseconds to the
+// units the time order key is stored in.
+int64_t get_time_frame_offset(const Analyzer::Constant* offset,
+                              const SQLTypeInfo& order_key_ti) {
+  if (offset->get_type_info().get_type() != kINTERVAL_DAY_TIME) {
+    throw std::runtime_error(
+        "RANGE window frame offset over a time ORDER BY key must be a day-time "
+        "interval");
+  }
+  const auto offset_ms = offset->get_constval().bigintval;
+  switch (order_key_ti.get_type()) {
+    case kTIMESTAMP: {
+      const auto dimen = order_key_ti.get_dimension();
+      return dimen < 3 ? offset_ms / MILLISECSPERSEC
+                       : offset_ms * (get_timestamp_precision_scale(dimen) /
+                                      MILLISECSPERSEC);
+    }
+    case kDATE: {
+      return order_key_ti.get_compression() == kENCODING_DATE_IN_DAYS
+                 ? offset_ms / (SECSPERDAY * MILLISECSPERSEC)
+                 : offset_ms / MILLISECSPERSEC;
+    }
+    case kTIME: {
+      return offset_ms / MILLISECSPERSEC;
+    }
+    default: { CHECK(false); }
+  }
+  return 0;
+}
+
+// Translates a bound of the frame of an aggregate window function. RANGE offsets are
+// only defined for a single ORDER BY key and are converted to the units it's stored in.
+Analyzer::WindowFrameBound translate_frame_bound(
+    const RexWindowFunctionOperator::RexWindowBound& window_bound,
+    const std::shared_ptr<Analyzer::Expr>& offset_expr,
+    const bool is_rows,
+    const std::vector<std::shared_ptr<Analyzer::Expr>>& order_keys) {
+  Analyzer::WindowFrameBound frame_bound;
+  frame_bound.offset = 0;
+  frame_bound.fp_offset = 0;
+  if (window_bound.unbounded) {
+    frame_bound.type = window_bound.preceding
+                           ? Analyzer::WindowFrameBound::Type::UnboundedPreceding
+                           : Analyzer::WindowFrameBound::Type::UnboundedFollowing;
+    return frame_bound;
+  }
+  if (window_bound.is_current_row) {
+    frame_bound.type = Analyzer::WindowFrameBound::Type::CurrentRow;
+    return frame_bound;
+  }
+  CHECK(window_bound.preceding != window_bound.following);
+  frame_bound.type = window_bound.preceding ? Analyzer::WindowFrameBound::Type::Preceding
+                                            : Analyzer::WindowFrameBound::Type::Following;
+  const auto offset = std::dynamic_pointer_cast<const Analyzer::Constant>(offset_expr);
+  if (!offset || offset->get_is_null()) {
+    throw std::runtime_error("Window frame offset must be a constant");
+  }
+  if (is_rows) {
+    const auto rows = get_frame_offset_value(offset.get());
+    if (rows != static_cast<int64_t>(rows)) {
+      throw std::runtime_error("ROWS window frame offset must be an integer");
+    }
+    frame_bound.offset = rows;
+  } else {
+    if (order_keys.size() != 1) {
+      throw std::runtime_error(
+          "RANGE window frame with an offset requires exactly one ORDER BY key");
+    }
+    const auto& order_key_ti = order_keys.front()->get_type_info();
+    if (order_key_ti.is_time()) {
+      frame_bound.offset = get_time_frame_offset(offset.get(), order_key_ti);
+    } else if (order_key_ti.is_fp()) {
+      frame_bound.fp_offset = get_frame_offset_value(offset.get());
+    } else if (order_key_ti.is_integer() || order_key_ti.is_decimal()) {
+      // Truncating is exact since the values of the order key are integers too.
+      frame_bound.offset = get_frame_offset_value(offset.get()) *
+                           exp_to_scale(order_key_ti.get_scale());
+    } else {
+      throw std::runtime_error("RANGE window frame not supported for ORDER BY key type " +
+                               order_key_ti.get_type_name());
+    }
+  }
+  if (frame_bound.offset < 0 || frame_bound.fp_offset < 0) {
+    throw std::runtime_error("Window frame offset cannot be negative");
+  }
+  return frame_bound;
+}
+
 }  // namespace
 
 std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
     const RexWindowFunctionOperator* rex_window_function) const {
-  if (!supported_lower_bound(rex_window_function->getLowerBound()) ||
-      !supported_upper_bound(rex_window_function) ||
-      ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
-       rex_window_function->isRows())) {
+  // Aggregates over the default frame go through the regular path, other frames get
+  // computed up front. The rest of the window functions only support the default frame.
+  const bool is_default_frame =
+      supported_lower_bound(rex_window_function->getLowerBound()) &&
+      supported_upper_bound(rex_window_function);
+  const bool is_framed_aggregate =
+      window_function_is_aggregate(rex_window_function->getKind()) &&
+      (!is_default_frame || rex_window_function->isRows());
+  if (!is_framed_aggregate &&
+      (!is_default_frame ||
+       ((rex_window_function->getKind() == SqlWindowFunctionKind::ROW_NUMBER) !=
+        rex_window_function->isRows()))) {
     throw std::runtime_error("Frame specification not supported");
   }
   std::vector<std::shared_ptr<Analyzer::Expr>> args;
@@ -1541,13 +1672,31 @@ std::shared_ptr<Analyzer::Expr> RelAlgTranslator::translateWindowFunction(
   for (const auto& order_key : rex_window_function->getOrderKeys()) {
     order_keys.push_back(translateScalarRex(order_key.get()));
   }
+  std::shared_ptr<Analyzer::WindowFrame> frame;
+  if (is_framed_aggregate) {
+    const auto& lower_bound = rex_window_function->getLowerBound();
+    const auto& upper_bound = rex_window_function->getUpperBound();
+    frame = std::make_shared<Analyzer::WindowFrame>();
+    frame->is_rows = rex_window_function->isRows();
+    frame->lower_bound = translate_frame_bound(
+        lower_bound,
+        lower_bound.offset ? translateScalarRex(lower_bound.offset.get()) : nullptr,
+        frame->is_rows,
+        order_keys);
+    frame->upper_bound = translate_frame_bound(
+        upper_bound,
+        upper_bound.offset ? translateScalarRex(upper_bound.offset.get()) : nullptr,
+        frame->is_rows,
+        order_keys);
+  }
   return makeExpr<Analyzer::WindowFunction>(
       rex_window_function->getType(),
       rex_window_function->getKind(),
       args,
       partition_keys,
       order_keys,
-      translate_collation(rex_window_function->getCollation()));
+      translate_collation(rex_window_function->getCollation()),
+      frame);
 }
 
 Analyzer::ExpressionPtrVector RelAlgTranslator::translateFunctionArgs(
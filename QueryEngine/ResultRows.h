@@ -24,6 +24,7 @@
 #ifndef QUERYENGINE_RESULTROWS_H
 #define QUERYENGINE_RESULTROWS_H
 
+#include "CountDistinctSet.h"
 #include "Descriptors/QueryMemoryDescriptor.h"
 #include "HyperLogLog.h"
 #include "OutputBufferInitialization.h"
@@ -36,6 +37,8 @@
 #include <glog/logging.h>
 #include <boost/noncopyable.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <list>
 #include <mutex>
@@ -197,18 +200,36 @@ class RowSetMemoryOwner : boost::noncopyable {
     std::lock_guard<std::mutex> lock(state_mutex_);
     count_distinct_bitmaps_.emplace_back(
         CountDistinctBitmapBuffer{count_distinct_buffer, bytes, system_allocated});
+    count_distinct_bytes_ += bytes;
   }
 
-  void addCountDistinctSet(std::set<int64_t>* count_distinct_set) {
+  void addCountDistinctSet(CountDistinctSet* count_distinct_set) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     count_distinct_sets_.push_back(count_distinct_set);
+    count_distinct_set->setChargedBytes(&count_distinct_bytes_);
   }
 
+  // Bytes currently taken by the count distinct bitmaps and sets, the sets charge their
+  // growth as values are inserted.
+  size_t getCountDistinctMemoryBytes() const { return count_distinct_bytes_; }
+
   void addGroupByBuffer(int64_t* group_by_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     group_by_buffers_.push_back(group_by_buffer);
   }
 
+  // Frees a group by buffer before the owner goes away, once no result set uses it.
+  // Buffers the owner doesn't know about are left alone.
+  void freeGroupByBuffer(int64_t* group_by_buffer) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    const auto it = std::find(
+        group_by_buffers_.rbegin(), group_by_buffers_.rend(), group_by_buffer);
+    if (it != group_by_buffers_.rend()) {
+      free(*it);
+      group_by_buffers_.erase(std::next(it).base());
+    }
+  }
+
   void addVarlenBuffer(void* varlen_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     varlen_buffers_.push_back(varlen_buffer);
@@ -297,7 +318,8 @@ class RowSetMemoryOwner : boost::noncopyable {
   };
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
-  std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::vector<CountDistinctSet*> count_distinct_sets_;
+  std::atomic<size_t> count_distinct_bytes_{0};
   std::vector<int64_t*> group_by_buffers_;
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
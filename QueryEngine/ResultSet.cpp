@@ -30,16 +30,20 @@
 #include "GpuMemUtils.h"
 #include "InPlaceSort.h"
 #include "OutputBufferInitialization.h"
+#include "ResultSetSpill.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
+#include "Shared/TaskPool.h"
 #include "Shared/checked_alloc.h"
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
 
 #include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <future>
 #include <numeric>
+#include <queue>
 
 ResultSetStorage::ResultSetStorage(const std::vector<TargetInfo>& targets,
                                    const QueryMemoryDescriptor& query_mem_desc,
@@ -434,6 +438,14 @@ int64_t ResultSet::getRenderTime() const {
   return render_time_ms_;
 }
 
+void ResultSet::setKernelTimes(const KernelTimes& kernel_times) {
+  kernel_times_ = kernel_times;
+}
+
+const KernelTimes& ResultSet::getKernelTimes() const {
+  return kernel_times_;
+}
+
 void ResultSet::moveToBegin() const {
   crt_row_buff_idx_ = 0;
   fetched_so_far_ = 0;
@@ -482,11 +494,6 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
     }
     return;
   }
-  // This check isn't strictly required, but allows the index buffer to be 32-bit.
-  if (query_mem_desc_.getEntryCount() > std::numeric_limits<uint32_t>::max()) {
-    throw RowSortException("Sorting more than 4B elements not supported");
-  }
-
   CHECK(permutation_.empty());
 
   const bool use_heap{order_entries.size() == 1 && top_n};
@@ -504,6 +511,10 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
 
   permutation_ = initPermutationBuffer(0, 1);
 
+  if (!use_heap && parallelSortPermutation(order_entries)) {
+    return;
+  }
+
   auto compare = createComparator(order_entries, use_heap);
 
   if (use_heap) {
@@ -529,10 +540,9 @@ void ResultSet::baselineSort(const std::list<Analyzer::OrderEntry>& order_entrie
 }
 #endif  // HAVE_CUDA
 
-std::vector<uint32_t> ResultSet::initPermutationBuffer(const size_t start,
-                                                       const size_t step) {
+Permutation ResultSet::initPermutationBuffer(const size_t start, const size_t step) {
   CHECK_NE(size_t(0), step);
-  std::vector<uint32_t> permutation;
+  Permutation permutation;
   const auto total_entries = query_mem_desc_.getEntryCount();
   permutation.reserve(total_entries / step);
   for (size_t i = start; i < total_entries; i += step) {
@@ -547,14 +557,14 @@ std::vector<uint32_t> ResultSet::initPermutationBuffer(const size_t start,
   return permutation;
 }
 
-const std::vector<uint32_t>& ResultSet::getPermutationBuffer() const {
+const Permutation& ResultSet::getPermutationBuffer() const {
   return permutation_;
 }
 
 void ResultSet::parallelTop(const std::list<Analyzer::OrderEntry>& order_entries,
                             const size_t top_n) {
   const size_t step = cpu_threads();
-  std::vector<std::vector<uint32_t>> strided_permutations(step);
+  std::vector<Permutation> strided_permutations(step);
   std::vector<std::future<void>> init_futures;
   for (size_t start = 0; start < step; ++start) {
     init_futures.emplace_back(
@@ -623,8 +633,8 @@ ResultSet::StorageLookupResult ResultSet::findStorage(const size_t entry_idx) co
 
 template <typename BUFFER_ITERATOR_TYPE>
 bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
-    const uint32_t lhs,
-    const uint32_t rhs) const {
+    const PermutationIdx lhs,
+    const PermutationIdx rhs) const {
   // NB: The compare function must define a strict weak ordering, otherwise
   // std::sort will trigger a segmentation fault (or corrupt memory).
   const auto lhs_storage_lookup_result = result_set_->findStorage(lhs);
@@ -637,22 +647,8 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
     CHECK_GE(order_entry.tle_no, 1);
     const auto& agg_info = result_set_->targets_[order_entry.tle_no - 1];
     const auto& entry_ti = get_compact_type(agg_info);
-    bool float_argument_input = takes_float_argument(agg_info);
-    // Need to determine if the float value has been stored as float
-    // or if it has been compacted to a different (often larger 8 bytes)
-    // in distributed case the floats are actually 4 bytes
-    // TODO the above takes_float_argument() is widely used  wonder if this problem
-    // exists elsewhere
-    if (entry_ti.get_type() == kFLOAT) {
-      const auto is_col_lazy =
-          !result_set_->lazy_fetch_info_.empty() &&
-          result_set_->lazy_fetch_info_[order_entry.tle_no - 1].is_lazily_fetched;
-      if (result_set_->query_mem_desc_.getPaddedColumnWidthBytes(order_entry.tle_no -
-                                                                 1) == sizeof(float)) {
-        float_argument_input =
-            result_set_->query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
-      }
-    }
+    const bool float_argument_input =
+        result_set_->isFloatArgumentInput(order_entry.tle_no - 1);
     const auto lhs_v = buffer_itr_.getColumnInternal(lhs_storage->buff_,
                                                      fixedup_lhs,
                                                      order_entry.tle_no - 1,
@@ -745,11 +741,11 @@ bool ResultSet::ResultSetComparator<BUFFER_ITERATOR_TYPE>::operator()(
 }
 
 void ResultSet::topPermutation(
-    std::vector<uint32_t>& to_sort,
+    Permutation& to_sort,
     const size_t n,
-    const std::function<bool(const uint32_t, const uint32_t)> compare) {
+    const std::function<bool(const PermutationIdx, const PermutationIdx)> compare) {
   std::make_heap(to_sort.begin(), to_sort.end(), compare);
-  std::vector<uint32_t> permutation_top;
+  Permutation permutation_top;
   permutation_top.reserve(n);
   for (size_t i = 0; i < n && !to_sort.empty(); ++i) {
     permutation_top.push_back(to_sort.front());
@@ -760,10 +756,427 @@ void ResultSet::topPermutation(
 }
 
 void ResultSet::sortPermutation(
-    const std::function<bool(const uint32_t, const uint32_t)> compare) {
+    const std::function<bool(const PermutationIdx, const PermutationIdx)> compare) {
   std::sort(permutation_.begin(), permutation_.end(), compare);
 }
 
+bool ResultSet::isFloatArgumentInput(const size_t target_idx) const {
+  const auto& agg_info = targets_[target_idx];
+  bool float_argument_input = takes_float_argument(agg_info);
+  // Need to determine if the float value has been stored as float
+  // or if it has been compacted to a different (often larger 8 bytes)
+  // in distributed case the floats are actually 4 bytes
+  // TODO the above takes_float_argument() is widely used  wonder if this problem
+  // exists elsewhere
+  if (get_compact_type(agg_info).get_type() == kFLOAT) {
+    const auto is_col_lazy =
+        !lazy_fetch_info_.empty() && lazy_fetch_info_[target_idx].is_lazily_fetched;
+    if (query_mem_desc_.getPaddedColumnWidthBytes(target_idx) == sizeof(float)) {
+      float_argument_input = query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
+    }
+  }
+  return float_argument_input;
+}
+
+namespace {
+
+// The normalized key of an order entry is a byte which puts the nulls first or last
+// followed by the value as a big endian unsigned integer.
+constexpr size_t kSortKeyEntryBytes = 1 + sizeof(uint64_t);
+
+// Each thread sorts at least that many entries before the sorted runs are merged.
+constexpr size_t kMinSortRunEntries = 1 << 14;
+
+// The strings which aren't dictionary encoded, the arrays and the geo targets are only
+// compared by value.
+bool has_normalized_sort_key(const SQLTypeInfo& ti, const bool has_executor) {
+  if (ti.is_string()) {
+    return ti.get_compression() == kENCODING_DICT && has_executor;
+  }
+  return !ti.is_array() && !ti.is_geometry();
+}
+
+uint64_t ordered_int_bits(const int64_t val) {
+  return static_cast<uint64_t>(val) ^ (uint64_t(1) << 63);
+}
+
+uint64_t ordered_fp_bits(double val) {
+  if (val == 0) {
+    // Both zeros compare equal.
+    val = 0;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+void write_sort_key(int8_t* key,
+                    const bool is_null,
+                    const uint64_t bits,
+                    const Analyzer::OrderEntry& order_entry) {
+  auto key_bytes = reinterpret_cast<uint8_t*>(key);
+  key_bytes[0] = is_null != order_entry.nulls_first;
+  const uint64_t val = is_null ? 0 : order_entry.is_desc ? ~bits : bits;
+  for (size_t i = 0; i < sizeof(val); ++i) {
+    key_bytes[1 + i] = val >> (56 - 8 * i);
+  }
+}
+
+}  // namespace
+
+template <typename BUFFER_ITERATOR_TYPE>
+ResultSet::NormalizedSortKeys<BUFFER_ITERATOR_TYPE>::NormalizedSortKeys(
+    const std::list<Analyzer::OrderEntry>& order_entries,
+    const ResultSet* result_set)
+    : result_set_(result_set), buffer_itr_(result_set) {
+  for (const auto& order_entry : order_entries) {
+    CHECK_GE(order_entry.tle_no, 1);
+    const auto& entry_ti =
+        get_compact_type(result_set_->targets_[order_entry.tle_no - 1]);
+    if (remaining_entries_.empty() &&
+        has_normalized_sort_key(entry_ti, result_set_->executor_ != nullptr)) {
+      keyed_entries_.push_back(order_entry);
+      float_argument_input_.push_back(
+          result_set_->isFloatArgumentInput(order_entry.tle_no - 1));
+    } else {
+      remaining_entries_.push_back(order_entry);
+    }
+  }
+  string_ids_.resize(keyed_entries_.size());
+  string_ranks_.resize(keyed_entries_.size());
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::NormalizedSortKeys<BUFFER_ITERATOR_TYPE>::rankStrings(
+    const Permutation& permutation) {
+  for (size_t i = 0; i < keyed_entries_.size(); ++i) {
+    const auto target_idx = keyed_entries_[i].tle_no - 1;
+    const auto& entry_ti = get_compact_type(result_set_->targets_[target_idx]);
+    if (!entry_ti.is_string()) {
+      continue;
+    }
+    CHECK_EQ(4, entry_ti.get_logical_size());
+    const size_t worker_count = cpu_threads();
+    const size_t stride = (permutation.size() + worker_count - 1) / worker_count;
+    std::vector<std::vector<int32_t>> ids_per_worker(worker_count);
+    std::vector<TaskPool_NS::TaskFuture<void>> collect_threads;
+    for (size_t worker_idx = 0, start = 0;
+         worker_idx < worker_count && start < permutation.size();
+         ++worker_idx, start += stride) {
+      const auto end = std::min(start + stride, permutation.size());
+      collect_threads.push_back(TaskPool_NS::async([this,
+                                                    &permutation,
+                                                    &entry_ti,
+                                                    &ids = ids_per_worker[worker_idx],
+                                                    target_idx,
+                                                    start,
+                                                    end] {
+        for (size_t j = start; j < end; ++j) {
+          const auto storage_lookup_result = result_set_->findStorage(permutation[j]);
+          const auto val =
+              buffer_itr_.getColumnInternal(storage_lookup_result.storage_ptr->buff_,
+                                            storage_lookup_result.fixedup_entry_idx,
+                                            target_idx,
+                                            storage_lookup_result);
+          if (!isNull(entry_ti, val, false)) {
+            ids.push_back(val.i1);
+          }
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+      }));
+    }
+    for (auto& child : collect_threads) {
+      child.wait();
+    }
+    for (auto& child : collect_threads) {
+      child.get();
+    }
+    auto& ids = string_ids_[i];
+    for (const auto& worker_ids : ids_per_worker) {
+      ids.insert(ids.end(), worker_ids.begin(), worker_ids.end());
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    const auto string_dict_proxy = result_set_->executor_->getStringDictionaryProxy(
+        entry_ti.get_comp_param(), result_set_->row_set_mem_owner_, false);
+    std::vector<std::string> strings;
+    strings.reserve(ids.size());
+    for (const auto id : ids) {
+      strings.push_back(string_dict_proxy->getString(id));
+    }
+    std::vector<size_t> string_order(ids.size());
+    std::iota(string_order.begin(), string_order.end(), 0);
+    std::sort(string_order.begin(),
+              string_order.end(),
+              [&strings](const size_t lhs, const size_t rhs) {
+                return strings[lhs] < strings[rhs];
+              });
+    auto& ranks = string_ranks_[i];
+    ranks.resize(ids.size());
+    uint64_t rank{0};
+    for (size_t j = 0; j < string_order.size(); ++j) {
+      if (j && strings[string_order[j]] != strings[string_order[j - 1]]) {
+        ++rank;
+      }
+      ranks[string_order[j]] = rank;
+    }
+  }
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::NormalizedSortKeys<BUFFER_ITERATOR_TYPE>::write(
+    const PermutationIdx entry_idx,
+    int8_t* key) const {
+  const auto storage_lookup_result = result_set_->findStorage(entry_idx);
+  const auto storage = storage_lookup_result.storage_ptr;
+  for (size_t i = 0; i < keyed_entries_.size(); ++i, key += kSortKeyEntryBytes) {
+    const auto& order_entry = keyed_entries_[i];
+    const auto target_idx = order_entry.tle_no - 1;
+    const auto& agg_info = result_set_->targets_[target_idx];
+    const auto& entry_ti = get_compact_type(agg_info);
+    const bool float_argument_input = float_argument_input_[i];
+    const auto val =
+        buffer_itr_.getColumnInternal(storage->buff_,
+                                      storage_lookup_result.fixedup_entry_idx,
+                                      target_idx,
+                                      storage_lookup_result);
+    if (isNull(entry_ti, val, float_argument_input)) {
+      write_sort_key(key, true, 0, order_entry);
+      continue;
+    }
+    uint64_t bits{0};
+    if (val.isPair()) {
+      bits = ordered_fp_bits(
+          pair_to_double({val.i1, val.i2}, entry_ti, float_argument_input));
+    } else {
+      CHECK(val.isInt());
+      if (entry_ti.is_string()) {
+        const auto& ids = string_ids_[i];
+        const auto it =
+            std::lower_bound(ids.begin(), ids.end(), static_cast<int32_t>(val.i1));
+        CHECK(it != ids.end() && *it == val.i1);
+        bits = string_ranks_[i][it - ids.begin()];
+      } else if (is_distinct_target(agg_info)) {
+        bits = ordered_int_bits(count_distinct_set_size(
+            val.i1, result_set_->query_mem_desc_.getCountDistinctDescriptor(target_idx)));
+      } else if (entry_ti.is_fp()) {
+        bits = float_argument_input
+                   ? ordered_fp_bits(
+                         *reinterpret_cast<const float*>(may_alias_ptr(&val.i1)))
+                   : ordered_fp_bits(
+                         *reinterpret_cast<const double*>(may_alias_ptr(&val.i1)));
+      } else {
+        bits = ordered_int_bits(val.i1);
+      }
+    }
+    write_sort_key(key, false, bits, order_entry);
+  }
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+size_t ResultSet::NormalizedSortKeys<BUFFER_ITERATOR_TYPE>::keyBytes() const {
+  return keyed_entries_.size() * kSortKeyEntryBytes;
+}
+
+bool ResultSet::parallelSortPermutation(
+    const std::list<Analyzer::OrderEntry>& order_entries) {
+  return query_mem_desc_.didOutputColumnar()
+             ? parallelSortPermutationImpl<ColumnWiseTargetAccessor>(order_entries)
+             : parallelSortPermutationImpl<RowWiseTargetAccessor>(order_entries);
+}
+
+// Sorts the permutation by its keys, through scratch files when the keys don't fit in
+// the result spill memory budget. The comparisons are a memcmp of the keys unless they
+// tie and some order entries aren't covered by them.
+template <typename BUFFER_ITERATOR_TYPE>
+bool ResultSet::parallelSortPermutationImpl(
+    const std::list<Analyzer::OrderEntry>& order_entries) {
+  NormalizedSortKeys<BUFFER_ITERATOR_TYPE> sort_keys(order_entries, this);
+  if (sort_keys.keyed_entries_.empty()) {
+    return false;
+  }
+  sort_keys.rankStrings(permutation_);
+  std::unique_ptr<ResultSetComparator<BUFFER_ITERATOR_TYPE>> tie_comparator;
+  if (!sort_keys.remaining_entries_.empty()) {
+    tie_comparator = std::make_unique<ResultSetComparator<BUFFER_ITERATOR_TYPE>>(
+        sort_keys.remaining_entries_, false, this);
+  }
+  const auto entry_count = permutation_.size();
+  // The key, the position and the sorted permutation entry of each entry.
+  const auto entry_bytes = sort_keys.keyBytes() + 2 * sizeof(PermutationIdx);
+  if (g_enable_result_spill && entry_count * entry_bytes > g_result_spill_memory_budget) {
+    const auto run_entry_count =
+        std::max(kMinSortRunEntries, g_result_spill_memory_budget / entry_bytes);
+    externalSortPermutation(sort_keys, tie_comparator.get(), run_entry_count);
+    return true;
+  }
+  std::vector<int8_t> keys;
+  Permutation positions;
+  sortKeyedRun(sort_keys, tie_comparator.get(), 0, entry_count, keys, positions);
+  Permutation sorted_permutation(entry_count);
+  for (size_t i = 0; i < entry_count; ++i) {
+    sorted_permutation[i] = permutation_[positions[i]];
+  }
+  permutation_.swap(sorted_permutation);
+  return true;
+}
+
+// Materializes the keys of permutation_[start, end) and sorts runs of it on all the
+// threads, then merges the sorted runs pairwise.
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::sortKeyedRun(
+    const NormalizedSortKeys<BUFFER_ITERATOR_TYPE>& sort_keys,
+    const ResultSetComparator<BUFFER_ITERATOR_TYPE>* tie_comparator,
+    const size_t start,
+    const size_t end,
+    std::vector<int8_t>& keys,
+    Permutation& positions) const {
+  const auto entry_count = end - start;
+  const auto key_bytes = sort_keys.keyBytes();
+  keys.resize(entry_count * key_bytes);
+  positions.resize(entry_count);
+  const auto compare = [this, start, &keys, key_bytes, tie_comparator](
+                           const PermutationIdx lhs, const PermutationIdx rhs) {
+    const auto cmp =
+        std::memcmp(&keys[lhs * key_bytes], &keys[rhs * key_bytes], key_bytes);
+    if (cmp || !tie_comparator) {
+      return cmp < 0;
+    }
+    return (*tie_comparator)(permutation_[start + lhs], permutation_[start + rhs]);
+  };
+  const size_t run_count =
+      std::max(size_t(1),
+               std::min(static_cast<size_t>(cpu_threads()),
+                        entry_count / kMinSortRunEntries));
+  std::vector<size_t> run_bounds;
+  for (size_t i = 0; i <= run_count; ++i) {
+    run_bounds.push_back(entry_count * i / run_count);
+  }
+  std::vector<TaskPool_NS::TaskFuture<void>> sort_threads;
+  for (size_t i = 0; i < run_count; ++i) {
+    sort_threads.push_back(TaskPool_NS::async(
+        [this, start, &sort_keys, &keys, &positions, &compare, key_bytes](
+            const size_t run_start, const size_t run_end) {
+          for (size_t j = run_start; j < run_end; ++j) {
+            sort_keys.write(permutation_[start + j], &keys[j * key_bytes]);
+            positions[j] = j;
+          }
+          std::sort(positions.begin() + run_start, positions.begin() + run_end, compare);
+        },
+        run_bounds[i],
+        run_bounds[i + 1]));
+  }
+  for (auto& child : sort_threads) {
+    child.wait();
+  }
+  for (auto& child : sort_threads) {
+    child.get();
+  }
+  for (size_t width = 1; width < run_count; width *= 2) {
+    std::vector<TaskPool_NS::TaskFuture<void>> merge_threads;
+    for (size_t i = 0; i + width < run_count; i += 2 * width) {
+      merge_threads.push_back(TaskPool_NS::async(
+          [&positions, &compare](
+              const size_t run_start, const size_t run_middle, const size_t run_end) {
+            std::inplace_merge(positions.begin() + run_start,
+                               positions.begin() + run_middle,
+                               positions.begin() + run_end,
+                               compare);
+          },
+          run_bounds[i],
+          run_bounds[i + width],
+          run_bounds[std::min(i + 2 * width, run_count)]));
+    }
+    for (auto& child : merge_threads) {
+      child.wait();
+    }
+    for (auto& child : merge_threads) {
+      child.get();
+    }
+  }
+  for (auto& position : positions) {
+    position += start;
+  }
+}
+
+// Sorts runs of run_entry_count entries of the permutation in memory and writes their
+// keys, each followed by its entry, to scratch files. The runs are then merged into
+// the permutation.
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::externalSortPermutation(
+    const NormalizedSortKeys<BUFFER_ITERATOR_TYPE>& sort_keys,
+    const ResultSetComparator<BUFFER_ITERATOR_TYPE>* tie_comparator,
+    const size_t run_entry_count) {
+  const auto entry_count = permutation_.size();
+  const auto key_bytes = sort_keys.keyBytes();
+  const auto record_bytes = key_bytes + sizeof(PermutationIdx);
+  std::vector<std::unique_ptr<SpillFile>> runs;
+  {
+    std::vector<int8_t> keys;
+    Permutation positions;
+    std::vector<int8_t> record(record_bytes);
+    for (size_t start = 0; start < entry_count; start += run_entry_count) {
+      const auto end = std::min(start + run_entry_count, entry_count);
+      sortKeyedRun(sort_keys, tie_comparator, start, end, keys, positions);
+      runs.emplace_back(std::make_unique<SpillFile>());
+      SpillWriter writer(runs.back().get());
+      for (const auto position : positions) {
+        std::memcpy(&record[0], &keys[(position - start) * key_bytes], key_bytes);
+        std::memcpy(&record[key_bytes], &permutation_[position], sizeof(PermutationIdx));
+        writer.append(&record[0], record_bytes);
+      }
+      writer.flush();
+    }
+  }
+  VLOG(1) << "Merging " << runs.size() << " sorted runs of " << entry_count
+          << " entries spilled to " << g_result_spill_path;
+  const auto block_bytes =
+      std::max(record_bytes,
+               std::min(size_t(SpillFile::kBlockBytes),
+                        g_result_spill_memory_budget / runs.size()));
+  std::vector<SpillReader> readers;
+  readers.reserve(runs.size());
+  for (const auto& run : runs) {
+    readers.emplace_back(run.get(), record_bytes, block_bytes);
+  }
+  const auto entry_of = [key_bytes](const int8_t* record) {
+    PermutationIdx entry_idx;
+    std::memcpy(&entry_idx, record + key_bytes, sizeof(PermutationIdx));
+    return entry_idx;
+  };
+  // Orders the runs by their current records, the smallest one on top of the heap.
+  const auto run_greater = [&readers, &entry_of, key_bytes, tie_comparator](
+                               const size_t lhs, const size_t rhs) {
+    const auto lhs_record = readers[lhs].current();
+    const auto rhs_record = readers[rhs].current();
+    const auto cmp = std::memcmp(lhs_record, rhs_record, key_bytes);
+    if (cmp || !tie_comparator) {
+      return cmp > 0;
+    }
+    return (*tie_comparator)(entry_of(rhs_record), entry_of(lhs_record));
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(run_greater)> heap(
+      run_greater);
+  for (size_t i = 0; i < readers.size(); ++i) {
+    if (!readers[i].done()) {
+      heap.push(i);
+    }
+  }
+  size_t entry_idx{0};
+  while (!heap.empty()) {
+    const auto run_idx = heap.top();
+    heap.pop();
+    CHECK_LT(entry_idx, entry_count);
+    permutation_[entry_idx++] = entry_of(readers[run_idx].current());
+    readers[run_idx].next();
+    if (!readers[run_idx].done()) {
+      heap.push(run_idx);
+    }
+  }
+  CHECK_EQ(entry_count, entry_idx);
+}
+
 void ResultSet::radixSortOnGpu(
     const std::list<Analyzer::OrderEntry>& order_entries) const {
   auto data_mgr = &executor_->catalog_->getDataMgr();
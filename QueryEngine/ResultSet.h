@@ -26,6 +26,7 @@
 #define QUERYENGINE_RESULTSET_H
 
 #include "../Chunk/Chunk.h"
+#include "../StringDictionary/StringDictionary.h"
 #include "CardinalityEstimator.h"
 #include "ResultSetBufferAccessors.h"
 #include "TargetValue.h"
@@ -288,6 +289,22 @@ class ResultSetRowIterator {
 
 class TSerializedRows;
 
+// Time the fragment kernels of a query spent fetching chunks and computing, summed over
+// the kernels, and the time the fetch stage spent prefetching chunks for them. The
+// compilation time saved is that of the kernels found in the persistent code cache.
+struct KernelTimes {
+  int64_t fetch_ms{0};
+  int64_t prefetch_ms{0};
+  int64_t compute_ms{0};
+  size_t prefetched_chunks{0};
+  int64_t compile_saved_ms{0};
+};
+
+// Indices of the entries of a result set in sort order. They are 64-bit so that result
+// sets with more than 4B entries can be sorted.
+using PermutationIdx = uint64_t;
+using Permutation = std::vector<PermutationIdx>;
+
 class ResultSet {
  public:
   ResultSet(const std::vector<TargetInfo>& targets,
@@ -422,6 +439,10 @@ class ResultSet {
 
   int64_t getRenderTime() const;
 
+  void setKernelTimes(const KernelTimes& kernel_times);
+
+  const KernelTimes& getKernelTimes() const;
+
   void moveToBegin() const;
 
   bool isTruncated() const;
@@ -458,7 +479,7 @@ class ResultSet {
     return row_set_mem_owner_;
   }
 
-  const std::vector<uint32_t>& getPermutationBuffer() const;
+  const Permutation& getPermutationBuffer() const;
   const bool isPermutationBufferEmpty() const { return permutation_.empty(); };
 
   std::string serialize() const;
@@ -689,7 +710,7 @@ class ResultSet {
         , result_set_(result_set)
         , buffer_itr_(result_set) {}
 
-    bool operator()(const uint32_t lhs, const uint32_t rhs) const;
+    bool operator()(const PermutationIdx lhs, const PermutationIdx rhs) const;
 
     // TODO(adb): make order_entries_ a pointer
     const std::list<Analyzer::OrderEntry> order_entries_;
@@ -698,33 +719,87 @@ class ResultSet {
     const BufferIteratorType buffer_itr_;
   };
 
-  std::function<bool(const uint32_t, const uint32_t)> createComparator(
+  std::function<bool(const PermutationIdx, const PermutationIdx)> createComparator(
       const std::list<Analyzer::OrderEntry>& order_entries,
       const bool use_heap) {
     if (query_mem_desc_.didOutputColumnar()) {
       column_wise_comparator_ =
           std::make_unique<ResultSetComparator<ColumnWiseTargetAccessor>>(
               order_entries, use_heap, this);
-      return [this](const uint32_t lhs, const uint32_t rhs) -> bool {
+      return [this](const PermutationIdx lhs, const PermutationIdx rhs) -> bool {
         return (*this->column_wise_comparator_)(lhs, rhs);
       };
     } else {
       row_wise_comparator_ = std::make_unique<ResultSetComparator<RowWiseTargetAccessor>>(
           order_entries, use_heap, this);
-      return [this](const uint32_t lhs, const uint32_t rhs) -> bool {
+      return [this](const PermutationIdx lhs, const PermutationIdx rhs) -> bool {
         return (*this->row_wise_comparator_)(lhs, rhs);
       };
     }
   }
 
+  // Fixed width keys which memcmp in the order of the rows, for the leading order
+  // entries which aren't on none encoded strings, arrays or geo.
+  template <typename BUFFER_ITERATOR_TYPE>
+  struct NormalizedSortKeys {
+    using BufferIteratorType = BUFFER_ITERATOR_TYPE;
+
+    NormalizedSortKeys(const std::list<Analyzer::OrderEntry>& order_entries,
+                       const ResultSet* result_set);
+
+    // Ranks the strings of the dictionary encoded entries found in the permutation.
+    void rankStrings(const Permutation& permutation);
+
+    void write(const PermutationIdx entry_idx, int8_t* key) const;
+
+    size_t keyBytes() const;
+
+    std::vector<Analyzer::OrderEntry> keyed_entries_;
+    // The order entries the keys don't cover, the ties are broken by comparing them.
+    std::list<Analyzer::OrderEntry> remaining_entries_;
+    std::vector<bool> float_argument_input_;
+    // For the dictionary encoded entries, the distinct ids in order and their ranks.
+    std::vector<std::vector<int32_t>> string_ids_;
+    std::vector<std::vector<uint64_t>> string_ranks_;
+    const ResultSet* result_set_;
+    const BufferIteratorType buffer_itr_;
+  };
+
+  // Sorts the permutation on all the CPU threads by normalized keys. Returns false when
+  // the first order entry can't have them.
+  bool parallelSortPermutation(const std::list<Analyzer::OrderEntry>& order_entries);
+
+  template <typename BUFFER_ITERATOR_TYPE>
+  bool parallelSortPermutationImpl(const std::list<Analyzer::OrderEntry>& order_entries);
+
+  // Leaves the positions of permutation_[start, end) in sort order in positions and
+  // their keys, in the order of the permutation, in keys.
+  template <typename BUFFER_ITERATOR_TYPE>
+  void sortKeyedRun(const NormalizedSortKeys<BUFFER_ITERATOR_TYPE>& sort_keys,
+                    const ResultSetComparator<BUFFER_ITERATOR_TYPE>* tie_comparator,
+                    const size_t start,
+                    const size_t end,
+                    std::vector<int8_t>& keys,
+                    Permutation& positions) const;
+
+  template <typename BUFFER_ITERATOR_TYPE>
+  void externalSortPermutation(
+      const NormalizedSortKeys<BUFFER_ITERATOR_TYPE>& sort_keys,
+      const ResultSetComparator<BUFFER_ITERATOR_TYPE>* tie_comparator,
+      const size_t run_entry_count);
+
+  // Whether the values of the float target are stored as floats rather than doubles.
+  bool isFloatArgumentInput(const size_t target_idx) const;
+
   static void topPermutation(
-      std::vector<uint32_t>& to_sort,
+      Permutation& to_sort,
       const size_t n,
-      const std::function<bool(const uint32_t, const uint32_t)> compare);
+      const std::function<bool(const PermutationIdx, const PermutationIdx)> compare);
 
-  void sortPermutation(const std::function<bool(const uint32_t, const uint32_t)> compare);
+  void sortPermutation(
+      const std::function<bool(const PermutationIdx, const PermutationIdx)> compare);
 
-  std::vector<uint32_t> initPermutationBuffer(const size_t start, const size_t step);
+  Permutation initPermutationBuffer(const size_t start, const size_t step);
 
   void parallelTop(const std::list<Analyzer::OrderEntry>& order_entries,
                    const size_t top_n);
@@ -747,7 +822,7 @@ class ResultSet {
       const std::vector<std::string>& col_names,
       arrow::ipc::DictionaryMemo& memo,
       const int32_t first_n) const;
-  std::shared_ptr<const std::vector<std::string>> getDictionary(const int dict_id) const;
+  StringDictionary::PinnedStringViews getDictionary(const int dict_id) const;
   std::shared_ptr<arrow::RecordBatch> getArrowBatch(
       const std::shared_ptr<arrow::Schema>& schema,
       const int32_t first_n) const;
@@ -786,9 +861,10 @@ class ResultSet {
   size_t drop_first_;
   size_t keep_first_;
   const std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner_;
-  std::vector<uint32_t> permutation_;
+  Permutation permutation_;
   int64_t queue_time_ms_;
   int64_t render_time_ms_;
+  KernelTimes kernel_times_;
   const Executor* executor_;  // TODO(alex): remove
 
   std::list<std::shared_ptr<Chunk_NS::Chunk>> chunks_;
@@ -865,11 +941,6 @@ class ResultSetManager {
   std::shared_ptr<ResultSet> rs_;
 };
 
-class RowSortException : public std::runtime_error {
- public:
-  RowSortException(const std::string& cause) : std::runtime_error(cause) {}
-};
-
 int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
                     const int8_t* byte_stream,
                     const int64_t pos);
@@ -417,12 +417,12 @@ key_t get_and_copy_to_shm(const std::shared_ptr<Buffer>& data) {
 
 }  // namespace arrow
 
-std::shared_ptr<const std::vector<std::string>> ResultSet::getDictionary(
-    const int dict_id) const {
+StringDictionary::PinnedStringViews ResultSet::getDictionary(const int dict_id) const {
   const auto sdp =
       executor_ ? executor_->getStringDictionaryProxy(dict_id, row_set_mem_owner_, false)
                 : row_set_mem_owner_->getStringDictProxy(dict_id);
-  return sdp->getDictionary()->copyStrings();
+  const auto string_dict = sdp->getDictionary();
+  return string_dict->getStringViews(0, string_dict->storageEntryCount());
 }
 
 std::shared_ptr<arrow::RecordBatch> ResultSet::getArrowBatch(
@@ -598,13 +598,14 @@ std::shared_ptr<arrow::RecordBatch> ResultSet::convertToArrow(
       if (memo.HasDictionaryId(dict_id)) {
         ARROW_THROW_NOT_OK(memo.GetDictionary(dict_id, &dict));
       } else {
-        auto str_list = getDictionary(dict_id);
+        // Appended straight from the dictionary payload, without copying the strings.
+        const auto str_list = getDictionary(dict_id);
 
         arrow::StringBuilder builder;
         // TODO(andrewseidl): replace with AppendValues() once Arrow 0.7.1 support is
         // fully deprecated
-        for (const std::string& val : *str_list) {
-          ARROW_THROW_NOT_OK(builder.Append(val));
+        for (const auto& val : str_list.views) {
+          ARROW_THROW_NOT_OK(builder.Append(val.data(), val.size()));
         }
         ARROW_THROW_NOT_OK(builder.Finish(&dict));
         ARROW_THROW_NOT_OK(memo.AddDictionary(dict_id, dict));
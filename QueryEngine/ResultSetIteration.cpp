@@ -761,6 +761,10 @@ int64_t lazy_decode(const ColumnLazyFetchInfo& col_lazy_fetch,
   CHECK(type_info.is_integer() || type_info.is_decimal() || type_info.is_time() ||
         type_info.is_timeinterval() || type_info.is_boolean() || type_info.is_string() ||
         type_info.is_array());
+  if (type_info.is_packed_int()) {
+    return packed_int_decode_noinline(
+        byte_stream, type_info.get_size(), inline_int_null_val(type_info), pos);
+  }
   size_t type_bitwidth = get_bit_width(type_info);
   if (type_info.get_compression() == kENCODING_FIXED) {
     type_bitwidth = type_info.get_comp_param();
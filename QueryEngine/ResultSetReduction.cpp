@@ -27,6 +27,7 @@
 #include "ResultSet.h"
 #include "RuntimeFunctions.h"
 #include "Shared/SqlTypesLayout.h"
+#include "Shared/TaskPool.h"
 
 #include "Shared/likely.h"
 #include "Shared/thread_count.h"
@@ -150,15 +151,14 @@ void ResultSetStorage::reduce(
     }
     if (use_multithreaded_reduction(that.query_mem_desc_.getEntryCount())) {
       const size_t thread_count = cpu_threads();
-      std::vector<std::future<void>> reduction_threads;
+      std::vector<TaskPool_NS::TaskFuture<void>> reduction_threads;
       for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
         const auto thread_entry_count =
             (that.query_mem_desc_.getEntryCount() + thread_count - 1) / thread_count;
         const auto start_index = thread_idx * thread_entry_count;
         const auto end_index = std::min(start_index + thread_entry_count,
                                         that.query_mem_desc_.getEntryCount());
-        reduction_threads.emplace_back(std::async(
-            std::launch::async,
+        reduction_threads.emplace_back(TaskPool_NS::async(
             [this, this_buff, that_buff, start_index, end_index, &that] {
               for (size_t entry_idx = start_index; entry_idx < end_index; ++entry_idx) {
                 reduceOneEntryBaseline(this_buff,
@@ -185,31 +185,28 @@ void ResultSetStorage::reduce(
   }
   if (use_multithreaded_reduction(entry_count)) {
     const size_t thread_count = cpu_threads();
-    std::vector<std::future<void>> reduction_threads;
+    std::vector<TaskPool_NS::TaskFuture<void>> reduction_threads;
     for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
       const auto thread_entry_count = (entry_count + thread_count - 1) / thread_count;
       const auto start_index = thread_idx * thread_entry_count;
       const auto end_index = std::min(start_index + thread_entry_count, entry_count);
       if (query_mem_desc_.didOutputColumnar()) {
-        reduction_threads.emplace_back(std::async(std::launch::async,
-                                                  [this,
-                                                   this_buff,
-                                                   that_buff,
-                                                   start_index,
-                                                   end_index,
-                                                   &that,
-                                                   &serialized_varlen_buffer] {
-                                                    reduceEntriesNoCollisionsColWise(
-                                                        this_buff,
-                                                        that_buff,
-                                                        that,
-                                                        start_index,
-                                                        end_index,
-                                                        serialized_varlen_buffer);
-                                                  }));
+        reduction_threads.emplace_back(TaskPool_NS::async([this,
+                                                           this_buff,
+                                                           that_buff,
+                                                           start_index,
+                                                           end_index,
+                                                           &that,
+                                                           &serialized_varlen_buffer] {
+          reduceEntriesNoCollisionsColWise(this_buff,
+                                           that_buff,
+                                           that,
+                                           start_index,
+                                           end_index,
+                                           serialized_varlen_buffer);
+        }));
       } else {
-        reduction_threads.emplace_back(std::async(
-            std::launch::async,
+        reduction_threads.emplace_back(TaskPool_NS::async(
             [this,
              this_buff,
              that_buff,
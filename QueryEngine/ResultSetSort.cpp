@@ -34,6 +34,7 @@
 #include <thrust/sort.h>
 
 #include <future>
+#include <limits>
 
 std::unique_ptr<CudaMgr_Namespace::CudaMgr> g_cuda_mgr;  // for unit tests only
 
@@ -145,12 +146,13 @@ void ResultSet::doBaselineSort(const ExecutorDeviceType device_type,
     topPermutation(permutation_, top_n, compare);
     return;
   } else {
-    permutation_ =
+    const auto permutation =
         (key_bytewidth == 4)
             ? baseline_sort<int32_t>(
                   device_type, 0, data_mgr, groupby_buffer, pod_oe, layout, top_n, 0, 1)
             : baseline_sort<int64_t>(
                   device_type, 0, data_mgr, groupby_buffer, pod_oe, layout, top_n, 0, 1);
+    permutation_.assign(permutation.begin(), permutation.end());
   }
 }
 
@@ -161,6 +163,10 @@ bool ResultSet::canUseFastBaselineSort(
       query_mem_desc_.sortOnGpu() || query_mem_desc_.didOutputColumnar()) {
     return false;
   }
+  // The baseline sort indices are 32-bit.
+  if (query_mem_desc_.getEntryCount() > std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
   const auto& order_entry = order_entries.front();
   CHECK_GE(order_entry.tle_no, 1);
   CHECK_LE(static_cast<size_t>(order_entry.tle_no), targets_.size());
@@ -0,0 +1,391 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResultSetSpill.h"
+
+#include "Execute.h"
+#include "MurmurHash.h"
+#include "RuntimeFunctions.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <unistd.h>
+
+namespace {
+
+// Independent of the hash which places the keys in the baseline hash tables, so the
+// keys of a partition still spread over the whole table. Each level of partitioning
+// adds its depth to it, for the partitions split again to spread too.
+constexpr uint64_t kPartitionHashSeed = 0x9e3779b97f4a7c15;
+
+// Bounds the scratch files open at a time and the write buffers of a partitioning.
+// The partitions still too large for the budget are split again, up to the maximum
+// depth; past it they are reduced in memory regardless, their keys are skewed.
+constexpr size_t kMaxSpillPartitions{32};
+constexpr size_t kMaxSpillDepth{3};
+
+boost::filesystem::path spill_directory() {
+  return g_result_spill_path.empty()
+             ? boost::filesystem::temp_directory_path() / "omnisci_spill"
+             : boost::filesystem::path(g_result_spill_path);
+}
+
+std::string spill_error(const std::string& what) {
+  return "Failed to " + what + " result spill file in " + spill_directory().string() +
+         ": " + std::strerror(errno);
+}
+
+bool is_empty_row(const int8_t* row, const size_t key_width) {
+  switch (key_width) {
+    case 4:
+      return *reinterpret_cast<const int32_t*>(row) == get_empty_key<int32_t>();
+    case 8:
+      return *reinterpret_cast<const int64_t*>(row) == get_empty_key<int64_t>();
+    default:
+      CHECK(false);
+      return true;
+  }
+}
+
+size_t next_power_of_two(const size_t n) {
+  size_t result{1};
+  while (result < n) {
+    result *= 2;
+  }
+  return result;
+}
+
+// Whether the hash table reducing row_count rows doesn't fit in half of the budget.
+bool exceeds_spill_budget(const size_t row_count, const size_t row_bytes) {
+  return 4 * row_count * row_bytes > g_result_spill_memory_budget;
+}
+
+}  // namespace
+
+// Distributes rows over scratch files by the hash of their keys, the seed depending on
+// the depth of the partitioning.
+class SpillPartitioner {
+ public:
+  SpillPartitioner(const size_t row_count,
+                   const size_t row_bytes,
+                   const size_t key_bytes,
+                   const size_t depth)
+      : key_bytes_(key_bytes), seed_(kPartitionHashSeed + depth), shift_(64) {
+    CHECK_GT(g_result_spill_memory_budget, size_t(0));
+    const auto partition_count = std::min(
+        kMaxSpillPartitions,
+        next_power_of_two(std::max(size_t(2),
+                                   (4 * row_count * row_bytes +
+                                    g_result_spill_memory_budget - 1) /
+                                       g_result_spill_memory_budget)));
+    for (size_t i = 1; i < partition_count; i *= 2) {
+      --shift_;
+    }
+    // The write buffers of all the partitions take at most half of the budget.
+    const auto block_bytes = std::min(
+        size_t(SpillFile::kBlockBytes),
+        std::max(row_bytes, g_result_spill_memory_budget / (2 * partition_count)));
+    writers_.reserve(partition_count);
+    for (size_t i = 0; i < partition_count; ++i) {
+      partitions_.emplace_back(std::make_unique<SpillFile>());
+      writers_.emplace_back(partitions_.back().get(), block_bytes);
+    }
+  }
+
+  void append(const int8_t* row, const size_t row_bytes) {
+    const auto h = MurmurHash64A(row, key_bytes_, seed_);
+    writers_[h >> shift_].append(row, row_bytes);
+  }
+
+  std::vector<std::unique_ptr<SpillFile>> finish() {
+    for (auto& writer : writers_) {
+      writer.flush();
+    }
+    writers_.clear();
+    return std::move(partitions_);
+  }
+
+  size_t partitionCount() const { return partitions_.size(); }
+
+ private:
+  const size_t key_bytes_;
+  const uint64_t seed_;
+  size_t shift_;
+  std::vector<std::unique_ptr<SpillFile>> partitions_;
+  std::vector<SpillWriter> writers_;
+};
+
+namespace {
+
+// Reduces the rows of a spill file into the given hash table, a chunk of them at a time.
+void reduce_spill_file(const SpillFile& file,
+                       const ResultSetStorage* table_storage,
+                       const std::vector<TargetInfo>& targets,
+                       const QueryMemoryDescriptor& query_mem_desc,
+                       std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+                       const std::vector<int64_t>& init_agg_vals,
+                       const Executor* executor) {
+  const auto row_bytes = query_mem_desc.getRowSize();
+  const auto row_count = file.size() / row_bytes;
+  const auto chunk_row_count = std::min(
+      row_count, std::max(size_t(1), g_result_spill_memory_budget / (4 * row_bytes)));
+  std::vector<int8_t> chunk_buffer(chunk_row_count * row_bytes);
+  for (size_t start = 0; start < row_count; start += chunk_row_count) {
+    const auto chunk_rows = std::min(chunk_row_count, row_count - start);
+    file.read(start * row_bytes, chunk_rows * row_bytes, &chunk_buffer[0]);
+    auto chunk_mem_desc = query_mem_desc;
+    chunk_mem_desc.setEntryCount(chunk_rows);
+    ResultSet chunk(targets,
+                    ExecutorDeviceType::CPU,
+                    chunk_mem_desc,
+                    row_set_mem_owner,
+                    executor);
+    const auto chunk_storage = chunk.allocateStorage(&chunk_buffer[0], init_agg_vals);
+    table_storage->reduce(*chunk_storage, {});
+  }
+}
+
+// Reduces the rows of a partition and appends the distinct ones to distinct_writer.
+// Partitions too large for the budget are split again first. Returns the number of
+// distinct rows.
+size_t reduce_partition(std::unique_ptr<SpillFile> partition,
+                        const size_t depth,
+                        SpillWriter& distinct_writer,
+                        const std::vector<TargetInfo>& targets,
+                        const QueryMemoryDescriptor& partition_mem_desc,
+                        std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+                        const std::vector<int64_t>& init_agg_vals,
+                        const Executor* executor) {
+  auto query_mem_desc = partition_mem_desc;
+  const auto row_bytes = query_mem_desc.getRowSize();
+  const auto row_count = partition->size() / row_bytes;
+  if (!row_count) {
+    return 0;
+  }
+  if (exceeds_spill_budget(row_count, row_bytes)) {
+    if (depth < kMaxSpillDepth) {
+      const auto key_bytes =
+          query_mem_desc.getEffectiveKeyWidth() * query_mem_desc.groupColWidthsSize();
+      SpillPartitioner partitioner(row_count, row_bytes, key_bytes, depth + 1);
+      SpillReader reader(partition.get(),
+                         row_bytes,
+                         std::min(size_t(SpillFile::kBlockBytes),
+                                  g_result_spill_memory_budget / 4));
+      for (; !reader.done(); reader.next()) {
+        partitioner.append(reader.current(), row_bytes);
+      }
+      auto sub_partitions = partitioner.finish();
+      partition.reset();
+      size_t distinct_count{0};
+      for (auto& sub_partition : sub_partitions) {
+        distinct_count += reduce_partition(std::move(sub_partition),
+                                           depth + 1,
+                                           distinct_writer,
+                                           targets,
+                                           partition_mem_desc,
+                                           row_set_mem_owner,
+                                           init_agg_vals,
+                                           executor);
+      }
+      return distinct_count;
+    }
+    LOG(WARNING) << "Result spill partition of " << row_count
+                 << " rows exceeds the memory budget, the keys are skewed";
+  }
+  const auto table_entry_count = 2 * row_count;
+  CHECK_LE(table_entry_count, size_t(std::numeric_limits<uint32_t>::max()));
+  query_mem_desc.setEntryCount(table_entry_count);
+  ResultSet table(targets,
+                  ExecutorDeviceType::CPU,
+                  query_mem_desc,
+                  row_set_mem_owner,
+                  executor);
+  const auto table_storage = table.allocateStorage(init_agg_vals);
+  table.initializeStorage();
+  reduce_spill_file(*partition,
+                    table_storage,
+                    targets,
+                    partition_mem_desc,
+                    row_set_mem_owner,
+                    init_agg_vals,
+                    executor);
+  partition.reset();
+  const auto key_width = query_mem_desc.getEffectiveKeyWidth();
+  const auto table_buffer = table_storage->getUnderlyingBuffer();
+  size_t distinct_count{0};
+  for (size_t i = 0; i < table_entry_count; ++i) {
+    const auto row = table_buffer + i * row_bytes;
+    if (!is_empty_row(row, key_width)) {
+      distinct_writer.append(row, row_bytes);
+      ++distinct_count;
+    }
+  }
+  return distinct_count;
+}
+
+}  // namespace
+
+constexpr size_t SpillFile::kBlockBytes;
+
+SpillFile::SpillFile() : file_(nullptr), size_(0) {
+  const auto directory = spill_directory();
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(directory, ec);
+  if (ec) {
+    throw std::runtime_error("Failed to create the result spill directory " +
+                             directory.string() + ": " + ec.message());
+  }
+  const auto path =
+      directory / boost::filesystem::unique_path("spill_%%%%-%%%%-%%%%-%%%%");
+  file_ = fopen(path.string().c_str(), "w+b");
+  if (!file_) {
+    throw std::runtime_error(spill_error("create"));
+  }
+  unlink(path.string().c_str());
+}
+
+SpillFile::~SpillFile() {
+  fclose(file_);
+}
+
+void SpillFile::append(const int8_t* data, const size_t size) {
+  if (fseeko(file_, 0, SEEK_END) || fwrite(data, 1, size, file_) != size) {
+    throw std::runtime_error(spill_error("write to"));
+  }
+  size_ += size;
+}
+
+void SpillFile::read(const size_t offset, const size_t size, int8_t* data) const {
+  CHECK_LE(offset + size, size_);
+  if (fseeko(file_, offset, SEEK_SET) || fread(data, 1, size, file_) != size) {
+    throw std::runtime_error(spill_error("read from"));
+  }
+}
+
+bool should_spill_reduction(const QueryMemoryDescriptor& query_mem_desc,
+                            const size_t total_entry_count) {
+  return g_enable_result_spill &&
+         query_mem_desc.getQueryDescriptionType() ==
+             QueryDescriptionType::GroupByBaselineHash &&
+         !query_mem_desc.didOutputColumnar() && !query_mem_desc.hasKeylessHash() &&
+         total_entry_count * query_mem_desc.getRowSize() > g_result_spill_memory_budget;
+}
+
+ResultSetSpiller::ResultSetSpiller(const size_t max_row_count)
+    : max_row_count_(max_row_count), row_count_(0) {}
+
+ResultSetSpiller::~ResultSetSpiller() {}
+
+void ResultSetSpiller::spill(const ResultSet& result) {
+  const auto& result_mem_desc = result.getQueryMemDesc();
+  const auto row_bytes = result_mem_desc.getRowSize();
+  const auto key_width = result_mem_desc.getEffectiveKeyWidth();
+  const auto buffer = result.getStorage()->getUnderlyingBuffer();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!partitioner_) {
+    targets_ = result.getTargetInfos();
+    query_mem_desc_ = std::make_unique<QueryMemoryDescriptor>(result_mem_desc);
+    const auto key_bytes = key_width * result_mem_desc.groupColWidthsSize();
+    partitioner_ =
+        std::make_unique<SpillPartitioner>(max_row_count_, row_bytes, key_bytes, 0);
+    VLOG(1) << "Spilling the group by results to " << partitioner_->partitionCount()
+            << " partitions in " << spill_directory().string();
+  }
+  CHECK_EQ(query_mem_desc_->getRowSize(), row_bytes);
+  CHECK_EQ(query_mem_desc_->getEffectiveKeyWidth(), key_width);
+  for (size_t i = 0; i < result_mem_desc.getEntryCount(); ++i) {
+    const auto row = buffer + i * row_bytes;
+    if (!is_empty_row(row, key_width)) {
+      partitioner_->append(row, row_bytes);
+      ++row_count_;
+    }
+  }
+}
+
+bool ResultSetSpiller::empty() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !partitioner_;
+}
+
+std::shared_ptr<ResultSet> ResultSetSpiller::reduce(
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+    const std::vector<int64_t>& init_agg_vals,
+    const Executor* executor) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK(partitioner_);
+  VLOG(1) << "Reducing " << row_count_ << " spilled rows";
+  auto partitions = partitioner_->finish();
+  partitioner_.reset();
+  SpillFile distinct_rows;
+  size_t distinct_count{0};
+  {
+    SpillWriter distinct_writer(&distinct_rows);
+    for (auto& partition : partitions) {
+      distinct_count += reduce_partition(std::move(partition),
+                                         0,
+                                         distinct_writer,
+                                         targets_,
+                                         *query_mem_desc_,
+                                         row_set_mem_owner,
+                                         init_agg_vals,
+                                         executor);
+    }
+    distinct_writer.flush();
+  }
+  // The distinct rows go through the hash table of the reduced result set like any
+  // other reduction, later reductions into it find their keys where they expect them.
+  // The partitions have no key in common, nothing is aggregated at this point.
+  auto reduced_mem_desc = *query_mem_desc_;
+  reduced_mem_desc.setEntryCount(std::max(size_t(1), 2 * distinct_count));
+  auto reduced_results = std::make_shared<ResultSet>(targets_,
+                                                     ExecutorDeviceType::CPU,
+                                                     reduced_mem_desc,
+                                                     row_set_mem_owner,
+                                                     executor);
+  const auto reduced_storage = reduced_results->allocateStorage(init_agg_vals);
+  reduced_results->initializeStorage();
+  reduce_spill_file(distinct_rows,
+                    reduced_storage,
+                    targets_,
+                    *query_mem_desc_,
+                    row_set_mem_owner,
+                    init_agg_vals,
+                    executor);
+  return reduced_results;
+}
+
+std::shared_ptr<ResultSet> reduce_baseline_hash_with_spill(
+    const std::vector<const ResultSet*>& results,
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+    const std::vector<int64_t>& init_agg_vals,
+    const Executor* executor) {
+  CHECK(!results.empty());
+  size_t entry_count{0};
+  for (const auto result : results) {
+    entry_count += result->getQueryMemDesc().getEntryCount();
+  }
+  ResultSetSpiller spiller(entry_count);
+  for (const auto result : results) {
+    spiller.spill(*result);
+  }
+  return spiller.reduce(row_set_mem_owner, init_agg_vals, executor);
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ResultSetSpill.h
+ * @brief   Reduction and sorting of result sets larger than the memory budget.
+ *
+ * The rows of the baseline hash group by results of the kernels are partitioned by
+ * the hash of their keys into scratch files as the kernels finish, their buffers are
+ * freed right after. Once all the kernels are done, the partitions are reduced one at a
+ * time in a hash table which fits in the memory budget, the ones still too large being
+ * partitioned again by an independent hash. Their distinct rows are inserted into the
+ * hash table of the reduced result set. The sorts which don't fit write sorted runs of
+ * their normalized keys to scratch files and merge them.
+ */
+
+#ifndef QUERYENGINE_RESULTSETSPILL_H
+#define QUERYENGINE_RESULTSETSPILL_H
+
+#include "ResultSet.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// An anonymous file in the directory given by g_result_spill_path, or in the temporary
+// directory if it isn't set. It's unlinked as soon as it's created, the space goes back
+// to the file system when it's closed.
+class SpillFile {
+ public:
+  SpillFile();
+
+  ~SpillFile();
+
+  void append(const int8_t* data, const size_t size);
+
+  void read(const size_t offset, const size_t size, int8_t* data) const;
+
+  size_t size() const { return size_; }
+
+  static constexpr size_t kBlockBytes = 1 << 20;
+
+ private:
+  FILE* file_;
+  size_t size_;
+};
+
+// Buffers the records appended to a spill file and writes them out in large blocks.
+class SpillWriter {
+ public:
+  explicit SpillWriter(SpillFile* file,
+                       const size_t block_bytes = SpillFile::kBlockBytes)
+      : file_(file), block_bytes_(block_bytes) {
+    buffer_.reserve(block_bytes_);
+  }
+
+  void append(const int8_t* record, const size_t record_bytes) {
+    if (buffer_.size() + record_bytes > block_bytes_) {
+      flush();
+    }
+    buffer_.insert(buffer_.end(), record, record + record_bytes);
+  }
+
+  void flush() {
+    if (!buffer_.empty()) {
+      file_->append(&buffer_[0], buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+ private:
+  SpillFile* file_;
+  size_t block_bytes_;
+  std::vector<int8_t> buffer_;
+};
+
+// Reads the fixed size records of a spill file in order, a block of them at a time.
+class SpillReader {
+ public:
+  SpillReader(const SpillFile* file, const size_t record_bytes, const size_t block_bytes)
+      : file_(file)
+      , record_bytes_(record_bytes)
+      , block_records_(std::max(size_t(1), block_bytes / record_bytes))
+      , file_offset_(0)
+      , block_offset_(0) {
+    CHECK_EQ(size_t(0), file_->size() % record_bytes_);
+    readBlock();
+  }
+
+  bool done() const { return block_offset_ == block_.size(); }
+
+  const int8_t* current() const {
+    CHECK(!done());
+    return &block_[block_offset_];
+  }
+
+  void next() {
+    block_offset_ += record_bytes_;
+    if (done()) {
+      readBlock();
+    }
+  }
+
+ private:
+  void readBlock() {
+    const auto bytes =
+        std::min(block_records_ * record_bytes_, file_->size() - file_offset_);
+    block_.resize(bytes);
+    if (bytes) {
+      file_->read(file_offset_, bytes, &block_[0]);
+    }
+    file_offset_ += bytes;
+    block_offset_ = 0;
+  }
+
+  const SpillFile* file_;
+  const size_t record_bytes_;
+  const size_t block_records_;
+  size_t file_offset_;
+  std::vector<int8_t> block_;
+  size_t block_offset_;
+};
+
+// Whether the reduction of the results of the devices into a hash table with
+// total_entry_count entries should go through the scratch files instead.
+bool should_spill_reduction(const QueryMemoryDescriptor& query_mem_desc,
+                            const size_t total_entry_count);
+
+class SpillPartitioner;
+
+// Partitions the rows of baseline hash group by results into scratch files, then reduces
+// the partitions into a single result set. The results can be spilled concurrently.
+class ResultSetSpiller {
+ public:
+  // The number of partitions is chosen for max_row_count rows, the partitions which end
+  // up too large for the budget are split again during the reduction.
+  explicit ResultSetSpiller(const size_t max_row_count);
+
+  ~ResultSetSpiller();
+
+  // Appends the non-empty rows of the result to the partitions. The result isn't
+  // referenced afterwards, its buffer can be released.
+  void spill(const ResultSet& result);
+
+  bool empty() const;
+
+  std::shared_ptr<ResultSet> reduce(std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+                                    const std::vector<int64_t>& init_agg_vals,
+                                    const Executor* executor);
+
+ private:
+  const size_t max_row_count_;
+  std::vector<TargetInfo> targets_;
+  std::unique_ptr<QueryMemoryDescriptor> query_mem_desc_;  // of the first result spilled
+  std::unique_ptr<SpillPartitioner> partitioner_;
+  size_t row_count_;
+  mutable std::mutex mutex_;
+};
+
+std::shared_ptr<ResultSet> reduce_baseline_hash_with_spill(
+    const std::vector<const ResultSet*>& results,
+    std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner,
+    const std::vector<int64_t>& init_agg_vals,
+    const Executor* executor);
+
+#endif  // QUERYENGINE_RESULTSETSPILL_H
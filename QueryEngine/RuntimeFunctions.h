@@ -195,6 +195,11 @@ extern "C" int64_t fixed_width_small_date_decode_noinline(const int8_t* byte_str
                                                           const int64_t ret_null_val,
                                                           const int64_t pos);
 
+extern "C" int64_t packed_int_decode_noinline(const int8_t* chunk,
+                                              const int32_t byte_width,
+                                              const int64_t null_val,
+                                              const int64_t pos);
+
 extern "C" int8_t* extract_str_ptr_noinline(const uint64_t str_and_len);
 
 extern "C" int32_t extract_str_len_noinline(const uint64_t str_and_len);
@@ -52,6 +52,17 @@ extern "C" int32_t string_compress(const int64_t ptr_and_len,
   return string_dict_proxy->getIdOfString(raw_str);
 }
 
+extern "C" int32_t translate_string_id(const int32_t string_id,
+                                       const int64_t translation_map_handle) {
+  if (string_id == NULL_INT) {
+    return NULL_INT;
+  }
+  auto translation_map =
+      reinterpret_cast<const StringDictionaryProxy::TranslationMap*>(
+          translation_map_handle);
+  return translation_map->translate(string_id);
+}
+
 llvm::Value* Executor::codegen(const Analyzer::CharLengthExpr* expr,
                                const CompilationOptions& co) {
   auto str_lv = codegen(expr->get_arg(), true, co);
@@ -17,6 +17,7 @@
 #include "TableOptimizer.h"
 
 #include <Analyzer/Analyzer.h>
+#include <Shared/TaskPool.h>
 #include <Shared/scope.h>
 
 namespace {
@@ -107,6 +108,8 @@ inline ExecutionOptions get_execution_options() {
 void TableOptimizer::recomputeMetadata() const {
   INJECT_TIMER(optimizeMetadata);
   std::lock_guard<std::mutex> lock(executor_->execute_mutex_);
+  // Maintenance work, yield the shared CPU pool to interactive queries.
+  TaskPool_NS::ScopedTaskContext task_context(TaskPool_NS::TaskPriority::LOW, nullptr);
 
   LOG(INFO) << "Recomputing metadata for " << td_->tableName;
 
@@ -322,8 +325,55 @@ void TableOptimizer::recomputeMetadata() const {
 }
 
 void TableOptimizer::vacuumDeletedRows() const {
+  TaskPool_NS::ScopedTaskContext task_context(TaskPool_NS::TaskPriority::LOW, nullptr);
   const auto table_id = td_->tableId;
   cat_.optimizeTable(td_);
   auto& data_mgr = cat_.getDataMgr();
   data_mgr.checkpoint(cat_.getCurrentDB().dbId, table_id);
 }
+
+void TableOptimizer::packEncodedColumns() const {
+  std::lock_guard<std::mutex> lock(executor_->execute_mutex_);
+  TaskPool_NS::ScopedTaskContext task_context(TaskPool_NS::TaskPriority::LOW, nullptr);
+
+  std::vector<const TableDescriptor*> table_descriptors;
+  if (td_->nShards > 0) {
+    const auto physical_tds = cat_.getPhysicalTablesDescriptors(td_);
+    table_descriptors.insert(
+        table_descriptors.begin(), physical_tds.begin(), physical_tds.end());
+  } else {
+    table_descriptors.push_back(td_);
+  }
+
+  auto& data_mgr = cat_.getDataMgr();
+  bool has_packed_columns{false};
+  for (const auto td : table_descriptors) {
+    const auto col_descs =
+        cat_.getAllColumnMetadataForTable(td->tableId, false, false, false);
+    for (const auto cd : col_descs) {
+      if (!cd->columnType.is_packed_int()) {
+        continue;
+      }
+      if (!has_packed_columns) {
+        LOG(INFO) << "Packing encoded columns for " << td_->tableName;
+        has_packed_columns = true;
+      }
+      auto* fragmenter = td->fragmenter;
+      CHECK(fragmenter);
+      fragmenter->packChunks(cd);
+    }
+    if (has_packed_columns) {
+      data_mgr.checkpoint(cat_.getCurrentDB().dbId, td->tableId);
+    }
+  }
+  if (!has_packed_columns) {
+    return;
+  }
+
+  // The cached copies of the chunks hold the plain values.
+  executor_->clearMetaInfoCache();
+  data_mgr.clearMemory(Data_Namespace::MemoryLevel::CPU_LEVEL);
+  if (data_mgr.gpusPresent()) {
+    data_mgr.clearMemory(Data_Namespace::MemoryLevel::GPU_LEVEL);
+  }
+}
@@ -55,6 +55,14 @@ class TableOptimizer {
    */
   void vacuumDeletedRows() const;
 
+  /**
+   * @brief Packs the chunks of RL, DIFF and BITPACK encoded columns.
+   * The chunks of these columns hold plain values while their fragment receives inserts.
+   * Packing rewrites the chunks of the full fragments into the encoded format, only if
+   * that makes them smaller. Like vacuuming, packing is a checkpointing operation.
+   */
+  void packEncodedColumns() const;
+
  private:
   const TableDescriptor* td_;
   Executor* executor_;
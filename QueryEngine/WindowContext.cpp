@@ -15,9 +15,13 @@
  */
 
 #include "WindowContext.h"
+#include <limits>
 #include <numeric>
+#include "../Shared/DateConverters.h"
+#include "../Shared/TaskPool.h"
 #include "../Shared/checked_alloc.h"
 #include "../Shared/sql_window_function_to_string.h"
+#include "../Shared/thread_count.h"
 #include "Descriptors/CountDistinctDescriptor.h"
 #include "OutputBufferInitialization.h"
 #include "ResultSetBufferAccessors.h"
@@ -32,6 +36,7 @@ WindowFunctionContext::WindowFunctionContext(
     : window_func_(window_func)
     , partitions_(partitions)
     , elem_count_(elem_count)
+    , aggregate_column_(nullptr)
     , output_(nullptr)
     , partition_start_(nullptr)
     , device_type_(device_type) {}
@@ -50,6 +55,15 @@ void WindowFunctionContext::addOrderColumn(
   order_columns_.push_back(column);
 }
 
+void WindowFunctionContext::setAggregateColumn(
+    const int8_t* column,
+    const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner) {
+  CHECK(window_func_->getFrame());
+  CHECK(!aggregate_column_);
+  aggregate_column_owner_ = chunks_owner;
+  aggregate_column_ = column;
+}
+
 namespace {
 
 // Converts the sorted indices to a mapping from row position to row number.
@@ -63,10 +77,10 @@ std::vector<int64_t> index_to_row_number(const int64_t* index, const size_t inde
 
 // Returns true iff the current element is greater than the previous, according to the
 // comparator. This is needed because peer rows have to have the same rank.
-bool advance_current_rank(
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator,
-    const int64_t* index,
-    const size_t i) {
+template <class COMPARATOR>
+bool advance_current_rank(const COMPARATOR& comparator,
+                          const int64_t* index,
+                          const size_t i) {
   if (i == 0) {
     return false;
   }
@@ -74,10 +88,10 @@ bool advance_current_rank(
 }
 
 // Computes the mapping from row position to rank.
-std::vector<int64_t> index_to_rank(
-    const int64_t* index,
-    const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+template <class COMPARATOR>
+std::vector<int64_t> index_to_rank(const int64_t* index,
+                                   const size_t index_size,
+                                   const COMPARATOR& comparator) {
   std::vector<int64_t> rank(index_size);
   size_t crt_rank = 1;
   for (size_t i = 0; i < index_size; ++i) {
@@ -90,10 +104,10 @@ std::vector<int64_t> index_to_rank(
 }
 
 // Computes the mapping from row position to dense rank.
-std::vector<int64_t> index_to_dense_rank(
-    const int64_t* index,
-    const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+template <class COMPARATOR>
+std::vector<int64_t> index_to_dense_rank(const int64_t* index,
+                                         const size_t index_size,
+                                         const COMPARATOR& comparator) {
   std::vector<int64_t> dense_rank(index_size);
   size_t crt_rank = 1;
   for (size_t i = 0; i < index_size; ++i) {
@@ -106,10 +120,10 @@ std::vector<int64_t> index_to_dense_rank(
 }
 
 // Computes the mapping from row position to percent rank.
-std::vector<double> index_to_percent_rank(
-    const int64_t* index,
-    const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+template <class COMPARATOR>
+std::vector<double> index_to_percent_rank(const int64_t* index,
+                                          const size_t index_size,
+                                          const COMPARATOR& comparator) {
   std::vector<double> percent_rank(index_size);
   size_t crt_rank = 1;
   for (size_t i = 0; i < index_size; ++i) {
@@ -123,10 +137,10 @@ std::vector<double> index_to_percent_rank(
 }
 
 // Computes the mapping from row position to cumulative distribution.
-std::vector<double> index_to_cume_dist(
-    const int64_t* index,
-    const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+template <class COMPARATOR>
+std::vector<double> index_to_cume_dist(const int64_t* index,
+                                       const size_t index_size,
+                                       const COMPARATOR& comparator) {
   std::vector<double> cume_dist(index_size);
   size_t start_peer_group = 0;
   while (start_peer_group < index_size) {
@@ -261,11 +275,11 @@ void apply_last_value_to_partition(const int32_t* original_indices,
 
 // Computes the multiplicities for an order by column. The first element in a peer group
 // gets a multiplicity equal to the size of the group, the remaining ones get 0.
-void index_to_multiplicities(
-    unsigned* partition_multiplicities,
-    const int64_t* index,
-    const size_t index_size,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+template <class COMPARATOR>
+void index_to_multiplicities(unsigned* partition_multiplicities,
+                             const int64_t* index,
+                             const size_t index_size,
+                             const COMPARATOR& comparator) {
   size_t multiplicity = 0;
   size_t sequence_start_idx = 0;
   for (size_t i = 0; i < index_size; ++i) {
@@ -313,74 +327,79 @@ void WindowFunctionContext::compute() {
   CHECK(!output_);
   output_ = static_cast<int8_t*>(checked_malloc(
       elem_count_ * window_function_buffer_element_size(window_func_->getKind())));
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  const bool is_framed_aggregate = window_func_->getFrame() != nullptr;
+  if (window_function_is_aggregate(window_func_->getKind()) && !is_framed_aggregate) {
     fillPartitionStart();
     CHECK(multiplicities_.empty());
     if (window_function_requires_multiplicity(window_func_->getKind())) {
       multiplicities_.resize(elem_count_);
     }
   }
+  const auto order_columns = makeOrderColumns();
+  const bool sort_partitions = !sorted_partitions_;
+  if (sort_partitions) {
+    sorted_partitions_ = std::make_shared<std::vector<int64_t>>(elem_count_);
+  }
   std::unique_ptr<int64_t[]> scratchpad(new int64_t[elem_count_]);
-  int64_t off = 0;
-  for (size_t i = 0; i < partitionCount(); ++i) {
-    auto partition_size = counts()[i];
-    if (partition_size == 0) {
-      continue;
-    }
-    auto output_for_partition_buff = scratchpad.get() + offsets()[i];
-    std::iota(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              int64_t(0));
-    std::vector<Comparator> comparators;
-    const auto& order_keys = window_func_->getOrderKeys();
-    const auto& collation = window_func_->getCollation();
-    CHECK_EQ(order_keys.size(), collation.size());
-    for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
-         ++order_column_idx) {
-      auto order_column_buffer = order_columns_[order_column_idx];
-      const auto order_col =
-          dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
-      CHECK(order_col);
-      const auto& order_col_collation = collation[order_column_idx];
-      const auto asc_comparator = makeComparator(order_col,
-                                                 order_column_buffer,
-                                                 payload() + offsets()[i],
-                                                 order_col_collation.nulls_first);
-      auto comparator = asc_comparator;
-      if (order_col_collation.is_desc) {
-        comparator = [asc_comparator](const int64_t lhs, const int64_t rhs) {
-          return asc_comparator(rhs, lhs);
-        };
+  // The partitions are laid out one after the other in the payload, in the order of
+  // their offsets, and each one only writes to its own range of the buffers.
+  const auto compute_partitions = [this, &order_columns, sort_partitions, &scratchpad](
+                                      const size_t start, const size_t end) {
+    for (size_t i = start; i < end; ++i) {
+      const auto partition_size = counts()[i];
+      if (partition_size == 0) {
+        continue;
       }
-      comparators.push_back(comparator);
-    }
-    const auto col_tuple_comparator = [&comparators](const int64_t lhs,
-                                                     const int64_t rhs) {
-      for (const auto& comparator : comparators) {
-        if (comparator(lhs, rhs)) {
-          return true;
+      const size_t off = offsets()[i];
+      const Comparator comparator(order_columns, payload() + off);
+      auto sorted_partition = sorted_partitions_->data() + off;
+      if (sort_partitions) {
+        std::iota(sorted_partition, sorted_partition + partition_size, int64_t(0));
+        if (!order_columns.empty()) {
+          std::sort(sorted_partition, sorted_partition + partition_size, comparator);
         }
       }
-      return false;
-    };
-    std::sort(output_for_partition_buff,
-              output_for_partition_buff + partition_size,
-              col_tuple_comparator);
-    computePartition(output_for_partition_buff,
-                     partition_size,
-                     off,
-                     window_func_,
-                     col_tuple_comparator);
-    if (window_func_->getKind() == SqlWindowFunctionKind::LAG ||
-        window_func_->getKind() == SqlWindowFunctionKind::LEAD ||
-        window_func_->getKind() == SqlWindowFunctionKind::FIRST_VALUE ||
-        window_func_->getKind() == SqlWindowFunctionKind::LAST_VALUE ||
-        window_function_is_aggregate(window_func_->getKind())) {
-      off += partition_size;
+      auto output_for_partition_buff = scratchpad.get() + off;
+      if (window_func_->getFrame()) {
+        computeFramedAggregatePartition(output_for_partition_buff,
+                                        sorted_partition,
+                                        partition_size,
+                                        off,
+                                        order_columns,
+                                        comparator);
+        continue;
+      }
+      std::copy(
+          sorted_partition, sorted_partition + partition_size, output_for_partition_buff);
+      computePartition(
+          output_for_partition_buff, partition_size, off, window_func_, comparator);
+    }
+  };
+  // Ranges of consecutive partitions with about the same number of rows, several per
+  // thread since the partition sizes can be very uneven.
+  const auto partition_count = partitionCount();
+  const auto range_elem_count =
+      std::max(size_t(1), elem_count_ / (4 * static_cast<size_t>(cpu_threads())));
+  std::vector<TaskPool_NS::TaskFuture<void>> partition_threads;
+  size_t range_start{0};
+  size_t range_elems{0};
+  for (size_t i = 0; i < partition_count; ++i) {
+    range_elems += counts()[i];
+    if (range_elems >= range_elem_count || i + 1 == partition_count) {
+      partition_threads.push_back(
+          TaskPool_NS::async(compute_partitions, range_start, i + 1));
+      range_start = i + 1;
+      range_elems = 0;
     }
   }
+  for (auto& child : partition_threads) {
+    child.wait();
+  }
+  for (auto& child : partition_threads) {
+    child.get();
+  }
   auto output_i64 = reinterpret_cast<int64_t*>(output_);
-  if (window_function_is_aggregate(window_func_->getKind())) {
+  if (window_function_is_aggregate(window_func_->getKind()) && !is_framed_aggregate) {
     std::copy(scratchpad.get(), scratchpad.get() + elem_count_, output_i64);
   } else {
     for (size_t i = 0; i < elem_count_; ++i) {
@@ -389,6 +408,20 @@ void WindowFunctionContext::compute() {
   }
 }
 
+void WindowFunctionContext::setSortedPartitions(
+    const std::shared_ptr<std::vector<int64_t>>& sorted_partitions) {
+  CHECK(!output_);
+  CHECK(sorted_partitions);
+  CHECK_EQ(elem_count_, sorted_partitions->size());
+  sorted_partitions_ = sorted_partitions;
+}
+
+const std::shared_ptr<std::vector<int64_t>>& WindowFunctionContext::getSortedPartitions()
+    const {
+  CHECK(sorted_partitions_);
+  return sorted_partitions_;
+}
+
 const Analyzer::WindowFunction* WindowFunctionContext::getWindowFunction() const {
   return window_func_;
 }
@@ -429,110 +462,149 @@ llvm::Value* WindowFunctionContext::getRowNumber() const {
 
 namespace {
 
+// Three-way comparison of the values of an order column at two rows, the nulls first or
+// last depending on the collation.
 template <class T>
-bool integer_comparator(const int8_t* order_column_buffer,
-                        const SQLTypeInfo& ti,
-                        const int32_t* partition_indices,
-                        const int64_t lhs,
-                        const int64_t rhs,
-                        const bool nulls_first) {
+int compare_order_values(const int8_t* order_column_buffer,
+                         const int32_t lhs_row,
+                         const int32_t rhs_row,
+                         const T null_val,
+                         const bool nulls_first) {
   const auto values = reinterpret_cast<const T*>(order_column_buffer);
-  const auto lhs_val = values[partition_indices[lhs]];
-  const auto rhs_val = values[partition_indices[rhs]];
-  const auto null_val = inline_int_null_val(ti);
-  if (lhs_val == null_val && rhs_val == null_val) {
-    return false;
-  }
-  if (lhs_val == null_val && rhs_val != null_val) {
-    return nulls_first;
-  }
-  if (rhs_val == null_val && lhs_val != null_val) {
-    return !nulls_first;
+  const auto lhs_val = values[lhs_row];
+  const auto rhs_val = values[rhs_row];
+  const bool lhs_is_null = lhs_val == null_val;
+  const bool rhs_is_null = rhs_val == null_val;
+  if (lhs_is_null || rhs_is_null) {
+    if (lhs_is_null && rhs_is_null) {
+      return 0;
+    }
+    return lhs_is_null == nulls_first ? -1 : 1;
   }
-  return lhs_val < rhs_val;
+  return lhs_val < rhs_val ? -1 : (rhs_val < lhs_val ? 1 : 0);
 }
 
-template <class T, class NullPatternType>
-bool fp_comparator(const int8_t* order_column_buffer,
-                   const SQLTypeInfo& ti,
-                   const int32_t* partition_indices,
-                   const int64_t lhs,
-                   const int64_t rhs,
-                   const bool nulls_first) {
-  const auto values = reinterpret_cast<const T*>(order_column_buffer);
-  const auto lhs_val = values[partition_indices[lhs]];
-  const auto rhs_val = values[partition_indices[rhs]];
-  const auto null_bit_pattern = null_val_bit_pattern(ti, ti.get_type() == kFLOAT);
-  const auto lhs_bit_pattern =
-      *reinterpret_cast<const NullPatternType*>(may_alias_ptr(&lhs_val));
-  const auto rhs_bit_pattern =
-      *reinterpret_cast<const NullPatternType*>(may_alias_ptr(&rhs_val));
-  if (lhs_bit_pattern == null_bit_pattern && rhs_bit_pattern == null_bit_pattern) {
-    return false;
-  }
-  if (lhs_bit_pattern == null_bit_pattern && rhs_bit_pattern != null_bit_pattern) {
-    return nulls_first;
-  }
-  if (rhs_bit_pattern == null_bit_pattern && lhs_bit_pattern != null_bit_pattern) {
-    return !nulls_first;
+// The integer type of the given width.
+SQLTypes get_int_type_by_size(const size_t size) {
+  switch (size) {
+    case 1: {
+      return kTINYINT;
+    }
+    case 2: {
+      return kSMALLINT;
+    }
+    case 4: {
+      return kINT;
+    }
+    case 8: {
+      return kBIGINT;
+    }
+    default: { CHECK(false); }
   }
-  return lhs_val < rhs_val;
+  return kNULLT;
 }
 
 }  // namespace
 
-std::function<bool(const int64_t lhs, const int64_t rhs)>
-WindowFunctionContext::makeComparator(const Analyzer::ColumnVar* col_var,
-                                      const int8_t* order_column_buffer,
-                                      const int32_t* partition_indices,
-                                      const bool nulls_first) {
-  const auto& ti = col_var->get_type_info();
-  switch (ti.get_type()) {
-    case kBIGINT: {
-      return [order_column_buffer, nulls_first, partition_indices, &ti](
-                 const int64_t lhs, const int64_t rhs) {
-        return integer_comparator<int64_t>(
-            order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-      };
-    }
-    case kINT: {
-      return [order_column_buffer, nulls_first, partition_indices, &ti](
-                 const int64_t lhs, const int64_t rhs) {
-        return integer_comparator<int32_t>(
-            order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-      };
-    }
-    case kSMALLINT: {
-      return [order_column_buffer, nulls_first, partition_indices, &ti](
-                 const int64_t lhs, const int64_t rhs) {
-        return integer_comparator<int16_t>(
-            order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-      };
-    }
-    case kTINYINT: {
-      return [order_column_buffer, nulls_first, partition_indices, &ti](
-                 const int64_t lhs, const int64_t rhs) {
-        return integer_comparator<int8_t>(
-            order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-      };
+std::vector<WindowFunctionContext::OrderColumn> WindowFunctionContext::makeOrderColumns()
+    const {
+  const auto& order_keys = window_func_->getOrderKeys();
+  const auto& collation = window_func_->getCollation();
+  CHECK_EQ(order_keys.size(), collation.size());
+  CHECK_EQ(order_keys.size(), order_columns_.size());
+  std::vector<OrderColumn> order_columns;
+  for (size_t order_column_idx = 0; order_column_idx < order_columns_.size();
+       ++order_column_idx) {
+    const auto order_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(order_keys[order_column_idx].get());
+    CHECK(order_col);
+    const auto& ti = order_col->get_type_info();
+    OrderColumn order_column;
+    order_column.buffer = order_columns_[order_column_idx];
+    order_column.type = ti.get_type();
+    order_column.int_null_val = 0;
+    order_column.fp_null_val = 0;
+    if (ti.is_integer() || ti.is_decimal() || ti.is_time()) {
+      // Compared as integers of the width they're stored in, which covers the decimals,
+      // the times and the fixed encodings too.
+      order_column.type = get_int_type_by_size(ti.get_size());
+      order_column.int_null_val = inline_fixed_encoding_null_val(ti);
+    } else if (ti.is_fp()) {
+      order_column.fp_null_val = inline_fp_null_val(ti);
+    } else {
+      throw std::runtime_error("Window function ORDER BY type not supported yet: " +
+                               ti.get_type_name());
     }
-    case kFLOAT: {
-      return [order_column_buffer, nulls_first, partition_indices, &ti](
-                 const int64_t lhs, const int64_t rhs) {
-        return fp_comparator<float, int32_t>(
-            order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-      };
+    order_column.is_desc = collation[order_column_idx].is_desc;
+    order_column.nulls_first = collation[order_column_idx].nulls_first;
+    order_columns.push_back(order_column);
+  }
+  return order_columns;
+}
+
+bool WindowFunctionContext::Comparator::operator()(const int64_t lhs,
+                                                   const int64_t rhs) const {
+  const auto lhs_row = partition_indices_[lhs];
+  const auto rhs_row = partition_indices_[rhs];
+  for (const auto& order_column : order_columns_) {
+    int cmp{0};
+    switch (order_column.type) {
+      case kBIGINT: {
+        cmp = compare_order_values<int64_t>(order_column.buffer,
+                                            lhs_row,
+                                            rhs_row,
+                                            order_column.int_null_val,
+                                            order_column.nulls_first);
+        break;
+      }
+      case kINT: {
+        cmp = compare_order_values<int32_t>(order_column.buffer,
+                                            lhs_row,
+                                            rhs_row,
+                                            order_column.int_null_val,
+                                            order_column.nulls_first);
+        break;
+      }
+      case kSMALLINT: {
+        cmp = compare_order_values<int16_t>(order_column.buffer,
+                                            lhs_row,
+                                            rhs_row,
+                                            order_column.int_null_val,
+                                            order_column.nulls_first);
+        break;
+      }
+      case kTINYINT: {
+        cmp = compare_order_values<int8_t>(order_column.buffer,
+                                           lhs_row,
+                                           rhs_row,
+                                           order_column.int_null_val,
+                                           order_column.nulls_first);
+        break;
+      }
+      case kFLOAT: {
+        cmp = compare_order_values<float>(order_column.buffer,
+                                          lhs_row,
+                                          rhs_row,
+                                          order_column.fp_null_val,
+                                          order_column.nulls_first);
+        break;
+      }
+      case kDOUBLE: {
+        cmp = compare_order_values<double>(order_column.buffer,
+                                           lhs_row,
+                                           rhs_row,
+                                           order_column.fp_null_val,
+                                           order_column.nulls_first);
+        break;
+      }
+      default: { CHECK(false); }
     }
-    case kDOUBLE: {
-      return [order_column_buffer, nulls_first, partition_indices, &ti](
-                 const int64_t lhs, const int64_t rhs) {
-        return fp_comparator<double, int64_t>(
-            order_column_buffer, ti, partition_indices, lhs, rhs, nulls_first);
-      };
+    if (cmp) {
+      // Descending order reverses the whole comparison, the position of the nulls too.
+      return order_column.is_desc ? cmp > 0 : cmp < 0;
     }
-    default: { LOG(FATAL) << "Type not supported yet"; }
   }
-  return nullptr;
+  return false;
 }
 
 void WindowFunctionContext::computePartition(
@@ -540,7 +612,7 @@ void WindowFunctionContext::computePartition(
     const size_t partition_size,
     const size_t off,
     const Analyzer::WindowFunction* window_func,
-    const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator) {
+    const Comparator& comparator) {
   switch (window_func->getKind()) {
     case SqlWindowFunctionKind::ROW_NUMBER: {
       const auto row_numbers =
@@ -627,6 +699,458 @@ void WindowFunctionContext::computePartition(
   }
 }
 
+namespace {
+
+// Reads the integer at the given row of a column stored with the given width.
+int64_t read_int_value(const int8_t* column, const size_t width, const int64_t row) {
+  switch (width) {
+    case 1: {
+      return column[row];
+    }
+    case 2: {
+      return reinterpret_cast<const int16_t*>(column)[row];
+    }
+    case 4: {
+      return reinterpret_cast<const int32_t*>(column)[row];
+    }
+    case 8: {
+      return reinterpret_cast<const int64_t*>(column)[row];
+    }
+    default: { CHECK(false); }
+  }
+  return 0;
+}
+
+// Reads the floating point value at the given row of a column.
+double read_fp_value(const int8_t* column, const SQLTypes type, const int64_t row) {
+  switch (type) {
+    case kFLOAT: {
+      return reinterpret_cast<const float*>(column)[row];
+    }
+    case kDOUBLE: {
+      return reinterpret_cast<const double*>(column)[row];
+    }
+    default: { CHECK(false); }
+  }
+  return 0;
+}
+
+template <class T>
+T add_saturated(const T val, const T offset) {
+  return val > std::numeric_limits<T>::max() - offset ? std::numeric_limits<T>::max()
+                                                      : val + offset;
+}
+
+template <class T>
+T subtract_saturated(const T val, const T offset) {
+  return val < std::numeric_limits<T>::lowest() + offset
+             ? std::numeric_limits<T>::lowest()
+             : val - offset;
+}
+
+// The values of the order key of a RANGE frame with offsets, at the positions of the
+// sorted partition. They're negated for descending order, which makes them ascending
+// between the first and the last non-null value either way.
+template <class T>
+struct RangeFrameKeys {
+  std::vector<T> values;
+  size_t non_null_start;
+  size_t non_null_end;
+};
+
+// The frame of each row of a sorted partition, as the range [start, end) of positions in
+// the sorted partition. Each bound is monotonic in the position of the row, even across
+// the null values of the order key, so the frames only ever slide forward.
+struct FrameRanges {
+  std::vector<size_t> start;
+  std::vector<size_t> end;
+};
+
+// Computes the frame ranges given the peers of each row, for the RANGE frames, and the
+// values of the order key, for the RANGE frames with offsets. The null values of the
+// order key are only peers of each other, they make up the frame of the rows with offset
+// bounds which have them.
+template <class T>
+FrameRanges compute_frame_ranges(const Analyzer::WindowFrame& frame,
+                                 const size_t partition_size,
+                                 const std::vector<size_t>& peer_start,
+                                 const std::vector<size_t>& peer_end,
+                                 const RangeFrameKeys<T>& keys,
+                                 const T lower_offset,
+                                 const T upper_offset) {
+  const auto bound_position = [&](const Analyzer::WindowFrameBound& bound,
+                                  const T range_offset,
+                                  const bool is_upper,
+                                  const size_t i) -> size_t {
+    using BoundType = Analyzer::WindowFrameBound::Type;
+    switch (bound.type) {
+      case BoundType::UnboundedPreceding: {
+        return 0;
+      }
+      case BoundType::UnboundedFollowing: {
+        return partition_size;
+      }
+      default: { break; }
+    }
+    if (frame.is_rows) {
+      const auto rows_offset = std::min(bound.offset, int64_t(partition_size));
+      auto position = static_cast<int64_t>(i) + is_upper;
+      if (bound.type == BoundType::Preceding) {
+        position -= rows_offset;
+      } else if (bound.type == BoundType::Following) {
+        position += rows_offset;
+      }
+      return std::min(std::max(position, int64_t(0)), int64_t(partition_size));
+    }
+    if (bound.type == BoundType::CurrentRow || i < keys.non_null_start ||
+        i >= keys.non_null_end) {
+      return is_upper ? peer_end[i] : peer_start[i];
+    }
+    const auto key = keys.values[i];
+    const auto target = bound.type == BoundType::Preceding
+                            ? subtract_saturated(key, range_offset)
+                            : add_saturated(key, range_offset);
+    const auto non_null_begin = keys.values.begin() + keys.non_null_start;
+    const auto non_null_end = keys.values.begin() + keys.non_null_end;
+    const auto it = is_upper ? std::upper_bound(non_null_begin, non_null_end, target)
+                             : std::lower_bound(non_null_begin, non_null_end, target);
+    return it - keys.values.begin();
+  };
+  FrameRanges frame_ranges;
+  frame_ranges.start.resize(partition_size);
+  frame_ranges.end.resize(partition_size);
+  for (size_t i = 0; i < partition_size; ++i) {
+    frame_ranges.start[i] = bound_position(frame.lower_bound, lower_offset, false, i);
+    frame_ranges.end[i] = bound_position(frame.upper_bound, upper_offset, true, i);
+  }
+  return frame_ranges;
+}
+
+// Reads the values of the order key of a RANGE frame at the positions of the sorted
+// partition, as integers or floating point values.
+template <class T, class IS_NULL, class VALUE>
+RangeFrameKeys<T> make_range_frame_keys(const size_t partition_size,
+                                        const IS_NULL& is_null,
+                                        const VALUE& value,
+                                        const bool is_desc) {
+  RangeFrameKeys<T> keys;
+  keys.values.resize(partition_size);
+  keys.non_null_start = partition_size;
+  keys.non_null_end = 0;
+  for (size_t i = 0; i < partition_size; ++i) {
+    if (is_null(i)) {
+      continue;
+    }
+    // The null sentinel is the lowest value, the negation of the others can't overflow.
+    keys.values[i] = is_desc ? -value(i) : value(i);
+    keys.non_null_start = std::min(keys.non_null_start, i);
+    keys.non_null_end = i + 1;
+  }
+  if (keys.non_null_start > keys.non_null_end) {
+    keys.non_null_start = keys.non_null_end = 0;
+  }
+  return keys;
+}
+
+// Keeps the count of the non-null values in a frame which slides forward along the
+// sorted partition and, for integers, their sum, adding the rows which enter the frame
+// and removing the ones which leave it. All the rows count for COUNT(*).
+class SlidingFrameAggregate {
+ public:
+  SlidingFrameAggregate(const std::vector<int64_t>& values,
+                        const std::vector<int8_t>& is_null)
+      : values_(values), is_null_(is_null), start_(0), end_(0), count_(0), sum_(0) {}
+
+  void slide(const size_t start, const size_t end) {
+    CHECK_LE(start_, start);
+    for (; start_ < start; ++start_) {
+      if (start_ < end_ && !is_null_[start_]) {
+        --count_;
+        sum_ -= values_[start_];
+      }
+    }
+    // Empty frames leave the state empty, the end catches up with the start.
+    end_ = std::max(end_, start_);
+    for (; end_ < end; ++end_) {
+      if (!is_null_[end_]) {
+        ++count_;
+        sum_ += values_[end_];
+      }
+    }
+  }
+
+  int64_t count() const { return count_; }
+
+  int64_t sum() const { return sum_; }
+
+ private:
+  const std::vector<int64_t>& values_;
+  const std::vector<int8_t>& is_null_;
+  size_t start_;
+  size_t end_;
+  int64_t count_;
+  int64_t sum_;
+};
+
+// Aggregates any range of a sequence of values in logarithmic time. Used for the
+// minimum and the maximum, which can't remove the values which leave the frame, and for
+// the floating point sums, which would lose precision doing so.
+template <class T, class AGG>
+class SegmentTree {
+ public:
+  SegmentTree(const std::vector<T>& leaves, const T identity, const AGG& agg)
+      : leaf_count_(leaves.size()), identity_(identity), agg_(agg) {
+    nodes_.resize(2 * leaf_count_, identity_);
+    std::copy(leaves.begin(), leaves.end(), nodes_.begin() + leaf_count_);
+    for (size_t i = leaf_count_; i > 1; --i) {
+      nodes_[i - 1] = agg_(nodes_[2 * i - 2], nodes_[2 * i - 1]);
+    }
+  }
+
+  // Aggregates the leaves in [start, end).
+  T query(size_t start, size_t end) const {
+    T lhs = identity_;
+    T rhs = identity_;
+    for (start += leaf_count_, end += leaf_count_; start < end; start /= 2, end /= 2) {
+      if (start & 1) {
+        lhs = agg_(lhs, nodes_[start++]);
+      }
+      if (end & 1) {
+        rhs = agg_(nodes_[--end], rhs);
+      }
+    }
+    return agg_(lhs, rhs);
+  }
+
+ private:
+  const size_t leaf_count_;
+  const T identity_;
+  const AGG agg_;
+  std::vector<T> nodes_;
+};
+
+template <class T, class AGG>
+SegmentTree<T, AGG> make_segment_tree(const std::vector<T>& leaves,
+                                      const T identity,
+                                      const AGG& agg) {
+  return SegmentTree<T, AGG>(leaves, identity, agg);
+}
+
+// Replaces the null values with the identity of the aggregate, for the segment trees.
+template <class T>
+std::vector<T> null_to_identity(std::vector<T> values,
+                                const std::vector<int8_t>& is_null,
+                                const T identity) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (is_null[i]) {
+      values[i] = identity;
+    }
+  }
+  return values;
+}
+
+}  // namespace
+
+void WindowFunctionContext::computeFramedAggregatePartition(
+    int64_t* output_for_partition_buff,
+    const int64_t* sorted_partition,
+    const size_t partition_size,
+    const size_t off,
+    const std::vector<OrderColumn>& order_columns,
+    const Comparator& comparator) const {
+  const auto& frame = *window_func_->getFrame();
+  const auto partition_rows = payload() + off;
+  const auto sorted_row = [partition_rows, sorted_partition](const size_t i) {
+    return partition_rows[sorted_partition[i]];
+  };
+  std::vector<size_t> peer_start(partition_size);
+  std::vector<size_t> peer_end(partition_size);
+  if (!frame.is_rows) {
+    for (size_t i = 0; i < partition_size; ++i) {
+      peer_start[i] = advance_current_rank(comparator, sorted_partition, i) || !i
+                          ? i
+                          : peer_start[i - 1];
+    }
+    for (size_t i = partition_size; i > 0; --i) {
+      peer_end[i - 1] =
+          i == partition_size || advance_current_rank(comparator, sorted_partition, i)
+              ? i
+              : peer_end[i];
+    }
+  }
+  const auto has_range_offset = [&frame](const Analyzer::WindowFrameBound& bound) {
+    return !frame.is_rows && (bound.type == Analyzer::WindowFrameBound::Type::Preceding ||
+                              bound.type == Analyzer::WindowFrameBound::Type::Following);
+  };
+  FrameRanges frame_ranges;
+  if (has_range_offset(frame.lower_bound) || has_range_offset(frame.upper_bound)) {
+    CHECK_EQ(order_columns.size(), size_t(1));
+    const auto& order_column = order_columns.front();
+    if (order_column.type == kFLOAT || order_column.type == kDOUBLE) {
+      const auto value = [&order_column, &sorted_row](const size_t i) {
+        return read_fp_value(order_column.buffer, order_column.type, sorted_row(i));
+      };
+      const auto keys = make_range_frame_keys<double>(
+          partition_size,
+          [&order_column, &value](const size_t i) {
+            return value(i) == order_column.fp_null_val;
+          },
+          value,
+          order_column.is_desc);
+      frame_ranges = compute_frame_ranges(frame,
+                                          partition_size,
+                                          peer_start,
+                                          peer_end,
+                                          keys,
+                                          frame.lower_bound.fp_offset,
+                                          frame.upper_bound.fp_offset);
+    } else {
+      const auto width = SQLTypeInfo(order_column.type, false).get_size();
+      const auto value = [&order_column, &sorted_row, width](const size_t i) {
+        return read_int_value(order_column.buffer, width, sorted_row(i));
+      };
+      const auto keys = make_range_frame_keys<int64_t>(
+          partition_size,
+          [&order_column, &value](const size_t i) {
+            return value(i) == order_column.int_null_val;
+          },
+          value,
+          order_column.is_desc);
+      frame_ranges = compute_frame_ranges(frame,
+                                          partition_size,
+                                          peer_start,
+                                          peer_end,
+                                          keys,
+                                          frame.lower_bound.offset,
+                                          frame.upper_bound.offset);
+    }
+  } else {
+    RangeFrameKeys<int64_t> keys{{}, 0, partition_size};
+    frame_ranges = compute_frame_ranges(
+        frame, partition_size, peer_start, peer_end, keys, int64_t(0), int64_t(0));
+  }
+  // The values of the argument at the positions of the sorted partition.
+  const auto& args = window_func_->getArgs();
+  std::vector<int64_t> int_values(partition_size);
+  std::vector<double> fp_values;
+  std::vector<int8_t> is_null(partition_size);
+  const auto arg_ti =
+      args.empty() ? SQLTypeInfo(kBIGINT, true) : args.front()->get_type_info();
+  if (aggregate_column_) {
+    if (arg_ti.is_fp()) {
+      fp_values.resize(partition_size);
+      const auto null_val = inline_fp_null_val(arg_ti);
+      for (size_t i = 0; i < partition_size; ++i) {
+        fp_values[i] = read_fp_value(aggregate_column_, arg_ti.get_type(), sorted_row(i));
+        is_null[i] = fp_values[i] == null_val;
+      }
+    } else {
+      const auto null_val = inline_fixed_encoding_null_val(arg_ti);
+      // The dates stored in days are aggregated as epoch seconds, like everywhere else.
+      const bool is_date_in_days = arg_ti.get_compression() == kENCODING_DATE_IN_DAYS;
+      for (size_t i = 0; i < partition_size; ++i) {
+        int_values[i] =
+            read_int_value(aggregate_column_, arg_ti.get_size(), sorted_row(i));
+        is_null[i] = int_values[i] == null_val;
+        if (is_date_in_days && !is_null[i]) {
+          int_values[i] = DateConverters::get_epoch_seconds_from_days(int_values[i]);
+        }
+      }
+    }
+  } else {
+    CHECK(window_func_->getKind() == SqlWindowFunctionKind::COUNT);
+  }
+  const auto& window_func_ti = window_func_->get_type_info();
+  auto output_fp = reinterpret_cast<double*>(may_alias_ptr(output_for_partition_buff));
+  const auto write_output = [&](const size_t i,
+                                const bool is_null_output,
+                                const int64_t int_val,
+                                const double fp_val) {
+    const auto pos = sorted_partition[i];
+    if (window_func_ti.is_fp()) {
+      output_fp[pos] = is_null_output ? inline_fp_null_val(window_func_ti) : fp_val;
+    } else {
+      output_for_partition_buff[pos] =
+          is_null_output ? inline_int_null_val(window_func_ti) : int_val;
+    }
+  };
+  SlidingFrameAggregate sliding_aggregate(int_values, is_null);
+  const auto kind = window_func_->getKind();
+  switch (kind) {
+    case SqlWindowFunctionKind::COUNT:
+    case SqlWindowFunctionKind::SUM:
+    case SqlWindowFunctionKind::SUM_INTERNAL:
+    case SqlWindowFunctionKind::AVG: {
+      // Only the floating point sums need the segment tree.
+      const auto fp_sum = make_segment_tree(
+          null_to_identity(fp_values, is_null, 0.0), 0.0, std::plus<double>());
+      const double scale = exp_to_scale(arg_ti.is_decimal() ? arg_ti.get_scale() : 0);
+      for (size_t i = 0; i < partition_size; ++i) {
+        const auto start = frame_ranges.start[i];
+        const auto end = frame_ranges.end[i];
+        sliding_aggregate.slide(start, end);
+        const auto count = sliding_aggregate.count();
+        if (kind == SqlWindowFunctionKind::COUNT) {
+          write_output(i, false, count, 0);
+          continue;
+        }
+        const bool is_empty = count == 0;
+        const auto sum = arg_ti.is_fp() && !is_empty ? fp_sum.query(start, end) : 0.0;
+        if (kind == SqlWindowFunctionKind::AVG) {
+          write_output(i,
+                       is_empty,
+                       0,
+                       arg_ti.is_fp() ? sum / count
+                                      : sliding_aggregate.sum() / scale / count);
+          continue;
+        }
+        write_output(i,
+                     is_empty && kind == SqlWindowFunctionKind::SUM,
+                     sliding_aggregate.sum(),
+                     sum);
+      }
+      break;
+    }
+    case SqlWindowFunctionKind::MIN:
+    case SqlWindowFunctionKind::MAX: {
+      const bool is_min = kind == SqlWindowFunctionKind::MIN;
+      const auto int_identity = is_min ? std::numeric_limits<int64_t>::max()
+                                       : std::numeric_limits<int64_t>::lowest();
+      const auto fp_identity = is_min ? std::numeric_limits<double>::max()
+                                      : std::numeric_limits<double>::lowest();
+      const auto int_extremum = [is_min](const int64_t lhs, const int64_t rhs) {
+        return is_min ? std::min(lhs, rhs) : std::max(lhs, rhs);
+      };
+      const auto fp_extremum = [is_min](const double lhs, const double rhs) {
+        return is_min ? std::min(lhs, rhs) : std::max(lhs, rhs);
+      };
+      const auto int_tree = make_segment_tree(
+          null_to_identity(arg_ti.is_fp() ? std::vector<int64_t>{} : int_values,
+                           is_null,
+                           int_identity),
+          int_identity,
+          int_extremum);
+      const auto fp_tree = make_segment_tree(
+          null_to_identity(fp_values, is_null, fp_identity), fp_identity, fp_extremum);
+      for (size_t i = 0; i < partition_size; ++i) {
+        const auto start = frame_ranges.start[i];
+        const auto end = frame_ranges.end[i];
+        sliding_aggregate.slide(start, end);
+        const bool is_empty = sliding_aggregate.count() == 0;
+        write_output(i,
+                     is_empty,
+                     is_empty || arg_ti.is_fp() ? 0 : int_tree.query(start, end),
+                     is_empty || !arg_ti.is_fp() ? 0 : fp_tree.query(start, end));
+      }
+      break;
+    }
+    default: {
+      throw std::runtime_error("Window frame not supported for " +
+                               sql_window_function_to_str(kind));
+    }
+  }
+}
+
 void WindowFunctionContext::fillPartitionStart() {
   CountDistinctDescriptor partition_start_bitmap{CountDistinctImplType::Bitmap,
                                                  0,
@@ -705,5 +1229,7 @@ void WindowProjectNodeContext::reset() {
   s_active_window_function_ = nullptr;
 }
 
-std::unique_ptr<WindowProjectNodeContext> WindowProjectNodeContext::s_instance_;
-WindowFunctionContext* WindowProjectNodeContext::s_active_window_function_{nullptr};
+thread_local std::unique_ptr<WindowProjectNodeContext>
+    WindowProjectNodeContext::s_instance_;
+thread_local WindowFunctionContext* WindowProjectNodeContext::s_active_window_function_{
+    nullptr};
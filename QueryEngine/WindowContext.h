@@ -21,10 +21,10 @@
 
 // Per-window function context which encapsulates the logic for computing the various
 // window function kinds and keeps ownership of buffers which contain the results. For
-// rank functions, the code generated for the projection simply reads the values and
-// writes them to the result set. For value and aggregate functions, only the iteration
-// order is written to the buffer, the rest is handled by generating code in a similar way
-// we do for non-window queries.
+// rank functions and aggregates over a ROWS or RANGE frame, the code generated for the
+// projection simply reads the values and writes them to the result set. For value and
+// the other aggregate functions, only the iteration order is written to the buffer, the
+// rest is handled by generating code in a similar way we do for non-window queries.
 class WindowFunctionContext {
  public:
   WindowFunctionContext(const Analyzer::WindowFunction* window_func,
@@ -43,9 +43,23 @@ class WindowFunctionContext {
                       const Analyzer::ColumnVar* col_var,
                       const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
 
+  // Adds the argument column buffer of an aggregate over a frame to the context and keeps
+  // ownership of it.
+  void setAggregateColumn(
+      const int8_t* column,
+      const std::vector<std::shared_ptr<Chunk_NS::Chunk>>& chunks_owner);
+
   // Computes the window function result to be used during the actual projection query.
   void compute();
 
+  // Reuses the sorted partitions of a window function with the same partitions and the
+  // same ORDER BY instead of sorting them again in compute().
+  void setSortedPartitions(
+      const std::shared_ptr<std::vector<int64_t>>& sorted_partitions);
+
+  // The positions of the rows of each partition in the ORDER BY order, set by compute().
+  const std::shared_ptr<std::vector<int64_t>>& getSortedPartitions() const;
+
   // Returns a pointer to the window function associated with this context.
   const Analyzer::WindowFunction* getWindowFunction() const;
 
@@ -73,8 +87,6 @@ class WindowFunctionContext {
   // Gets the row number expression for this window function.
   llvm::Value* getRowNumber() const;
 
-  using Comparator = std::function<bool(const int64_t lhs, const int64_t rhs)>;
-
  private:
   // State for a window aggregate. The count field is only used for average.
   struct AggregateState {
@@ -83,17 +95,49 @@ class WindowFunctionContext {
     llvm::Value* row_number = nullptr;
   };
 
-  static Comparator makeComparator(const Analyzer::ColumnVar* col_var,
-                                   const int8_t* partition_values,
-                                   const int32_t* partition_indices,
-                                   const bool nulls_first);
+  // An order column buffer along with its type, null value and collation.
+  struct OrderColumn {
+    const int8_t* buffer;
+    SQLTypes type;
+    int64_t int_null_val;
+    double fp_null_val;
+    bool is_desc;
+    bool nulls_first;
+  };
+
+  // Compares the positions of two rows in a partition by the order columns. The values
+  // are compared as the type of each column rather than through a chain of type erased
+  // comparators.
+  class Comparator {
+   public:
+    Comparator(const std::vector<OrderColumn>& order_columns,
+               const int32_t* partition_indices)
+        : order_columns_(order_columns), partition_indices_(partition_indices) {}
 
-  void computePartition(
-      int64_t* output_for_partition_buff,
-      const size_t partition_size,
-      const size_t off,
-      const Analyzer::WindowFunction* window_func,
-      const std::function<bool(const int64_t lhs, const int64_t rhs)>& comparator);
+    bool operator()(const int64_t lhs, const int64_t rhs) const;
+
+   private:
+    const std::vector<OrderColumn>& order_columns_;
+    const int32_t* partition_indices_;
+  };
+
+  std::vector<OrderColumn> makeOrderColumns() const;
+
+  void computePartition(int64_t* output_for_partition_buff,
+                        const size_t partition_size,
+                        const size_t off,
+                        const Analyzer::WindowFunction* window_func,
+                        const Comparator& comparator);
+
+  // Computes an aggregate over a ROWS or RANGE frame for the rows of a partition, given
+  // their positions in the ORDER BY order. Writes the value of each row at its position
+  // in the partition, as a double for floating point results.
+  void computeFramedAggregatePartition(int64_t* output_for_partition_buff,
+                                       const int64_t* sorted_partition,
+                                       const size_t partition_size,
+                                       const size_t off,
+                                       const std::vector<OrderColumn>& order_columns,
+                                       const Comparator& comparator) const;
 
   void fillPartitionStart();
 
@@ -110,6 +154,10 @@ class WindowFunctionContext {
   std::vector<std::vector<std::shared_ptr<Chunk_NS::Chunk>>> order_columns_owner_;
   // Order column buffers.
   std::vector<const int8_t*> order_columns_;
+  // Keeps ownership of the argument column of an aggregate over a frame.
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> aggregate_column_owner_;
+  // The argument column buffer of an aggregate over a frame, null for COUNT(*).
+  const int8_t* aggregate_column_;
   // Hash table which contains the partitions specified by the window.
   std::shared_ptr<JoinHashTableInterface> partitions_;
   // The number of elements in the table.
@@ -123,6 +171,9 @@ class WindowFunctionContext {
   AggregateState aggregate_state_;
   // The multiplicities for peers, to be used by aggregate functions.
   std::vector<unsigned> multiplicities_;
+  // The positions of the rows of each partition in the ORDER BY order, at the offset of
+  // the partition. Shared by the window functions with the same partitions and order.
+  std::shared_ptr<std::vector<int64_t>> sorted_partitions_;
   const ExecutorDeviceType device_type_;
 };
 
@@ -161,10 +212,10 @@ class WindowProjectNodeContext {
   // target index.
   std::unordered_map<size_t, std::unique_ptr<WindowFunctionContext>> window_contexts_;
   // Singleton instance used for an execution unit which is a project with window
-  // functions.
-  static std::unique_ptr<WindowProjectNodeContext> s_instance_;
+  // functions. Thread local since queries on different executors run concurrently.
+  static thread_local std::unique_ptr<WindowProjectNodeContext> s_instance_;
   // The active window function. Method comments in this class describe how it's used.
-  static WindowFunctionContext* s_active_window_function_;
+  static thread_local WindowFunctionContext* s_active_window_function_;
 };
 
 bool window_function_is_aggregate(const SqlWindowFunctionKind kind);
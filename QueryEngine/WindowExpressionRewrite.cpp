@@ -55,6 +55,17 @@ const Analyzer::WindowFunction* extract_sum_window(
   return sum_window_expr;
 }
 
+// Returns true iff the window functions have the same frame or both have the default one.
+bool window_frames_match(const Analyzer::WindowFunction* lhs,
+                         const Analyzer::WindowFunction* rhs) {
+  const auto& lhs_frame = lhs->getFrame();
+  const auto& rhs_frame = rhs->getFrame();
+  if (!lhs_frame || !rhs_frame) {
+    return !lhs_frame && !rhs_frame;
+  }
+  return *lhs_frame == *rhs_frame;
+}
+
 // Returns true iff the sum and the count match in type and arguments. Used to replace
 // combination can be replaced with an explicit average.
 bool window_sum_and_count_match(const Analyzer::UOper* cast_sum_window_expr,
@@ -72,7 +83,8 @@ bool window_sum_and_count_match(const Analyzer::UOper* cast_sum_window_expr,
     return false;
   }
   CHECK_EQ(count_window_expr->get_type_info().get_type(), kBIGINT);
-  return expr_list_match(sum_window_expr->getArgs(), count_window_expr->getArgs());
+  return window_frames_match(sum_window_expr, count_window_expr) &&
+         expr_list_match(sum_window_expr->getArgs(), count_window_expr->getArgs());
 }
 
 }  // namespace
@@ -113,7 +125,8 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_sum_window(const Analyzer::Exp
                                             sum_window_expr->getArgs(),
                                             sum_window_expr->getPartitionKeys(),
                                             sum_window_expr->getOrderKeys(),
-                                            sum_window_expr->getCollation());
+                                            sum_window_expr->getCollation(),
+                                            sum_window_expr->getFrame());
 }
 
 std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Expr* expr) {
@@ -143,7 +156,8 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Exp
                                sum_window_expr->get_type_info().get_type()) {
     return nullptr;
   }
-  if (!expr_list_match(sum_window_expr.get()->getArgs(), count_window->getArgs())) {
+  if (!window_frames_match(sum_window_expr.get(), count_window) ||
+      !expr_list_match(sum_window_expr.get()->getArgs(), count_window->getArgs())) {
     return nullptr;
   }
   return makeExpr<Analyzer::WindowFunction>(SQLTypeInfo(kDOUBLE),
@@ -151,5 +165,6 @@ std::shared_ptr<Analyzer::WindowFunction> rewrite_avg_window(const Analyzer::Exp
                                             sum_window_expr->getArgs(),
                                             sum_window_expr->getPartitionKeys(),
                                             sum_window_expr->getOrderKeys(),
-                                            sum_window_expr->getCollation());
+                                            sum_window_expr->getCollation(),
+                                            sum_window_expr->getFrame());
 }
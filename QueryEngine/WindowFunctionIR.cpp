@@ -55,6 +55,9 @@ llvm::Value* Executor::codegenWindowFunction(const Analyzer::WindowFunction* win
     case SqlWindowFunctionKind::MAX:
     case SqlWindowFunctionKind::SUM:
     case SqlWindowFunctionKind::COUNT: {
+      if (window_func->getFrame()) {
+        return codegenWindowFramedAggregate(window_func, window_func_context);
+      }
       return codegenWindowFunctionAggregate(window_func, window_func_context, co);
     }
     default: { LOG(FATAL) << "Invalid window function kind"; }
@@ -103,6 +106,23 @@ std::string get_window_agg_name(const SqlWindowFunctionKind kind,
 
 }  // namespace
 
+llvm::Value* Executor::codegenWindowFramedAggregate(
+    const Analyzer::WindowFunction* window_func,
+    const WindowFunctionContext* window_func_context) {
+  const auto& window_func_ti = window_func->get_type_info();
+  const auto output_lv =
+      ll_int(reinterpret_cast<const int64_t>(window_func_context->output()));
+  if (!window_func_ti.is_fp()) {
+    return cgen_state_->emitCall("row_number_window_func", {output_lv, posArg(nullptr)});
+  }
+  const auto double_lv =
+      cgen_state_->emitCall("percent_window_func", {output_lv, posArg(nullptr)});
+  return window_func_ti.get_type() == kFLOAT
+             ? cgen_state_->ir_builder_.CreateFPTrunc(
+                   double_lv, llvm::Type::getFloatTy(cgen_state_->context_))
+             : double_lv;
+}
+
 llvm::Value* Executor::codegenWindowFunctionAggregate(
     const Analyzer::WindowFunction* window_func,
     const WindowFunctionContext* window_func_context,
@@ -241,7 +241,7 @@ ExecutionResult run_select_query(
   }
 
   const auto& cat = session->getCatalog();
-  auto executor = Executor::getExecutor(cat.getCurrentDB().dbId);
+  auto executor = Executor::acquireExecutor(cat.getCurrentDB().dbId);
   CompilationOptions co = {
       device_type, true, ExecutorOptLevel::LoopStrengthReduction, false};
   ExecutionOptions eo = {g_enable_columnar_output,
@@ -273,7 +273,7 @@ ExecutionResult run_select_query_with_filter_push_down(
     const bool just_explain,
     const bool with_filter_push_down) {
   const auto& cat = session->getCatalog();
-  auto executor = Executor::getExecutor(cat.getCurrentDB().dbId);
+  auto executor = Executor::acquireExecutor(cat.getCurrentDB().dbId);
   CompilationOptions co = {
       device_type, true, ExecutorOptLevel::LoopStrengthReduction, false};
   ExecutionOptions eo = {g_enable_columnar_output,
@@ -228,6 +228,18 @@ size_t get_row_count(const TQueryResult& query_result) {
   return query_result.row_set.columns.front().nulls.size();
 }
 
+void print_timing_info(const TQueryResult& query_result) {
+  std::cout << "Execution time: " << query_result.execution_time_ms << " ms,"
+            << " Total time: " << query_result.total_time_ms << " ms" << std::endl;
+  std::cout << "Kernel fetch time: " << query_result.kernel_fetch_time_ms << " ms,"
+            << " Kernel compute time: " << query_result.kernel_compute_time_ms << " ms,"
+            << " Prefetch time: " << query_result.prefetch_time_ms << " ms" << std::endl;
+  if (query_result.compile_time_saved_ms > 0) {
+    std::cout << "Compilation time saved by the persistent code cache: "
+              << query_result.compile_time_saved_ms << " ms" << std::endl;
+  }
+}
+
 void get_table_epoch(ClientContext& context, const std::string& table_specifier) {
   if (table_specifier.size() == 0) {
     std::cerr
@@ -809,6 +821,30 @@ void print_memory_info(ClientContext& context, std::string memory_level) {
 
       tss << std::endl;
     }
+    tss << "Eviction policy: " << nodeIt.eviction_policy << std::endl;
+    tss << "DB_ID TABLE_ID        HITS      MISSES   EVICTIONS" << std::endl;
+    for (const auto& table_stats : nodeIt.table_stats) {
+      tss << std::setfill(' ') << std::setw(5) << table_stats.db_id;
+      tss << std::setfill(' ') << std::setw(9) << table_stats.table_id;
+      tss << std::setfill(' ') << std::setw(12) << table_stats.hits;
+      tss << std::setfill(' ') << std::setw(12) << table_stats.misses;
+      tss << std::setfill(' ') << std::setw(12) << table_stats.evictions;
+      tss << std::endl;
+    }
+    if (!nodeIt.string_dict_cache_stats.empty()) {
+      tss << "Dictionary LIKE/REGEXP caches:" << std::endl;
+      tss << "DB_ID  DICT_ID        HITS      MISSES     ENTRIES       BYTES"
+          << std::endl;
+      for (const auto& cache_stats : nodeIt.string_dict_cache_stats) {
+        tss << std::setfill(' ') << std::setw(5) << cache_stats.db_id;
+        tss << std::setfill(' ') << std::setw(9) << cache_stats.dict_id;
+        tss << std::setfill(' ') << std::setw(12) << cache_stats.hits;
+        tss << std::setfill(' ') << std::setw(12) << cache_stats.misses;
+        tss << std::setfill(' ') << std::setw(12) << cache_stats.num_entries;
+        tss << std::setfill(' ') << std::setw(12) << cache_stats.num_bytes;
+        tss << std::endl;
+      }
+    }
     tss << "---------------------------------------------------------------" << std::endl;
   }
   std::cout << tss.str() << std::endl;
@@ -1216,10 +1252,7 @@ int main(int argc, char** argv) {
               std::cout << "No rows returned." << std::endl;
             }
             if (print_timing) {
-              std::cout << "Execution time: " << context.query_return.execution_time_ms
-                        << " ms,"
-                        << " Total time: " << context.query_return.total_time_ms << " ms"
-                        << std::endl;
+              print_timing_info(context.query_return);
             }
             continue;
           }
@@ -1254,10 +1287,7 @@ int main(int argc, char** argv) {
           }
           if (print_timing) {
             std::cout << row_count << " rows returned." << std::endl;
-            std::cout << "Execution time: " << context.query_return.execution_time_ms
-                      << " ms,"
-                      << " Total time: " << context.query_return.total_time_ms << " ms"
-                      << std::endl;
+            print_timing_info(context.query_return);
           }
         } else {
           (void)backchannel(TURN_OFF, nullptr);
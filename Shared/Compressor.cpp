@@ -23,14 +23,20 @@
  **/
 
 #include "Compressor.h"
-#include <blosc.h>
 #include <glog/logging.h>
+#include <cstring>
 #include <string>
 #include <thread>
 
+#ifdef HAVE_BLOSC
+#include <blosc.h>
+#endif
+
 // we only compress data if the payload size is greater than 512 MB
 size_t g_compression_limit_bytes{512 * 1024 * 1024};
 
+#ifdef HAVE_BLOSC
+
 BloscCompressor::BloscCompressor() {
   std::lock_guard<std::mutex> compressor_lock_(compressor_lock);
   blosc_init();
@@ -195,17 +201,59 @@ void BloscCompressor::getBloscBufferSizes(const uint8_t* data_ptr,
   blosc_cbuffer_sizes(data_ptr, num_bytes_uncompressed, num_bytes_compressed, block_size);
 }
 
-BloscCompressor* BloscCompressor::instance = NULL;
-
-BloscCompressor* BloscCompressor::getCompressor() {
-  static std::mutex compressor_singleton_lock;
-  std::lock_guard<std::mutex> singleton_lock(compressor_singleton_lock);
+int64_t BloscCompressor::compressWithContext(const uint8_t* buffer,
+                                             const size_t buffer_size,
+                                             uint8_t* compressed_buffer,
+                                             const size_t compressed_buffer_size,
+                                             const int compressor,
+                                             const size_t typesize) {
+  const char* compressor_name{nullptr};
+  if (blosc_compcode_to_compname(compressor, &compressor_name) < 0) {
+    throw CompressionFailedError("unsupported compressor code " +
+                                 std::to_string(compressor));
+  }
+  // The callers compress in parallel already, a single internal thread each.
+  const auto compressed_len = blosc_compress_ctx(5,
+                                                 1,
+                                                 typesize,
+                                                 buffer_size,
+                                                 buffer,
+                                                 compressed_buffer,
+                                                 compressed_buffer_size,
+                                                 compressor_name,
+                                                 0,
+                                                 1);
+  if (compressed_len <= 0) {
+    throw CompressionFailedError(std::string("failed to compress buffer of length ") +
+                                 std::to_string(buffer_size));
+  }
+  return compressed_len;
+}
 
-  if (instance == NULL) {
-    instance = new BloscCompressor();
+size_t BloscCompressor::decompressWithContext(const uint8_t* compressed_buffer,
+                                              uint8_t* decompressed_buffer,
+                                              const size_t decompressed_size) {
+  const auto decompressed_len =
+      blosc_decompress_ctx(compressed_buffer, decompressed_buffer, decompressed_size, 1);
+  if (decompressed_len <= 0 ||
+      static_cast<size_t>(decompressed_len) != decompressed_size) {
+    throw CompressionFailedError(std::string("failed to decompress buffer of length ") +
+                                 std::to_string(decompressed_size));
   }
+  return decompressed_len;
+}
 
-  return instance;
+size_t BloscCompressor::getMaxCompressedSize(const size_t len) {
+  return len + BLOSC_MAX_OVERHEAD;
+}
+
+int BloscCompressor::getCompressorCode(const std::string& compressor_name) {
+  const auto compressor = blosc_compname_to_compcode(compressor_name.c_str());
+  const char* supported_name{nullptr};
+  if (compressor < 0 || blosc_compcode_to_compname(compressor, &supported_name) < 0) {
+    return -1;
+  }
+  return compressor;
 }
 
 int BloscCompressor::setThreads(size_t num_threads) {
@@ -220,3 +268,113 @@ int BloscCompressor::setCompressor(std::string& compressor_name) {
   // current compressor.
   return blosc_set_compressor(compressor_name.c_str());
 }
+
+#else
+
+// Built without blosc: nothing is compressed, compressed buffers can't be read.
+
+namespace {
+
+const std::string no_blosc_error{"blosc compression is not supported by this build"};
+
+}  // namespace
+
+BloscCompressor::BloscCompressor() {}
+
+BloscCompressor::~BloscCompressor() {}
+
+int64_t BloscCompressor::compress(const uint8_t* buffer,
+                                  const size_t buffer_size,
+                                  uint8_t* compressed_buffer,
+                                  const size_t compressed_buffer_size,
+                                  const size_t min_compressor_bytes) {
+  return 0;
+}
+
+std::string BloscCompressor::compress(const std::string& buffer) {
+  return buffer;
+}
+
+size_t BloscCompressor::decompress(const uint8_t* compressed_buffer,
+                                   uint8_t* decompressed_buffer,
+                                   const size_t decompressed_size) {
+  throw CompressionFailedError(no_blosc_error);
+}
+
+std::string BloscCompressor::decompress(const std::string& buffer,
+                                        const size_t decompressed_size) {
+  return buffer;
+}
+
+size_t BloscCompressor::compressOrMemcpy(const uint8_t* input_buffer,
+                                         uint8_t* output_buffer,
+                                         size_t uncompressed_size,
+                                         const size_t min_compressor_bytes) {
+  memcpy(output_buffer, input_buffer, uncompressed_size);
+  return uncompressed_size;
+}
+
+bool BloscCompressor::decompressOrMemcpy(const uint8_t* compressed_buffer,
+                                         const size_t compressed_size,
+                                         uint8_t* decompressed_buffer,
+                                         const size_t decompressed_size) {
+  if (compressed_size > decompressed_size) {
+    throw std::runtime_error(
+        "compressed buffer size is greater than decompressed buffer size.");
+  }
+  memcpy(decompressed_buffer, compressed_buffer, decompressed_size);
+  return false;
+}
+
+void BloscCompressor::getBloscBufferSizes(const uint8_t* data_ptr,
+                                          size_t* num_bytes_compressed,
+                                          size_t* num_bytes_uncompressed,
+                                          size_t* block_size) {
+  *num_bytes_compressed = *num_bytes_uncompressed = *block_size = 0;
+}
+
+int64_t BloscCompressor::compressWithContext(const uint8_t* buffer,
+                                             const size_t buffer_size,
+                                             uint8_t* compressed_buffer,
+                                             const size_t compressed_buffer_size,
+                                             const int compressor,
+                                             const size_t typesize) {
+  throw CompressionFailedError(no_blosc_error);
+}
+
+size_t BloscCompressor::decompressWithContext(const uint8_t* compressed_buffer,
+                                              uint8_t* decompressed_buffer,
+                                              const size_t decompressed_size) {
+  throw CompressionFailedError(no_blosc_error);
+}
+
+size_t BloscCompressor::getMaxCompressedSize(const size_t len) {
+  return len;
+}
+
+int BloscCompressor::getCompressorCode(const std::string& compressor_name) {
+  return -1;
+}
+
+int BloscCompressor::setThreads(size_t num_threads) {
+  return -1;
+}
+
+int BloscCompressor::setCompressor(std::string& compressor_name) {
+  return -1;
+}
+
+#endif  // HAVE_BLOSC
+
+BloscCompressor* BloscCompressor::instance = NULL;
+
+BloscCompressor* BloscCompressor::getCompressor() {
+  static std::mutex compressor_singleton_lock;
+  std::lock_guard<std::mutex> singleton_lock(compressor_singleton_lock);
+
+  if (instance == NULL) {
+    instance = new BloscCompressor();
+  }
+
+  return instance;
+}
@@ -79,6 +79,26 @@ class BloscCompressor {
 
   int setCompressor(std::string& compressor);
 
+  // Thread safe variants on blosc contexts, they neither take compressor_lock nor use
+  // the global blosc settings. The compressor is a blosc compressor code and typesize
+  // the width of the values to shuffle.
+  int64_t compressWithContext(const uint8_t* buffer,
+                              const size_t buffer_size,
+                              uint8_t* compressed_buffer,
+                              const size_t compressed_buffer_size,
+                              const int compressor,
+                              const size_t typesize);
+
+  size_t decompressWithContext(const uint8_t* compressed_buffer,
+                               uint8_t* decompressed_buffer,
+                               const size_t decompressed_size);
+
+  // Size of the output buffer which is always large enough for compressWithContext.
+  static size_t getMaxCompressedSize(const size_t len);
+
+  // Code of the given blosc compressor, -1 if the library doesn't support it.
+  static int getCompressorCode(const std::string& compressor_name);
+
   ~BloscCompressor();
 
  private:
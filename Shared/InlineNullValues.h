@@ -46,7 +46,7 @@ inline int64_t inline_int_null_val(const SQL_TYPE_INFO& ti) {
     CHECK_EQ(4, ti.get_logical_size());
     type = kINT;
   } else {
-    CHECK_EQ(kENCODING_NONE, ti.get_compression());
+    CHECK(ti.get_compression() == kENCODING_NONE || ti.is_packed_int());
   }
   switch (type) {
     case kBOOLEAN:
@@ -75,7 +75,7 @@ inline int64_t inline_int_null_val(const SQL_TYPE_INFO& ti) {
 
 template <typename SQL_TYPE_INFO>
 inline int64_t inline_fixed_encoding_null_val(const SQL_TYPE_INFO& ti) {
-  if (ti.get_compression() == kENCODING_NONE) {
+  if (ti.get_compression() == kENCODING_NONE || ti.is_packed_int()) {
     return inline_int_null_val(ti);
   }
   if (ti.get_compression() == kENCODING_DATE_IN_DAYS) {
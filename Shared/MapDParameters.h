@@ -40,11 +40,14 @@ struct MapDParameters {
   size_t cpu_buffer_mem_bytes = 0;  // max size of memory reserved for CPU buffers [bytes]
   size_t gpu_buffer_mem_bytes = 0;  // max size of memory reserved for GPU buffers [bytes]
   double gpu_input_mem_limit = 0.9;  // Punt query to CPU if input mem exceeds % GPU mem
+  std::string cpu_buffer_eviction_policy = "lru";  // "lru" or scan resistant "2q"
+  std::string gpu_buffer_eviction_policy = "lru";
   std::string ssl_cert_file = "";    // file path to server's certified PKI certificate
   std::string ssl_key_file = "";     // file path to server's' private PKI key
   std::string ssl_trust_store = "";  // file path to java jks version of ssl_key_fle
   std::string ssl_trust_password = "";  // pass phrae for java jks trust store.
   bool aggregator = false;
+  size_t calcite_plan_cache_size = 64 << 20;  // calcite plans kept [bytes], 0 disables
   bool enable_calcite_view_optimize =
       false;  // allow calcite to optimize the relalgebra for a view query
   MapDParameters() : cuda_block_size(0), cuda_grid_size(0), calcite_max_mem(1024) {}
@@ -65,6 +65,7 @@ class MapDProgramOptions : public boost::program_options::options_description {
       MINSPERMONTH;  // maximum session life in days (30 Days)
                      // (https://pages.nist.gov/800-63-3/sp800-63b.html#aal3reauth)
   std::string udf_file_name = {""};
+  size_t persistent_code_cache_size = 0;  // bytes of query code kept across restarts
 
  private:
   void fillOptions(boost::program_options::options_description& desc);
@@ -86,7 +86,7 @@ inline int64_t inline_int_null_val(const SQLTypeInfo& ti) {
 }
 
 inline int64_t inline_fixed_encoding_null_val(const SQLTypeInfo& ti) {
-  if (ti.get_compression() == kENCODING_NONE) {
+  if (ti.get_compression() == kENCODING_NONE || ti.is_packed_int()) {
     return inline_int_null_val(ti);
   }
   if (ti.get_compression() == kENCODING_DATE_IN_DAYS) {
@@ -0,0 +1,290 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TaskPool.h"
+#include "thread_count.h"
+
+#include <glog/logging.h>
+
+namespace TaskPool_NS {
+
+thread_local TaskPool* TaskPool::tls_pool_{nullptr};
+thread_local int TaskPool::tls_worker_idx_{-1};
+thread_local TaskContext TaskPool::tls_context_;
+
+TaskPool::TaskPool(const size_t worker_count)
+    : base_worker_count_(std::max(worker_count, size_t(1)))
+    , max_worker_count_(4 * base_worker_count_)
+    , running_workers_(0)
+    , blocked_workers_(0)
+    , shutdown_(false)
+    , queue_depth_(0)
+    , executed_count_(0)
+    , steal_count_(0)
+    , cancelled_count_(0) {
+  // Preallocate the deques of the spare workers as well, so that stealing never races
+  // with the growth of the vector.
+  for (size_t i = 0; i < max_worker_count_; ++i) {
+    worker_queues_.emplace_back(new WorkerQueue());
+  }
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  for (size_t i = 0; i < base_worker_count_; ++i) {
+    spawnWorker();
+  }
+}
+
+TaskPool::~TaskPool() {
+  {
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    shutdown_ = true;
+  }
+  work_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+TaskPool& TaskPool::instance() {
+  static TaskPool pool(cpu_threads());
+  return pool;
+}
+
+const TaskContext& TaskPool::getContext() {
+  return tls_context_;
+}
+
+TaskPoolStats TaskPool::getStats() const {
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  return {workers_.size(),
+          running_workers_,
+          blocked_workers_,
+          queue_depth_.load(),
+          executed_count_.load(),
+          steal_count_.load(),
+          cancelled_count_.load()};
+}
+
+bool TaskPool::isOwnWorker() const {
+  return tls_pool_ == this && tls_worker_idx_ >= 0;
+}
+
+void TaskPool::enqueue(QueuedTask&& task) {
+  {
+    // Count the task before publishing it so that the depth never underflows; workers
+    // check the depth in their wait predicate, hence the global mutex.
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    ++queue_depth_;
+    if (!isOwnWorker() || task.context.priority == TaskPriority::HIGH) {
+      global_queues_[static_cast<int>(task.context.priority)].push_back(std::move(task));
+    }
+    // The workers might all have blocked while the queue was empty.
+    spawnSpareWorkerIfNeeded();
+  }
+  if (isOwnWorker() && task.context.priority != TaskPriority::HIGH) {
+    auto& worker_queue = *worker_queues_[tls_worker_idx_];
+    std::lock_guard<std::mutex> lock(worker_queue.mutex);
+    worker_queue.tasks.push_back(std::move(task));
+  }
+  work_available_.notify_one();
+}
+
+bool TaskPool::popGlobalTask(const TaskPriority priority, QueuedTask& task) {
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  auto& queue = global_queues_[static_cast<int>(priority)];
+  if (queue.empty()) {
+    return false;
+  }
+  task = std::move(queue.front());
+  queue.pop_front();
+  return true;
+}
+
+bool TaskPool::popTask(const int worker_idx, QueuedTask& task) {
+  bool found = popGlobalTask(TaskPriority::HIGH, task);
+  if (!found && worker_idx >= 0) {
+    // Own tasks, most recently pushed first since their inputs are likely still in cache.
+    auto& worker_queue = *worker_queues_[worker_idx];
+    std::lock_guard<std::mutex> lock(worker_queue.mutex);
+    if (!worker_queue.tasks.empty()) {
+      task = std::move(worker_queue.tasks.back());
+      worker_queue.tasks.pop_back();
+      found = true;
+    }
+  }
+  if (!found) {
+    found = popGlobalTask(TaskPriority::NORMAL, task) ||
+            popGlobalTask(TaskPriority::LOW, task);
+  }
+  for (size_t i = 1; !found && i <= max_worker_count_; ++i) {
+    const auto victim_idx = (std::max(worker_idx, 0) + i) % max_worker_count_;
+    if (static_cast<int>(victim_idx) == worker_idx) {
+      continue;
+    }
+    auto& victim_queue = *worker_queues_[victim_idx];
+    std::lock_guard<std::mutex> lock(victim_queue.mutex);
+    if (!victim_queue.tasks.empty()) {
+      task = std::move(victim_queue.tasks.front());
+      victim_queue.tasks.pop_front();
+      ++steal_count_;
+      found = true;
+    }
+  }
+  if (found) {
+    --queue_depth_;
+  }
+  return found;
+}
+
+bool TaskPool::runOwnTask() {
+  if (!isOwnWorker()) {
+    return false;
+  }
+  QueuedTask task;
+  {
+    auto& worker_queue = *worker_queues_[tls_worker_idx_];
+    std::lock_guard<std::mutex> lock(worker_queue.mutex);
+    if (worker_queue.tasks.empty()) {
+      return false;
+    }
+    task = std::move(worker_queue.tasks.back());
+    worker_queue.tasks.pop_back();
+  }
+  --queue_depth_;
+  runTask(task);
+  return true;
+}
+
+void TaskPool::runTask(QueuedTask& task) {
+  const bool cancelled = task.context.cancelled && task.context.cancelled->load();
+  // Nested submissions inherit the context of the task.
+  // Counted upfront, the future of the task is ready as soon as it has run.
+  if (cancelled) {
+    ++cancelled_count_;
+  } else {
+    ++executed_count_;
+  }
+  const auto saved_context = tls_context_;
+  tls_context_ = task.context;
+  task.run(cancelled);
+  tls_context_ = saved_context;
+}
+
+void TaskPool::workerLoop(const size_t worker_idx) {
+  tls_pool_ = this;
+  tls_worker_idx_ = worker_idx;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(global_mutex_);
+      work_available_.wait(lock, [this] {
+        return shutdown_ || (queue_depth_ > 0 && running_workers_ < base_worker_count_);
+      });
+      if (queue_depth_ == 0) {
+        if (shutdown_) {
+          return;
+        }
+        continue;
+      }
+      ++running_workers_;
+    }
+    QueuedTask task;
+    const bool found = popTask(worker_idx, task);
+    if (found) {
+      runTask(task);
+    }
+    {
+      std::lock_guard<std::mutex> lock(global_mutex_);
+      --running_workers_;
+    }
+    work_available_.notify_one();
+  }
+}
+
+void TaskPool::spawnWorker() {
+  // Called with the global mutex held.
+  CHECK_LT(workers_.size(), max_worker_count_);
+  const auto worker_idx = workers_.size();
+  workers_.emplace_back([this, worker_idx] { workerLoop(worker_idx); });
+}
+
+void TaskPool::spawnSpareWorkerIfNeeded() {
+  // Called with the global mutex held.
+  const auto idle_workers = workers_.size() - running_workers_ - blocked_workers_;
+  if (queue_depth_ > 0 && idle_workers == 0 && running_workers_ < base_worker_count_ &&
+      workers_.size() < max_worker_count_) {
+    // Compensate for the blocked workers, otherwise the tasks they wait for might never
+    // get a worker.
+    spawnWorker();
+  }
+}
+
+void TaskPool::beginBlocking() {
+  if (!isOwnWorker()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    CHECK_GT(running_workers_, size_t(0));
+    --running_workers_;
+    ++blocked_workers_;
+    spawnSpareWorkerIfNeeded();
+  }
+  work_available_.notify_one();
+}
+
+void TaskPool::endBlocking() {
+  if (!isOwnWorker()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(global_mutex_);
+  CHECK_GT(blocked_workers_, size_t(0));
+  --blocked_workers_;
+  ++running_workers_;
+}
+
+void TaskPool::helpWhileBlocked() {
+  if (!isOwnWorker() || queue_depth_ == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    const auto idle_workers = workers_.size() - running_workers_ - blocked_workers_;
+    if (queue_depth_ == 0 || idle_workers > 0 || running_workers_ >= base_worker_count_) {
+      return;
+    }
+    if (workers_.size() < max_worker_count_) {
+      spawnWorker();
+      return;
+    }
+    // No spare worker left to spawn, the tasks waited for could be among the queued
+    // ones; run one on this worker instead of risking a deadlock.
+    CHECK_GT(blocked_workers_, size_t(0));
+    --blocked_workers_;
+    ++running_workers_;
+  }
+  QueuedTask task;
+  if (popTask(tls_worker_idx_, task)) {
+    runTask(task);
+  }
+  {
+    std::lock_guard<std::mutex> lock(global_mutex_);
+    CHECK_GT(running_workers_, size_t(0));
+    --running_workers_;
+    ++blocked_workers_;
+  }
+  work_available_.notify_one();
+}
+
+}  // namespace TaskPool_NS
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Process-wide work-stealing pool for the CPU tasks of queries (fragment kernels,
+ * reductions, hash table builds, columnar conversions etc.). Replaces spawning fresh
+ * std::async threads sized by cpu_threads() for every call, which oversubscribes the
+ * cores when several queries run at a time.
+ *
+ * Each worker has its own deque; tasks submitted from a worker are pushed to its deque
+ * and idle workers steal from the other end. Tasks submitted from other threads go to
+ * one global queue per priority. Tasks inherit the priority and the cancellation flag
+ * of the thread submitting them, set through ScopedTaskContext for a query and
+ * propagated to nested submissions. Workers blocked on a TaskFuture are compensated
+ * with spare workers so that tasks waiting on other tasks cannot starve the pool; once
+ * the pool has reached its worker cap, blocked workers run the queued tasks themselves.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace TaskPool_NS {
+
+enum class TaskPriority { LOW = 0, NORMAL = 1, HIGH = 2 };
+
+class TaskCancelled : public std::runtime_error {
+ public:
+  TaskCancelled() : std::runtime_error("Task cancelled") {}
+};
+
+using CancellationFlag = std::atomic<bool>;
+
+struct TaskContext {
+  TaskPriority priority{TaskPriority::NORMAL};
+  // Tasks which haven't started yet when the flag gets set are not run, their
+  // futures throw TaskCancelled instead.
+  std::shared_ptr<CancellationFlag> cancelled;
+};
+
+struct TaskPoolStats {
+  size_t worker_count;
+  size_t running_count;
+  size_t blocked_count;
+  size_t queue_depth;
+  size_t executed_count;
+  size_t steal_count;
+  size_t cancelled_count;
+};
+
+template <typename T>
+class TaskFuture;
+
+class TaskPool {
+ public:
+  explicit TaskPool(const size_t worker_count);
+  ~TaskPool();
+
+  static TaskPool& instance();
+
+  template <typename F, typename... Args>
+  auto submit(F&& func, Args&&... args);
+
+  TaskPoolStats getStats() const;
+
+  // Context inherited by the tasks submitted from the calling thread.
+  static const TaskContext& getContext();
+
+ private:
+  struct QueuedTask {
+    std::function<void(const bool cancelled)> run;
+    TaskContext context;
+  };
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<QueuedTask> tasks;
+  };
+
+  void enqueue(QueuedTask&& task);
+  bool popTask(const int worker_idx, QueuedTask& task);
+  bool popGlobalTask(const TaskPriority priority, QueuedTask& task);
+  bool runOwnTask();
+  void runTask(QueuedTask& task);
+  void workerLoop(const size_t worker_idx);
+  void spawnWorker();
+  void spawnSpareWorkerIfNeeded();
+  bool isOwnWorker() const;
+
+  // Bracket a blocking wait of a worker thread on a TaskFuture.
+  void beginBlocking();
+  void endBlocking();
+  // Called periodically by a blocked worker, makes sure the queued tasks get a worker.
+  void helpWhileBlocked();
+
+  const size_t base_worker_count_;
+  const size_t max_worker_count_;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  std::vector<std::thread> workers_;
+
+  std::deque<QueuedTask> global_queues_[3];
+  mutable std::mutex global_mutex_;
+  std::condition_variable work_available_;
+  size_t running_workers_;
+  size_t blocked_workers_;
+  bool shutdown_;
+
+  std::atomic<size_t> queue_depth_;
+  std::atomic<size_t> executed_count_;
+  std::atomic<size_t> steal_count_;
+  std::atomic<size_t> cancelled_count_;
+
+  static thread_local TaskPool* tls_pool_;
+  static thread_local int tls_worker_idx_;
+  static thread_local TaskContext tls_context_;
+
+  friend class ScopedTaskContext;
+  template <typename T>
+  friend class TaskFuture;
+};
+
+// Sets the context of the tasks submitted from the current thread for its lifetime.
+class ScopedTaskContext {
+ public:
+  ScopedTaskContext(const TaskPriority priority,
+                    std::shared_ptr<CancellationFlag> cancelled)
+      : saved_context_(TaskPool::tls_context_) {
+    TaskPool::tls_context_ = TaskContext{priority, cancelled};
+  }
+  ~ScopedTaskContext() { TaskPool::tls_context_ = saved_context_; }
+
+ private:
+  const TaskContext saved_context_;
+};
+
+template <typename T>
+class TaskFuture {
+ public:
+  TaskFuture() = default;
+  TaskFuture(std::future<T>&& future) : future_(std::move(future)) {}
+
+  bool valid() const { return future_.valid(); }
+
+  bool ready() const {
+    using namespace std::chrono_literals;
+    return future_.wait_for(0ns) == std::future_status::ready;
+  }
+
+  void wait() const {
+    if (ready()) {
+      return;
+    }
+    auto pool = TaskPool::tls_pool_;
+    if (pool) {
+      // A worker first runs the tasks it submitted itself, the awaited one is likely
+      // among them unless it has been stolen already.
+      while (!ready() && pool->runOwnTask()) {
+      }
+      if (ready()) {
+        return;
+      }
+      pool->beginBlocking();
+      while (future_.wait_for(std::chrono::milliseconds(1)) !=
+             std::future_status::ready) {
+        pool->helpWhileBlocked();
+      }
+      pool->endBlocking();
+    } else {
+      future_.wait();
+    }
+  }
+
+  T get() {
+    wait();
+    return future_.get();
+  }
+
+ private:
+  std::future<T> future_;
+};
+
+namespace detail {
+
+template <typename R, typename Bound>
+void set_promise_value(std::promise<R>& promise, Bound& bound) {
+  promise.set_value(bound());
+}
+
+template <typename Bound>
+void set_promise_value(std::promise<void>& promise, Bound& bound) {
+  bound();
+  promise.set_value();
+}
+
+}  // namespace detail
+
+template <typename F, typename... Args>
+auto TaskPool::submit(F&& func, Args&&... args) {
+  using Bound = decltype(std::bind(std::forward<F>(func), std::forward<Args>(args)...));
+  using R = decltype(std::declval<Bound&>()());
+  auto bound =
+      std::make_shared<Bound>(std::bind(std::forward<F>(func), std::forward<Args>(args)...));
+  auto promise = std::make_shared<std::promise<R>>();
+  TaskFuture<R> future(promise->get_future());
+  enqueue(QueuedTask{[bound, promise](const bool cancelled) {
+                       if (cancelled) {
+                         promise->set_exception(std::make_exception_ptr(TaskCancelled()));
+                         return;
+                       }
+                       try {
+                         detail::set_promise_value(*promise, *bound);
+                       } catch (...) {
+                         promise->set_exception(std::current_exception());
+                       }
+                     },
+                     tls_context_});
+  return future;
+}
+
+// Drop-in replacement for std::async(std::launch::async, ...) which runs the task on
+// the process-wide pool.
+template <typename F, typename... Args>
+auto async(F&& func, Args&&... args) {
+  return TaskPool::instance().submit(std::forward<F>(func), std::forward<Args>(args)...);
+}
+
+}  // namespace TaskPool_NS
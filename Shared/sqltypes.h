@@ -147,7 +147,8 @@ enum EncodingType {
   kENCODING_SPARSE = 5,        // Null encoding for sparse columns
   kENCODING_GEOINT = 6,        // Encoding coordinates as intergers
   kENCODING_DATE_IN_DAYS = 7,  // Date encoding in days
-  kENCODING_LAST = 8
+  kENCODING_BITPACK = 8,       // Frame of reference bit packing
+  kENCODING_LAST = 9
 };
 
 #include "SQLTypeUtilities.h"
@@ -437,6 +438,11 @@ class SQLTypeInfoCore : public TYPE_FACET_PACK<SQLTypeInfoCore<TYPE_FACET_PACK..
   inline bool is_fixlen_array() const { return type == kARRAY && size > 0; }
   inline bool is_timeinterval() const { return IS_INTERVAL(type); }
   inline bool is_geometry() const { return IS_GEO(type); }
+  // Run length encoded, delta encoded or bit packed integers, decoded by the kernels
+  inline bool is_packed_int() const {
+    return compression == kENCODING_RL || compression == kENCODING_DIFF ||
+           compression == kENCODING_BITPACK;
+  }
 
   inline bool is_varlen() const {  // TODO: logically this should ignore fixlen arrays
     return (IS_STRING(type) && compression != kENCODING_DICT) || type == kARRAY ||
@@ -652,7 +658,8 @@ class SQLTypeInfoCore : public TYPE_FACET_PACK<SQLTypeInfoCore<TYPE_FACET_PACK..
             return comp_param / 8;
           case kENCODING_RL:
           case kENCODING_DIFF:
-            break;
+          case kENCODING_BITPACK:
+            return sizeof(int16_t);
           default:
             assert(false);
         }
@@ -666,7 +673,8 @@ class SQLTypeInfoCore : public TYPE_FACET_PACK<SQLTypeInfoCore<TYPE_FACET_PACK..
             return comp_param / 8;
           case kENCODING_RL:
           case kENCODING_DIFF:
-            break;
+          case kENCODING_BITPACK:
+            return sizeof(int32_t);
           default:
             assert(false);
         }
@@ -682,7 +690,8 @@ class SQLTypeInfoCore : public TYPE_FACET_PACK<SQLTypeInfoCore<TYPE_FACET_PACK..
             return comp_param / 8;
           case kENCODING_RL:
           case kENCODING_DIFF:
-            break;
+          case kENCODING_BITPACK:
+            return sizeof(int64_t);
           default:
             assert(false);
         }
@@ -730,6 +739,8 @@ class SQLTypeInfoCore : public TYPE_FACET_PACK<SQLTypeInfoCore<TYPE_FACET_PACK..
             return comp_param / 8;
           case kENCODING_RL:
           case kENCODING_DIFF:
+          case kENCODING_BITPACK:
+            return sizeof(int64_t);
           case kENCODING_SPARSE:
             assert(false);
             break;
@@ -801,7 +812,7 @@ std::string SQLTypeInfoCore<TYPE_FACET_PACK...>::type_name[kSQLTYPE_LAST] = {
 
 template <template <class> class... TYPE_FACET_PACK>
 std::string SQLTypeInfoCore<TYPE_FACET_PACK...>::comp_name[kENCODING_LAST] =
-    {"NONE", "FIXED", "RL", "DIFF", "DICT", "SPARSE", "COMPRESSED", "DAYS"};
+    {"NONE", "FIXED", "RL", "DIFF", "DICT", "SPARSE", "COMPRESSED", "DAYS", "BITPACK"};
 #endif
 
 using SQLTypeInfo =
@@ -824,7 +835,7 @@ int64_t convert_decimal_value_to_scale(const int64_t decimal_value,
 
 inline SQLTypeInfo get_logical_type_info(const SQLTypeInfo& type_info) {
   EncodingType encoding = type_info.get_compression();
-  if (encoding == kENCODING_DATE_IN_DAYS ||
+  if (encoding == kENCODING_DATE_IN_DAYS || type_info.is_packed_int() ||
       (encoding == kENCODING_FIXED && type_info.get_type() != kARRAY)) {
     encoding = kENCODING_NONE;
   }
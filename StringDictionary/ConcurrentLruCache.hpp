@@ -0,0 +1,119 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ConcurrentLruCache.hpp
+ * @brief   Thread safe LRU cache bounded by the memory used by its entries.
+ *
+ * The values are immutable and shared with the callers, an entry which is replaced or
+ * evicted stays valid for whoever got it before. The caller tells the size of each
+ * value on put, the least recently used entries are evicted once the total goes over
+ * the limit.
+ */
+
+#ifndef STRINGDICTIONARY_CONCURRENTLRUCACHE_HPP
+#define STRINGDICTIONARY_CONCURRENTLRUCACHE_HPP
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct LruCacheStats {
+  size_t hits;
+  size_t misses;
+  size_t num_entries;
+  size_t num_bytes;
+};
+
+template <typename key_t, typename value_t, class hash_t = std::hash<key_t>>
+class ConcurrentLruCache {
+ private:
+  struct CacheItem {
+    key_t key;
+    std::shared_ptr<const value_t> value;
+    size_t num_bytes;
+  };
+  typedef typename std::list<CacheItem> cache_list_t;
+  typedef typename cache_list_t::iterator list_iterator_t;
+  typedef typename std::unordered_map<key_t, list_iterator_t, hash_t> map_t;
+
+ public:
+  ConcurrentLruCache(const size_t max_bytes)
+      : max_bytes_(max_bytes), num_bytes_(0), hits_(0), misses_(0) {}
+
+  std::shared_ptr<const value_t> get(const key_t& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_items_map_.find(key);
+    if (it == cache_items_map_.end()) {
+      ++misses_;
+      return nullptr;
+    }
+    ++hits_;
+    cache_items_list_.splice(cache_items_list_.begin(), cache_items_list_, it->second);
+    return it->second->value;
+  }
+
+  void put(const key_t& key,
+           std::shared_ptr<const value_t> value,
+           const size_t num_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    erase(key);
+    if (num_bytes > max_bytes_) {
+      return;
+    }
+    cache_items_list_.push_front(CacheItem{key, std::move(value), num_bytes});
+    cache_items_map_[key] = cache_items_list_.begin();
+    num_bytes_ += num_bytes;
+    while (num_bytes_ > max_bytes_) {
+      erase(cache_items_list_.back().key);
+    }
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_items_map_.clear();
+    cache_items_list_.clear();
+    num_bytes_ = 0;
+  }
+
+  LruCacheStats getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return LruCacheStats{hits_, misses_, cache_items_map_.size(), num_bytes_};
+  }
+
+ private:
+  void erase(const key_t& key) {
+    auto it = cache_items_map_.find(key);
+    if (it == cache_items_map_.end()) {
+      return;
+    }
+    num_bytes_ -= it->second->num_bytes;
+    cache_items_list_.erase(it->second);
+    cache_items_map_.erase(it);
+  }
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  cache_list_t cache_items_list_;
+  map_t cache_items_map_;
+  size_t num_bytes_;
+  size_t hits_;
+  size_t misses_;
+};
+
+#endif  // STRINGDICTIONARY_CONCURRENTLRUCACHE_HPP
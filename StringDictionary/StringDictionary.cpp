@@ -15,6 +15,7 @@
  */
 
 #include "StringDictionary.h"
+#include "../Shared/measure.h"
 #include "../Shared/sqltypes.h"
 #include "../Utils/Regexp.h"
 #include "../Utils/StringLike.h"
@@ -28,6 +29,7 @@
 #include <boost/sort/spreadsort/string_sort.hpp>
 
 #include <future>
+#include <numeric>
 #include <thread>
 
 namespace {
@@ -85,7 +87,7 @@ const uint64_t round_up_p2(const uint64_t num) {
   return in;
 }
 
-uint32_t rk_hash(const std::string& str) {
+uint32_t rk_hash(const boost::string_view str) {
   uint32_t str_hash = 1;
   // rely on fact that unsigned overflow is defined and wraps
   for (size_t i = 0; i < str.size(); ++i) {
@@ -93,10 +95,31 @@ uint32_t rk_hash(const std::string& str) {
   }
   return str_hash;
 }
+
+std::atomic<uint64_t> g_next_dict_instance_id{0};
+
 }  // namespace
 
+bool g_enable_string_dict_trigram_index{false};
+size_t g_string_dict_predicate_cache_size{64 << 20};     // bytes per dictionary
+size_t g_string_dict_translation_cache_size{256 << 20};  // bytes per dictionary
+
 const int32_t StringDictionary::INVALID_STR_ID{-1};
 
+struct StringDictionary::PayloadMapping {
+  char* addr;
+  size_t size;
+  const bool is_temp;
+
+  ~PayloadMapping() {
+    if (is_temp) {
+      free(addr);
+    } else {
+      checked_munmap(addr, size);
+    }
+  }
+};
+
 StringDictionary::StringDictionary(const std::string& folder,
                                    const bool isTemp,
                                    const bool recover,
@@ -107,6 +130,8 @@ StringDictionary::StringDictionary(const std::string& folder,
     , rk_hashes_(initial_capacity)
     , isTemp_(isTemp)
     , materialize_hashes_(materializeHashes)
+    , hash_table_resized_(true)
+    , persisted_hash_count_(0)
     , payload_fd_(-1)
     , offset_fd_(-1)
     , offset_map_(nullptr)
@@ -114,7 +139,9 @@ StringDictionary::StringDictionary(const std::string& folder,
     , offset_file_size_(0)
     , payload_file_size_(0)
     , payload_file_off_(0)
-    , strings_cache_(nullptr) {
+    , predicate_cache_(g_string_dict_predicate_cache_size)
+    , translation_cache_(g_string_dict_translation_cache_size)
+    , instance_id_(g_next_dict_instance_id++) {
   if (!isTemp && folder.empty()) {
     return;
   }
@@ -126,6 +153,12 @@ StringDictionary::StringDictionary(const std::string& folder,
     offsets_path_ = (storage_path / boost::filesystem::path("DictOffsets")).string();
     const auto payload_path =
         (storage_path / boost::filesystem::path("DictPayload")).string();
+    trigrams_path_ = (storage_path / boost::filesystem::path("DictTrigrams")).string();
+    hashes_path_ = (storage_path / boost::filesystem::path("DictHashes")).string();
+    if (!recover) {
+      boost::filesystem::remove(trigrams_path_);
+      boost::filesystem::remove(hashes_path_);
+    }
     payload_fd_ = checked_open(payload_path.c_str(), recover);
     offset_fd_ = checked_open(offsets_path_.c_str(), recover);
     payload_file_size_ = file_size(payload_fd_);
@@ -139,10 +172,12 @@ StringDictionary::StringDictionary(const std::string& folder,
     addOffsetCapacity();
   }
   if (!isTemp_) {  // we never mmap or recover temp dictionaries
-    payload_map_ = reinterpret_cast<char*>(checked_mmap(payload_fd_, payload_file_size_));
+    setPayloadMapping(
+        reinterpret_cast<char*>(checked_mmap(payload_fd_, payload_file_size_)));
     offset_map_ =
         reinterpret_cast<StringIdxEntry*>(checked_mmap(offset_fd_, offset_file_size_));
-    if (recover) {
+    // Rehashes all the strings if the persisted hash table can't be used.
+    if (recover && !loadHashTable()) {
       const size_t bytes = file_size(offset_fd_);
       if (bytes % sizeof(StringIdxEntry) != 0) {
         LOG(WARNING) << "Offsets " << offsets_path_ << " file is truncated";
@@ -178,8 +213,8 @@ StringDictionary::StringDictionary(const std::string& folder,
                   // hit the canary, recovery finished
                   break;
                 } else {
-                  std::string temp(recovered.c_str_ptr, recovered.size);
-                  hashVec.emplace_back(std::make_pair(rk_hash(temp), temp.size()));
+                  hashVec.emplace_back(std::make_pair(
+                      rk_hash({recovered.c_str_ptr, recovered.size}), recovered.size));
                 }
               }
               return hashVec;
@@ -193,6 +228,8 @@ StringDictionary::StringDictionary(const std::string& folder,
       if (dictionary_futures.size() != 0) {
         processDictionaryFutures(dictionary_futures);
       }
+      hash_table_resized_ = true;
+      writeHashTable();
     }
   }
 }
@@ -217,26 +254,27 @@ void StringDictionary::processDictionaryFutures(
 }
 
 StringDictionary::StringDictionary(const LeafHostInfo& host, const DictRef dict_ref)
-    : strings_cache_(nullptr)
+    : predicate_cache_(g_string_dict_predicate_cache_size)
+    , translation_cache_(g_string_dict_translation_cache_size)
     , client_(new StringDictionaryClient(host, dict_ref, true))
-    , client_no_timeout_(new StringDictionaryClient(host, dict_ref, false)) {}
+    , client_no_timeout_(new StringDictionaryClient(host, dict_ref, false))
+    , instance_id_(g_next_dict_instance_id++) {}
 
 StringDictionary::~StringDictionary() noexcept {
   if (client_) {
     return;
   }
   if (payload_map_) {
+    CHECK(offset_map_);
+    // The pinned mappings outlive the dictionary, they are released with their pins.
+    payload_mapping_.reset();
     if (!isTemp_) {
-      CHECK(offset_map_);
-      checked_munmap(payload_map_, payload_file_size_);
       checked_munmap(offset_map_, offset_file_size_);
       CHECK_GE(payload_fd_, 0);
       close(payload_fd_);
       CHECK_GE(offset_fd_, 0);
       close(offset_fd_);
     } else {
-      CHECK(offset_map_);
-      free(payload_map_);
       free(offset_map_);
     }
   }
@@ -254,6 +292,47 @@ int32_t StringDictionary::getOrAdd(const std::string& str) noexcept {
 
 namespace {
 
+// The persisted hash table: this header padded to a page, the buckets and the hashes of
+// the strings, if materialized.
+constexpr uint32_t dict_hashes_magic{0x48534944};  // "DISH"
+constexpr uint32_t dict_hashes_format_version{1};
+constexpr size_t dict_hashes_page_size{4096};
+constexpr size_t buckets_per_page{dict_hashes_page_size / sizeof(int32_t)};
+
+struct DictHashesHeader {
+  uint32_t magic;
+  uint32_t format_version;
+  uint64_t str_count;
+  uint64_t payload_size;  // bytes of payload of the str_count strings
+  uint64_t bucket_count;
+  uint32_t has_rk_hashes;
+  uint32_t valid;  // cleared while the table is being written
+  uint64_t checksum;
+};
+
+uint64_t header_checksum(const DictHashesHeader& header) {
+  // FNV-1a over the fields before the checksum.
+  uint64_t checksum{0xcbf29ce484222325ULL};
+  const auto bytes = reinterpret_cast<const uint8_t*>(&header);
+  for (size_t i = 0; i < offsetof(DictHashesHeader, checksum); ++i) {
+    checksum = (checksum ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return checksum;
+}
+
+bool checked_pwrite(const int fd, const void* buf, const size_t count, off_t offset) {
+  auto ptr = static_cast<const char*>(buf);
+  size_t written{0};
+  while (written < count) {
+    const auto ret = pwrite(fd, ptr + written, count - written, offset + written);
+    if (ret <= 0) {
+      return false;
+    }
+    written += ret;
+  }
+  return true;
+}
+
 template <class T>
 void log_encoding_error(const std::string& str) {
   LOG(ERROR) << "Could not encode string: " << str
@@ -270,49 +349,71 @@ void StringDictionary::getOrAddBulk(const std::vector<std::string>& string_vec,
     getOrAddBulkRemote(string_vec, encoded_vec);
     return;
   }
-  size_t out_idx{0};
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-
-  for (const auto& str : string_vec) {
-    if (str.empty()) {
-      encoded_vec[out_idx++] = inline_int_null_value<T>();
-      continue;
-    }
+  // The hashes are computed and the strings already in the dictionary are looked up
+  // without excluding the other encoders, only the new strings are added under the
+  // write lock.
+  std::vector<uint32_t> hashes(string_vec.size());
+  for (size_t i = 0; i < string_vec.size(); ++i) {
+    const auto& str = string_vec[i];
     CHECK(str.size() <= MAX_STRLEN);
-    uint32_t bucket;
-    const uint32_t hash = rk_hash(str);
-    bucket = computeBucket(hash, str, str_ids_, false);
+    hashes[i] = rk_hash(str);
+  }
+  std::vector<size_t> new_str_indices;
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    for (size_t i = 0; i < string_vec.size(); ++i) {
+      const auto& str = string_vec[i];
+      if (str.empty()) {
+        encoded_vec[i] = inline_int_null_value<T>();
+        continue;
+      }
+      const auto string_id = str_ids_[computeBucket(hashes[i], str, str_ids_, false)];
+      if (string_id == INVALID_STR_ID) {
+        new_str_indices.push_back(i);
+        continue;
+      }
+      encoded_vec[i] = string_id;
+    }
+  }
+  if (new_str_indices.empty()) {
+    return;
+  }
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  for (const auto i : new_str_indices) {
+    const auto& str = string_vec[i];
+    const uint32_t hash = hashes[i];
+    // Added by another encoder or earlier in the batch since the lookup.
+    uint32_t bucket = computeBucket(hash, str, str_ids_, false);
     if (str_ids_[bucket] != INVALID_STR_ID) {
-      encoded_vec[out_idx++] = str_ids_[bucket];
+      encoded_vec[i] = str_ids_[bucket];
       continue;
     }
     // need to add record to dictionary
     // check there is room
     if (str_count_ == static_cast<size_t>(max_valid_int_value<T>())) {
       log_encoding_error<T>(str);
-      encoded_vec[out_idx++] = inline_int_null_value<T>();
+      encoded_vec[i] = inline_int_null_value<T>();
       continue;
     }
-    if (str_ids_[bucket] == INVALID_STR_ID) {
-      CHECK_LT(str_count_, MAX_STRCOUNT)
-          << "Maximum number (" << str_count_
-          << ") of Dictionary encoded Strings reached for this column, offset path "
-             "for column is  "
-          << offsets_path_;
-      if (fillRateIsHigh()) {
-        // resize when more than 50% is full
-        increaseCapacity();
-        bucket = computeBucket(hash, str, str_ids_, false);
-      }
-      appendToStorage(str);
+    CHECK_LT(str_count_, MAX_STRCOUNT)
+        << "Maximum number (" << str_count_
+        << ") of Dictionary encoded Strings reached for this column, offset path "
+           "for column is  "
+        << offsets_path_;
+    if (fillRateIsHigh()) {
+      // resize when more than 50% is full
+      increaseCapacity();
+      bucket = computeBucket(hash, str, str_ids_, false);
+    }
+    appendToStorage(str);
 
-      str_ids_[bucket] = static_cast<int32_t>(str_count_);
-      if (materialize_hashes_) {
-        rk_hashes_[str_count_] = hash;
-      }
-      ++str_count_;
+    str_ids_[bucket] = static_cast<int32_t>(str_count_);
+    markHashTableDirty(bucket);
+    if (materialize_hashes_) {
+      rk_hashes_[str_count_] = hash;
     }
-    encoded_vec[out_idx++] = str_ids_[bucket];
+    ++str_count_;
+    encoded_vec[i] = str_ids_[bucket];
   }
   invalidateInvertedIndex();
 }
@@ -362,7 +463,7 @@ int32_t StringDictionary::getIdOfString(const std::string& str) const {
   return getUnlocked(str);
 }
 
-int32_t StringDictionary::getUnlocked(const std::string& str) const noexcept {
+int32_t StringDictionary::getUnlocked(const boost::string_view str) const noexcept {
   const uint32_t hash = rk_hash(str);
   auto str_id = str_ids_[computeBucket(hash, str, str_ids_, false)];
   return str_id;
@@ -392,6 +493,60 @@ std::pair<char*, size_t> StringDictionary::getStringBytes(int32_t string_id) con
   return getStringBytesChecked(string_id);
 }
 
+std::shared_ptr<const void> StringDictionary::pinPayload() const {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  if (client_) {
+    return nullptr;
+  }
+  return payload_mapping_;
+}
+
+boost::string_view StringDictionary::getStringView(
+    const int32_t string_id,
+    std::shared_ptr<const void>& pin) const {
+  CHECK(pin);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  if (pin != payload_mapping_) {
+    pin = payload_mapping_;
+  }
+  CHECK_LE(0, string_id);
+  CHECK_LT(string_id, static_cast<int32_t>(str_count_));
+  return getStringViewChecked(string_id);
+}
+
+boost::string_view StringDictionary::getPinnedStringView(const int32_t string_id,
+                                                        const void* pin) const {
+  CHECK(pin);
+  const auto mapping = static_cast<const PayloadMapping*>(pin);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  CHECK_LE(0, string_id);
+  CHECK_LT(string_id, static_cast<int32_t>(str_count_));
+  const StringIdxEntry* str_meta = offset_map_ + string_id;
+  CHECK(str_meta->size != 0xffff);
+  if (str_meta->off + str_meta->size > mapping->size) {
+    return {};
+  }
+  return {mapping->addr + str_meta->off, str_meta->size};
+}
+
+StringDictionary::PinnedStringViews StringDictionary::getStringViews(
+    const int32_t begin_id,
+    const int32_t end_id) const {
+  CHECK(!client_);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  // Pinned under the same lock as the views are taken, no remap in between.
+  PinnedStringViews pinned_views{payload_mapping_, {}};
+  CHECK(pinned_views.pin);
+  CHECK_LE(0, begin_id);
+  CHECK_LE(begin_id, end_id);
+  CHECK_LE(end_id, static_cast<int32_t>(str_count_));
+  pinned_views.views.reserve(end_id - begin_id);
+  for (int32_t string_id = begin_id; string_id < end_id; ++string_id) {
+    pinned_views.views.push_back(getStringViewChecked(string_id));
+  }
+  return pinned_views;
+}
+
 size_t StringDictionary::storageEntryCount() const {
   mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   if (client_) {
@@ -402,22 +557,22 @@ size_t StringDictionary::storageEntryCount() const {
 
 namespace {
 
-bool is_like(const std::string& str,
+bool is_like(const boost::string_view str,
              const std::string& pattern,
              const bool icase,
              const bool is_simple,
              const char escape) {
   return icase
              ? (is_simple ? string_ilike_simple(
-                                str.c_str(), str.size(), pattern.c_str(), pattern.size())
-                          : string_ilike(str.c_str(),
+                                str.data(), str.size(), pattern.c_str(), pattern.size())
+                          : string_ilike(str.data(),
                                          str.size(),
                                          pattern.c_str(),
                                          pattern.size(),
                                          escape))
              : (is_simple ? string_like_simple(
-                                str.c_str(), str.size(), pattern.c_str(), pattern.size())
-                          : string_like(str.c_str(),
+                                str.data(), str.size(), pattern.c_str(), pattern.size())
+                          : string_like(str.data(),
                                         str.size(),
                                         pattern.c_str(),
                                         pattern.size(),
@@ -426,40 +581,44 @@ bool is_like(const std::string& str,
 
 }  // namespace
 
-std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
-                                               const bool icase,
-                                               const bool is_simple,
-                                               const char escape,
-                                               const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-  if (client_) {
-    return client_->get_like(pattern, icase, is_simple, escape, generation);
-  }
-  const auto cache_key = std::make_tuple(pattern, icase, is_simple, escape);
-  const auto it = like_cache_.find(cache_key);
-  if (it != like_cache_.end()) {
-    return it->second;
+template <typename F>
+std::vector<int32_t> StringDictionary::getMatchingIds(
+    const std::vector<std::string>& literals,
+    const size_t begin_id,
+    const size_t end_id,
+    F matches) const {
+  CHECK_LE(end_id, str_count_);
+  std::vector<int32_t> candidates;
+  const auto trigram_index = getTrigramIndex();
+  // Only the strings with all the trigrams of the literals can match, if there are any.
+  const bool use_candidates =
+      trigram_index && trigram_index->getCandidates(literals, end_id, candidates);
+  if (use_candidates) {
+    candidates.erase(
+        candidates.begin(),
+        std::lower_bound(candidates.begin(), candidates.end(), begin_id));
   }
-  std::vector<int32_t> result;
+  const size_t id_count = use_candidates ? candidates.size() : end_id - begin_id;
   std::vector<std::thread> workers;
   int worker_count = cpu_threads();
   CHECK_GT(worker_count, 0);
+  if (use_candidates) {
+    worker_count = std::min<int>(worker_count, id_count / 1000 + 1);
+  }
   std::vector<std::vector<int32_t>> worker_results(worker_count);
-  CHECK_LE(generation, str_count_);
   for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
     workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          icase,
-                          is_simple,
-                          escape,
+                          &candidates,
+                          &matches,
+                          use_candidates,
+                          begin_id,
+                          id_count,
                           worker_idx,
                           worker_count,
                           this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_like(str, pattern, icase, is_simple, escape)) {
+      for (size_t i = worker_idx; i < id_count; i += worker_count) {
+        const int32_t string_id = use_candidates ? candidates[i] : begin_id + i;
+        if (matches(getStringViewChecked(string_id))) {
           worker_results[worker_idx].push_back(string_id);
         }
       }
@@ -468,72 +627,82 @@ std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
   for (auto& worker : workers) {
     worker.join();
   }
+  std::vector<int32_t> result;
   for (const auto& worker_result : worker_results) {
     result.insert(result.end(), worker_result.begin(), worker_result.end());
   }
-  // place result into cache for reuse if similar query
-  const auto it_ok = like_cache_.insert(std::make_pair(cache_key, result));
+  std::sort(result.begin(), result.end());
+  return result;
+}
 
-  CHECK(it_ok.second);
+template <typename F>
+std::vector<int32_t> StringDictionary::getCachedMatchingIds(
+    const std::string& cache_key,
+    const std::vector<std::string>& literals,
+    const size_t generation,
+    F matches) const {
+  CHECK_LE(generation, str_count_);
+  auto cached = predicate_cache_.get(cache_key);
+  if (!cached || cached->covered_count < generation) {
+    // Only the strings added since the cached result was computed are matched.
+    auto extended = std::make_shared<CachedMatches>();
+    size_t begin_id{0};
+    if (cached) {
+      extended->ids = cached->ids;
+      begin_id = cached->covered_count;
+    }
+    const auto new_ids = getMatchingIds(literals, begin_id, generation, matches);
+    extended->ids.insert(extended->ids.end(), new_ids.begin(), new_ids.end());
+    extended->covered_count = generation;
+    predicate_cache_.put(cache_key,
+                         extended,
+                         sizeof(CachedMatches) + cache_key.size() +
+                             extended->ids.size() * sizeof(int32_t));
+    cached = extended;
+  }
+  return std::vector<int32_t>(
+      cached->ids.begin(),
+      std::lower_bound(cached->ids.begin(), cached->ids.end(), generation));
+}
 
-  return result;
+std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
+                                               const bool icase,
+                                               const bool is_simple,
+                                               const char escape,
+                                               const size_t generation) const {
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  if (client_) {
+    return client_->get_like(pattern, icase, is_simple, escape, generation);
+  }
+  const auto cache_key = std::string{'L', icase, is_simple, escape} + pattern;
+  return getCachedMatchingIds(
+      cache_key,
+      TrigramIndex::getLikeLiterals(pattern, is_simple, escape),
+      generation,
+      [&pattern, icase, is_simple, escape](const boost::string_view str) {
+        return is_like(str, pattern, icase, is_simple, escape);
+      });
 }
 
 std::vector<int32_t> StringDictionary::getEquals(std::string pattern,
                                                  std::string comp_operator,
                                                  size_t generation) {
   std::vector<int32_t> result;
-  auto eq_id_itr = equal_cache_.find(pattern);
-  int32_t eq_id = MAX_STRLEN + 1;
+  int32_t eq_id = getUnlocked(pattern);
+  if (eq_id != INVALID_STR_ID && static_cast<size_t>(eq_id) >= generation) {
+    eq_id = INVALID_STR_ID;
+  }
   int32_t cur_size = str_count_;
-  if (eq_id_itr != equal_cache_.end()) {
-    auto eq_id = eq_id_itr->second;
-    if (comp_operator == "=") {
+  if (comp_operator == "=") {
+    if (eq_id != INVALID_STR_ID) {
       result.push_back(eq_id);
-    } else {
-      for (int32_t idx = 0; idx <= cur_size; idx++) {
-        if (idx == eq_id) {
-          continue;
-        }
-        result.push_back(idx);
-      }
     }
   } else {
-    std::vector<std::thread> workers;
-    int worker_count = cpu_threads();
-    CHECK_GT(worker_count, 0);
-    std::vector<std::vector<int32_t>> worker_results(worker_count);
-    CHECK_LE(generation, str_count_);
-    for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
-      workers.emplace_back(
-          [&worker_results, &pattern, generation, worker_idx, worker_count, this]() {
-            for (size_t string_id = worker_idx; string_id < generation;
-                 string_id += worker_count) {
-              const auto str = getStringUnlocked(string_id);
-              if (str == pattern) {
-                worker_results[worker_idx].push_back(string_id);
-              }
-            }
-          });
-    }
-    for (auto& worker : workers) {
-      worker.join();
-    }
-    for (const auto& worker_result : worker_results) {
-      result.insert(result.end(), worker_result.begin(), worker_result.end());
-    }
-    if (result.size() > 0) {
-      const auto it_ok = equal_cache_.insert(std::make_pair(pattern, result[0]));
-      CHECK(it_ok.second);
-      eq_id = result[0];
-    }
-    if (comp_operator == "<>") {
-      for (int32_t idx = 0; idx <= cur_size; idx++) {
-        if (idx == eq_id) {
-          continue;
-        }
-        result.push_back(idx);
+    for (int32_t idx = 0; idx <= cur_size; idx++) {
+      if (idx == eq_id) {
+        continue;
       }
+      result.push_back(idx);
     }
   }
   return result;
@@ -692,10 +861,10 @@ std::vector<int32_t> StringDictionary::getCompare(const std::string& pattern,
 
 namespace {
 
-bool is_regexp_like(const std::string& str,
+bool is_regexp_like(const boost::string_view str,
                     const std::string& pattern,
                     const char escape) {
-  return regexp_like(str.c_str(), str.size(), pattern.c_str(), pattern.size(), escape);
+  return regexp_like(str.data(), str.size(), pattern.c_str(), pattern.size(), escape);
 }
 
 }  // namespace
@@ -703,100 +872,75 @@ bool is_regexp_like(const std::string& str,
 std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
                                                      const char escape,
                                                      const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   if (client_) {
     return client_->get_regexp_like(pattern, escape, generation);
   }
-  const auto cache_key = std::make_pair(pattern, escape);
-  const auto it = regex_cache_.find(cache_key);
-  if (it != regex_cache_.end()) {
-    return it->second;
-  }
-  std::vector<int32_t> result;
-  std::vector<std::thread> workers;
-  int worker_count = cpu_threads();
-  CHECK_GT(worker_count, 0);
-  std::vector<std::vector<int32_t>> worker_results(worker_count);
-  CHECK_LE(generation, str_count_);
-  for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
-    workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          escape,
-                          worker_idx,
-                          worker_count,
-                          this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_regexp_like(str, pattern, escape)) {
-          worker_results[worker_idx].push_back(string_id);
-        }
-      }
-    });
-  }
-  for (auto& worker : workers) {
-    worker.join();
-  }
-  for (const auto& worker_result : worker_results) {
-    result.insert(result.end(), worker_result.begin(), worker_result.end());
-  }
-  const auto it_ok = regex_cache_.insert(std::make_pair(cache_key, result));
-  CHECK(it_ok.second);
-
-  return result;
+  const auto cache_key = std::string{'R', escape} + pattern;
+  return getCachedMatchingIds(cache_key,
+                              TrigramIndex::getRegexpLiterals(pattern),
+                              generation,
+                              [&pattern, escape](const boost::string_view str) {
+                                return is_regexp_like(str, pattern, escape);
+                              });
 }
 
-std::shared_ptr<const std::vector<std::string>> StringDictionary::copyStrings() const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-  if (client_) {
-    // TODO(miyu): support remote string dictionary
-    throw std::runtime_error(
-        "copying dictionaries from remote server is not supported yet.");
+std::shared_ptr<const std::vector<int32_t>> StringDictionary::getTranslationMap(
+    const StringDictionary* dest,
+    const size_t source_count,
+    const size_t dest_count) const {
+  CHECK(dest);
+  if (client_ || dest->client_) {
+    return nullptr;
   }
-
-  if (strings_cache_) {
-    return strings_cache_;
+  const auto cache_key = std::to_string(dest->instance_id_) + ':' +
+                         std::to_string(source_count) + ':' + std::to_string(dest_count);
+  auto cached = translation_cache_.get(cache_key);
+  if (cached) {
+    return cached;
   }
-
-  strings_cache_ = std::make_shared<std::vector<std::string>>();
-  strings_cache_->reserve(str_count_);
-  const bool multithreaded = str_count_ > 10000;
-  const auto worker_count =
-      multithreaded ? static_cast<size_t>(cpu_threads()) : size_t(1);
-  CHECK_GT(worker_count, 0);
-  std::vector<std::vector<std::string>> worker_results(worker_count);
-  auto copy = [this](std::vector<std::string>& str_list,
-                     const size_t start_id,
-                     const size_t end_id) {
-    CHECK_LE(start_id, end_id);
-    str_list.reserve(end_id - start_id);
-    for (size_t string_id = start_id; string_id < end_id; ++string_id) {
-      str_list.push_back(getStringUnlocked(string_id));
-    }
-  };
-  if (multithreaded) {
+  // Several threads building the same hash table ask for the same map.
+  std::lock_guard<std::mutex> translation_lock(translation_mutex_);
+  cached = translation_cache_.get(cache_key);
+  if (cached) {
+    return cached;
+  }
+  auto translation_map =
+      std::make_shared<std::vector<int32_t>>(source_count, INVALID_STR_ID);
+  if (dest == this) {
+    std::iota(translation_map->begin(),
+              translation_map->begin() + std::min(source_count, dest_count),
+              0);
+  } else {
+    const auto source_strings = getStringViews(0, source_count);
+    mapd_shared_lock<mapd_shared_mutex> dest_read_lock(dest->rw_mutex_);
+    const size_t worker_count =
+        std::min<size_t>(cpu_threads(), source_count / 10000 + 1);
+    const size_t ids_per_worker = (source_count + worker_count - 1) / worker_count;
     std::vector<std::future<void>> workers;
-    const auto stride = (str_count_ + (worker_count - 1)) / worker_count;
-    for (size_t worker_idx = 0, start = 0, end = std::min(start + stride, str_count_);
-         worker_idx < worker_count && start < str_count_;
-         ++worker_idx, start += stride, end = std::min(start + stride, str_count_)) {
-      workers.push_back(std::async(
-          std::launch::async, copy, std::ref(worker_results[worker_idx]), start, end));
+    for (size_t begin = 0; begin < source_count; begin += ids_per_worker) {
+      const size_t end = std::min(begin + ids_per_worker, source_count);
+      workers.emplace_back(std::async(std::launch::async, [&, begin, end] {
+        for (size_t string_id = begin; string_id < end; ++string_id) {
+          const auto dest_id = dest->getUnlocked(source_strings.views[string_id]);
+          if (dest_id != INVALID_STR_ID && static_cast<size_t>(dest_id) < dest_count) {
+            (*translation_map)[string_id] = dest_id;
+          }
+        }
+      }));
     }
     for (auto& worker : workers) {
       worker.get();
     }
-  } else {
-    CHECK_EQ(worker_results.size(), size_t(1));
-    copy(worker_results[0], 0, str_count_);
   }
+  translation_cache_.put(cache_key,
+                         translation_map,
+                         cache_key.size() + source_count * sizeof(int32_t));
+  return translation_map;
+}
 
-  for (const auto& worker_result : worker_results) {
-    strings_cache_->insert(
-        strings_cache_->end(), worker_result.begin(), worker_result.end());
-  }
-  return strings_cache_;
+LruCacheStats StringDictionary::getPredicateCacheStats() const {
+  return predicate_cache_.getStats();
 }
 
 bool StringDictionary::fillRateIsHigh() const noexcept {
@@ -817,13 +961,13 @@ void StringDictionary::increaseCapacity() noexcept {
     rk_hashes_.resize(rk_hashes_.size() * 2);
   } else {
     for (size_t i = 0; i < str_count_; ++i) {
-      const auto str = getStringChecked(i);
-      const uint32_t hash = rk_hash(str);
+      const uint32_t hash = rk_hash(getStringViewChecked(i));
       uint32_t bucket = computeUniqueBucketWithHash(hash, new_str_ids);
       new_str_ids[bucket] = i;
     }
   }
   str_ids_.swap(new_str_ids);
+  hash_table_resized_ = true;
 }
 
 int32_t StringDictionary::getOrAddImpl(const std::string& str) noexcept {
@@ -858,6 +1002,7 @@ int32_t StringDictionary::getOrAddImpl(const std::string& str) noexcept {
     }
     appendToStorage(str);
     str_ids_[bucket] = static_cast<int32_t>(str_count_);
+    markHashTableDirty(bucket);
     if (materialize_hashes_) {
       rk_hashes_[str_count_] = hash;
     }
@@ -873,6 +1018,13 @@ std::string StringDictionary::getStringChecked(const int string_id) const noexce
   return std::string(str_canary.c_str_ptr, str_canary.size);
 }
 
+boost::string_view StringDictionary::getStringViewChecked(const int string_id) const
+    noexcept {
+  const auto str_canary = getStringFromStorage(string_id);
+  CHECK(!str_canary.canary);
+  return {str_canary.c_str_ptr, str_canary.size};
+}
+
 std::pair<char*, size_t> StringDictionary::getStringBytesChecked(
     const int string_id) const noexcept {
   const auto str_canary = getStringFromStorage(string_id);
@@ -881,7 +1033,7 @@ std::pair<char*, size_t> StringDictionary::getStringBytesChecked(
 }
 
 uint32_t StringDictionary::computeBucket(const uint32_t hash,
-                                         const std::string str,
+                                         const boost::string_view str,
                                          const std::vector<int32_t>& data,
                                          const bool unique) const noexcept {
   auto bucket = hash & (data.size() - 1);
@@ -898,7 +1050,7 @@ uint32_t StringDictionary::computeBucket(const uint32_t hash,
           // can't be the same string if hash is different
           const auto old_str = getStringFromStorage(data[bucket]);
           if (str.size() == old_str.size &&
-              !memcmp(str.c_str(), old_str.c_str_ptr, str.size())) {
+              !memcmp(str.data(), old_str.c_str_ptr, str.size())) {
             // found the string
             break;
           }
@@ -906,7 +1058,7 @@ uint32_t StringDictionary::computeBucket(const uint32_t hash,
       } else {
         const auto old_str = getStringFromStorage(data[bucket]);
         if (str.size() == old_str.size &&
-            !memcmp(str.c_str(), old_str.c_str_ptr, str.size())) {
+            !memcmp(str.data(), old_str.c_str_ptr, str.size())) {
           // found the string
           break;
         }
@@ -945,11 +1097,11 @@ void StringDictionary::appendToStorage(const std::string& str) noexcept {
   // write the payload
   if (payload_file_off_ + str.size() > payload_file_size_) {
     if (!isTemp_) {
-      checked_munmap(payload_map_, payload_file_size_);
       addPayloadCapacity();
       CHECK(payload_file_off_ + str.size() <= payload_file_size_);
-      payload_map_ =
-          reinterpret_cast<char*>(checked_mmap(payload_fd_, payload_file_size_));
+      // The previous mapping is unmapped right away unless pinned.
+      setPayloadMapping(
+          reinterpret_cast<char*>(checked_mmap(payload_fd_, payload_file_size_)));
     } else {
       addPayloadCapacity();
     }
@@ -971,6 +1123,9 @@ void StringDictionary::appendToStorage(const std::string& str) noexcept {
     }
   }
   memcpy(offset_map_ + str_count_, &str_meta, sizeof(str_meta));
+  if (trigram_index_ && trigram_index_->getIndexedCount() == str_count_) {
+    trigram_index_->add(str_count_, str.c_str(), str.size());
+  }
 }
 
 StringDictionary::PayloadString StringDictionary::getStringFromStorage(
@@ -991,9 +1146,25 @@ StringDictionary::PayloadString StringDictionary::getStringFromStorage(
 void StringDictionary::addPayloadCapacity() noexcept {
   if (!isTemp_) {
     payload_file_size_ += addStorageCapacity(payload_fd_);
+  } else if (payload_mapping_ && payload_mapping_.use_count() > 1) {
+    // Pinned, moved to a new buffer rather than reallocated. Twice as large for the
+    // pinned buffers not to add up to more than the payload.
+    CHECK_GT(payload_file_size_, size_t(0));
+    auto new_payload = static_cast<char*>(malloc(2 * payload_file_size_));
+    CHECK(new_payload);
+    memcpy(new_payload, payload_map_, payload_file_size_);
+    memset(new_payload + payload_file_size_, 0xff, payload_file_size_);
+    payload_file_size_ *= 2;
+    setPayloadMapping(new_payload);
   } else {
     payload_map_ =
         static_cast<char*>(addMemoryCapacity(payload_map_, payload_file_size_));
+    if (payload_mapping_) {
+      payload_mapping_->addr = payload_map_;
+      payload_mapping_->size = payload_file_size_;
+    } else {
+      setPayloadMapping(payload_map_);
+    }
   }
 }
 
@@ -1033,21 +1204,215 @@ void* StringDictionary::addMemoryCapacity(void* addr, size_t& mem_size) noexcept
   return new_addr;
 }
 
+void StringDictionary::setPayloadMapping(char* payload) noexcept {
+  // Called under the write lock, no pin can be taken meanwhile. The mapping replaced is
+  // released along with its last pin.
+  payload_map_ = payload;
+  payload_mapping_ = std::shared_ptr<PayloadMapping>(
+      new PayloadMapping{payload_map_, payload_file_size_, isTemp_});
+}
+
 void StringDictionary::invalidateInvertedIndex() noexcept {
-  if (!like_cache_.empty()) {
-    decltype(like_cache_)().swap(like_cache_);
+  // The LIKE and REGEXP results are extended on lookup instead, the positions in the
+  // sorted cache are shifted by the new strings.
+  compare_cache_.invalidateInvertedIndex();
+}
+
+const TrigramIndex* StringDictionary::getTrigramIndex() const {
+  // The caller holds the read lock, the index is only modified under the write lock
+  // once it's caught up with the dictionary.
+  if (!g_enable_string_dict_trigram_index || trigrams_path_.empty()) {
+    return nullptr;
   }
-  if (!regex_cache_.empty()) {
-    decltype(regex_cache_)().swap(regex_cache_);
+  std::lock_guard<std::mutex> trigram_index_lock(trigram_index_mutex_);
+  if (!trigram_index_) {
+    trigram_index_.reset(new TrigramIndex(trigrams_path_));
+    trigram_index_->load(str_count_);
   }
-  if (!equal_cache_.empty()) {
-    decltype(equal_cache_)().swap(equal_cache_);
+  const auto indexed_count = trigram_index_->getIndexedCount();
+  if (indexed_count < str_count_) {
+    auto clock_begin = timer_start();
+    trigram_index_->addRange(str_count_, [this](const int32_t string_id) {
+      const auto str = getStringFromStorage(string_id);
+      return std::pair<const char*, size_t>(str.c_str_ptr, str.size);
+    });
+    LOG(INFO) << "Indexed the trigrams of " << str_count_ - indexed_count
+              << " strings of " << trigrams_path_ << " in " << timer_stop(clock_begin)
+              << "ms";
   }
-  compare_cache_.invalidateInvertedIndex();
+  return trigram_index_.get();
 }
 
 char* StringDictionary::CANARY_BUFFER{nullptr};
 
+bool StringDictionary::loadHashTable() {
+  boost::system::error_code ec;
+  if (!boost::filesystem::exists(hashes_path_, ec)) {
+    return false;
+  }
+  const auto fd = open(hashes_path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  const size_t hashes_file_size = file_size(fd);
+  DictHashesHeader header;
+  const size_t entry_count = offset_file_size_ / sizeof(StringIdxEntry);
+  bool valid = pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+               header.magic == dict_hashes_magic &&
+               header.format_version == dict_hashes_format_version && header.valid &&
+               header.checksum == header_checksum(header) &&
+               (header.has_rk_hashes || !materialize_hashes_) &&
+               header.str_count <= entry_count &&
+               header.bucket_count > header.str_count &&
+               (header.bucket_count & (header.bucket_count - 1)) == 0 &&
+               hashes_file_size >=
+                   dict_hashes_page_size + header.bucket_count * sizeof(int32_t) +
+                       (header.has_rk_hashes ? header.str_count * sizeof(uint32_t) : 0);
+  if (valid && header.str_count) {
+    // The table is stale if the strings it covers don't end where the header says.
+    const auto last = getStringFromStorage(header.str_count - 1);
+    valid = !last.canary &&
+            offset_map_[header.str_count - 1].off + last.size == header.payload_size;
+  }
+  if (!valid) {
+    LOG(WARNING) << "Hash table " << hashes_path_
+                 << " is stale or corrupt, rebuilding it";
+    close(fd);
+    return false;
+  }
+  auto clock_begin = timer_start();
+  const size_t map_size = hashes_file_size;
+  auto map = reinterpret_cast<const int8_t*>(
+      mmap(nullptr, map_size, PROT_READ, MAP_SHARED, fd, 0));
+  close(fd);
+  CHECK(map != reinterpret_cast<const int8_t*>(-1));
+  const auto buckets = reinterpret_cast<const int32_t*>(map + dict_hashes_page_size);
+  // The checksum only covers the header: every string must be in exactly one bucket,
+  // lookups would read out of the offsets with an id out of range.
+  size_t bucket_str_count{0};
+  bool buckets_valid{true};
+  for (size_t bucket = 0; buckets_valid && bucket < header.bucket_count; ++bucket) {
+    const auto str_id = buckets[bucket];
+    if (str_id != INVALID_STR_ID) {
+      buckets_valid = str_id >= 0 && static_cast<uint64_t>(str_id) < header.str_count;
+      ++bucket_str_count;
+    }
+  }
+  if (!buckets_valid || bucket_str_count != header.str_count) {
+    checked_munmap(const_cast<int8_t*>(map), map_size);
+    LOG(WARNING) << "Hash table " << hashes_path_ << " is corrupt, rebuilding it";
+    return false;
+  }
+  str_ids_.assign(buckets, buckets + header.bucket_count);
+  if (materialize_hashes_) {
+    const auto hashes =
+        reinterpret_cast<const uint32_t*>(buckets + header.bucket_count);
+    rk_hashes_.assign(hashes, hashes + header.str_count);
+    rk_hashes_.resize(header.bucket_count);
+  }
+  checked_munmap(const_cast<int8_t*>(map), map_size);
+  str_count_ = header.str_count;
+  payload_file_off_ = header.payload_size;
+  hash_table_resized_ = false;
+  hash_table_dirty_pages_.assign(
+      (str_ids_.size() + buckets_per_page - 1) / buckets_per_page, false);
+  persisted_hash_count_ = str_count_;
+  // The strings added after the last checkpoint.
+  for (size_t string_id = str_count_; string_id < entry_count; ++string_id) {
+    const auto recovered = getStringFromStorage(string_id);
+    if (recovered.canary) {
+      break;
+    }
+    if (fillRateIsHigh()) {
+      increaseCapacity();
+    }
+    const auto hash = rk_hash({recovered.c_str_ptr, recovered.size});
+    const auto bucket = computeUniqueBucketWithHash(hash, str_ids_);
+    str_ids_[bucket] = static_cast<int32_t>(str_count_);
+    markHashTableDirty(bucket);
+    if (materialize_hashes_) {
+      rk_hashes_[str_count_] = hash;
+    }
+    payload_file_off_ += recovered.size;
+    ++str_count_;
+  }
+  LOG(INFO) << "Loaded the hash table of " << header.str_count << " strings from "
+            << hashes_path_ << " in " << timer_stop(clock_begin) << "ms, "
+            << str_count_ - header.str_count << " strings added since";
+  return true;
+}
+
+bool StringDictionary::writeHashTable() noexcept {
+  if (hashes_path_.empty() ||
+      (!hash_table_resized_ && persisted_hash_count_ == str_count_)) {
+    return true;
+  }
+  const auto fd = open(hashes_path_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) {
+    LOG(ERROR) << "Could not open hash table " << hashes_path_;
+    return false;
+  }
+  DictHashesHeader header{dict_hashes_magic,
+                          dict_hashes_format_version,
+                          str_count_,
+                          payload_file_off_,
+                          str_ids_.size(),
+                          materialize_hashes_,
+                          0,
+                          0};
+  // Invalidated first, a table which isn't completely written is rebuilt on open.
+  header.checksum = header_checksum(header);
+  bool ret = checked_pwrite(fd, &header, sizeof(header), 0) && fsync(fd) == 0;
+  const size_t table_bytes = str_ids_.size() * sizeof(int32_t);
+  if (hash_table_resized_) {
+    ret = ret && ftruncate(fd, dict_hashes_page_size + table_bytes) == 0 &&
+          checked_pwrite(fd, str_ids_.data(), table_bytes, dict_hashes_page_size);
+    persisted_hash_count_ = 0;
+  } else {
+    for (size_t page = 0; ret && page < hash_table_dirty_pages_.size(); ++page) {
+      if (!hash_table_dirty_pages_[page]) {
+        continue;
+      }
+      const size_t first_bucket = page * buckets_per_page;
+      const size_t bucket_count =
+          std::min(buckets_per_page, str_ids_.size() - first_bucket);
+      ret = checked_pwrite(fd,
+                           str_ids_.data() + first_bucket,
+                           bucket_count * sizeof(int32_t),
+                           dict_hashes_page_size + first_bucket * sizeof(int32_t));
+    }
+  }
+  if (materialize_hashes_ && str_count_ > persisted_hash_count_) {
+    ret = ret && checked_pwrite(fd,
+                                rk_hashes_.data() + persisted_hash_count_,
+                                (str_count_ - persisted_hash_count_) * sizeof(uint32_t),
+                                dict_hashes_page_size + table_bytes +
+                                    persisted_hash_count_ * sizeof(uint32_t));
+  }
+  header.valid = 1;
+  header.checksum = header_checksum(header);
+  ret = ret && fsync(fd) == 0 && checked_pwrite(fd, &header, sizeof(header), 0) &&
+        fsync(fd) == 0;
+  close(fd);
+  if (!ret) {
+    LOG(ERROR) << "Could not write hash table " << hashes_path_;
+    // Written again in full by the next checkpoint.
+    hash_table_resized_ = true;
+    return false;
+  }
+  hash_table_resized_ = false;
+  hash_table_dirty_pages_.assign(
+      (str_ids_.size() + buckets_per_page - 1) / buckets_per_page, false);
+  persisted_hash_count_ = str_count_;
+  return true;
+}
+
+void StringDictionary::markHashTableDirty(const uint32_t bucket) noexcept {
+  if (!hash_table_resized_ && !hashes_path_.empty()) {
+    hash_table_dirty_pages_[bucket / buckets_per_page] = true;
+  }
+}
+
 bool StringDictionary::checkpoint() noexcept {
   if (client_) {
     try {
@@ -1057,11 +1422,24 @@ bool StringDictionary::checkpoint() noexcept {
     }
   }
   CHECK(!isTemp_);
+  size_t synced_count{0};
+  {
+    // The strings below this count are in the maps synced below.
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    synced_count = str_count_;
+  }
   bool ret = true;
   ret = ret && (msync((void*)offset_map_, offset_file_size_, MS_SYNC) == 0);
   ret = ret && (msync((void*)payload_map_, payload_file_size_, MS_SYNC) == 0);
   ret = ret && (fsync(offset_fd_) == 0);
   ret = ret && (fsync(payload_fd_) == 0);
+  if (ret) {
+    mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+    ret = writeHashTable();
+    if (ret && trigram_index_) {
+      ret = trigram_index_->checkpoint(synced_count);
+    }
+  }
   return ret;
 }
 
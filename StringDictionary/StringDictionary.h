@@ -18,15 +18,19 @@
 #define STRINGDICTIONARY_STRINGDICTIONARY_H
 
 #include "../Shared/mapd_shared_mutex.h"
+#include "ConcurrentLruCache.hpp"
 #include "DictRef.h"
 #include "DictionaryCache.hpp"
 #include "LeafHostInfo.h"
+#include "TrigramIndex.h"
 
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <boost/utility/string_view.hpp>
 
+#include <atomic>
 #include <future>
 #include <map>
 #include <string>
@@ -60,6 +64,31 @@ class StringDictionary {
   std::pair<char*, size_t> getStringBytes(int32_t string_id) const noexcept;
   size_t storageEntryCount() const;
 
+  // Keeps the current payload mapping alive, the strings added meanwhile remap the
+  // payload to a new address but leave the pinned mapping alone. Each mapping is
+  // released along with its last pin. Null for a remote dictionary or one without
+  // storage, such as the dictionary of the literals.
+  std::shared_ptr<const void> pinPayload() const;
+
+  // View of the string in the payload. Moves the pin to the current mapping first if
+  // the payload has been remapped since it was taken; the view is valid as long as the
+  // pin it returns with.
+  boost::string_view getStringView(const int32_t string_id,
+                                   std::shared_ptr<const void>& pin) const;
+
+  // View of the string in the mapping pinned by pin, which the caller keeps alive. The
+  // data of the view is null if the string has been added past the end of the mapping.
+  boost::string_view getPinnedStringView(const int32_t string_id,
+                                         const void* pin) const;
+
+  struct PinnedStringViews {
+    std::shared_ptr<const void> pin;
+    std::vector<boost::string_view> views;
+  };
+
+  // Views of the strings with ids in [begin_id, end_id), along with their pin.
+  PinnedStringViews getStringViews(const int32_t begin_id, const int32_t end_id) const;
+
   std::vector<int32_t> getLike(const std::string& pattern,
                                const bool icase,
                                const bool is_simple,
@@ -74,7 +103,16 @@ class StringDictionary {
                                      const char escape,
                                      const size_t generation) const;
 
-  std::shared_ptr<const std::vector<std::string>> copyStrings() const;
+  // Ids in dest of the first source_count strings, INVALID_STR_ID for those which aren't
+  // among the first dest_count strings of dest. Built in parallel and cached for the pair
+  // of dictionaries and counts. Null if either dictionary is remote.
+  std::shared_ptr<const std::vector<int32_t>> getTranslationMap(
+      const StringDictionary* dest,
+      const size_t source_count,
+      const size_t dest_count) const;
+
+  // Hits, misses and memory used by the cached results of the LIKE and REGEXP lookups.
+  LruCacheStats getPredicateCacheStats() const;
 
   bool checkpoint() noexcept;
 
@@ -97,6 +135,12 @@ class StringDictionary {
     int32_t diff;
   };
 
+  // Sorted ids of the strings matching a predicate among the first covered_count ones.
+  struct CachedMatches {
+    std::vector<int32_t> ids;
+    size_t covered_count;
+  };
+
   struct PayloadString {
     char* c_str_ptr;
     size_t size;
@@ -111,12 +155,13 @@ class StringDictionary {
   int32_t getOrAddImpl(const std::string& str) noexcept;
   template <class T>
   void getOrAddBulkRemote(const std::vector<std::string>& string_vec, T* encoded_vec);
-  int32_t getUnlocked(const std::string& str) const noexcept;
+  int32_t getUnlocked(const boost::string_view str) const noexcept;
   std::string getStringUnlocked(int32_t string_id) const noexcept;
   std::string getStringChecked(const int string_id) const noexcept;
+  boost::string_view getStringViewChecked(const int string_id) const noexcept;
   std::pair<char*, size_t> getStringBytesChecked(const int string_id) const noexcept;
   uint32_t computeBucket(const uint32_t hash,
-                         const std::string str,
+                         const boost::string_view str,
                          const std::vector<int32_t>& data,
                          const bool unique) const noexcept;
   uint32_t computeUniqueBucketWithHash(const uint32_t hash,
@@ -127,7 +172,22 @@ class StringDictionary {
   void addOffsetCapacity() noexcept;
   size_t addStorageCapacity(int fd) noexcept;
   void* addMemoryCapacity(void* addr, size_t& mem_size) noexcept;
+  void setPayloadMapping(char* payload) noexcept;
   void invalidateInvertedIndex() noexcept;
+  bool loadHashTable();
+  bool writeHashTable() noexcept;
+  void markHashTableDirty(const uint32_t bucket) noexcept;
+  const TrigramIndex* getTrigramIndex() const;
+  template <typename F>
+  std::vector<int32_t> getMatchingIds(const std::vector<std::string>& literals,
+                                      const size_t begin_id,
+                                      const size_t end_id,
+                                      F matches) const;
+  template <typename F>
+  std::vector<int32_t> getCachedMatchingIds(const std::string& cache_key,
+                                            const std::vector<std::string>& literals,
+                                            const size_t generation,
+                                            F matches) const;
   std::vector<int32_t> getEquals(std::string pattern,
                                  std::string comp_operator,
                                  size_t generation);
@@ -144,6 +204,13 @@ class StringDictionary {
   bool isTemp_;
   bool materialize_hashes_;
   std::string offsets_path_;
+  std::string trigrams_path_;
+  std::string hashes_path_;
+  // Whether the whole hash table has to be written on checkpoint, or only its dirty
+  // pages and the hashes of the strings added since the last one.
+  bool hash_table_resized_;
+  std::vector<bool> hash_table_dirty_pages_;
+  size_t persisted_hash_count_;
   int payload_fd_;
   int offset_fd_;
   StringIdxEntry* offset_map_;
@@ -152,14 +219,23 @@ class StringDictionary {
   size_t payload_file_size_;
   size_t payload_file_off_;
   mutable mapd_shared_mutex rw_mutex_;
-  mutable std::map<std::tuple<std::string, bool, bool, char>, std::vector<int32_t>>
-      like_cache_;
-  mutable std::map<std::pair<std::string, char>, std::vector<int32_t>> regex_cache_;
-  mutable std::map<std::string, int32_t> equal_cache_;
+  // Results of the LIKE and REGEXP lookups, extended with the strings added since.
+  mutable ConcurrentLruCache<std::string, CachedMatches> predicate_cache_;
+  // Translation maps to other dictionaries, by destination and counts.
+  mutable ConcurrentLruCache<std::string, std::vector<int32_t>> translation_cache_;
+  mutable std::mutex translation_mutex_;
   mutable DictionaryCache<std::string, compare_cache_value_t> compare_cache_;
-  mutable std::shared_ptr<std::vector<std::string>> strings_cache_;
+  // Built on the first LIKE or REGEXP lookup, kept up to date by appendToStorage after.
+  mutable std::unique_ptr<TrigramIndex> trigram_index_;
+  mutable std::mutex trigram_index_mutex_;
+  // Owns payload_map_. Pins are copies taken under the read lock, the payload is only
+  // remapped under the write lock.
+  struct PayloadMapping;
+  std::shared_ptr<PayloadMapping> payload_mapping_;
   std::unique_ptr<StringDictionaryClient> client_;
   std::unique_ptr<StringDictionaryClient> client_no_timeout_;
+  // Tells the dictionaries apart in the translation caches, unlike their addresses.
+  const uint64_t instance_id_;
 
   static char* CANARY_BUFFER;
 };
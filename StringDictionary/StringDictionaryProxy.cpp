@@ -28,7 +28,13 @@
 
 StringDictionaryProxy::StringDictionaryProxy(std::shared_ptr<StringDictionary> sd,
                                              const ssize_t generation)
-    : string_dict_(sd), generation_(generation) {}
+    : string_dict_(sd), generation_(generation), payload_pin_(nullptr) {
+  auto pin = sd->pinPayload();
+  if (pin) {
+    payload_pin_ = pin.get();
+    payload_pins_.push_back(std::move(pin));
+  }
+}
 
 int32_t truncate_to_generation(const int32_t id, const size_t generation) {
   if (id == StringDictionary::INVALID_STR_ID) {
@@ -56,10 +62,8 @@ int32_t StringDictionaryProxy::getOrAddTransient(const std::string& str) {
     auto it_ok = transient_str_to_int_.insert(std::make_pair(str, transient_id));
     CHECK(it_ok.second);
   }
-  {
-    auto it_ok = transient_int_to_str_.insert(std::make_pair(transient_id, str));
-    CHECK(it_ok.second);
-  }
+  transient_strings_.push_back(str);
+  transient_count_ = transient_strings_.size();
   return transient_id;
 }
 
@@ -92,9 +96,9 @@ std::string StringDictionaryProxy::getString(int32_t string_id) const {
     return string_dict_->getString(string_id);
   }
   CHECK_NE(StringDictionary::INVALID_STR_ID, string_id);
-  auto it = transient_int_to_str_.find(string_id);
-  CHECK(it != transient_int_to_str_.end());
-  return it->second;
+  const size_t transient_idx = -string_id - 2;
+  CHECK_LT(transient_idx, transient_strings_.size());
+  return transient_strings_[transient_idx];
 }
 
 namespace {
@@ -129,10 +133,12 @@ std::vector<int32_t> StringDictionaryProxy::getLike(const std::string& pattern,
                                                     const char escape) const {
   CHECK_GE(generation_, 0);
   auto result = string_dict_->getLike(pattern, icase, is_simple, escape, generation_);
-  for (const auto& kv : transient_int_to_str_) {
-    const auto str = getString(kv.first);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  for (size_t transient_idx = 0; transient_idx < transient_strings_.size();
+       ++transient_idx) {
+    const auto& str = transient_strings_[transient_idx];
     if (is_like(str, pattern, icase, is_simple, escape)) {
-      result.push_back(kv.first);
+      result.push_back(-static_cast<int32_t>(transient_idx) - 2);
     }
   }
   return result;
@@ -167,10 +173,12 @@ std::vector<int32_t> StringDictionaryProxy::getCompare(
     const std::string& comp_operator) const {
   CHECK_GE(generation_, 0);
   auto result = string_dict_->getCompare(pattern, comp_operator, generation_);
-  for (const auto& kv : transient_int_to_str_) {
-    const auto str = getString(kv.first);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  for (size_t transient_idx = 0; transient_idx < transient_strings_.size();
+       ++transient_idx) {
+    const auto& str = transient_strings_[transient_idx];
     if (do_compare(str, pattern, comp_operator)) {
-      result.push_back(kv.first);
+      result.push_back(-static_cast<int32_t>(transient_idx) - 2);
     }
   }
   return result;
@@ -190,10 +198,12 @@ std::vector<int32_t> StringDictionaryProxy::getRegexpLike(const std::string& pat
                                                           const char escape) const {
   CHECK_GE(generation_, 0);
   auto result = string_dict_->getRegexpLike(pattern, escape, generation_);
-  for (const auto& kv : transient_int_to_str_) {
-    const auto str = getString(kv.first);
+  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+  for (size_t transient_idx = 0; transient_idx < transient_strings_.size();
+       ++transient_idx) {
+    const auto& str = transient_strings_[transient_idx];
     if (is_regexp_like(str, pattern, escape)) {
-      result.push_back(kv.first);
+      result.push_back(-static_cast<int32_t>(transient_idx) - 2);
     }
   }
   return result;
@@ -205,7 +215,47 @@ int32_t StringDictionaryProxy::getOrAdd(const std::string& str) noexcept {
 
 std::pair<char*, size_t> StringDictionaryProxy::getStringBytes(int32_t string_id) const
     noexcept {
-  return string_dict_.get()->getStringBytes(string_id);
+  const auto pin = payload_pin_.load();
+  if (!pin) {
+    return string_dict_.get()->getStringBytes(string_id);
+  }
+  auto str = string_dict_->getPinnedStringView(string_id, pin);
+  if (!str.data()) {
+    // Added after the mapping was pinned, pin the current one. The bytes handed out
+    // before still point into the earlier mappings, they stay pinned too.
+    std::lock_guard<std::mutex> payload_pins_lock(payload_pins_mutex_);
+    auto new_pin = string_dict_->pinPayload();
+    CHECK(new_pin);
+    str = string_dict_->getPinnedStringView(string_id, new_pin.get());
+    CHECK(str.data());
+    payload_pin_ = new_pin.get();
+    payload_pins_.push_back(std::move(new_pin));
+  }
+  return std::make_pair(const_cast<char*>(str.data()), str.size());
+}
+
+const StringDictionaryProxy::TranslationMap* StringDictionaryProxy::getTranslationMap(
+    const StringDictionaryProxy* dest) const {
+  CHECK(dest);
+  std::lock_guard<std::mutex> translation_maps_lock(translation_maps_mutex_);
+  auto& translation_map = translation_maps_[dest];
+  if (!translation_map) {
+    const size_t source_count =
+        generation_ >= 0 ? generation_ : string_dict_->storageEntryCount();
+    const size_t dest_count = dest->generation_ >= 0
+                                  ? dest->generation_
+                                  : dest->string_dict_->storageEntryCount();
+    translation_map.reset(new TranslationMap(
+        this,
+        dest,
+        string_dict_->getTranslationMap(
+            dest->string_dict_.get(), source_count, dest_count)));
+  }
+  return translation_map.get();
+}
+
+size_t StringDictionaryProxy::transientEntryCount() const {
+  return transient_count_;
 }
 
 size_t StringDictionaryProxy::storageEntryCount() const {
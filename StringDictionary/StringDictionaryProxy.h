@@ -24,9 +24,11 @@
 #include "../Shared/mapd_shared_mutex.h"
 #include "StringDictionary.h"
 
-#include <map>
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 // used to access a StringDictionary when transient strings are involved
@@ -56,11 +58,60 @@ class StringDictionaryProxy {
 
   std::vector<int32_t> getRegexpLike(const std::string& pattern, const char escape) const;
 
+  size_t transientEntryCount() const;
+
+  // Translates the ids of a proxy to the ids of the same strings in another one. The
+  // dictionary ids go through a dense array, the transient ones through the proxies.
+  class TranslationMap {
+   public:
+    TranslationMap(const StringDictionaryProxy* source,
+                   const StringDictionaryProxy* dest,
+                   std::shared_ptr<const std::vector<int32_t>> dest_ids)
+        : source_(source), dest_(dest), dest_ids_(dest_ids) {}
+
+    int32_t translate(const int32_t string_id) const {
+      if (dest_ids_ && string_id >= 0 &&
+          static_cast<size_t>(string_id) < dest_ids_->size()) {
+        const auto dest_id = (*dest_ids_)[string_id];
+        // The transients of dest are checked on lookup, they can be added after the
+        // map is built, e.g. by the code generated for a literal. Their count is read
+        // without a lock, the miss path of the hash join builds stays lock-free.
+        if (dest_id != StringDictionary::INVALID_STR_ID ||
+            !dest_->transientEntryCount()) {
+          return dest_id;
+        }
+      }
+      return dest_->getIdOfString(source_->getString(string_id));
+    }
+
+   private:
+    const StringDictionaryProxy* source_;
+    const StringDictionaryProxy* dest_;
+    std::shared_ptr<const std::vector<int32_t>> dest_ids_;
+  };
+
+  // The translation to dest, built on the first call and kept as long as the proxy.
+  const TranslationMap* getTranslationMap(const StringDictionaryProxy* dest) const;
+
  private:
   std::shared_ptr<StringDictionary> string_dict_;
-  std::map<int32_t, std::string> transient_int_to_str_;
-  std::map<std::string, int32_t> transient_str_to_int_;
+  // The transient ids are -2, -3, ..., the strings are stored in that order.
+  std::vector<std::string> transient_strings_;
+  std::unordered_map<std::string, int32_t> transient_str_to_int_;
+  // Size of transient_strings_, read without the lock by the translation of the ids.
+  std::atomic<size_t> transient_count_{0};
   ssize_t generation_;
+  // The bytes handed out by getStringBytes stay valid as long as the proxy: it pins the
+  // payload mapping once and only pins a newer one for the strings added past its end.
+  // The pins are kept until the proxy goes away, the lookups read the latest one
+  // without the mutex.
+  mutable std::atomic<const void*> payload_pin_;
+  mutable std::vector<std::shared_ptr<const void>> payload_pins_;
+  mutable std::mutex payload_pins_mutex_;
   mutable mapd_shared_mutex rw_mutex_;
+  mutable std::unordered_map<const StringDictionaryProxy*,
+                             std::unique_ptr<const TranslationMap>>
+      translation_maps_;
+  mutable std::mutex translation_maps_mutex_;
 };
 #endif  // STRINGDICTIONARY_STRINGDICTIONARYPROXY_H
\ No newline at end of file
@@ -0,0 +1,429 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TrigramIndex.h"
+#include "Shared/thread_count.h"
+
+#include <glog/logging.h>
+#include <unistd.h>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <future>
+
+namespace {
+
+constexpr uint32_t trigram_block_magic{0x4d475254};  // "TRGM"
+// Loading an index file with more blocks than this rewrites it as a single block.
+constexpr size_t max_trigram_blocks{32};
+// Below this many ids, indexing them isn't worth spreading over threads.
+constexpr size_t min_ids_per_thread{10000};
+
+struct TrigramBlockHeader {
+  uint32_t magic;
+  uint32_t num_trigrams;
+  uint64_t begin_id;
+  uint64_t end_id;
+  uint64_t num_ids;
+};
+
+struct TrigramPostingsHeader {
+  uint32_t trigram;
+  uint32_t num_ids;
+};
+
+inline uint32_t lowercase(const char c) {
+  if ('A' <= c && c <= 'Z') {
+    return 'a' + (c - 'A');
+  }
+  return static_cast<uint8_t>(c);
+}
+
+// The distinct trigrams of the lowercased bytes of str, packed into 24 bits.
+void get_trigrams(const char* str, const size_t len, std::vector<uint32_t>& trigrams) {
+  trigrams.clear();
+  if (len < 3) {
+    return;
+  }
+  uint32_t trigram = (lowercase(str[0]) << 8) | lowercase(str[1]);
+  for (size_t i = 2; i < len; ++i) {
+    trigram = ((trigram << 8) | lowercase(str[i])) & 0xffffff;
+    trigrams.push_back(trigram);
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+void add_literal(std::vector<std::string>& literals, std::string& run) {
+  if (run.size() >= 3) {
+    literals.push_back(run);
+  }
+  run.clear();
+}
+
+}  // namespace
+
+TrigramIndex::TrigramIndex(const std::string& path)
+    : path_(path), indexed_count_(0), persisted_count_(0) {}
+
+size_t TrigramIndex::load(const size_t max_count) {
+  postings_.clear();
+  indexed_count_ = 0;
+  persisted_count_ = 0;
+  boost::system::error_code ec;
+  if (path_.empty() || !boost::filesystem::exists(path_, ec)) {
+    return 0;
+  }
+  const size_t file_size = boost::filesystem::file_size(path_);
+  auto f = fopen(path_.c_str(), "rb");
+  CHECK(f);
+  size_t valid_bytes{0};
+  size_t num_blocks{0};
+  while (true) {
+    TrigramBlockHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        header.magic != trigram_block_magic || header.begin_id != indexed_count_ ||
+        header.end_id < header.begin_id) {
+      break;
+    }
+    const size_t block_bytes = sizeof(header) +
+                               header.num_trigrams * sizeof(TrigramPostingsHeader) +
+                               header.num_ids * sizeof(int32_t);
+    if (valid_bytes + block_bytes > file_size) {
+      break;
+    }
+    std::vector<TrigramPostingsHeader> postings_headers(header.num_trigrams);
+    std::vector<int32_t> ids(header.num_ids);
+    if (fread(postings_headers.data(),
+              sizeof(TrigramPostingsHeader),
+              postings_headers.size(),
+              f) != postings_headers.size() ||
+        fread(ids.data(), sizeof(int32_t), ids.size(), f) != ids.size()) {
+      break;
+    }
+    size_t num_ids{0};
+    for (const auto& postings_header : postings_headers) {
+      num_ids += postings_header.num_ids;
+    }
+    if (num_ids != ids.size()) {
+      break;
+    }
+    auto ids_it = ids.begin();
+    for (const auto& postings_header : postings_headers) {
+      auto& postings = postings_[postings_header.trigram];
+      postings.insert(postings.end(), ids_it, ids_it + postings_header.num_ids);
+      ids_it += postings_header.num_ids;
+    }
+    indexed_count_ = header.end_id;
+    valid_bytes += block_bytes;
+    ++num_blocks;
+  }
+  fclose(f);
+  if (indexed_count_ > max_count) {
+    LOG(WARNING) << "Trigram index " << path_ << " covers " << indexed_count_
+                 << " strings, the dictionary only has " << max_count
+                 << ", rebuilding it";
+    postings_.clear();
+    indexed_count_ = 0;
+    valid_bytes = 0;
+  }
+  if (valid_bytes < file_size) {
+    // Left over by a checkpoint which didn't complete.
+    LOG(WARNING) << "Truncating trigram index " << path_ << " to " << valid_bytes
+                 << " bytes";
+    boost::filesystem::resize_file(path_, valid_bytes);
+  }
+  persisted_count_ = indexed_count_;
+  if (num_blocks > max_trigram_blocks) {
+    compact();
+  }
+  return indexed_count_;
+}
+
+void TrigramIndex::add(const int32_t string_id, const char* str, const size_t len) {
+  CHECK_EQ(static_cast<size_t>(string_id), indexed_count_);
+  std::vector<uint32_t> trigrams;
+  get_trigrams(str, len, trigrams);
+  for (const auto trigram : trigrams) {
+    postings_[trigram].push_back(string_id);
+  }
+  ++indexed_count_;
+}
+
+void TrigramIndex::addRange(
+    const size_t end_id,
+    const std::function<std::pair<const char*, size_t>(int32_t)>& get_string) {
+  if (end_id <= indexed_count_) {
+    return;
+  }
+  const size_t thread_count = std::max<size_t>(
+      1,
+      std::min<size_t>(cpu_threads(), (end_id - indexed_count_) / min_ids_per_thread));
+  const size_t ids_per_thread =
+      (end_id - indexed_count_ + thread_count - 1) / thread_count;
+  std::vector<std::future<std::unordered_map<uint32_t, std::vector<int32_t>>>>
+      partial_postings;
+  for (size_t begin = indexed_count_; begin < end_id; begin += ids_per_thread) {
+    const size_t end = std::min(begin + ids_per_thread, end_id);
+    partial_postings.emplace_back(
+        std::async(std::launch::async, [begin, end, &get_string] {
+          std::unordered_map<uint32_t, std::vector<int32_t>> postings;
+          std::vector<uint32_t> trigrams;
+          for (size_t string_id = begin; string_id < end; ++string_id) {
+            const auto str = get_string(string_id);
+            get_trigrams(str.first, str.second, trigrams);
+            for (const auto trigram : trigrams) {
+              postings[trigram].push_back(string_id);
+            }
+          }
+          return postings;
+        }));
+  }
+  // The ranges are merged in order, the posting lists stay sorted.
+  for (auto& partial_postings_future : partial_postings) {
+    const auto partial = partial_postings_future.get();
+    for (const auto& trigram_postings : partial) {
+      auto& postings = postings_[trigram_postings.first];
+      postings.insert(
+          postings.end(), trigram_postings.second.begin(), trigram_postings.second.end());
+    }
+  }
+  indexed_count_ = end_id;
+}
+
+bool TrigramIndex::getCandidates(const std::vector<std::string>& literals,
+                                 const size_t generation,
+                                 std::vector<int32_t>& candidates) const {
+  CHECK_LE(generation, indexed_count_);
+  std::vector<uint32_t> trigrams;
+  std::vector<uint32_t> literal_trigrams;
+  for (const auto& literal : literals) {
+    get_trigrams(literal.data(), literal.size(), literal_trigrams);
+    trigrams.insert(trigrams.end(), literal_trigrams.begin(), literal_trigrams.end());
+  }
+  if (trigrams.empty()) {
+    return false;
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+  candidates.clear();
+  std::vector<const std::vector<int32_t>*> posting_lists;
+  for (const auto trigram : trigrams) {
+    const auto it = postings_.find(trigram);
+    if (it == postings_.end()) {
+      return true;
+    }
+    posting_lists.push_back(&it->second);
+  }
+  std::sort(posting_lists.begin(),
+            posting_lists.end(),
+            [](const std::vector<int32_t>* lhs, const std::vector<int32_t>* rhs) {
+              return lhs->size() < rhs->size();
+            });
+  const auto& shortest = *posting_lists.front();
+  candidates.assign(shortest.begin(),
+                    std::lower_bound(shortest.begin(), shortest.end(), generation));
+  std::vector<int32_t> intersection;
+  for (size_t i = 1; i < posting_lists.size() && !candidates.empty(); ++i) {
+    const auto& postings = *posting_lists[i];
+    intersection.clear();
+    if (candidates.size() * 32 < postings.size()) {
+      for (const auto string_id : candidates) {
+        if (std::binary_search(postings.begin(), postings.end(), string_id)) {
+          intersection.push_back(string_id);
+        }
+      }
+    } else {
+      std::set_intersection(candidates.begin(),
+                            candidates.end(),
+                            postings.begin(),
+                            postings.end(),
+                            std::back_inserter(intersection));
+    }
+    candidates.swap(intersection);
+  }
+  return true;
+}
+
+bool TrigramIndex::checkpoint(const size_t end_id) {
+  const auto checkpoint_count = std::min(end_id, indexed_count_);
+  if (path_.empty() || checkpoint_count <= persisted_count_) {
+    return true;
+  }
+  boost::system::error_code ec;
+  const auto file_size = boost::filesystem::file_size(path_, ec);
+  auto f = fopen(path_.c_str(), "ab");
+  if (!f) {
+    LOG(ERROR) << "Could not open trigram index " << path_;
+    return false;
+  }
+  const bool written = writeBlock(f, persisted_count_, checkpoint_count);
+  if (fclose(f) != 0 || !written) {
+    LOG(ERROR) << "Could not write trigram index " << path_;
+    // Drops the partial block, it would hide the blocks appended after it.
+    boost::filesystem::resize_file(path_, ec ? 0 : file_size, ec);
+    return false;
+  }
+  persisted_count_ = checkpoint_count;
+  return true;
+}
+
+bool TrigramIndex::writeBlock(FILE* f,
+                              const size_t begin_id,
+                              const size_t end_id) const {
+  std::vector<TrigramPostingsHeader> postings_headers;
+  std::vector<int32_t> ids;
+  for (const auto& trigram_postings : postings_) {
+    const auto& postings = trigram_postings.second;
+    const auto first = std::lower_bound(postings.begin(), postings.end(), begin_id);
+    const auto last = std::lower_bound(first, postings.end(), end_id);
+    if (first == last) {
+      continue;
+    }
+    postings_headers.push_back(TrigramPostingsHeader{
+        trigram_postings.first, static_cast<uint32_t>(last - first)});
+    ids.insert(ids.end(), first, last);
+  }
+  const TrigramBlockHeader header{trigram_block_magic,
+                                  static_cast<uint32_t>(postings_headers.size()),
+                                  begin_id,
+                                  end_id,
+                                  ids.size()};
+  return fwrite(&header, sizeof(header), 1, f) == 1 &&
+         fwrite(postings_headers.data(),
+                sizeof(TrigramPostingsHeader),
+                postings_headers.size(),
+                f) == postings_headers.size() &&
+         fwrite(ids.data(), sizeof(int32_t), ids.size(), f) == ids.size() &&
+         fflush(f) == 0 && fsync(fileno(f)) == 0;
+}
+
+void TrigramIndex::compact() {
+  const auto tmp_path = path_ + ".tmp";
+  auto f = fopen(tmp_path.c_str(), "wb");
+  if (!f) {
+    return;
+  }
+  const bool written = writeBlock(f, 0, persisted_count_);
+  if (fclose(f) != 0 || !written) {
+    LOG(WARNING) << "Could not compact trigram index " << path_;
+    boost::filesystem::remove(tmp_path);
+    return;
+  }
+  boost::filesystem::rename(tmp_path, path_);
+}
+
+std::vector<std::string> TrigramIndex::getLikeLiterals(const std::string& pattern,
+                                                       const bool is_simple,
+                                                       const char escape) {
+  if (is_simple) {
+    // The whole pattern is a substring to search for.
+    return {pattern};
+  }
+  std::vector<std::string> literals;
+  std::string run;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const char c = pattern[i];
+    if (c == escape && i + 1 < pattern.size()) {
+      run += pattern[++i];
+    } else if (c == '%' || c == '_') {
+      add_literal(literals, run);
+    } else if (c == '[') {
+      // One of a set of characters.
+      add_literal(literals, run);
+      while (i < pattern.size() && pattern[i] != ']') {
+        ++i;
+      }
+    } else {
+      run += c;
+    }
+  }
+  add_literal(literals, run);
+  return literals;
+}
+
+std::vector<std::string> TrigramIndex::getRegexpLiterals(const std::string& pattern) {
+  if (pattern.find('|') != std::string::npos) {
+    return {};
+  }
+  std::vector<std::string> literals;
+  std::string run;
+  int depth{0};
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const char c = pattern[i];
+    switch (c) {
+      case '(':
+        add_literal(literals, run);
+        ++depth;
+        break;
+      case ')':
+        add_literal(literals, run);
+        --depth;
+        break;
+      case '[':
+        add_literal(literals, run);
+        ++i;
+        if (i < pattern.size() && pattern[i] == '^') {
+          ++i;
+        }
+        if (i < pattern.size() && pattern[i] == ']') {
+          ++i;
+        }
+        while (i < pattern.size() && pattern[i] != ']') {
+          if (pattern[i] == '[' && i + 1 < pattern.size() &&
+              (pattern[i + 1] == ':' || pattern[i + 1] == '.' || pattern[i + 1] == '=')) {
+            // Character class, collating element or equivalence class.
+            const auto end = pattern.find(std::string{pattern[i + 1], ']'}, i + 2);
+            i = end == std::string::npos ? pattern.size() : end + 2;
+          } else {
+            ++i;
+          }
+        }
+        break;
+      case '*':
+      case '?':
+      case '{':
+        // The quantified character is optional.
+        if (!run.empty()) {
+          run.pop_back();
+        }
+        add_literal(literals, run);
+        if (c == '{') {
+          while (i < pattern.size() && pattern[i] != '}') {
+            ++i;
+          }
+        }
+        break;
+      case '\\':
+        add_literal(literals, run);
+        ++i;
+        break;
+      case '+':
+      case '.':
+      case '^':
+      case '$':
+        add_literal(literals, run);
+        break;
+      default:
+        if (depth == 0) {
+          run += c;
+        }
+        break;
+    }
+  }
+  add_literal(literals, run);
+  return literals;
+}
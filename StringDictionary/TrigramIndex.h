@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TrigramIndex.h
+ * @brief   Inverted index from the trigrams of the strings of a dictionary to their ids.
+ *
+ * A string matching a LIKE or REGEXP pattern contains every literal run the pattern
+ * requires, hence all the trigrams of those runs. Intersecting the posting lists of
+ * these trigrams narrows the dictionary scan down to a few candidates, which are then
+ * verified against the pattern. The trigrams are taken over the ASCII lowercased bytes
+ * of the strings, the same index serves LIKE and ILIKE and the candidates are a superset
+ * of the case sensitive matches.
+ *
+ * The ids are indexed in order. The postings of the ids indexed since the previous
+ * checkpoint are appended as a block to the index file, which is compacted into a
+ * single block when it is loaded back with too many of them.
+ */
+
+#ifndef STRINGDICTIONARY_TRIGRAMINDEX_H
+#define STRINGDICTIONARY_TRIGRAMINDEX_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TrigramIndex {
+ public:
+  // The index kept in the file at path, in memory only if path is empty.
+  explicit TrigramIndex(const std::string& path);
+
+  // Reads back the persisted blocks, returns the number of ids they cover. An index
+  // file covering more than max_count ids doesn't belong to the dictionary and is
+  // discarded.
+  size_t load(const size_t max_count);
+
+  // Number of ids indexed so far, the next id to add.
+  size_t getIndexedCount() const { return indexed_count_; }
+
+  void add(const int32_t string_id, const char* str, const size_t len);
+
+  // Indexes the ids from getIndexedCount() up to end_id, get_string returns the bytes
+  // of an id and is called from several threads.
+  void addRange(const size_t end_id,
+                const std::function<std::pair<const char*, size_t>(int32_t)>& get_string);
+
+  // Ids below generation of the strings containing all the trigrams of the literals,
+  // sorted. Returns false if the literals don't have any trigram, the index can't
+  // narrow the search down then.
+  bool getCandidates(const std::vector<std::string>& literals,
+                     const size_t generation,
+                     std::vector<int32_t>& candidates) const;
+
+  // Appends the postings of the ids indexed since the last checkpoint and below end_id
+  // to the file, the ids the dictionary has already persisted.
+  bool checkpoint(const size_t end_id);
+
+  // Literal runs a string must contain to match the LIKE pattern.
+  static std::vector<std::string> getLikeLiterals(const std::string& pattern,
+                                                  const bool is_simple,
+                                                  const char escape);
+
+  // Literal runs a string must contain to match the extended regular expression. Only
+  // the runs outside of groups and bracket expressions are considered, none at all if
+  // the expression has alternatives.
+  static std::vector<std::string> getRegexpLiterals(const std::string& pattern);
+
+ private:
+  // Writes the postings of the ids in [begin_id, end_id) as a block.
+  bool writeBlock(FILE* f, const size_t begin_id, const size_t end_id) const;
+  void compact();
+
+  const std::string path_;
+  std::unordered_map<uint32_t, std::vector<int32_t>> postings_;
+  size_t indexed_count_;
+  size_t persisted_count_;
+};
+
+#endif  // STRINGDICTIONARY_TRIGRAMINDEX_H
@@ -156,6 +156,46 @@ TEST_F(ViewObject, BasicTest) {
   EXPECT_EQ(tab_result.plan_result, view_result.plan_result);
 }
 
+TEST(CalcitePlanCache, Normalize) {
+  const auto normalized = CalcitePlanCache::normalize(
+      "SELECT  i1, 'it''s' -- comment\n FROM table1 /* comment */ WHERE i2 = 42 AND "
+      "i1 > 3000000000 AND d = DATE '2019-01-01' AND f = 1.5 LIMIT 10");
+  EXPECT_EQ(
+      "SELECT i1, ?s FROM table1 WHERE i2 = ?i AND i1 > ?l AND d = DATE '2019-01-01' "
+      "AND f = 1.5 LIMIT ?i",
+      normalized.text);
+  ASSERT_EQ(size_t(4), normalized.literals.size());
+  EXPECT_EQ("it's", normalized.literals[0].value);
+  EXPECT_EQ("42", normalized.literals[1].value);
+  EXPECT_EQ("3000000000", normalized.literals[2].value);
+  EXPECT_EQ("10", normalized.literals[3].value);
+}
+
+TEST_F(ViewObject, PlanCache) {
+  const auto plan_cache = g_calcite->getPlanCache();
+  ASSERT_TRUE(plan_cache);
+  const auto process = [](const std::string& sql) {
+    rapidjson::Document ra;
+    ra.Parse(::g_calcite->process(*g_session, sql, {}, true, false, false)
+                 .plan_result.c_str());
+    return ra;
+  };
+  const auto query = [](const int i1, const std::string& str) {
+    return "SELECT segment_name FROM attribute_table WHERE block_group_id = " +
+           std::to_string(i1) + " AND agg_column = '" + str + "' LIMIT 5";
+  };
+  process(query(10, "abc"));
+  const auto hits = plan_cache->getStats().hits;
+  const auto cached_ra = process(query(20, "de"));
+  EXPECT_EQ(hits + 1, plan_cache->getStats().hits);
+  // Planned from scratch once the metadata changes.
+  ::g_calcite->updateMetadata(g_session->getCatalog().getCurrentDB().dbName,
+                              "attribute_table");
+  const auto ra = process(query(20, "de"));
+  EXPECT_EQ(hits + 1, plan_cache->getStats().hits);
+  EXPECT_TRUE(ra == cached_ra);
+}
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
   google::InitGoogleLogging(argv[0]);
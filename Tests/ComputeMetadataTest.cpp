@@ -17,6 +17,7 @@
 #include "TestHelpers.h"
 
 #include "../Catalog/Catalog.h"
+#include "../DataMgr/ChunkSketch.h"
 #include "../QueryEngine/Execute.h"
 #include "../QueryEngine/TableOptimizer.h"
 #include "../QueryRunner/QueryRunner.h"
@@ -523,6 +524,234 @@ TEST_F(MetadataUpdate, DeleteReset) {
   run_op_per_fragment(td, check_recomputed_metadata_values);
 }
 
+class PackedEncodings : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    EXPECT_NO_THROW(run_ddl_statement("DROP TABLE IF EXISTS " + g_table_name + ";"));
+    EXPECT_NO_THROW(run_ddl_statement(
+        "CREATE TABLE " + g_table_name +
+        " (r BIGINT ENCODING RL, d BIGINT ENCODING DIFF, b INT ENCODING BITPACK, "
+        "t TIMESTAMP ENCODING DIFF, s SMALLINT ENCODING BITPACK) WITH "
+        "(FRAGMENT_SIZE=64);"));
+
+    TestHelpers::ValuesGenerator gen(g_table_name);
+    for (size_t i = 0; i < num_rows_; i++) {
+      const auto b = i % 7 == 0 ? std::string("null") : std::to_string(i % 5);
+      const auto insert_query = gen(i / 16,
+                                    1000000 + 3 * i,
+                                    b,
+                                    "'2019-01-01 00:00:00'",
+                                    i % 2 ? -int(i) : int(i));
+      run_multiple_agg(insert_query, ExecutorDeviceType::CPU);
+    }
+  }
+
+  void TearDown() override {
+    EXPECT_NO_THROW(run_ddl_statement("DROP TABLE IF EXISTS " + g_table_name + ";"));
+  }
+
+  std::vector<int64_t> runQueries() {
+    std::vector<int64_t> results;
+    const std::vector<std::string> queries{
+        "SELECT SUM(r), MIN(r), MAX(r) FROM " + g_table_name + ";",
+        "SELECT SUM(d), MIN(d), COUNT(*) FROM " + g_table_name + ";",
+        "SELECT SUM(b), COUNT(b), MAX(b) FROM " + g_table_name + ";",
+        "SELECT COUNT(*), MIN(s), SUM(s) FROM " + g_table_name + ";",
+        "SELECT COUNT(*), SUM(r), MIN(d) FROM " + g_table_name +
+            " WHERE t < '2020-01-01 00:00:00' AND b = 3;"};
+    for (const auto& query : queries) {
+      const auto rows = run_multiple_agg(query, ExecutorDeviceType::CPU);
+      const auto row = rows->getNextRow(false, false);
+      CHECK_EQ(row.size(), size_t(3));
+      for (const auto& col : row) {
+        results.push_back(TestHelpers::v<int64_t>(col));
+      }
+    }
+    const auto rows =
+        run_multiple_agg("SELECT r, COUNT(*) FROM " + g_table_name +
+                             " WHERE b IS NULL GROUP BY r ORDER BY r LIMIT 3;",
+                         ExecutorDeviceType::CPU);
+    for (auto row = rows->getNextRow(false, false); !row.empty();
+         row = rows->getNextRow(false, false)) {
+      results.push_back(TestHelpers::v<int64_t>(row[0]));
+      results.push_back(TestHelpers::v<int64_t>(row[1]));
+    }
+    return results;
+  }
+
+  const size_t num_rows_{200};
+};
+
+TEST_F(PackedEncodings, PackedChunksMatchPlainChunks) {
+  const auto& cat = g_session->getCatalog();
+  const auto td = cat.getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+
+  std::vector<size_t> plain_bytes;
+  run_op_per_fragment(td, [&plain_bytes](const Fragmenter_Namespace::FragmentInfo& f) {
+    for (const auto& chunk_metadata : f.getChunkMetadataMapPhysical()) {
+      plain_bytes.push_back(chunk_metadata.second.numBytes);
+    }
+  });
+  const auto plain_results = runQueries();
+
+  auto executor = Executor::getExecutor(cat.getCurrentDB().dbId);
+  TableOptimizer optimizer(td, executor.get(), cat);
+  EXPECT_NO_THROW(optimizer.packEncodedColumns());
+
+  // The full fragments pack every encoded column but d, its 1024 rows delta blocks are
+  // larger than the plain 64 rows chunks. The deleted column stays plain.
+  size_t chunk_idx{0};
+  size_t packed_chunks{0};
+  run_op_per_fragment(
+      td, [&plain_bytes, &chunk_idx, &packed_chunks](
+              const Fragmenter_Namespace::FragmentInfo& f) {
+        for (const auto& chunk_metadata : f.getChunkMetadataMapPhysical()) {
+          ASSERT_LT(chunk_idx, plain_bytes.size());
+          ASSERT_LE(chunk_metadata.second.numBytes, plain_bytes[chunk_idx]);
+          if (chunk_metadata.second.numBytes < plain_bytes[chunk_idx]) {
+            ++packed_chunks;
+          }
+          ++chunk_idx;
+        }
+      });
+  ASSERT_EQ(packed_chunks, size_t(3 * 4));
+
+  ASSERT_EQ(plain_results, runQueries());
+  // 16 rows each of 0 to 11 and 8 rows of 12.
+  ASSERT_EQ(plain_results[0], int64_t(16 * 66 + 12 * 8));
+
+  // Packing again is a no-op, the chunks are packed already.
+  EXPECT_NO_THROW(optimizer.packEncodedColumns());
+  ASSERT_EQ(plain_results, runQueries());
+}
+
+class ChunkSketches : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    g_enable_chunk_sketches = true;
+    EXPECT_NO_THROW(run_ddl_statement("DROP TABLE IF EXISTS " + g_table_name + ";"));
+    EXPECT_NO_THROW(run_ddl_statement(
+        "CREATE TABLE " + g_table_name +
+        " (x INT, k BIGINT, s TEXT ENCODING DICT(32), f DOUBLE) WITH "
+        "(FRAGMENT_SIZE=100);"));
+
+    // Even keys spread over each fragment, the chunk stats can't rule the odd ones out.
+    TestHelpers::ValuesGenerator gen(g_table_name);
+    for (size_t i = 0; i < num_rows_; i++) {
+      const auto k = 2 * ((i * 37) % num_rows_);
+      run_multiple_agg(gen(i, k, "'str" + std::to_string(k) + "'", 0.5 * i),
+                       ExecutorDeviceType::CPU);
+    }
+  }
+
+  void TearDown() override {
+    EXPECT_NO_THROW(run_ddl_statement("DROP TABLE IF EXISTS " + g_table_name + ";"));
+    g_enable_chunk_sketches = false;
+  }
+
+  int64_t count(const std::string& filter) {
+    const auto rows = run_multiple_agg(
+        "SELECT COUNT(*) FROM " + g_table_name + " WHERE " + filter + ";",
+        ExecutorDeviceType::CPU);
+    const auto row = rows->getNextRow(false, false);
+    CHECK_EQ(row.size(), size_t(1));
+    return TestHelpers::v<int64_t>(row[0]);
+  }
+
+  // Lookups of the chunks of the table in the CPU buffer pool so far, hits and misses.
+  size_t chunkFetches() {
+    const auto& cat = g_session->getCatalog();
+    const auto td = cat.getMetadataForTable(g_table_name);
+    size_t fetches{0};
+    for (const auto& memory_info :
+         cat.getDataMgr().getMemoryInfo(Data_Namespace::MemoryLevel::CPU_LEVEL)) {
+      for (const auto& table_stats : memory_info.tableStats) {
+        if (table_stats.db_id == cat.getCurrentDB().dbId &&
+            table_stats.table_id == td->tableId) {
+          fetches += table_stats.hits + table_stats.misses;
+        }
+      }
+    }
+    return fetches;
+  }
+
+  const size_t num_rows_{300};
+  const size_t num_fragments_{3};
+};
+
+TEST_F(ChunkSketches, FilterResults) {
+  const auto& cat = g_session->getCatalog();
+  const auto td = cat.getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+  const auto k_cd = cat.getMetadataForColumn(td->tableId, "k");
+  const auto f_cd = cat.getMetadataForColumn(td->tableId, "f");
+
+  std::vector<uint8_t> registers;
+  run_op_per_fragment(td, [&](const Fragmenter_Namespace::FragmentInfo& fragment) {
+    const auto& metadata_map = fragment.getChunkMetadataMapPhysical();
+    const auto& k_metadata = metadata_map.at(k_cd->columnId);
+    ASSERT_TRUE(k_metadata.sketch);
+    ASSERT_FALSE(metadata_map.at(f_cd->columnId).sketch);
+    ChunkSketch::mergeDistinctRegisters(registers,
+                                        k_metadata.sketch->getDistinctRegisters());
+  });
+  const auto ndv = ChunkSketch::estimateDistinct(registers);
+  ASSERT_GE(ndv, size_t(0.95 * num_rows_));
+  ASSERT_LE(ndv, size_t(1.05 * num_rows_));
+
+  ASSERT_EQ(count("k = 74"), int64_t(1));
+  ASSERT_EQ(count("k = 75"), int64_t(0));
+  ASSERT_EQ(count("k IN (2, 4, 75, 598)"), int64_t(3));
+  ASSERT_EQ(count("k IN (1, 3, 5)"), int64_t(0));
+  ASSERT_EQ(count("s = 'str74'"), int64_t(1));
+  ASSERT_EQ(count("s = 'str75'"), int64_t(0));
+  ASSERT_EQ(count("s IN ('str2', 'str4', 'str75')"), int64_t(2));
+
+  // The fragments ruled out by the sketches are skipped, their chunks aren't fetched.
+  const auto fetches = chunkFetches();
+  ASSERT_EQ(count("k = 75"), int64_t(0));
+  ASSERT_EQ(count("k IN (1, 3, 5)"), int64_t(0));
+  ASSERT_EQ(chunkFetches(), fetches);
+  ASSERT_EQ(count("k = 74"), int64_t(1));
+  ASSERT_LT(chunkFetches(), fetches + num_fragments_);
+
+  // The updated chunks lose their sketches, the new values aren't in them.
+  run_multiple_agg("UPDATE " + g_table_name + " SET k = 75 WHERE x = 1;",
+                   ExecutorDeviceType::CPU);
+  ASSERT_EQ(count("k = 75"), int64_t(1));
+  ASSERT_EQ(count("k IN (1, 75)"), int64_t(1));
+}
+
+TEST_F(ChunkSketches, ReloadPersisted) {
+  auto& cat = g_session->getCatalog();
+  const auto db_id = cat.getCurrentDB().dbId;
+  auto td = cat.getMetadataForTable(g_table_name);
+  // Reopens the table from disk like the rollback of a failed import: the fragmenter
+  // reads the chunk metadata again, with the sketches written at checkpoint.
+  cat.setTableEpoch(db_id, td->tableId, cat.getTableEpoch(db_id, td->tableId));
+  td = cat.getMetadataForTable(g_table_name, /*populateFragmenter=*/true);
+  const auto k_cd = cat.getMetadataForColumn(td->tableId, "k");
+
+  size_t num_fragments{0};
+  std::vector<uint8_t> registers;
+  run_op_per_fragment(td, [&](const Fragmenter_Namespace::FragmentInfo& fragment) {
+    ++num_fragments;
+    const auto& k_metadata = fragment.getChunkMetadataMapPhysical().at(k_cd->columnId);
+    ASSERT_TRUE(k_metadata.sketch);
+    ASSERT_FALSE(k_metadata.sketch->mayContain(75));
+    ChunkSketch::mergeDistinctRegisters(registers,
+                                        k_metadata.sketch->getDistinctRegisters());
+  });
+  ASSERT_EQ(num_fragments, num_fragments_);
+  const auto ndv = ChunkSketch::estimateDistinct(registers);
+  ASSERT_GE(ndv, size_t(0.95 * num_rows_));
+  ASSERT_LE(ndv, size_t(1.05 * num_rows_));
+
+  const auto fetches = chunkFetches();
+  ASSERT_EQ(count("k = 75"), int64_t(0));
+  ASSERT_EQ(chunkFetches(), fetches);
+  ASSERT_EQ(count("k = 74"), int64_t(1));
+}
+
 int main(int argc, char** argv) {
   google::InitGoogleLogging(argv[0]);
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/measure.h"
+#include "../Shared/thread_count.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <boost/program_options.hpp>
+
+#include <future>
+#include <vector>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+std::unique_ptr<Catalog_Namespace::SessionInfo> g_session;
+size_t g_num_rows{20000};
+size_t g_queries_per_client{20};
+
+inline void run_ddl_statement(const std::string& query_str) {
+  QueryRunner::run_ddl_statement(query_str, g_session);
+}
+
+std::shared_ptr<ResultSet> run_multiple_agg(const std::string& query_str) {
+  return QueryRunner::run_multiple_agg(
+      query_str, g_session, ExecutorDeviceType::CPU, true, true);
+}
+
+template <class T>
+T v(const TargetValue& r) {
+  auto scalar_r = boost::get<ScalarTargetValue>(&r);
+  CHECK(scalar_r);
+  auto p = boost::get<T>(scalar_r);
+  CHECK(p);
+  return *p;
+}
+
+const std::vector<std::string> g_queries{
+    "SELECT COUNT(*) FROM concurrent_perf_test WHERE x > 10;",
+    "SELECT SUM(x) FROM concurrent_perf_test WHERE y < 50;",
+    "SELECT MAX(y) FROM concurrent_perf_test WHERE x <> 7;",
+    "SELECT COUNT(*) FROM concurrent_perf_test WHERE MOD(x, 3) = 1;"};
+
+int64_t run_query(const std::string& query_str) {
+  const auto rows = run_multiple_agg(query_str);
+  const auto crt_row = rows->getNextRow(true, true);
+  CHECK_EQ(size_t(1), crt_row.size());
+  return v<int64_t>(crt_row[0]);
+}
+
+void create_and_populate_table() {
+  run_ddl_statement("DROP TABLE IF EXISTS concurrent_perf_test;");
+  run_ddl_statement(
+      "CREATE TABLE concurrent_perf_test (x INT, y INT) WITH (fragment_size=500);");
+  for (size_t i = 0; i < g_num_rows; ++i) {
+    run_multiple_agg("INSERT INTO concurrent_perf_test VALUES(" +
+                     std::to_string(i % 1000) + ", " + std::to_string(i % 100) + ");");
+  }
+}
+
+}  // namespace
+
+TEST(ConcurrentQueryPerf, Throughput) {
+  std::vector<int64_t> expected;
+  for (const auto& query : g_queries) {
+    expected.push_back(run_query(query));
+  }
+
+  const auto max_clients = static_cast<size_t>(std::max(cpu_threads() / 2, 1));
+  const auto saved_num_executors = g_num_executors;
+  double single_client_qps{0};
+  for (size_t num_clients = 1; num_clients <= max_clients; num_clients *= 2) {
+    g_num_executors = num_clients;
+    std::vector<std::future<void>> clients;
+    const auto elapsed_ms = measure<>::execution([&]() {
+      for (size_t client_idx = 0; client_idx < num_clients; ++client_idx) {
+        clients.emplace_back(std::async(std::launch::async, [client_idx, &expected] {
+          for (size_t i = 0; i < g_queries_per_client; ++i) {
+            const auto query_idx = (client_idx + i) % g_queries.size();
+            ASSERT_EQ(expected[query_idx], run_query(g_queries[query_idx]));
+          }
+        }));
+      }
+      for (auto& client : clients) {
+        client.get();
+      }
+    });
+    const double qps =
+        1000. * num_clients * g_queries_per_client / std::max(elapsed_ms, int64_t(1));
+    if (num_clients == 1) {
+      single_client_qps = qps;
+    }
+    LOG(INFO) << num_clients << " client(s): " << qps << " queries/s, "
+              << qps / std::max(single_client_qps, 1.) << "x single client throughput";
+  }
+  g_num_executors = saved_num_executors;
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+
+  namespace po = boost::program_options;
+  po::options_description desc("Options");
+  desc.add_options()("num-rows",
+                     po::value<size_t>(&g_num_rows)->default_value(g_num_rows),
+                     "Number of rows in the test table");
+  desc.add_options()(
+      "queries-per-client",
+      po::value<size_t>(&g_queries_per_client)->default_value(g_queries_per_client),
+      "Number of queries each client runs");
+  po::variables_map vm;
+  po::store(po::command_line_parser(argc, argv).options(desc).allow_unregistered().run(),
+            vm);
+  po::notify(vm);
+
+  g_session.reset(QueryRunner::get_session(BASE_PATH));
+
+  int err{0};
+  try {
+    create_and_populate_table();
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+
+  run_ddl_statement("DROP TABLE IF EXISTS concurrent_perf_test;");
+  g_session.reset(nullptr);
+  return err;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/thread_count.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <vector>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+std::unique_ptr<Catalog_Namespace::SessionInfo> g_session;
+const size_t g_num_rows{5000};
+const size_t g_queries_per_client{5};
+const auto g_query_timeout = std::chrono::seconds(60);
+
+inline void run_ddl_statement(const std::string& query_str) {
+  QueryRunner::run_ddl_statement(query_str, g_session);
+}
+
+std::shared_ptr<ResultSet> run_multiple_agg(const std::string& query_str) {
+  return QueryRunner::run_multiple_agg(
+      query_str, g_session, ExecutorDeviceType::CPU, true, true);
+}
+
+template <class T>
+T v(const TargetValue& r) {
+  auto scalar_r = boost::get<ScalarTargetValue>(&r);
+  CHECK(scalar_r);
+  auto p = boost::get<T>(scalar_r);
+  CHECK(p);
+  return *p;
+}
+
+const std::vector<std::string> g_queries{
+    "SELECT COUNT(*) FROM concurrent_test WHERE x > 10;",
+    "SELECT SUM(x) FROM concurrent_test WHERE y < 50;",
+    "SELECT MAX(y) FROM concurrent_test WHERE x <> 7;",
+    "SELECT COUNT(*) FROM concurrent_test WHERE MOD(x, 3) = 1;"};
+
+int64_t run_query(const std::string& query_str) {
+  const auto rows = run_multiple_agg(query_str);
+  const auto crt_row = rows->getNextRow(true, true);
+  CHECK_EQ(size_t(1), crt_row.size());
+  return v<int64_t>(crt_row[0]);
+}
+
+void create_and_populate_table() {
+  run_ddl_statement("DROP TABLE IF EXISTS concurrent_test;");
+  run_ddl_statement(
+      "CREATE TABLE concurrent_test (x INT, y INT) WITH (fragment_size=500);");
+  for (size_t i = 0; i < g_num_rows; ++i) {
+    run_multiple_agg("INSERT INTO concurrent_test VALUES(" + std::to_string(i % 1000) +
+                     ", " + std::to_string(i % 100) + ");");
+  }
+}
+
+std::vector<int64_t> run_all_queries() {
+  std::vector<int64_t> results;
+  for (const auto& query : g_queries) {
+    results.push_back(run_query(query));
+  }
+  return results;
+}
+
+class ScopedNumExecutors {
+ public:
+  explicit ScopedNumExecutors(const size_t num_executors)
+      : saved_num_executors_(g_num_executors) {
+    g_num_executors = num_executors;
+  }
+
+  ~ScopedNumExecutors() { g_num_executors = saved_num_executors_; }
+
+ private:
+  const size_t saved_num_executors_;
+};
+
+}  // namespace
+
+TEST(Concurrent, RunsBesideBusyExecutor) {
+  const auto expected = run_all_queries();
+  const auto db_id = g_session->getCatalog().getCurrentDB().dbId;
+  ScopedNumExecutors num_executors(2);
+  auto busy_executor = Executor::acquireExecutor(db_id);
+
+  // With one executor held for the whole query, the queries can only complete if
+  // they get the other one.
+  auto client = std::async(std::launch::async, run_all_queries);
+  if (client.wait_for(g_query_timeout) != std::future_status::ready) {
+    busy_executor.reset();
+    FAIL() << "The queries waited for the busy executor";
+  }
+  EXPECT_EQ(expected, client.get());
+
+  auto other_executor = std::async(std::launch::async, [db_id] {
+    return Executor::acquireExecutor(db_id);
+  });
+  if (other_executor.wait_for(g_query_timeout) != std::future_status::ready) {
+    busy_executor.reset();
+    FAIL() << "The executor pool handed out a single executor";
+  }
+  EXPECT_NE(busy_executor.get(), other_executor.get().get());
+}
+
+TEST(Concurrent, WaitsForFreeExecutor) {
+  const auto expected = run_all_queries();
+  const auto db_id = g_session->getCatalog().getCurrentDB().dbId;
+  ScopedNumExecutors num_executors(1);
+  auto busy_executor = Executor::acquireExecutor(db_id);
+
+  auto client = std::async(std::launch::async, run_all_queries);
+  // The only executor is held, the client can't have made any progress.
+  EXPECT_EQ(std::future_status::timeout,
+            client.wait_for(std::chrono::milliseconds(100)));
+  busy_executor.reset();
+  ASSERT_EQ(std::future_status::ready, client.wait_for(g_query_timeout));
+  EXPECT_EQ(expected, client.get());
+}
+
+TEST(Concurrent, ClientsGetSameResults) {
+  const auto expected = run_all_queries();
+  const auto num_clients = static_cast<size_t>(std::max(cpu_threads() / 2, 2));
+  ScopedNumExecutors num_executors(num_clients);
+  std::vector<std::future<void>> clients;
+  for (size_t client_idx = 0; client_idx < num_clients; ++client_idx) {
+    clients.emplace_back(std::async(std::launch::async, [client_idx, &expected] {
+      for (size_t i = 0; i < g_queries_per_client; ++i) {
+        const auto query_idx = (client_idx + i) % g_queries.size();
+        ASSERT_EQ(expected[query_idx], run_query(g_queries[query_idx]));
+      }
+    }));
+  }
+  for (auto& client : clients) {
+    ASSERT_EQ(std::future_status::ready, client.wait_for(g_query_timeout));
+    client.get();
+  }
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+
+  g_session.reset(QueryRunner::get_session(BASE_PATH));
+
+  int err{0};
+  try {
+    create_and_populate_table();
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+
+  run_ddl_statement("DROP TABLE IF EXISTS concurrent_test;");
+  g_session.reset(nullptr);
+  return err;
+}
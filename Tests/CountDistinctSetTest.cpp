@@ -0,0 +1,131 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/CountDistinctSet.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+std::vector<int64_t> random_values(const size_t count, const int64_t range, int seed) {
+  std::mt19937_64 gen(seed);
+  std::uniform_int_distribution<int64_t> dist(-range, range);
+  std::vector<int64_t> vals;
+  for (size_t i = 0; i < count; ++i) {
+    vals.push_back(dist(gen));
+  }
+  return vals;
+}
+
+}  // namespace
+
+TEST(CountDistinctSet, EmptyKey) {
+  const auto empty_key = std::numeric_limits<int64_t>::min();
+  CountDistinctSet set;
+  ASSERT_EQ(size_t(0), set.size());
+  set.insert(empty_key);
+  set.insert(empty_key);
+  ASSERT_EQ(size_t(1), set.size());
+  set.insert(0);
+  set.insert(std::numeric_limits<int64_t>::max());
+  ASSERT_EQ(size_t(3), set.size());
+
+  const std::vector<int64_t> vals{empty_key, 1, empty_key, 2};
+  CountDistinctSet batch_set;
+  batch_set.insert(vals.data(), vals.size());
+  ASSERT_EQ(size_t(3), batch_set.size());
+}
+
+TEST(CountDistinctSet, BatchInsertRehash) {
+  // Far more values than the initial table, the batch insert rehashes several times.
+  const auto vals = random_values(100000, 30000, 1);
+  const std::set<int64_t> ref(vals.begin(), vals.end());
+  CountDistinctSet set;
+  const auto initial_bytes = set.memoryBytes();
+  set.insert(vals.data(), vals.size());
+  ASSERT_EQ(ref.size(), set.size());
+  ASSERT_LT(initial_bytes, set.memoryBytes());
+  // Inserting the same values again doesn't change anything.
+  set.insert(vals.data(), vals.size());
+  ASSERT_EQ(ref.size(), set.size());
+}
+
+TEST(CountDistinctSet, UniteDifferentSizes) {
+  const auto small_vals = random_values(100, 1000, 2);
+  auto large_vals = random_values(50000, 100000, 3);
+  large_vals.push_back(std::numeric_limits<int64_t>::min());
+  std::set<int64_t> ref(small_vals.begin(), small_vals.end());
+  ref.insert(large_vals.begin(), large_vals.end());
+
+  CountDistinctSet small_set;
+  small_set.insert(small_vals.data(), small_vals.size());
+  CountDistinctSet large_set;
+  large_set.insert(large_vals.data(), large_vals.size());
+
+  // Same as count_distinct_set_union: merge the smaller set into the larger one and
+  // copy the result back.
+  large_set.unite(small_set);
+  ASSERT_EQ(ref.size(), large_set.size());
+  small_set = large_set;
+  ASSERT_EQ(ref.size(), small_set.size());
+  ASSERT_EQ(large_set.memoryBytes(), small_set.memoryBytes());
+
+  // The other way around gives the same union.
+  CountDistinctSet other_small_set;
+  other_small_set.insert(small_vals.data(), small_vals.size());
+  CountDistinctSet other_large_set;
+  other_large_set.insert(large_vals.data(), large_vals.size());
+  other_small_set.unite(other_large_set);
+  ASSERT_EQ(ref.size(), other_small_set.size());
+}
+
+TEST(CountDistinctSet, ChargedBytes) {
+  std::atomic<size_t> charged_bytes{0};
+  {
+    CountDistinctSet set;
+    set.setChargedBytes(&charged_bytes);
+    ASSERT_EQ(set.memoryBytes(), charged_bytes);
+    const auto vals = random_values(10000, 1000000, 4);
+    set.insert(vals.data(), vals.size());
+    ASSERT_EQ(set.memoryBytes(), charged_bytes);
+
+    CountDistinctSet copy;
+    copy.setChargedBytes(&charged_bytes);
+    copy = set;
+    ASSERT_EQ(set.memoryBytes() + copy.memoryBytes(), charged_bytes);
+  }
+  ASSERT_EQ(size_t(0), charged_bytes);
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
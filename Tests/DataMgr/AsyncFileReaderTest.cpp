@@ -0,0 +1,145 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../DataMgr/FileMgr/AsyncFileReader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+const size_t g_file_size{1 << 20};
+
+class TestFile {
+ public:
+  TestFile() {
+    std::string path_template = std::string(BASE_PATH) + "/async_reader_XXXXXX";
+    fd_ = mkstemp(&path_template[0]);
+    CHECK_GE(fd_, 0);
+    // Only the descriptor is needed, nothing is left behind by the death tests.
+    unlink(path_template.c_str());
+    contents_.resize(g_file_size);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = static_cast<int8_t>(i * 31 + i / 4096);
+    }
+    CHECK_EQ(static_cast<ssize_t>(contents_.size()),
+             write(fd_, contents_.data(), contents_.size()));
+  }
+
+  ~TestFile() { close(fd_); }
+
+  int fd() const { return fd_; }
+  const std::vector<int8_t>& contents() const { return contents_; }
+
+ private:
+  int fd_;
+  std::vector<int8_t> contents_;
+};
+
+// Runs every test with io_uring, where built in and supported, and with the I/O threads.
+class AsyncFileReaderTest : public ::testing::TestWithParam<bool> {
+ protected:
+  // Outlives the reader, which may still have readahead hints for it queued.
+  TestFile file_;
+  File_Namespace::AsyncFileReader reader_{2, 4, GetParam()};
+};
+
+}  // namespace
+
+TEST_P(AsyncFileReaderTest, ReadsAllRequests) {
+  // More requests than the queue depth, of odd sizes and offsets.
+  std::vector<int8_t> buf(g_file_size);
+  std::vector<File_Namespace::FileReadRequest> requests;
+  size_t offset{0};
+  for (size_t size = 1; offset < g_file_size; size = size * 3 + 7) {
+    size = std::min(size, g_file_size - offset);
+    requests.push_back({file_.fd(), offset, size, buf.data() + offset});
+    offset += size;
+  }
+  ASSERT_LT(size_t(4), requests.size());
+  reader_.read(requests);
+  EXPECT_EQ(file_.contents(), buf);
+}
+
+TEST_P(AsyncFileReaderTest, ReadsUpToEndOfFile) {
+  std::vector<int8_t> buf(4096);
+  reader_.read({{file_.fd(), g_file_size - buf.size(), buf.size(), buf.data()},
+                {file_.fd(), 0, buf.size() / 2, buf.data()}});
+  EXPECT_TRUE(std::equal(
+      buf.begin() + buf.size() / 2, buf.end(), file_.contents().end() - buf.size() / 2));
+  EXPECT_TRUE(std::equal(
+      buf.begin(), buf.begin() + buf.size() / 2, file_.contents().begin()));
+}
+
+TEST_P(AsyncFileReaderTest, ReadPastEndOfFileFails) {
+  // The first read of the request comes back short, the rest of it hits the end of the
+  // file, which means the page the FileMgr expected isn't there.
+  std::vector<int8_t> buf(8192);
+  const auto offset = g_file_size - buf.size() / 2;
+  EXPECT_DEATH(reader_.read({{file_.fd(), offset, buf.size(), buf.data()},
+                             {file_.fd(), 0, buf.size(), buf.data()}}),
+               "Error trying to read from file");
+  EXPECT_DEATH(reader_.read({{file_.fd(), offset, buf.size(), buf.data()}}),
+               "Error trying to read from file");
+}
+
+TEST_P(AsyncFileReaderTest, ReadaheadDoesNotBlock) {
+  std::vector<File_Namespace::FileReadRequest> requests;
+  for (size_t offset = 0; offset < 2 * g_file_size; offset += 4096) {
+    // Hints past the end of the file are harmless.
+    requests.push_back({file_.fd(), offset, 4096, nullptr});
+  }
+  reader_.readahead(requests);
+  std::vector<int8_t> buf(g_file_size);
+  const auto half = g_file_size / 2;
+  reader_.read({{file_.fd(), 0, half, buf.data()},
+                {file_.fd(), half, half, buf.data() + half}});
+  EXPECT_EQ(file_.contents(), buf);
+}
+
+TEST(AsyncFileReader, FallsBackToThreads) {
+  File_Namespace::AsyncFileReader reader(2, 4, false);
+  EXPECT_FALSE(reader.usesIoUring());
+}
+
+INSTANTIATE_TEST_CASE_P(IoUringOrThreads, AsyncFileReaderTest, ::testing::Bool());
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+  // The reader has threads of its own.
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+  int err{0};
+  try {
+    boost::filesystem::create_directories(BASE_PATH);
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../DataMgr/BufferMgr/CpuBufferMgr/CpuBufferMgr.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace {
+
+const size_t g_page_size{512};
+const size_t g_pool_pages{16};
+
+// Stands in for the FileMgr, every chunk is a single page of zeros.
+class ChunkSource : public Data_Namespace::AbstractBufferMgr {
+ public:
+  ChunkSource() : AbstractBufferMgr(0) {}
+
+  void fetchBuffer(const ChunkKey& key,
+                   Data_Namespace::AbstractBuffer* destBuffer,
+                   const size_t numBytes) override {
+    const auto chunk_size = numBytes ? numBytes : g_page_size;
+    destBuffer->reserve(chunk_size);
+    std::memset(destBuffer->getMemoryPtr(), 0, chunk_size);
+    destBuffer->setSize(chunk_size);
+  }
+
+  Data_Namespace::AbstractBuffer* createBuffer(const ChunkKey&,
+                                               const size_t,
+                                               const size_t) override {
+    CHECK(false);
+    return nullptr;
+  }
+  void deleteBuffer(const ChunkKey&, const bool) override { CHECK(false); }
+  void deleteBuffersWithPrefix(const ChunkKey&, const bool) override {}
+  Data_Namespace::AbstractBuffer* getBuffer(const ChunkKey&, const size_t) override {
+    CHECK(false);
+    return nullptr;
+  }
+  Data_Namespace::AbstractBuffer* putBuffer(const ChunkKey&,
+                                            Data_Namespace::AbstractBuffer*,
+                                            const size_t) override {
+    CHECK(false);
+    return nullptr;
+  }
+  void getChunkMetadataVec(std::vector<std::pair<ChunkKey, ChunkMetadata>>&) override {}
+  void getChunkMetadataVecForKeyPrefix(std::vector<std::pair<ChunkKey, ChunkMetadata>>&,
+                                       const ChunkKey&) override {}
+  bool isBufferOnDevice(const ChunkKey&) override { return true; }
+  std::string printSlabs() override { return ""; }
+  void clearSlabs() override {}
+  size_t getMaxSize() override { return 0; }
+  size_t getInUseSize() override { return 0; }
+  size_t getAllocated() override { return 0; }
+  bool isAllocationCapped() override { return false; }
+  void checkpoint() override {}
+  void checkpoint(const int, const int) override {}
+  Data_Namespace::AbstractBuffer* alloc(const size_t) override {
+    CHECK(false);
+    return nullptr;
+  }
+  void free(Data_Namespace::AbstractBuffer*) override { CHECK(false); }
+  MgrType getMgrType() override { return FILE_MGR; }
+  std::string getStringMgrType() override { return ToString(FILE_MGR); }
+  size_t getNumChunks() override { return 0; }
+};
+
+ChunkKey hot_key(const int frag_id) {
+  return {1, 1, 1, frag_id};
+}
+
+ChunkKey scan_key(const int frag_id) {
+  return {1, 2, 1, frag_id};
+}
+
+void read_chunk(Buffer_Namespace::BufferMgr& buffer_mgr, const ChunkKey& key) {
+  auto buffer = buffer_mgr.getBuffer(key, g_page_size);
+  CHECK(buffer);
+  buffer->unPin();
+}
+
+// Loads four chunks and reads them again so that they count as hot, then scans four
+// times as many chunks of another table as the pool can hold, each read twice, the
+// way a sequence of queries over it would.
+size_t hot_chunks_left_after_scan(const Buffer_Namespace::EvictionPolicy policy,
+                                  const bool large_scan) {
+  ChunkSource chunk_source;
+  Buffer_Namespace::CpuBufferMgr buffer_mgr(0,
+                                            g_pool_pages * g_page_size,
+                                            nullptr,
+                                            g_pool_pages * g_page_size,
+                                            g_page_size,
+                                            &chunk_source,
+                                            policy);
+  const int hot_chunk_count{4};
+  for (int i = 0; i < 2; ++i) {
+    for (int frag_id = 0; frag_id < hot_chunk_count; ++frag_id) {
+      read_chunk(buffer_mgr, hot_key(frag_id));
+    }
+  }
+  {
+    Buffer_Namespace::ScopedLargeScan scan_hint(large_scan);
+    for (int frag_id = 0; frag_id < static_cast<int>(4 * g_pool_pages); ++frag_id) {
+      read_chunk(buffer_mgr, scan_key(frag_id));
+      read_chunk(buffer_mgr, scan_key(frag_id));
+    }
+  }
+  size_t hot_chunks_left{0};
+  for (int frag_id = 0; frag_id < hot_chunk_count; ++frag_id) {
+    hot_chunks_left += buffer_mgr.isBufferOnDevice(hot_key(frag_id)) ? 1 : 0;
+  }
+  return hot_chunks_left;
+}
+
+}  // namespace
+
+TEST(BufferMgr, LruScanFlushesHotChunks) {
+  EXPECT_EQ(size_t(0),
+            hot_chunks_left_after_scan(Buffer_Namespace::EvictionPolicy::LRU, true));
+}
+
+TEST(BufferMgr, TwoQLargeScanKeepsHotChunks) {
+  EXPECT_EQ(size_t(4),
+            hot_chunks_left_after_scan(Buffer_Namespace::EvictionPolicy::TWO_Q, true));
+}
+
+TEST(BufferMgr, TwoQRereadScanPromotesChunks) {
+  // Without the large scan hint, the chunks read twice are hot as well and take over.
+  EXPECT_EQ(size_t(0),
+            hot_chunks_left_after_scan(Buffer_Namespace::EvictionPolicy::TWO_Q, false));
+}
+
+TEST(BufferMgr, PrefixLookup) {
+  ChunkSource chunk_source;
+  Buffer_Namespace::CpuBufferMgr buffer_mgr(0,
+                                            g_pool_pages * g_page_size,
+                                            nullptr,
+                                            g_pool_pages * g_page_size,
+                                            g_page_size,
+                                            &chunk_source);
+  // The index buffer of a varlen column's chunk.
+  read_chunk(buffer_mgr, {1, 3, 2, 0, 2});
+  EXPECT_FALSE(buffer_mgr.isBufferOnDevice({1, 3, 2, 0}));
+  EXPECT_TRUE(buffer_mgr.isBufferWithPrefixOnDevice({1, 3, 2, 0}));
+  EXPECT_TRUE(buffer_mgr.isBufferWithPrefixOnDevice({1, 3}));
+  EXPECT_FALSE(buffer_mgr.isBufferWithPrefixOnDevice({1, 3, 2, 1}));
+  EXPECT_FALSE(buffer_mgr.isBufferWithPrefixOnDevice({1, 4}));
+  read_chunk(buffer_mgr, {1, 3, 1, 0});
+  EXPECT_TRUE(buffer_mgr.isBufferWithPrefixOnDevice({1, 3, 1, 0}));
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
@@ -1368,6 +1368,10 @@ TEST(Select, CountDistinct) {
         c("SELECT z, str, COUNT(distinct f) FROM test GROUP BY z, str ORDER BY str DESC;",
           dt));  // Exception: Cannot use a fast path for COUNT distinct
     c("SELECT COUNT(distinct x * (50000 - 1)) FROM test;", dt);
+    SKIP_ON_AGGREGATOR(
+        c("SELECT y, COUNT(distinct d), COUNT(distinct x * (50000 - 1)) FROM test GROUP "
+          "BY y ORDER BY y;",
+          dt));  // Exception: Cannot use a fast path for COUNT distinct
     EXPECT_THROW(run_multiple_agg("SELECT COUNT(distinct real_str) FROM test;", dt),
                  std::runtime_error);  // Exception: Strings must be dictionary-encoded
                                        // for COUNT(DISTINCT).
@@ -1856,6 +1860,22 @@ TEST(Select, Case) {
   }
 }
 
+TEST(Select, LiteralDictionary) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    // The strings of these expressions only exist in the dictionary of the literals.
+    c("SELECT CASE WHEN x = 7 THEN 'seven' ELSE 'other' END AS key0, COUNT(*) FROM test "
+      "GROUP BY key0 ORDER BY key0;",
+      dt);
+    c("SELECT CASE WHEN x = 7 THEN 'seven' ELSE real_str END AS key0, COUNT(*) FROM test "
+      "GROUP BY key0 ORDER BY key0;",
+      dt);
+    c("SELECT COUNT(*) FROM test WHERE CASE WHEN x = 7 THEN 'seven' ELSE real_str END "
+      "LIKE '%ee%';",
+      dt);
+  }
+}
+
 TEST(Select, Strings) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -5966,6 +5986,25 @@ TEST(Select, Joins_FilterPushDown) {
   g_filter_push_down_low_frac = default_lower_frac;
 }
 
+TEST(Select, StringCompareAcrossDictionaries) {
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    c("SELECT COUNT(*) FROM join_test WHERE str = dup_str;", dt);
+    c("SELECT COUNT(*) FROM join_test WHERE str <> dup_str;", dt);
+    // The literal is only added to the dictionary of dup_str as a transient string
+    // while generating the code of the right side.
+    c("SELECT COUNT(*) FROM join_test WHERE str = CASE WHEN x = 7 THEN dup_str ELSE "
+      "'baz' END;",
+      dt);
+    c("SELECT COUNT(*) FROM join_test WHERE str <> CASE WHEN x = 7 THEN dup_str ELSE "
+      "'baz' END;",
+      dt);
+    c("SELECT x FROM join_test WHERE str = CASE WHEN x > 8 THEN 'baz' ELSE dup_str END "
+      "ORDER BY x;",
+      dt);
+  }
+}
+
 TEST(Select, Joins_InnerJoin_TwoTables) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -13803,6 +13842,63 @@ TEST(Select, WindowFunctionTestAggregate) {
     dt);
 }
 
+TEST(Select, WindowFunctionTestMultipleOrderKeys) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  c("SELECT x, y, t, RANK() OVER (PARTITION BY y ORDER BY x ASC, t DESC) r1, "
+    "DENSE_RANK() OVER (PARTITION BY y ORDER BY x ASC, t DESC) r2, ROW_NUMBER() OVER "
+    "(PARTITION BY y ORDER BY t DESC) r3 FROM test_window_func ORDER BY x ASC, y ASC, "
+    "t ASC, r1 ASC, r2 ASC, r3 ASC;",
+    dt);
+}
+
+TEST(Select, WindowFunctionTestFrame) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const ExecutorDeviceType dt = ExecutorDeviceType::CPU;
+  c("SELECT x, y, t, AVG(x) OVER (PARTITION BY y ORDER BY t ASC ROWS BETWEEN 2 PRECEDING "
+    "AND CURRENT ROW) a, SUM(x) OVER (PARTITION BY y ORDER BY t DESC ROWS BETWEEN 1 "
+    "PRECEDING AND 1 FOLLOWING) s, MIN(x) OVER (PARTITION BY y ORDER BY t ASC ROWS "
+    "BETWEEN CURRENT ROW AND 2 FOLLOWING) m1, MAX(x) OVER (PARTITION BY y ORDER BY t ASC "
+    "ROWS BETWEEN 3 PRECEDING AND 1 PRECEDING) m2, COUNT(x) OVER (PARTITION BY y ORDER "
+    "BY t ASC ROWS BETWEEN 1 FOLLOWING AND UNBOUNDED FOLLOWING) c FROM test_window_func "
+    "ORDER BY x ASC, y ASC, t ASC;",
+    dt);
+  c("SELECT x, y, t, SUM(t) OVER (PARTITION BY y ORDER BY x ASC RANGE BETWEEN CURRENT "
+    "ROW AND UNBOUNDED FOLLOWING) s, COUNT(*) OVER (PARTITION BY y ORDER BY x DESC RANGE "
+    "BETWEEN UNBOUNDED PRECEDING AND UNBOUNDED FOLLOWING) c FROM test_window_func ORDER "
+    "BY x ASC, y ASC, t ASC;",
+    dt);
+  {
+    // The peers of the current row are in its RANGE frame with offsets too.
+    const auto rows = run_multiple_agg(
+        "SELECT t, SUM(x) OVER (PARTITION BY y ORDER BY x ASC RANGE BETWEEN 3 PRECEDING "
+        "AND CURRENT ROW) s FROM test_window_func ORDER BY t ASC;",
+        dt);
+    const std::vector<int64_t> expected_sums{1, 0, 2, 37, 3, 15, 39, 15, 39, 39};
+    ASSERT_EQ(expected_sums.size(), rows->rowCount());
+    for (size_t row_idx = 0; row_idx < rows->rowCount(); ++row_idx) {
+      ASSERT_EQ(expected_sums[row_idx], v<int64_t>(rows->getRowAt(row_idx, 1, true)));
+    }
+  }
+  EXPECT_THROW(run_multiple_agg("SELECT SUM(x) OVER (PARTITION BY y ORDER BY x ASC, t "
+                                "ASC RANGE 1 PRECEDING) FROM test_window_func;",
+                                dt),
+               std::runtime_error);
+  {
+    // The DATE column is stored in days, the aggregates return epoch seconds.
+    const auto rows = run_multiple_agg(
+        "SELECT MIN(o) OVER (PARTITION BY x ORDER BY y ASC ROWS BETWEEN 1 PRECEDING AND "
+        "1 FOLLOWING) m1, MAX(o) OVER (PARTITION BY x ORDER BY y ASC ROWS BETWEEN "
+        "UNBOUNDED PRECEDING AND CURRENT ROW) m2 FROM test WHERE o IS NOT NULL;",
+        dt);
+    ASSERT_GT(rows->rowCount(), size_t(0));
+    for (size_t row_idx = 0; row_idx < rows->rowCount(); ++row_idx) {
+      ASSERT_EQ(936835200, v<int64_t>(rows->getRowAt(row_idx, 0, true)));
+      ASSERT_EQ(936835200, v<int64_t>(rows->getRowAt(row_idx, 1, true)));
+    }
+  }
+}
+
 namespace {
 
 int create_sharded_join_table(const std::string& table_name,
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/FragmentPrefetcher.h"
+#include "../QueryEngine/InputMetadata.h"
+#include "../QueryEngine/ResultSet.h"
+#include "../QueryRunner/QueryRunner.h"
+#include "../Shared/TaskPool.h"
+#include "../Shared/thread_count.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <limits>
+#include <thread>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+std::unique_ptr<Catalog_Namespace::SessionInfo> g_session;
+
+// One row per fragment, so that there are more kernels than CPU threads.
+const size_t g_num_rows = 2 * cpu_threads() + 8;
+
+inline void run_ddl_statement(const std::string& query_str) {
+  QueryRunner::run_ddl_statement(query_str, g_session);
+}
+
+std::shared_ptr<ResultSet> run_multiple_agg(const std::string& query_str) {
+  return QueryRunner::run_multiple_agg(
+      query_str, g_session, ExecutorDeviceType::CPU, true, true);
+}
+
+template <class T>
+T v(const TargetValue& r) {
+  auto scalar_r = boost::get<ScalarTargetValue>(&r);
+  CHECK(scalar_r);
+  auto p = boost::get<T>(scalar_r);
+  CHECK(p);
+  return *p;
+}
+
+void create_and_populate_table() {
+  run_ddl_statement("DROP TABLE IF EXISTS prefetch_test;");
+  run_ddl_statement(
+      "CREATE TABLE prefetch_test (x INT, y BIGINT) WITH (fragment_size=1);");
+  for (size_t i = 0; i < g_num_rows; ++i) {
+    run_multiple_agg("INSERT INTO prefetch_test VALUES(" + std::to_string(i) + ", " +
+                     std::to_string(2 * i) + ");");
+  }
+}
+
+RelAlgExecutionUnit build_ra_exe_unit(const int table_id,
+                                      const std::vector<int>& col_ids) {
+  std::list<std::shared_ptr<const InputColDescriptor>> input_col_descs;
+  for (const auto col_id : col_ids) {
+    input_col_descs.push_back(
+        std::make_shared<const InputColDescriptor>(col_id, table_id, 0));
+  }
+  return RelAlgExecutionUnit{{InputDescriptor(table_id, 0)},
+                             input_col_descs,
+                             {},
+                             {},
+                             {},
+                             {},
+                             {},
+                             nullptr,
+                             SortInfo{{}, SortAlgorithm::Default, 0, 0},
+                             0};
+}
+
+}  // namespace
+
+TEST(FragmentPrefetcher, SameResults) {
+  const auto saved_depth = g_fragment_prefetch_depth;
+  for (const size_t depth : {size_t(0), size_t(2), size_t(8)}) {
+    g_fragment_prefetch_depth = depth;
+    const auto rows = run_multiple_agg(
+        "SELECT COUNT(*), SUM(x), SUM(y) FROM prefetch_test WHERE x >= 0;");
+    const auto crt_row = rows->getNextRow(true, true);
+    ASSERT_EQ(size_t(3), crt_row.size());
+    const int64_t n = g_num_rows;
+    EXPECT_EQ(n, v<int64_t>(crt_row[0]));
+    EXPECT_EQ(n * (n - 1) / 2, v<int64_t>(crt_row[1]));
+    EXPECT_EQ(n * (n - 1), v<int64_t>(crt_row[2]));
+    if (depth) {
+      // The kernels past the CPU threads wait for a running one and get prefetched.
+      EXPECT_LT(size_t(0), rows->getKernelTimes().prefetched_chunks);
+    } else {
+      EXPECT_EQ(size_t(0), rows->getKernelTimes().prefetched_chunks);
+    }
+  }
+  g_fragment_prefetch_depth = saved_depth;
+}
+
+TEST(FragmentPrefetcher, FetchesWhileTaskPoolBusy) {
+  auto& cat = g_session->getCatalog();
+  const auto td = cat.getMetadataForTable("prefetch_test");
+  ASSERT_TRUE(td);
+  const auto x_cd = cat.getMetadataForColumn(td->tableId, "x");
+  const auto y_cd = cat.getMetadataForColumn(td->tableId, "y");
+  ASSERT_TRUE(x_cd && y_cd);
+  const auto ra_exe_unit =
+      build_ra_exe_unit(td->tableId, {x_cd->columnId, y_cd->columnId});
+  const std::vector<InputTableInfo> table_infos{
+      {td->tableId, td->fragmenter->getFragmentsForQuery()}};
+  const auto num_frags = table_infos.front().info.fragments.size();
+  ASSERT_EQ(g_num_rows, num_frags);
+  std::vector<FragmentsList> kernel_frag_lists;
+  for (size_t frag_idx = 0; frag_idx < num_frags; ++frag_idx) {
+    kernel_frag_lists.push_back({{td->tableId, {frag_idx}}});
+  }
+
+  // Occupy every worker the pool may have, the way running kernels do.
+  std::promise<void> unblock;
+  std::shared_future<void> unblocked(unblock.get_future());
+  std::vector<TaskPool_NS::TaskFuture<void>> busy;
+  for (int i = 0; i < 4 * cpu_threads(); ++i) {
+    busy.push_back(TaskPool_NS::async([unblocked] { unblocked.wait(); }));
+  }
+
+  FetchComputeStats stats;
+  {
+    FragmentPrefetcher prefetcher(cat,
+                                  ra_exe_unit,
+                                  table_infos,
+                                  kernel_frag_lists,
+                                  num_frags,
+                                  std::numeric_limits<size_t>::max(),
+                                  stats);
+    prefetcher.prefetch(0);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (stats.prefetched_chunks < 2 * num_frags &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    unblock.set_value();
+  }
+  EXPECT_EQ(2 * num_frags, stats.prefetched_chunks.load());
+  for (auto& task : busy) {
+    task.get();
+  }
+}
+
+int main(int argc, char* argv[]) {
+  google::InitGoogleLogging(argv[0]);
+  ::testing::InitGoogleTest(&argc, argv);
+
+  g_session.reset(QueryRunner::get_session(BASE_PATH));
+
+  int err{0};
+  try {
+    create_and_populate_table();
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+
+  run_ddl_statement("DROP TABLE IF EXISTS prefetch_test;");
+  g_session.reset(nullptr);
+  return err;
+}
@@ -17,11 +17,13 @@
 #include "TestHelpers.h"
 
 #include "../Import/Importer.h"
+#include "../Import/StructuralCharScanner.h"
 
 #include <algorithm>
 #include <limits>
 #include <string>
 
+#include <arrow/api.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -288,6 +290,110 @@ TEST(Detect, Numeric) {
   d(kTEXT, "1.22.22");
 }
 
+TEST(ArrowImport, NullsAndBorrowedValues) {
+  ColumnDescriptor cd;
+  cd.columnName = "i";
+  cd.columnType = SQLTypeInfo(kINT, false);
+  arrow::Int32Builder builder;
+  std::vector<int32_t> expected;
+  for (int32_t i = 0; i < 200; ++i) {
+    if (i % 7 == 3) {
+      ASSERT_TRUE(builder.AppendNull().ok());
+      expected.push_back(NULL_INT);
+    } else {
+      ASSERT_TRUE(builder.Append(i).ok());
+      expected.push_back(i);
+    }
+  }
+  std::shared_ptr<arrow::Array> with_nulls;
+  ASSERT_TRUE(builder.Finish(&with_nulls).ok());
+
+  Importer_NS::TypedImportBuffer import_buffer(&cd, nullptr);
+  EXPECT_FALSE(import_buffer.borrow_arrow_values(&cd, *with_nulls));
+  ASSERT_EQ(expected.size(),
+            import_buffer.add_arrow_values(&cd, *with_nulls, true, nullptr));
+  const auto values = reinterpret_cast<const int32_t*>(import_buffer.getAsBytes());
+  EXPECT_EQ(expected, std::vector<int32_t>(values, values + expected.size()));
+
+  // a slice without nulls is referred to rather than copied
+  const auto no_nulls = with_nulls->Slice(4, 3);
+  import_buffer.clear();
+  ASSERT_TRUE(import_buffer.borrow_arrow_values(&cd, *no_nulls));
+  EXPECT_EQ(
+      reinterpret_cast<const int8_t*>(
+          std::static_pointer_cast<arrow::Int32Array>(no_nulls)->raw_values()),
+      import_buffer.getAsBytes());
+}
+
+TEST(ArrowImport, EmptyNullArrayNotBorrowed) {
+  // The columns without a physical arrow type are converted, even from an empty batch.
+  for (const auto type : {kTEXT, kDATE}) {
+    ColumnDescriptor cd;
+    cd.columnName = "c";
+    cd.columnType = SQLTypeInfo(type, false);
+    if (type == kTEXT) {
+      cd.columnType.set_compression(kENCODING_DICT);
+    }
+    arrow::NullBuilder builder;
+    std::shared_ptr<arrow::Array> empty;
+    ASSERT_TRUE(builder.Finish(&empty).ok());
+    ASSERT_EQ(arrow::Type::NA, empty->type_id());
+    Importer_NS::TypedImportBuffer import_buffer(&cd, nullptr);
+    EXPECT_FALSE(import_buffer.borrow_arrow_values(&cd, *empty));
+  }
+}
+
+TEST(StructuralCharScanner, Find) {
+  const Importer_NS::StructuralCharScanner scanner(",\"\n");
+  const std::string text = "0123456789abcdefghijklmnopqrstuvwxyz,\"\n";
+  const char* end = text.data() + text.size();
+  for (size_t i = 0; i < text.size(); ++i) {
+    const char* found = scanner.find(text.data() + i, end);
+    EXPECT_EQ(std::max(i, text.find(',')), static_cast<size_t>(found - text.data()));
+  }
+  const std::string plain(40, 'a');
+  EXPECT_EQ(plain.data() + plain.size(),
+            scanner.find(plain.data(), plain.data() + plain.size()));
+}
+
+const char* create_table_quoted = R"(
+    CREATE TABLE import_test_quoted(
+      i INTEGER,
+      quoted TEXT ENCODING DICT(32),
+      plain TEXT ENCODING DICT(32)
+    );
+  )";
+
+class ImportTestQuoted : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists import_test_quoted;"));
+    ASSERT_NO_THROW(run_ddl_statement(create_table_quoted););
+  }
+
+  void TearDown() override {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists import_test_quoted;"));
+  }
+};
+
+TEST_F(ImportTestQuoted, EscapedAndPaddedFields) {
+  EXPECT_NO_THROW(
+      run_ddl_statement("copy import_test_quoted from "
+                        "'../../Tests/Import/datafiles/quoted_escaped.csv' with "
+                        "(header='false');"));
+  const auto count = [](const std::string& where) {
+    auto rows = run_query("SELECT COUNT(*) FROM import_test_quoted WHERE " + where + ";");
+    auto crt_row = rows->getNextRow(true, true);
+    CHECK_EQ(size_t(1), crt_row.size());
+    return v<int64_t>(crt_row[0]);
+  };
+  EXPECT_EQ(int64_t(1),
+            count("i = 1 AND quoted = 'a, quoted \"field\" that is longer than "
+                  "sixteen bytes' AND plain = 'plain field padded'"));
+  EXPECT_EQ(int64_t(1), count("i = 2 AND plain = 'x'"));
+  EXPECT_EQ(int64_t(1), count("i = 3 AND quoted = 'short' AND plain IS NULL"));
+}
+
 const char* create_table_mixed_varlen = R"(
     CREATE TABLE import_test_mixed_varlen(
       pt GEOMETRY(POINT),
@@ -664,6 +770,30 @@ TEST_F(ImportTest, One_parquet_file_drop) {
       100,
       1.0));
 }
+TEST_F(ImportTest, One_parquet_file_projected_columns) {
+  // only some of the columns of the file, by name and in another order
+  ASSERT_NO_THROW(run_ddl_statement("drop table trips;"));
+  ASSERT_NO_THROW(
+      run_ddl_statement("CREATE TABLE trips (trip_distance DECIMAL(14,2), "
+                        "trip_time_in_secs INTEGER, medallion TEXT ENCODING DICT);"));
+  EXPECT_TRUE(import_test_local_parquet(
+      "trip.parquet",
+      "part-00000-027865e6-e4d9-40b9-97ff-83c5c5531154-c000.snappy.parquet",
+      100,
+      1.0));
+}
+TEST_F(ImportTest, One_parquet_file_mismatched_columns) {
+  // a column missing from the file and not as many columns as the file
+  ASSERT_NO_THROW(run_ddl_statement("drop table trips;"));
+  ASSERT_NO_THROW(run_ddl_statement(
+      "CREATE TABLE trips (trip_distance DECIMAL(14,2), no_such_column INTEGER);"));
+  EXPECT_THROW(import_test_local_parquet(
+                   "trip.parquet",
+                   "part-00000-027865e6-e4d9-40b9-97ff-83c5c5531154-c000.snappy.parquet",
+                   100,
+                   1.0),
+               std::runtime_error);
+}
 TEST_F(ImportTest, All_parquet_file) {
   EXPECT_TRUE(import_test_local_parquet("trip.parquet", "*.parquet", 1200, 1.0));
   EXPECT_TRUE(import_test_parquet_with_null(1200));
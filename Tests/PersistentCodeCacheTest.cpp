@@ -0,0 +1,152 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestHelpers.h"
+
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/PersistentCodeCache.h"
+#include "../QueryRunner/QueryRunner.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#ifndef BASE_PATH
+#define BASE_PATH "./tmp"
+#endif
+
+namespace {
+
+std::unique_ptr<Catalog_Namespace::SessionInfo> g_session;
+
+std::shared_ptr<ResultSet> run_multiple_agg(const std::string& query_str) {
+  return QueryRunner::run_multiple_agg(
+      query_str, g_session, ExecutorDeviceType::CPU, false, false, nullptr);
+}
+
+int64_t run_simple_agg(const std::string& query_str) {
+  const auto rows = run_multiple_agg(query_str);
+  const auto crt_row = rows->getNextRow(true, true);
+  CHECK_EQ(size_t(1), crt_row.size());
+  return TestHelpers::v<int64_t>(crt_row[0]);
+}
+
+std::string get_cache_path(const std::string& name) {
+  const auto path = boost::filesystem::path(BASE_PATH) / name;
+  boost::filesystem::remove_all(path);
+  return path.string();
+}
+
+}  // namespace
+
+TEST(PersistentCodeCache, PersistsAcrossInstances) {
+  const auto path = get_cache_path("code_cache_test");
+  {
+    PersistentCodeCache cache(path, 1 << 20);
+    cache.put("key1", "code1", 100);
+    cache.put("key2", std::string(1000, 'x'), 200);
+    std::string code;
+    int64_t compile_us{0};
+    ASSERT_TRUE(cache.get("key1", code, compile_us));
+    ASSERT_EQ("code1", code);
+    ASSERT_EQ(100, compile_us);
+    ASSERT_FALSE(cache.get("key3", code, compile_us));
+    ASSERT_EQ(size_t(1), cache.getNumHits());
+  }
+  PersistentCodeCache cache(path, 1 << 20);
+  ASSERT_EQ(size_t(2), cache.getNumEntries());
+  std::string code;
+  int64_t compile_us{0};
+  ASSERT_TRUE(cache.get("key2", code, compile_us));
+  ASSERT_EQ(std::string(1000, 'x'), code);
+  ASSERT_EQ(200, compile_us);
+  // Entries are replaced, not duplicated.
+  cache.put("key2", "code2", 300);
+  ASSERT_EQ(size_t(2), cache.getNumEntries());
+  ASSERT_TRUE(cache.get("key2", code, compile_us));
+  ASSERT_EQ("code2", code);
+}
+
+TEST(PersistentCodeCache, EvictsLeastRecentlyUsed) {
+  const auto path = get_cache_path("code_cache_evict_test");
+  const std::string code(1000, 'x');
+  PersistentCodeCache cache(path, 3500);
+  cache.put("key1", code, 0);
+  cache.put("key2", code, 0);
+  cache.put("key3", code, 0);
+  std::string read_code;
+  int64_t compile_us{0};
+  ASSERT_TRUE(cache.get("key1", read_code, compile_us));
+  cache.put("key4", code, 0);
+  ASSERT_EQ(size_t(3), cache.getNumEntries());
+  ASSERT_LE(cache.getNumBytes(), size_t(3500));
+  ASSERT_FALSE(cache.get("key2", read_code, compile_us));
+  ASSERT_TRUE(cache.get("key1", read_code, compile_us));
+  ASSERT_TRUE(cache.get("key3", read_code, compile_us));
+  ASSERT_TRUE(cache.get("key4", read_code, compile_us));
+  // Too large to ever fit.
+  cache.put("key5", std::string(4000, 'x'), 0);
+  ASSERT_FALSE(cache.get("key5", read_code, compile_us));
+  ASSERT_EQ(size_t(3), cache.getNumEntries());
+}
+
+TEST(PersistentCodeCache, RunsPersistedQueries) {
+  PersistentCodeCache::init(get_cache_path("code_cache_query_test"), 1 << 28);
+  QueryRunner::run_ddl_statement("DROP TABLE IF EXISTS code_cache_test;", g_session);
+  QueryRunner::run_ddl_statement("CREATE TABLE code_cache_test (x INT, s TEXT);",
+                                 g_session);
+  for (int i = 0; i < 10; ++i) {
+    run_multiple_agg("INSERT INTO code_cache_test VALUES (" + std::to_string(i) +
+                     ", 'str" + std::to_string(i % 3) + "');");
+  }
+  const std::vector<std::pair<std::string, int64_t>> queries{
+      {"SELECT SUM(x) FROM code_cache_test WHERE x > 3;", 39},
+      {"SELECT COUNT(*) FROM code_cache_test WHERE s LIKE '%1';", 3},
+      {"SELECT MAX(c) FROM (SELECT s, COUNT(*) AS c FROM code_cache_test GROUP BY s);",
+       4}};
+  for (const auto& query : queries) {
+    ASSERT_EQ(query.second, run_simple_agg(query.first));
+  }
+  const auto persistent_cache = PersistentCodeCache::instance();
+  ASSERT_TRUE(persistent_cache);
+  const auto num_entries = persistent_cache->getNumEntries();
+  ASSERT_GT(num_entries, size_t(0));
+  // The executors start over with empty code caches, as after a restart.
+  Executor::nukeCacheOfExecutors();
+  const auto num_hits = persistent_cache->getNumHits();
+  for (const auto& query : queries) {
+    ASSERT_EQ(query.second, run_simple_agg(query.first));
+  }
+  // Every query loaded its code from the persistent cache instead of compiling it.
+  ASSERT_GE(persistent_cache->getNumHits() - num_hits, queries.size());
+  ASSERT_EQ(num_entries, persistent_cache->getNumEntries());
+  QueryRunner::run_ddl_statement("DROP TABLE code_cache_test;", g_session);
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+  g_session.reset(QueryRunner::get_session(BASE_PATH));
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  g_session.reset(nullptr);
+  return err;
+}
@@ -25,16 +25,25 @@
 
 #include "../QueryEngine/ResultRows.h"
 #include "../QueryEngine/ResultSet.h"
+#include "../QueryEngine/ResultSetSpill.h"
 #include "../QueryEngine/RuntimeFunctions.h"
+#include "../Shared/checked_alloc.h"
 #include "../StringDictionary/StringDictionary.h"
 
+#include <boost/filesystem/operations.hpp>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstring>
+#include <future>
 #include <queue>
 #include <random>
 
+extern bool g_enable_result_spill;
+extern size_t g_result_spill_memory_budget;
+extern std::string g_result_spill_path;
+
 TEST(Construct, Allocate) {
   std::vector<TargetInfo> target_infos;
   QueryMemoryDescriptor query_mem_desc;
@@ -2186,6 +2195,229 @@ TEST(Reduce, BaselineHashColumnar) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1);
 }
 
+TEST(Reduce, BaselineHashSpilled) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  EvenNumberGenerator generator1;
+  ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+  const auto rs1 = std::make_unique<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  fill_storage_buffer(rs1->allocateStorage()->getUnderlyingBuffer(),
+                      target_infos,
+                      query_mem_desc,
+                      generator1,
+                      1);
+  const auto rs2 = std::make_unique<ResultSet>(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  fill_storage_buffer(rs2->allocateStorage()->getUnderlyingBuffer(),
+                      target_infos,
+                      query_mem_desc,
+                      generator2,
+                      1);
+  const auto spill_path = boost::filesystem::temp_directory_path() /
+                          boost::filesystem::unique_path("result_spill_%%%%-%%%%");
+  g_enable_result_spill = true;
+  g_result_spill_memory_budget = 4 * query_mem_desc.getRowSize();
+  g_result_spill_path = spill_path.string();
+  ASSERT_TRUE(should_spill_reduction(query_mem_desc, 2 * query_mem_desc.getEntryCount()));
+  // The slots of the empty entries are never read, their initial values don't matter.
+  const auto spilled_rs = reduce_baseline_hash_with_spill(
+      {rs1.get(), rs2.get()},
+      row_set_mem_owner,
+      std::vector<int64_t>(query_mem_desc.getSlotCount(), 0),
+      nullptr);
+  {
+    // The reduced result is a hash table, reducing the same keys into it adds no row.
+    const auto layout_rs = reduce_baseline_hash_with_spill(
+        {rs1.get(), rs2.get()},
+        row_set_mem_owner,
+        std::vector<int64_t>(query_mem_desc.getSlotCount(), 0),
+        nullptr);
+    const auto row_count = layout_rs->rowCount();
+    const auto rs3 = std::make_unique<ResultSet>(target_infos,
+                                                 ExecutorDeviceType::CPU,
+                                                 query_mem_desc,
+                                                 row_set_mem_owner,
+                                                 nullptr);
+    EvenNumberGenerator generator3;
+    fill_storage_buffer(rs3->allocateStorage()->getUnderlyingBuffer(),
+                        target_infos,
+                        query_mem_desc,
+                        generator3,
+                        1);
+    layout_rs->getStorage()->reduce(*rs3->getStorage(), {});
+    ASSERT_EQ(row_count, layout_rs->rowCount());
+  }
+  g_enable_result_spill = false;
+  ASSERT_TRUE(boost::filesystem::is_empty(spill_path));
+  boost::filesystem::remove_all(spill_path);
+  ResultSetManager rs_manager;
+  std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
+  const auto result_rs = rs_manager.reduce(storage_set);
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, false, false);
+  result_rs->sort(order_entries, 0);
+  spilled_rs->sort(order_entries, 0);
+  ASSERT_EQ(result_rs->rowCount(), spilled_rs->rowCount());
+  while (true) {
+    const auto row = result_rs->getNextRow(false, false);
+    const auto spilled_row = spilled_rs->getNextRow(false, false);
+    ASSERT_EQ(row.size(), spilled_row.size());
+    if (row.empty()) {
+      break;
+    }
+    for (size_t i = 0; i < row.size(); ++i) {
+      const auto val = boost::get<ScalarTargetValue>(&row[i]);
+      const auto spilled_val = boost::get<ScalarTargetValue>(&spilled_row[i]);
+      ASSERT_TRUE(val && spilled_val);
+      ASSERT_TRUE(*val == *spilled_val);
+    }
+  }
+}
+
+TEST(Reduce, BaselineHashSpilledPerKernel) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  const auto make_rs = [&](NumberGenerator& generator) {
+    auto rs = std::make_unique<ResultSet>(target_infos,
+                                          ExecutorDeviceType::CPU,
+                                          query_mem_desc,
+                                          row_set_mem_owner,
+                                          nullptr);
+    fill_storage_buffer(rs->allocateStorage()->getUnderlyingBuffer(),
+                        target_infos,
+                        query_mem_desc,
+                        generator,
+                        1);
+    return rs;
+  };
+  const auto spill_path = boost::filesystem::temp_directory_path() /
+                          boost::filesystem::unique_path("result_spill_%%%%-%%%%");
+  g_enable_result_spill = true;
+  g_result_spill_memory_budget = 4 * query_mem_desc.getRowSize();
+  g_result_spill_path = spill_path.string();
+  ResultSetSpiller spiller(2 * query_mem_desc.getEntryCount());
+  ASSERT_TRUE(spiller.empty());
+  {
+    // Like the kernels, each result is spilled as soon as it's produced and released
+    // right after, concurrently with the other one.
+    std::vector<std::future<void>> kernels;
+    for (size_t i = 0; i < 2; ++i) {
+      kernels.emplace_back(std::async(std::launch::async, [&, i] {
+        EvenNumberGenerator generator1;
+        ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() -
+                                                   1);
+        const auto rs = i ? make_rs(generator2) : make_rs(generator1);
+        spiller.spill(*rs);
+      }));
+    }
+    for (auto& kernel : kernels) {
+      kernel.get();
+    }
+  }
+  ASSERT_FALSE(spiller.empty());
+  const auto spilled_rs = spiller.reduce(
+      row_set_mem_owner, std::vector<int64_t>(query_mem_desc.getSlotCount(), 0), nullptr);
+  g_enable_result_spill = false;
+  ASSERT_TRUE(boost::filesystem::is_empty(spill_path));
+  boost::filesystem::remove_all(spill_path);
+  EvenNumberGenerator generator1;
+  ReverseOddOrEvenNumberGenerator generator2(2 * query_mem_desc.getEntryCount() - 1);
+  const auto rs1 = make_rs(generator1);
+  const auto rs2 = make_rs(generator2);
+  ResultSetManager rs_manager;
+  std::vector<ResultSet*> storage_set{rs1.get(), rs2.get()};
+  const auto result_rs = rs_manager.reduce(storage_set);
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, false, false);
+  result_rs->sort(order_entries, 0);
+  spilled_rs->sort(order_entries, 0);
+  ASSERT_EQ(result_rs->rowCount(), spilled_rs->rowCount());
+  while (true) {
+    const auto row = result_rs->getNextRow(false, false);
+    const auto spilled_row = spilled_rs->getNextRow(false, false);
+    ASSERT_EQ(row.size(), spilled_row.size());
+    if (row.empty()) {
+      break;
+    }
+    for (size_t i = 0; i < row.size(); ++i) {
+      const auto val = boost::get<ScalarTargetValue>(&row[i]);
+      const auto spilled_val = boost::get<ScalarTargetValue>(&spilled_row[i]);
+      ASSERT_TRUE(val && spilled_val);
+      ASSERT_TRUE(*val == *spilled_val);
+    }
+  }
+}
+
+TEST(Reduce, FreeGroupByBuffer) {
+  RowSetMemoryOwner row_set_mem_owner;
+  auto buffer1 = static_cast<int64_t*>(checked_malloc(64));
+  auto buffer2 = static_cast<int64_t*>(checked_malloc(64));
+  row_set_mem_owner.addGroupByBuffer(buffer1);
+  row_set_mem_owner.addGroupByBuffer(buffer2);
+  // Freed now and not again with the owner, unknown buffers are ignored.
+  row_set_mem_owner.freeGroupByBuffer(buffer1);
+  row_set_mem_owner.freeGroupByBuffer(buffer1);
+}
+
+TEST(Sort, SpilledRuns) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc_large(target_infos, 8);
+  // Enough entries for several sorted runs, each run holds at least 2^14 of them.
+  query_mem_desc.setEntryCount(5 * (1 << 14));
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  const auto make_rs = [&]() {
+    auto rs = std::make_unique<ResultSet>(target_infos,
+                                          ExecutorDeviceType::CPU,
+                                          query_mem_desc,
+                                          row_set_mem_owner,
+                                          nullptr);
+    ReverseOddOrEvenNumberGenerator generator(2 * query_mem_desc.getEntryCount() - 1);
+    fill_storage_buffer(rs->allocateStorage()->getUnderlyingBuffer(),
+                        target_infos,
+                        query_mem_desc,
+                        generator,
+                        2);
+    return rs;
+  };
+  const auto rs = make_rs();
+  const auto spilled_rs = make_rs();
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, true, false);
+  order_entries.emplace_back(2, false, false);
+  rs->sort(order_entries, 0);
+  const auto spill_path = boost::filesystem::temp_directory_path() /
+                          boost::filesystem::unique_path("result_spill_%%%%-%%%%");
+  g_enable_result_spill = true;
+  g_result_spill_memory_budget = 1 << 10;
+  g_result_spill_path = spill_path.string();
+  spilled_rs->sort(order_entries, 0);
+  g_enable_result_spill = false;
+  ASSERT_TRUE(boost::filesystem::is_empty(spill_path));
+  boost::filesystem::remove_all(spill_path);
+  ASSERT_EQ(rs->rowCount(), spilled_rs->rowCount());
+  ASSERT_GT(rs->rowCount(), size_t(2 * (1 << 14)));
+  while (true) {
+    const auto row = rs->getNextRow(false, false);
+    const auto spilled_row = spilled_rs->getNextRow(false, false);
+    ASSERT_EQ(row.size(), spilled_row.size());
+    if (row.empty()) {
+      break;
+    }
+    for (size_t i = 0; i < row.size(); ++i) {
+      const auto val = boost::get<ScalarTargetValue>(&row[i]);
+      const auto spilled_val = boost::get<ScalarTargetValue>(&spilled_row[i]);
+      ASSERT_TRUE(val && spilled_val);
+      ASSERT_TRUE(*val == *spilled_val);
+    }
+  }
+}
+
 TEST(MoreReduce, MissingValues) {
   std::vector<TargetInfo> target_infos;
   SQLTypeInfo bigint_ti(kBIGINT, false);
@@ -3316,6 +3548,63 @@ TEST(ReduceRandomGroups, BaselineHashColumnar_Large_NullVal_0075) {
       target_infos, query_mem_desc, gen1, gen2, prct1, prct2, silent, 2);
 }
 
+TEST(Sort, MultipleOrderEntriesWithNulls) {
+  SQLTypeInfo int_ti(kINT, false);
+  SQLTypeInfo double_ti(kDOUBLE, false);
+  std::vector<TargetInfo> target_infos;
+  target_infos.push_back(TargetInfo{true, kMIN, int_ti, int_ti, true, false});
+  target_infos.push_back(TargetInfo{true, kMIN, double_ti, double_ti, true, false});
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99999);
+  const auto row_set_mem_owner = std::make_shared<RowSetMemoryOwner>();
+  ResultSet rs(
+      target_infos, ExecutorDeviceType::CPU, query_mem_desc, row_set_mem_owner, nullptr);
+  const auto storage = rs.allocateStorage();
+  using SortKey = std::pair<int64_t, double>;
+  std::vector<SortKey> expected;
+  auto entry_ptr = reinterpret_cast<int64_t*>(storage->getUnderlyingBuffer());
+  for (size_t i = 0; i < query_mem_desc.getEntryCount(); ++i, entry_ptr += 3) {
+    if (i % 5 == 4) {
+      entry_ptr[0] = EMPTY_KEY_64;
+      continue;
+    }
+    entry_ptr[0] = i;
+    const int64_t ival = i % 11 == 0 ? inline_int_null_val(int_ti) : (i * 7) % 10 - 5;
+    const double dval = i % 13 == 0 ? inline_fp_null_val(double_ti)
+                                    : static_cast<double>((i * 37) % 97) / 4 - 12;
+    write_int(reinterpret_cast<int8_t*>(entry_ptr + 1), ival, 8);
+    std::memcpy(entry_ptr + 2, &dval, sizeof(dval));
+    expected.emplace_back(ival, dval);
+  }
+  // ORDER BY 1 DESC NULLS FIRST, 2 ASC NULLS LAST
+  const auto is_less = [&int_ti, &double_ti](const SortKey& lhs, const SortKey& rhs) {
+    const auto int_null = inline_int_null_val(int_ti);
+    if (lhs.first != rhs.first) {
+      if (lhs.first == int_null || rhs.first == int_null) {
+        return lhs.first == int_null;
+      }
+      return lhs.first > rhs.first;
+    }
+    const auto fp_null = inline_fp_null_val(double_ti);
+    if (lhs.second == fp_null || rhs.second == fp_null) {
+      return rhs.second == fp_null && lhs.second != fp_null;
+    }
+    return lhs.second < rhs.second;
+  };
+  std::sort(expected.begin(), expected.end(), is_less);
+  std::list<Analyzer::OrderEntry> order_entries;
+  order_entries.emplace_back(1, true, true);
+  order_entries.emplace_back(2, false, false);
+  rs.sort(order_entries, 0);
+  ASSERT_EQ(expected.size(), rs.rowCount());
+  for (const auto& expected_key : expected) {
+    const auto row = rs.getNextRow(false, false);
+    ASSERT_EQ(size_t(2), row.size());
+    ASSERT_EQ(expected_key.first, v<int64_t>(row[0]));
+    ASSERT_EQ(expected_key.second, v<double>(row[1]));
+  }
+  ASSERT_TRUE(rs.getNextRow(false, false).empty());
+}
+
 int main(int argc, char** argv) {
   google::InitGoogleLogging(argv[0]);
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Shared/Compressor.h"
+
+#include <blosc.h>
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> compress_frame(const std::vector<int32_t>& values,
+                                    const int compressor) {
+  std::vector<uint8_t> frame(
+      BloscCompressor::getMaxCompressedSize(values.size() * sizeof(int32_t)));
+  frame.resize(BloscCompressor::getCompressor()->compressWithContext(
+      reinterpret_cast<const uint8_t*>(values.data()),
+      values.size() * sizeof(int32_t),
+      frame.data(),
+      frame.size(),
+      compressor,
+      sizeof(int32_t)));
+  return frame;
+}
+
+}  // namespace
+
+TEST(Compressor, TableCompressionCodecs) {
+  // The COMPRESSION option of a table names the blosc codec its frames use.
+  EXPECT_EQ(BLOSC_LZ4, BloscCompressor::getCompressorCode("lz4"));
+  EXPECT_EQ(BLOSC_LZ4HC, BloscCompressor::getCompressorCode("lz4hc"));
+  EXPECT_EQ(BLOSC_ZSTD, BloscCompressor::getCompressorCode("zstd"));
+  EXPECT_EQ(-1, BloscCompressor::getCompressorCode("gzip"));
+
+  std::vector<int32_t> values(1 << 16);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i % 1000;
+  }
+  for (const auto& codec : std::vector<std::pair<std::string, std::string>>{
+           {"lz4", "LZ4"}, {"lz4hc", "LZ4"}, {"zstd", "Zstd"}}) {
+    const auto frame =
+        compress_frame(values, BloscCompressor::getCompressorCode(codec.first));
+    EXPECT_LT(frame.size(), values.size() * sizeof(int32_t));
+    const char* complib{nullptr};
+    blosc_cbuffer_complib(frame.data(), &complib);
+    ASSERT_TRUE(complib);
+    EXPECT_EQ(codec.second, std::string(complib)) << codec.first;
+
+    std::vector<int32_t> decompressed(values.size());
+    BloscCompressor::getCompressor()->decompressWithContext(
+        frame.data(),
+        reinterpret_cast<uint8_t*>(decompressed.data()),
+        decompressed.size() * sizeof(int32_t));
+    EXPECT_EQ(values, decompressed) << codec.first;
+  }
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
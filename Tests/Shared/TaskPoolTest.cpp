@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../../Shared/TaskPool.h"
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int fib(TaskPool_NS::TaskPool& pool, const int n) {
+  if (n < 2) {
+    return n;
+  }
+  // Waiting on nested tasks from a worker must not exhaust the pool.
+  auto lhs = pool.submit(fib, std::ref(pool), n - 1);
+  auto rhs = pool.submit(fib, std::ref(pool), n - 2);
+  return lhs.get() + rhs.get();
+}
+
+// Each link of the chain blocks its worker on the next one. High priority tasks go to
+// the global queue, so the waiting worker can't just run the next link as its own.
+int chain(TaskPool_NS::TaskPool& pool, const int n) {
+  if (n == 0) {
+    return 0;
+  }
+  return pool.submit(chain, std::ref(pool), n - 1).get() + 1;
+}
+
+}  // namespace
+
+TEST(TaskPool, RunsAllTasks) {
+  TaskPool_NS::TaskPool pool(4);
+  std::atomic<size_t> counter{0};
+  std::vector<TaskPool_NS::TaskFuture<void>> futures;
+  for (size_t i = 0; i < 10000; ++i) {
+    futures.push_back(pool.submit([&counter] { ++counter; }));
+  }
+  for (auto& future : futures) {
+    future.get();
+  }
+  ASSERT_EQ(size_t(10000), counter.load());
+  const auto stats = pool.getStats();
+  ASSERT_EQ(size_t(10000), stats.executed_count);
+  ASSERT_EQ(size_t(0), stats.queue_depth);
+}
+
+TEST(TaskPool, NestedTasks) {
+  TaskPool_NS::TaskPool pool(2);
+  ASSERT_EQ(2584, pool.submit(fib, std::ref(pool), 18).get());
+}
+
+TEST(TaskPool, NestedWaitsAtWorkerCap) {
+  // A pool of one worker spawns at most four, the chain blocks many more.
+  auto pool = std::make_unique<TaskPool_NS::TaskPool>(1);
+  const int chain_length = 32;
+  std::promise<int> result;
+  auto result_future = result.get_future();
+  std::thread waiter([&pool, &result, chain_length] {
+    TaskPool_NS::ScopedTaskContext task_context(TaskPool_NS::TaskPriority::HIGH, nullptr);
+    result.set_value(pool->submit(chain, std::ref(*pool), chain_length).get());
+  });
+  if (result_future.wait_for(std::chrono::seconds(60)) != std::future_status::ready) {
+    // The workers are deadlocked, joining them would hang the test.
+    waiter.detach();
+    pool.release();
+    FAIL() << "Nested waits deadlocked the pool";
+  }
+  waiter.join();
+  ASSERT_EQ(chain_length, result_future.get());
+  ASSERT_GE(size_t(4), pool->getStats().worker_count);
+}
+
+TEST(TaskPool, Exceptions) {
+  TaskPool_NS::TaskPool pool(2);
+  auto future = pool.submit([] { throw std::runtime_error("task failed"); });
+  ASSERT_THROW(future.get(), std::runtime_error);
+}
+
+TEST(TaskPool, Cancellation) {
+  TaskPool_NS::TaskPool pool(1);
+  auto cancelled = std::make_shared<TaskPool_NS::CancellationFlag>(true);
+  TaskPool_NS::TaskFuture<int> future;
+  {
+    TaskPool_NS::ScopedTaskContext task_context(TaskPool_NS::TaskPriority::NORMAL,
+                                                cancelled);
+    future = pool.submit([] { return 1; });
+  }
+  ASSERT_THROW(future.get(), TaskPool_NS::TaskCancelled);
+  ASSERT_EQ(size_t(1), pool.getStats().cancelled_count);
+  // Tasks submitted outside of the scope don't inherit the flag.
+  ASSERT_EQ(2, pool.submit([] { return 2; }).get());
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
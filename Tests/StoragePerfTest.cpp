@@ -30,10 +30,14 @@
 #include "../Fragmenter/Fragmenter.h"
 #include "../Parser/ParserNode.h"
 #include "../Parser/parser.h"
+#include "../QueryEngine/Execute.h"
+#include "../QueryEngine/TableOptimizer.h"
 #include "../QueryRunner/QueryRunner.h"
 #include "PopulateTableRandom.h"
 #include "ScanTable.h"
 #include "Shared/MapDParameters.h"
+#include "Shared/measure.h"
+#include "Shared/thread_count.h"
 #include "boost/filesystem.hpp"
 #include "boost/program_options.hpp"
 #include "glog/logging.h"
@@ -444,6 +448,169 @@ TEST(DataLoad, NumbersTable_Parallel_CreateDropCreateTable_InsertRows) {
   ASSERT_NO_THROW(run_ddl_statement("drop table numbers_6;"););
 }
 
+TEST(BufferMgr, Concurrent_GetChunkBuffer) {
+  ASSERT_NO_THROW(run_ddl_statement("drop table if exists numbers_buf;"););
+  ASSERT_NO_THROW(run_ddl_statement(
+      "create table numbers_buf (a smallint, b int, c bigint, d numeric(17,3), e "
+      "double, f float) with (fragment_size=100000);"););
+  EXPECT_TRUE(load_data_test("numbers_buf", SMALL / 5));
+
+  const auto& cat = gsession->getCatalog();
+  const auto td = cat.getMetadataForTable("numbers_buf");
+  CHECK(td);
+  std::vector<std::pair<ChunkKey, size_t>> chunks;
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  for (const auto& fragment : table_info.fragments) {
+    for (const auto& chunk_metadata : fragment.getChunkMetadataMap()) {
+      chunks.emplace_back(
+          ChunkKey{cat.getCurrentDB().dbId,
+                   td->tableId,
+                   chunk_metadata.first,
+                   fragment.fragmentId},
+          chunk_metadata.second.numBytes);
+    }
+  }
+  ASSERT_FALSE(chunks.empty());
+
+  // Load all the chunks once, the benchmark measures buffer pool hits only.
+  auto& data_mgr = cat.getDataMgr();
+  for (const auto& chunk : chunks) {
+    data_mgr.getChunkBuffer(chunk.first, Data_Namespace::CPU_LEVEL, 0, chunk.second)
+        ->unPin();
+  }
+
+  const size_t ops_per_thread = 1000000;
+  const auto max_threads = static_cast<size_t>(cpu_threads());
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    std::vector<std::future<void>> threads;
+    const auto elapsed_ms = measure<>::execution([&]() {
+      for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+        threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+          for (size_t i = 0; i < ops_per_thread; ++i) {
+            const auto& chunk = chunks[(thread_idx + i) % chunks.size()];
+            auto buffer = data_mgr.getChunkBuffer(
+                chunk.first, Data_Namespace::CPU_LEVEL, 0, chunk.second);
+            buffer->unPin();
+          }
+        }));
+      }
+      for (auto& thread : threads) {
+        thread.get();
+      }
+    });
+    LOG(INFO) << num_threads << " thread(s): "
+              << 1000. * num_threads * ops_per_thread / std::max(elapsed_ms, int64_t(1))
+              << " getChunkBuffer calls/s";
+  }
+
+  ASSERT_NO_THROW(run_ddl_statement("drop table numbers_buf;"););
+}
+
+namespace {
+
+// Sorted timestamps, runs of a few categories and increasing ids.
+void populate_encoding_test_table(const TableDescriptor* td,
+                                  const Catalog& cat,
+                                  const size_t num_rows) {
+  const auto cds = cat.getAllColumnMetadataForTable(td->tableId, false, false, false);
+  CHECK_EQ(cds.size(), size_t(3));
+  const size_t rows_per_batch = SMALL / 10;
+  for (size_t start = 0; start < num_rows; start += rows_per_batch) {
+    const auto batch_rows = std::min(rows_per_batch, num_rows - start);
+    std::vector<int64_t> ts(batch_rows);
+    std::vector<int32_t> category(batch_rows);
+    std::vector<int64_t> id(batch_rows);
+    for (size_t i = 0; i < batch_rows; ++i) {
+      const auto row = start + i;
+      ts[i] = 1546300800 + row / 10;
+      category[i] = (row / 5000) % 8;
+      id[i] = 1000000000 + row;
+    }
+    InsertData insert_data;
+    insert_data.databaseId = cat.getCurrentDB().dbId;
+    insert_data.tableId = td->tableId;
+    insert_data.numRows = batch_rows;
+    for (const auto cd : cds) {
+      insert_data.columnIds.push_back(cd->columnId);
+    }
+    DataBlockPtr p{0};
+    p.numbersPtr = reinterpret_cast<int8_t*>(ts.data());
+    insert_data.data.push_back(p);
+    p.numbersPtr = reinterpret_cast<int8_t*>(category.data());
+    insert_data.data.push_back(p);
+    p.numbersPtr = reinterpret_cast<int8_t*>(id.data());
+    insert_data.data.push_back(p);
+    td->fragmenter->insertData(insert_data);
+  }
+}
+
+}  // namespace
+
+TEST(StorageEncodings, Footprint_And_Scan) {
+  const size_t num_rows = SMALL;
+  const std::vector<std::pair<std::string, std::string>> encodings{
+      {"none", "ts BIGINT, category INT, id BIGINT"},
+      {"fixed",
+       "ts BIGINT ENCODING FIXED(32), category INT ENCODING FIXED(8), id BIGINT "
+       "ENCODING FIXED(32)"},
+      {"rl", "ts BIGINT ENCODING RL, category INT ENCODING RL, id BIGINT ENCODING RL"},
+      {"diff",
+       "ts BIGINT ENCODING DIFF, category INT ENCODING DIFF, id BIGINT ENCODING DIFF"},
+      {"bitpack",
+       "ts BIGINT ENCODING BITPACK, category INT ENCODING BITPACK, id BIGINT ENCODING "
+       "BITPACK"}};
+
+  auto& cat = gsession->getCatalog();
+  std::vector<int64_t> expected_results;
+  for (const auto& encoding : encodings) {
+    const auto table_name = "encodings_" + encoding.first;
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists " + table_name + ";"););
+    ASSERT_NO_THROW(run_ddl_statement("create table " + table_name + " (" +
+                                      encoding.second + ");"););
+    const auto td = cat.getMetadataForTable(table_name);
+    CHECK(td);
+    populate_encoding_test_table(td, cat, num_rows);
+    auto executor = Executor::getExecutor(cat.getCurrentDB().dbId);
+    const TableOptimizer optimizer(td, executor.get(), cat);
+    const auto pack_ms = measure<>::execution([&]() { optimizer.packEncodedColumns(); });
+
+    size_t num_bytes{0};
+    const auto table_info = td->fragmenter->getFragmentsForQuery();
+    for (const auto& fragment : table_info.fragments) {
+      for (const auto& chunk_metadata : fragment.getChunkMetadataMap()) {
+        num_bytes += chunk_metadata.second.numBytes;
+      }
+    }
+
+    const auto query = "SELECT COUNT(*), SUM(ts), MAX(id) FROM " + table_name +
+                       " WHERE category = 3;";
+    // The first run compiles the query and loads the chunks.
+    QueryRunner::run_multiple_agg(query, gsession, ExecutorDeviceType::CPU, true, true);
+    const size_t num_scans = 10;
+    std::shared_ptr<ResultSet> rows;
+    const auto scan_ms = measure<>::execution([&]() {
+      for (size_t i = 0; i < num_scans; ++i) {
+        rows = QueryRunner::run_multiple_agg(
+            query, gsession, ExecutorDeviceType::CPU, true, true);
+      }
+    });
+    std::vector<int64_t> results;
+    for (const auto& col : rows->getNextRow(false, false)) {
+      const auto scalar_col = boost::get<ScalarTargetValue>(&col);
+      CHECK(scalar_col);
+      results.push_back(*boost::get<int64_t>(scalar_col));
+    }
+    if (expected_results.empty()) {
+      expected_results = results;
+    }
+    EXPECT_EQ(expected_results, results);
+
+    std::cout << encoding.first << ": " << num_bytes << " bytes, packed in " << pack_ms
+              << " ms, " << scan_ms / num_scans << " ms per scan." << std::endl;
+    ASSERT_NO_THROW(run_ddl_statement("drop table " + table_name + ";"););
+  }
+}
+
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
   ::testing::InitGoogleTest(&argc, argv);
@@ -251,6 +251,58 @@ TEST(StorageSmallParallel, AllTypes) {
   ASSERT_NO_THROW(run_ddl_statement("drop table alltypes;"););
 }
 
+#ifdef HAVE_BLOSC
+TEST(StorageCompressed, AllTypes) {
+  auto& cat = gsession->getCatalog();
+  for (const std::string compression : {"lz4", "zstd"}) {
+    ASSERT_NO_THROW(run_ddl_statement("drop table if exists alltypes;"););
+    ASSERT_NO_THROW(run_ddl_statement(
+        "create table alltypes (a smallint, b int, c bigint, d numeric(17,3), e double, "
+        "f float, g timestamp(0), h time(0), i date, x varchar(10) encoding none, y "
+        "text encoding none) with (fragment_size=30000, compression='" +
+        compression + "');"););
+    const auto insert_col_hashs = populate_table_random("alltypes", SMALL, cat);
+    // The chunks are read back from the compressed pages.
+    cat.getDataMgr().clearMemory(Data_Namespace::MemoryLevel::CPU_LEVEL);
+    EXPECT_EQ(insert_col_hashs, scan_table_return_hash("alltypes", cat));
+
+    const auto td = cat.getMetadataForTable("alltypes");
+    ASSERT_TRUE(td);
+    std::vector<std::pair<ChunkKey, ChunkMetadata>> chunk_metadata_vec;
+    cat.getDataMgr().getChunkMetadataVecForKeyPrefix(
+        chunk_metadata_vec, {cat.getCurrentDB().dbId, td->tableId});
+    ASSERT_FALSE(chunk_metadata_vec.empty());
+    for (const auto& chunk_metadata : chunk_metadata_vec) {
+      EXPECT_GT(chunk_metadata.second.numCompressedBytes, size_t(0));
+    }
+    ASSERT_NO_THROW(run_ddl_statement("drop table alltypes;"););
+  }
+  EXPECT_ANY_THROW(
+      run_ddl_statement("create table alltypes (a int) with (compression='gzip');"););
+}
+
+TEST(StorageCompressed, Appends) {
+  auto& cat = gsession->getCatalog();
+  ASSERT_NO_THROW(run_ddl_statement("drop table if exists appends;"););
+  ASSERT_NO_THROW(
+      run_ddl_statement("create table appends (a int, b bigint, x text encoding none) "
+                        "with (fragment_size=1000000, compression='lz4');"););
+  // Appends of a fraction of a frame, and of several frames with a partial one left.
+  for (const size_t num_rows : {10, 1000, 300000, 10, 300000, 1000}) {
+    populate_table_random("appends", num_rows, cat);
+  }
+  const auto inserted_col_hashs = scan_table_return_hash("appends", cat);
+  cat.getDataMgr().clearMemory(Data_Namespace::MemoryLevel::CPU_LEVEL);
+  EXPECT_EQ(inserted_col_hashs, scan_table_return_hash("appends", cat));
+  ASSERT_NO_THROW(run_ddl_statement("drop table appends;"););
+}
+#else
+TEST(StorageCompressed, NotSupported) {
+  EXPECT_ANY_THROW(
+      run_ddl_statement("create table alltypes (a int) with (compression='lz4');"););
+}
+#endif  // HAVE_BLOSC
+
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
   ::testing::InitGoogleTest(&argc, argv);
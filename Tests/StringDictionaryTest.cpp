@@ -14,17 +14,29 @@
  * limitations under the License.
  */
 
+#include "../Shared/measure.h"
+#include "../Shared/thread_count.h"
 #include "../StringDictionary/StringDictionary.h"
+#include "../StringDictionary/StringDictionaryProxy.h"
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
 #include <limits>
+#include <thread>
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
 #endif
 
+extern bool g_enable_string_dict_trigram_index;
+extern size_t g_string_dict_predicate_cache_size;
+
 TEST(StringDictionary, AddAndGet) {
   StringDictionary string_dict(BASE_PATH, false, false);
   auto id1 = string_dict.getOrAdd("foo bar");
@@ -86,6 +98,450 @@ TEST(StringDictionary, RecoverMany) {
   }
 }
 
+namespace {
+
+std::string get_dict_path(const std::string& name) {
+  const auto path = boost::filesystem::path(BASE_PATH) / name;
+  boost::filesystem::remove_all(path);
+  boost::filesystem::create_directories(path);
+  return path.string();
+}
+
+std::vector<int32_t> sorted(std::vector<int32_t> ids) {
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+// The matches of the LIKE and REGEXP patterns with the trigram index, the same as the
+// ones of the full scans of the reference dictionary without.
+void check_trigram_matches(const StringDictionary& string_dict,
+                           const StringDictionary& reference_dict,
+                           const size_t generation) {
+  const std::vector<std::tuple<std::string, bool, bool>> like_patterns{
+      {"%ello%", false, false},
+      {"%ELLO%", true, false},
+      {"hel_o%", false, false},
+      {"%wor%ld", true, false},
+      {"%o w%", false, false},
+      {"%50\\%%", false, false},
+      {"%[hy]ello%", false, false},
+      {"ello", false, true},
+      {"ello", true, true},
+      {"zzz", false, true}};
+  for (const auto& pattern : like_patterns) {
+    const auto expected = sorted(reference_dict.getLike(std::get<0>(pattern),
+                                                        std::get<1>(pattern),
+                                                        std::get<2>(pattern),
+                                                        '\\',
+                                                        generation));
+    g_enable_string_dict_trigram_index = true;
+    const auto ids = sorted(string_dict.getLike(std::get<0>(pattern),
+                                                std::get<1>(pattern),
+                                                std::get<2>(pattern),
+                                                '\\',
+                                                generation));
+    g_enable_string_dict_trigram_index = false;
+    ASSERT_EQ(expected, ids) << std::get<0>(pattern);
+  }
+  const std::vector<std::string> regexp_patterns{"h.*llo",
+                                                 "[Hh]ello.*",
+                                                 "hel+o",
+                                                 "(hello|yellow)",
+                                                 "x?yz",
+                                                 "hello( world)?",
+                                                 "world pea[[:alpha:]]e",
+                                                 "h\\w*"};
+  for (const auto& pattern : regexp_patterns) {
+    const auto expected = sorted(reference_dict.getRegexpLike(pattern, '\\', generation));
+    g_enable_string_dict_trigram_index = true;
+    const auto ids = sorted(string_dict.getRegexpLike(pattern, '\\', generation));
+    g_enable_string_dict_trigram_index = false;
+    ASSERT_EQ(expected, ids) << pattern;
+  }
+}
+
+const std::vector<std::string> g_trigram_strings{"Hello World",
+                                                 "yellow",
+                                                 "hello",
+                                                 "help",
+                                                 "world peace",
+                                                 "HELLOWORLD",
+                                                 "xyz",
+                                                 "yz",
+                                                 "50% off",
+                                                 "hello world",
+                                                 "yello"};
+
+}  // namespace
+
+TEST(TrigramIndex, Literals) {
+  using Literals = std::vector<std::string>;
+  ASSERT_EQ((Literals{"hello", "world"}),
+            TrigramIndex::getLikeLiterals("%hello_world%", false, '\\'));
+  ASSERT_EQ((Literals{"50%"}), TrigramIndex::getLikeLiterals("%50\\%%", false, '\\'));
+  ASSERT_EQ((Literals{"a_b%"}), TrigramIndex::getLikeLiterals("a_b%", true, '\\'));
+  ASSERT_EQ((Literals{"abc"}), TrigramIndex::getRegexpLiterals("abcd?ef"));
+  ASSERT_EQ((Literals{"bar", "baz"}), TrigramIndex::getRegexpLiterals("(foo)bar+baz"));
+  ASSERT_EQ((Literals{"xyz"}), TrigramIndex::getRegexpLiterals("[abc]{2,3}xyz$"));
+  ASSERT_TRUE(TrigramIndex::getRegexpLiterals("foobar|bazqux").empty());
+}
+
+TEST(StringDictionary, TrigramIndexMatches) {
+  StringDictionary string_dict(get_dict_path("trigram_dict"), false, false);
+  StringDictionary reference_dict(get_dict_path("trigram_reference_dict"), false, false);
+  const size_t half = g_trigram_strings.size() / 2;
+  for (size_t i = 0; i < half; ++i) {
+    string_dict.getOrAdd(g_trigram_strings[i]);
+    reference_dict.getOrAdd(g_trigram_strings[i]);
+  }
+  check_trigram_matches(string_dict, reference_dict, half);
+  // Indexed as they're added.
+  for (size_t i = half; i < g_trigram_strings.size(); ++i) {
+    string_dict.getOrAdd(g_trigram_strings[i]);
+    reference_dict.getOrAdd(g_trigram_strings[i]);
+  }
+  check_trigram_matches(string_dict, reference_dict, g_trigram_strings.size());
+  check_trigram_matches(string_dict, reference_dict, half - 1);
+}
+
+TEST(StringDictionary, TrigramIndexRecover) {
+  const auto path = get_dict_path("trigram_recover_dict");
+  const int str_count{20000};
+  StringDictionary reference_dict(get_dict_path("trigram_reference_dict"), false, false);
+  for (const auto& str : g_trigram_strings) {
+    reference_dict.getOrAdd(str);
+  }
+  for (int i = 0; i < str_count; ++i) {
+    reference_dict.getOrAdd("str" + std::to_string(i));
+  }
+  const auto count = reference_dict.storageEntryCount();
+  {
+    StringDictionary string_dict(path, false, false);
+    for (const auto& str : g_trigram_strings) {
+      string_dict.getOrAdd(str);
+    }
+    check_trigram_matches(string_dict, reference_dict, g_trigram_strings.size());
+    ASSERT_TRUE(string_dict.checkpoint());
+    for (int i = 0; i < str_count / 2; ++i) {
+      string_dict.getOrAdd("str" + std::to_string(i));
+    }
+    ASSERT_TRUE(string_dict.checkpoint());
+    // Not persisted, indexed again on recovery.
+    for (int i = str_count / 2; i < str_count; ++i) {
+      string_dict.getOrAdd("str" + std::to_string(i));
+    }
+  }
+  ASSERT_GT(boost::filesystem::file_size(path + "/DictTrigrams"), size_t(0));
+  StringDictionary string_dict(path, false, true);
+  ASSERT_EQ(count, string_dict.storageEntryCount());
+  check_trigram_matches(string_dict, reference_dict, count);
+  g_enable_string_dict_trigram_index = true;
+  ASSERT_EQ(std::vector<int32_t>{static_cast<int32_t>(count - 1)},
+            string_dict.getLike(
+                "%str" + std::to_string(str_count - 1), false, false, '\\', count));
+  g_enable_string_dict_trigram_index = false;
+}
+
+TEST(StringDictionary, PredicateCacheExtendsResults) {
+  StringDictionary string_dict(get_dict_path("predicate_cache_dict"), false, false);
+  for (const auto& str : g_trigram_strings) {
+    string_dict.getOrAdd(str);
+  }
+  const size_t count = g_trigram_strings.size();
+  const auto ids = string_dict.getLike("%ello%", false, false, '\\', count);
+  ASSERT_EQ(size_t(0), string_dict.getPredicateCacheStats().hits);
+  ASSERT_EQ(ids, string_dict.getLike("%ello%", false, false, '\\', count));
+  ASSERT_EQ(size_t(1), string_dict.getPredicateCacheStats().hits);
+  // Older generations are served from the same entry.
+  ASSERT_EQ((std::vector<int32_t>{0, 1}),
+            string_dict.getLike("%ello%", false, false, '\\', 2));
+  const auto new_id = string_dict.getOrAdd("cello");
+  auto extended_ids = ids;
+  extended_ids.push_back(new_id);
+  ASSERT_EQ(extended_ids,
+            string_dict.getLike("%ello%", false, false, '\\', count + 1));
+  ASSERT_EQ(std::vector<int32_t>{new_id},
+            string_dict.getRegexpLike("c.*", '\\', count + 1));
+  const auto stats = string_dict.getPredicateCacheStats();
+  ASSERT_EQ(size_t(3), stats.hits);
+  ASSERT_EQ(size_t(2), stats.misses);
+  ASSERT_EQ(size_t(2), stats.num_entries);
+  ASSERT_GT(stats.num_bytes, size_t(0));
+}
+
+TEST(StringDictionary, PredicateCacheIsBounded) {
+  const auto cache_size = g_string_dict_predicate_cache_size;
+  g_string_dict_predicate_cache_size = 4096;
+  StringDictionary string_dict(
+      get_dict_path("predicate_cache_bounded_dict"), false, false);
+  g_string_dict_predicate_cache_size = cache_size;
+  for (int i = 0; i < 1000; ++i) {
+    string_dict.getOrAdd("str" + std::to_string(i));
+  }
+  for (int i = 0; i < 100; ++i) {
+    const auto ids = string_dict.getLike(
+        "%" + std::to_string(i) + "%", false, false, '\\', 1000);
+    ASSERT_FALSE(ids.empty());
+    ASSERT_LE(string_dict.getPredicateCacheStats().num_bytes, size_t(4096));
+  }
+  ASSERT_LT(string_dict.getPredicateCacheStats().num_entries, size_t(100));
+}
+
+TEST(StringDictionary, ConcurrentLikeAndAdd) {
+  StringDictionary string_dict(get_dict_path("concurrent_like_dict"), false, false);
+  const int str_count{20000};
+  g_enable_string_dict_trigram_index = true;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int reader_idx = 0; reader_idx < 4; ++reader_idx) {
+    readers.emplace_back([&string_dict, &done] {
+      while (!done) {
+        const auto generation = string_dict.storageEntryCount();
+        const auto ids = string_dict.getLike("str1%", false, false, '\\', generation);
+        size_t expected{0};
+        for (size_t i = 0; i < generation; ++i) {
+          expected += std::to_string(i)[0] == '1';
+        }
+        CHECK_EQ(expected, ids.size());
+      }
+    });
+  }
+  for (int i = 0; i < str_count; ++i) {
+    CHECK_EQ(i, string_dict.getOrAdd("str" + std::to_string(i)));
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  g_enable_string_dict_trigram_index = false;
+}
+
+TEST(StringDictionary, ConcurrentBulkEncoding) {
+  // Batches of rows, mostly of strings already in the dictionary, encoded from several
+  // threads as the import workers do.
+  const size_t distinct_count{50000};
+  const size_t batch_size{10000};
+  const size_t batches_per_thread{40};
+  const auto max_threads = static_cast<size_t>(cpu_threads());
+  for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    StringDictionary string_dict(get_dict_path("bulk_encoding_dict"), false, false);
+    std::vector<std::future<void>> threads;
+    const auto elapsed_ms = measure<>::execution([&]() {
+      for (size_t thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
+        threads.push_back(std::async(std::launch::async, [&, thread_idx] {
+          std::vector<std::string> strings(batch_size);
+          std::vector<int32_t> ids(batch_size);
+          for (size_t batch_idx = 0; batch_idx < batches_per_thread; ++batch_idx) {
+            for (size_t i = 0; i < batch_size; ++i) {
+              const auto row = (thread_idx * 7919 + batch_idx * batch_size + i) * 31;
+              strings[i] = "str" + std::to_string(row % distinct_count);
+            }
+            string_dict.getOrAddBulk(strings, ids.data());
+            for (size_t i = 0; i < batch_size; i += 997) {
+              CHECK_EQ(strings[i], string_dict.getString(ids[i]));
+            }
+          }
+        }));
+      }
+      for (auto& thread : threads) {
+        thread.get();
+      }
+    });
+    ASSERT_EQ(distinct_count, string_dict.storageEntryCount());
+    for (size_t i = 0; i < distinct_count; ++i) {
+      const auto str = "str" + std::to_string(i);
+      ASSERT_EQ(str, string_dict.getString(string_dict.getIdOfString(str)));
+    }
+    LOG(INFO) << num_threads << " thread(s): "
+              << 1000. * num_threads * batches_per_thread * batch_size /
+                     std::max(elapsed_ms, int64_t(1))
+              << " strings encoded/s";
+  }
+}
+
+namespace {
+
+void check_strings(const StringDictionary& string_dict, const int count) {
+  for (int i = 0; i < count; ++i) {
+    const auto str = "str" + std::to_string(i);
+    ASSERT_EQ(i, string_dict.getIdOfString(str));
+    ASSERT_EQ(str, string_dict.getString(i));
+  }
+}
+
+}  // namespace
+
+TEST(StringDictionary, PersistedHashTable) {
+  for (const bool materialize_hashes : {false, true}) {
+    const auto path = get_dict_path("hash_table_dict");
+    const int str_count{20000};
+    {
+      StringDictionary string_dict(path, false, false, materialize_hashes);
+      for (int i = 0; i < str_count; ++i) {
+        string_dict.getOrAdd("str" + std::to_string(i));
+      }
+      ASSERT_TRUE(string_dict.checkpoint());
+    }
+    ASSERT_TRUE(boost::filesystem::exists(path + "/DictHashes"));
+    {
+      StringDictionary string_dict(path, false, true, materialize_hashes);
+      ASSERT_EQ(size_t(str_count), string_dict.storageEntryCount());
+      check_strings(string_dict, str_count);
+      ASSERT_TRUE(string_dict.checkpoint());
+      // Added to the persisted table on the next open, without a checkpoint.
+      for (int i = str_count; i < 2 * str_count; ++i) {
+        ASSERT_EQ(i, string_dict.getOrAdd("str" + std::to_string(i)));
+      }
+    }
+    {
+      StringDictionary string_dict(path, false, true, materialize_hashes);
+      ASSERT_EQ(size_t(2 * str_count), string_dict.storageEntryCount());
+      check_strings(string_dict, 2 * str_count);
+      ASSERT_EQ(2 * str_count, string_dict.getOrAdd("new str"));
+      ASSERT_TRUE(string_dict.checkpoint());
+    }
+    {
+      // Only the pages of the table the new strings went into are written.
+      StringDictionary string_dict(path, false, true, materialize_hashes);
+      for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(2 * str_count + 1 + i,
+                  string_dict.getOrAdd("new str" + std::to_string(i)));
+      }
+      ASSERT_TRUE(string_dict.checkpoint());
+    }
+    {
+      StringDictionary string_dict(path, false, true, materialize_hashes);
+      check_strings(string_dict, 2 * str_count);
+      for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(2 * str_count + 1 + i,
+                  string_dict.getIdOfString("new str" + std::to_string(i)));
+      }
+    }
+    {
+      // A corrupt table is rebuilt from the strings.
+      std::fstream hashes_file(path + "/DictHashes",
+                               std::ios::in | std::ios::out | std::ios::binary);
+      hashes_file.seekp(8);
+      hashes_file.write("garbage", 7);
+    }
+    {
+      StringDictionary string_dict(path, false, true, materialize_hashes);
+      ASSERT_EQ(2 * str_count, string_dict.getIdOfString("new str"));
+      ASSERT_EQ(2 * str_count + 11, string_dict.getOrAdd("newer str"));
+      ASSERT_TRUE(string_dict.checkpoint());
+    }
+    {
+      // So is a table with a valid header and string ids out of range in the buckets.
+      std::fstream hashes_file(path + "/DictHashes",
+                               std::ios::in | std::ios::out | std::ios::binary);
+      const std::vector<int32_t> bad_ids(1024, std::numeric_limits<int32_t>::max());
+      hashes_file.seekp(4096);
+      hashes_file.write(reinterpret_cast<const char*>(bad_ids.data()),
+                        bad_ids.size() * sizeof(int32_t));
+    }
+    StringDictionary string_dict(path, false, true, materialize_hashes);
+    check_strings(string_dict, 2 * str_count);
+    ASSERT_EQ(2 * str_count + 11, string_dict.getIdOfString("newer str"));
+  }
+}
+
+TEST(StringDictionary, PinnedStringViews) {
+  for (const bool is_temp : {false, true}) {
+    StringDictionary string_dict(
+        is_temp ? std::string() : get_dict_path("string_views_dict"), is_temp, false);
+    const auto make_str = [](const int i) {
+      return std::to_string(i) + std::string(1000, 'a' + i % 26);
+    };
+    for (int i = 0; i < 100; ++i) {
+      string_dict.getOrAdd(make_str(i));
+    }
+    auto pinned = string_dict.getStringViews(10, 100);
+    ASSERT_EQ(size_t(90), pinned.views.size());
+    auto pin = string_dict.pinPayload();
+    const auto view = string_dict.getStringView(5, pin);
+    std::weak_ptr<const void> first_mapping = pin;
+    // Grows the payload past its first few mappings.
+    for (int i = 100; i < 20000; ++i) {
+      string_dict.getOrAdd(make_str(i));
+    }
+    for (int i = 10; i < 100; ++i) {
+      ASSERT_EQ(make_str(i), pinned.views[i - 10].to_string());
+    }
+    ASSERT_EQ(make_str(5), view.to_string());
+    const auto all = string_dict.getStringViews(0, string_dict.storageEntryCount());
+    ASSERT_EQ(size_t(20000), all.views.size());
+    ASSERT_EQ(make_str(19999), all.views.back().to_string());
+    // Reading through an outdated pin moves it to the current mapping.
+    auto moved_pin = pin;
+    ASSERT_EQ(make_str(19999), string_dict.getStringView(19999, moved_pin).to_string());
+    ASSERT_NE(pin, moved_pin);
+    ASSERT_EQ(all.pin, moved_pin);
+    // Each mapping is released with its own last pin, regardless of the others.
+    ASSERT_FALSE(first_mapping.expired());
+    pin.reset();
+    ASSERT_FALSE(first_mapping.expired());
+    pinned.pin.reset();
+    ASSERT_TRUE(first_mapping.expired());
+  }
+}
+
+TEST(StringDictionary, ProxyPins) {
+  // The dictionary of the literals has no storage, nothing to pin.
+  auto literal_dict = std::make_shared<StringDictionary>("", false, true);
+  ASSERT_FALSE(literal_dict->pinPayload());
+  StringDictionaryProxy literal_proxy(literal_dict, 0);
+  ASSERT_EQ(-2, literal_proxy.getOrAddTransient("literal"));
+  ASSERT_EQ("literal", literal_proxy.getString(-2));
+
+  auto string_dict =
+      std::make_shared<StringDictionary>(get_dict_path("proxy_pins_dict"), false, false);
+  const auto make_str = [](const int i) {
+    return std::to_string(i) + std::string(1000, 'a' + i % 26);
+  };
+  for (int i = 0; i < 100; ++i) {
+    string_dict->getOrAdd(make_str(i));
+  }
+  StringDictionaryProxy proxy(string_dict, -1);
+  const auto first_bytes = proxy.getStringBytes(5);
+  // Grows the payload past its first few mappings, the proxy pins the newer ones.
+  for (int i = 100; i < 20000; ++i) {
+    string_dict->getOrAdd(make_str(i));
+  }
+  const auto last_bytes = proxy.getStringBytes(19999);
+  ASSERT_EQ(make_str(19999), std::string(last_bytes.first, last_bytes.second));
+  ASSERT_EQ(make_str(5), std::string(first_bytes.first, first_bytes.second));
+}
+
+TEST(StringDictionary, TranslationMap) {
+  StringDictionary source_dict(get_dict_path("translation_source_dict"), false, false);
+  StringDictionary dest_dict(get_dict_path("translation_dest_dict"), false, false);
+  for (int i = 0; i < 1000; ++i) {
+    source_dict.getOrAdd("str" + std::to_string(i));
+  }
+  // Every other source string, in reverse order.
+  for (int i = 998; i >= 0; i -= 2) {
+    dest_dict.getOrAdd("str" + std::to_string(i));
+  }
+  const auto translation_map = source_dict.getTranslationMap(&dest_dict, 1000, 400);
+  ASSERT_TRUE(translation_map);
+  ASSERT_EQ(size_t(1000), translation_map->size());
+  for (int i = 0; i < 1000; ++i) {
+    const auto dest_id = (*translation_map)[i];
+    if (i % 2 || (998 - i) / 2 >= 400) {
+      ASSERT_EQ(StringDictionary::INVALID_STR_ID, dest_id);
+    } else {
+      ASSERT_EQ("str" + std::to_string(i), dest_dict.getString(dest_id));
+    }
+  }
+  ASSERT_EQ(translation_map, source_dict.getTranslationMap(&dest_dict, 1000, 400));
+  ASSERT_NE(translation_map, source_dict.getTranslationMap(&dest_dict, 1000, 500));
+  const auto identity_map = source_dict.getTranslationMap(&source_dict, 10, 10);
+  ASSERT_EQ(size_t(10), identity_map->size());
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(i, (*identity_map)[i]);
+  }
+}
+
 int main(int argc, char** argv) {
   google::InitGoogleLogging(argv[0]);
   testing::InitGoogleTest(&argc, argv);
@@ -14,12 +14,84 @@
  * limitations under the License.
  */
 
+#include "../DataMgr/PackedIntCodec.h"
+#include "../Utils/ChunkIter.h"
 #include "../Utils/Regexp.h"
 #include "../Utils/StringLike.h"
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Sets the iterator up over a packed chunk the way Chunk::begin_iterator does.
+ChunkIter packed_chunk_iter(const SQLTypeInfo& ti,
+                            std::vector<int8_t>& chunk,
+                            const size_t num_elems,
+                            const int start_idx) {
+  ChunkIter it;
+  it.type_info = ti;
+  it.skip = 1;
+  it.skip_size = ti.get_size();
+  it.second_buf = chunk.data();
+  const auto payload = chunk.data() + PACKED_INT_HEADER_SIZE;
+  it.current_pos = it.start_pos = payload + start_idx * it.skip_size;
+  it.end_pos = payload + num_elems * it.skip_size;
+  it.num_elems = num_elems;
+  return it;
+}
+
+void check_packed_chunk_iter(const EncodingType encoding,
+                             const PackedIntFormat format,
+                             const std::vector<int32_t>& values) {
+  SQLTypeInfo ti(kINT, false);
+  ti.set_compression(encoding);
+  std::vector<int8_t> chunk;
+  if (format == kPACKED_RAW) {
+    const PackedIntChunkHeader header{kPACKED_RAW, 0, 0};
+    chunk.resize(PACKED_INT_HEADER_SIZE + values.size() * sizeof(int32_t));
+    std::memcpy(chunk.data(), &header, sizeof(header));
+    std::memcpy(chunk.data() + PACKED_INT_HEADER_SIZE,
+                values.data(),
+                values.size() * sizeof(int32_t));
+  } else {
+    chunk = pack_int_chunk(reinterpret_cast<const int8_t*>(values.data()),
+                           values.size(),
+                           sizeof(int32_t),
+                           NULL_INT,
+                           encoding);
+    ASSERT_FALSE(chunk.empty());
+  }
+  ASSERT_EQ(format, reinterpret_cast<const PackedIntChunkHeader*>(chunk.data())->format);
+
+  const int start_idx = 5;
+  auto it = packed_chunk_iter(ti, chunk, values.size(), start_idx);
+  VarlenDatum vd;
+  bool is_end;
+  for (size_t i = start_idx; i < values.size(); ++i) {
+    ChunkIter_get_next(&it, false, &vd, &is_end);
+    ASSERT_FALSE(is_end);
+    ASSERT_EQ(sizeof(int32_t), vd.length);
+    ASSERT_EQ(values[i] == NULL_INT, vd.is_null) << i;
+    ASSERT_EQ(values[i], *reinterpret_cast<const int32_t*>(vd.pointer)) << i;
+  }
+  ChunkIter_get_next(&it, true, &vd, &is_end);
+  ASSERT_TRUE(is_end);
+
+  it = packed_chunk_iter(ti, chunk, values.size(), 0);
+  for (const size_t i : {size_t(0), size_t(97), values.size() - 1}) {
+    ChunkIter_get_nth(&it, i, true, &vd, &is_end);
+    ASSERT_FALSE(is_end);
+    ASSERT_EQ(values[i] == NULL_INT, vd.is_null) << i;
+    ASSERT_EQ(values[i], *reinterpret_cast<const int32_t*>(vd.pointer)) << i;
+  }
+}
+
+}  // namespace
+
 TEST(Utils, StringLike) {
   ASSERT_TRUE(string_like("abc", 3, "abc", 3, '\\'));
   ASSERT_FALSE(string_like("abc", 3, "ABC", 3, '\\'));
@@ -45,6 +117,19 @@ TEST(Utils, Regexp) {
   ASSERT_TRUE(regexp_like("hello [", 7, ".*\\[.*", 6, '\\'));
 }
 
+TEST(Utils, ChunkIterPackedInt) {
+  std::vector<int32_t> runs;
+  std::vector<int32_t> frames;
+  for (int32_t i = 0; i < 3000; ++i) {
+    runs.push_back(i % 500 == 0 ? NULL_INT : 1000 + i / 100);
+    frames.push_back(i % 97 == 0 ? NULL_INT : -50 + i % 13 + i / 1000);
+  }
+  check_packed_chunk_iter(kENCODING_RL, kPACKED_RAW, frames);
+  check_packed_chunk_iter(kENCODING_RL, kPACKED_RLE, runs);
+  check_packed_chunk_iter(kENCODING_BITPACK, kPACKED_BITPACK, frames);
+  check_packed_chunk_iter(kENCODING_DIFF, kPACKED_DELTA, frames);
+}
+
 int main(int argc, char* argv[]) {
   google::InitGoogleLogging(argv[0]);
   ::testing::InitGoogleTest(&argc, argv);
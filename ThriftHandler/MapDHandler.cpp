@@ -64,12 +64,14 @@
 #include "Shared/MapDParameters.h"
 #include "Shared/SQLTypeUtilities.h"
 #include "Shared/StringTransform.h"
+#include "Shared/TaskPool.h"
 #include "Shared/geo_types.h"
 #include "Shared/geosupport.h"
 #include "Shared/import_helpers.h"
 #include "Shared/mapd_shared_mutex.h"
 #include "Shared/measure.h"
 #include "Shared/scope.h"
+#include "StringDictionary/StringDictionary.h"
 
 #include <fcntl.h>
 #include <glog/logging.h>
@@ -92,6 +94,7 @@
 #include <fstream>
 #include <future>
 #include <map>
+#include <set>
 #include <memory>
 #include <random>
 #include <regex>
@@ -502,6 +505,19 @@ void MapDHandler::interrupt(const TSessionId& session) {
   }
 }
 
+namespace {
+
+void fill_task_pool_status(TServerStatus& server_status) {
+  const auto stats = TaskPool_NS::TaskPool::instance().getStats();
+  server_status.task_pool_workers = stats.worker_count;
+  server_status.task_pool_queue_depth = stats.queue_depth;
+  server_status.task_pool_executed_count = stats.executed_count;
+  server_status.task_pool_steal_count = stats.steal_count;
+  server_status.task_pool_cancelled_count = stats.cancelled_count;
+}
+
+}  // namespace
+
 void MapDHandler::get_server_status(TServerStatus& _return, const TSessionId& session) {
   LOG_ON_RETURN(session);
   const auto rendering_enabled = bool(render_handler_);
@@ -513,6 +529,7 @@ void MapDHandler::get_server_status(TServerStatus& _return, const TSessionId& se
   _return.start_time = start_time_;
   _return.edition = MAPD_EDITION;
   _return.host_name = "aggregator";
+  fill_task_pool_status(_return);
 }
 
 void MapDHandler::get_status(std::vector<TServerStatus>& _return,
@@ -527,6 +544,7 @@ void MapDHandler::get_status(std::vector<TServerStatus>& _return,
   ret.start_time = start_time_;
   ret.edition = MAPD_EDITION;
   ret.host_name = "aggregator";
+  fill_task_pool_status(ret);
   _return.push_back(ret);
   if (leaf_aggregator_.leafCount() > 0) {
     std::vector<TServerStatus> leaf_status = leaf_aggregator_.getLeafStatus(session);
@@ -2016,6 +2034,41 @@ TSessionId MapDHandler::getInvalidSessionId() const {
   return INVALID_SESSION_ID;
 }
 
+namespace {
+
+// The LIKE and REGEXP result caches of the dictionaries loaded in the database.
+void add_string_dict_cache_stats(TNodeMemoryInfo& node_info,
+                                 const Catalog_Namespace::Catalog& cat) {
+  std::set<int> dict_ids;
+  for (const auto td : cat.getAllTableMetadata()) {
+    for (const auto cd :
+         cat.getAllColumnMetadataForTable(td->tableId, false, false, true)) {
+      const auto& ti = cd->columnType;
+      if ((ti.is_string() || (ti.is_array() && ti.get_elem_type().is_string())) &&
+          ti.get_compression() == kENCODING_DICT) {
+        dict_ids.insert(ti.get_comp_param());
+      }
+    }
+  }
+  for (const auto dict_id : dict_ids) {
+    const auto dd = cat.getMetadataForDict(dict_id, false);
+    if (!dd || !dd->stringDict) {
+      continue;
+    }
+    const auto stats = dd->stringDict->getPredicateCacheStats();
+    TStringDictCacheStats cache_stats;
+    cache_stats.db_id = cat.getCurrentDB().dbId;
+    cache_stats.dict_id = dict_id;
+    cache_stats.hits = stats.hits;
+    cache_stats.misses = stats.misses;
+    cache_stats.num_entries = stats.num_entries;
+    cache_stats.num_bytes = stats.num_bytes;
+    node_info.string_dict_cache_stats.push_back(cache_stats);
+  }
+}
+
+}  // namespace
+
 void MapDHandler::get_memory(std::vector<TNodeMemoryInfo>& _return,
                              const TSessionId& session,
                              const std::string& memory_level) {
@@ -2052,6 +2105,19 @@ void MapDHandler::get_memory(std::vector<TNodeMemoryInfo>& _return,
       md.is_free = gpu.isFree == Buffer_Namespace::MemStatus::FREE;
       nodeInfo.node_memory_data.push_back(md);
     }
+    nodeInfo.eviction_policy = Buffer_Namespace::to_string(memInfo.evictionPolicy);
+    for (const auto& stats : memInfo.tableStats) {
+      TTableMemoryStats table_stats;
+      table_stats.db_id = stats.db_id;
+      table_stats.table_id = stats.table_id;
+      table_stats.hits = stats.hits;
+      table_stats.misses = stats.misses;
+      table_stats.evictions = stats.evictions;
+      nodeInfo.table_stats.push_back(table_stats);
+    }
+    if (mem_level == Data_Namespace::MemoryLevel::CPU_LEVEL) {
+      add_string_dict_cache_stats(nodeInfo, session_info.getCatalog());
+    }
     _return.push_back(nodeInfo);
   }
   if (leaf_aggregator_.leafCount() > 0) {
@@ -2377,8 +2443,14 @@ void MapDHandler::load_table_binary_arrow(const TSessionId& session,
   size_t col_idx = 0;
   try {
     for (auto cd : loader->get_column_descs()) {
-      numRows = import_buffers[col_idx]->add_arrow_values(
-          cd, *batch->column(col_idx), true, nullptr);
+      const auto& array = *batch->column(col_idx);
+      // The fixed width columns which need no conversion are loaded straight from the
+      // arrow buffers, the batch outlives the load.
+      if (import_buffers[col_idx]->borrow_arrow_values(cd, array)) {
+        numRows = array.length();
+      } else {
+        numRows = import_buffers[col_idx]->add_arrow_values(cd, array, true, nullptr);
+      }
       col_idx++;
     }
   } catch (const std::exception& e) {
@@ -4448,11 +4520,11 @@ std::vector<PushedDownFilterInfo> MapDHandler::execute_rel_alg(
                          find_push_down_candidates,
                          just_calcite_explain,
                          mapd_parameters_.gpu_input_mem_limit};
-  auto executor = Executor::getExecutor(cat.getCurrentDB().dbId,
-                                        jit_debug_ ? "/tmp" : "",
-                                        jit_debug_ ? "mapdquery" : "",
-                                        mapd_parameters_,
-                                        nullptr);
+  auto executor = Executor::acquireExecutor(cat.getCurrentDB().dbId,
+                                            jit_debug_ ? "/tmp" : "",
+                                            jit_debug_ ? "mapdquery" : "",
+                                            mapd_parameters_,
+                                            nullptr);
   RelAlgExecutor ra_executor(executor.get(), cat);
   ExecutionResult result{std::make_shared<ResultSet>(std::vector<TargetInfo>{},
                                                      ExecutorDeviceType::CPU,
@@ -4464,6 +4536,11 @@ std::vector<PushedDownFilterInfo> MapDHandler::execute_rel_alg(
       [&]() { result = ra_executor.executeRelAlgQuery(query_ra, co, eo, nullptr); });
   // reduce execution time by the time spent during queue waiting
   _return.execution_time_ms -= result.getRows()->getQueueTime();
+  const auto& kernel_times = result.getRows()->getKernelTimes();
+  _return.kernel_fetch_time_ms += kernel_times.fetch_ms;
+  _return.kernel_compute_time_ms += kernel_times.compute_ms;
+  _return.prefetch_time_ms += kernel_times.prefetch_ms;
+  _return.compile_time_saved_ms += kernel_times.compile_saved_ms;
   const auto& filter_push_down_info = result.getPushedDownFilterInfo();
   if (!filter_push_down_info.empty()) {
     return filter_push_down_info;
@@ -4504,11 +4581,11 @@ void MapDHandler::execute_rel_alg_df(TDataFrame& _return,
                          false,
                          false,
                          mapd_parameters_.gpu_input_mem_limit};
-  auto executor = Executor::getExecutor(cat.getCurrentDB().dbId,
-                                        jit_debug_ ? "/tmp" : "",
-                                        jit_debug_ ? "mapdquery" : "",
-                                        mapd_parameters_,
-                                        nullptr);
+  auto executor = Executor::acquireExecutor(cat.getCurrentDB().dbId,
+                                            jit_debug_ ? "/tmp" : "",
+                                            jit_debug_ ? "mapdquery" : "",
+                                            mapd_parameters_,
+                                            nullptr);
   RelAlgExecutor ra_executor(executor.get(), cat);
   const auto result = ra_executor.executeRelAlgQuery(query_ra, co, eo, nullptr);
   const auto rs = result.getRows();
@@ -4947,6 +5024,7 @@ void MapDHandler::sql_execute_impl(TQueryResult& _return,
           if (optimize_stmt->shouldVacuumDeletedRows()) {
             optimizer.vacuumDeletedRows();
           }
+          optimizer.packEncodedColumns();
           optimizer.recomputeMetadata();
         });
 
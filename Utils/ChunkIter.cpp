@@ -20,6 +20,7 @@
  */
 
 #include "ChunkIter.h"
+#include "../DataMgr/PackedIntChunk.h"
 
 #include <cstdlib>
 
@@ -140,6 +141,84 @@ DEVICE static void decompress(const SQLTypeInfo& ti,
   result->is_null = ti.is_null(*datum);
 }
 
+// The chunks of RL, DIFF and BITPACK encoded columns start with a PackedIntChunkHeader,
+// second_buf points to it. The positions of the iterator are those of the values in a
+// RAW payload, the other formats are decoded row by row.
+DEVICE static void decode_packed_int(const ChunkIter* it,
+                                     const int8_t* current_pos,
+                                     VarlenDatum* result,
+                                     Datum* datum) {
+  const auto header = reinterpret_cast<const PackedIntChunkHeader*>(it->second_buf);
+  const auto payload = it->second_buf + PACKED_INT_HEADER_SIZE;
+  const int64_t pos = (current_pos - payload) / it->skip_size;
+  const uint64_t null_offset = (uint64_t(1) << header->bit_width) - 1;
+  int64_t val{0};
+  bool is_null{false};
+  switch (header->format) {
+    case kPACKED_RAW:
+      switch (it->skip_size) {
+        case 1:
+          val = *(int8_t*)current_pos;
+          break;
+        case 2:
+          val = *(int16_t*)current_pos;
+          break;
+        case 4:
+          val = *(int32_t*)current_pos;
+          break;
+        case 8:
+          val = *(int64_t*)current_pos;
+          break;
+        default:
+          assert(false);
+      }
+      break;
+    case kPACKED_RLE:
+      val = packed_int_rle_decode(payload, header->base, pos);
+      break;
+    case kPACKED_BITPACK: {
+      const auto offset = packed_int_unpack(payload, header->bit_width, pos);
+      is_null = offset == null_offset;
+      val = header->base + static_cast<int64_t>(offset);
+      break;
+    }
+    case kPACKED_DELTA: {
+      const auto block = payload + (pos / PACKED_INT_DELTA_BLOCK_ROWS) *
+                                       packed_int_delta_block_size(header->bit_width);
+      const auto offset = packed_int_unpack(
+          block + sizeof(int64_t), header->bit_width, pos % PACKED_INT_DELTA_BLOCK_ROWS);
+      is_null = offset == null_offset;
+      val = *(const int64_t*)block + static_cast<int64_t>(offset);
+      break;
+    }
+    default:
+      // Not a packed chunk.
+      assert(false);
+  }
+  switch (it->type_info.get_type()) {
+    case kTINYINT:
+      datum->tinyintval = is_null ? NULL_TINYINT : static_cast<int8_t>(val);
+      result->length = sizeof(int8_t);
+      result->pointer = (int8_t*)&datum->tinyintval;
+      break;
+    case kSMALLINT:
+      datum->smallintval = is_null ? NULL_SMALLINT : static_cast<int16_t>(val);
+      result->length = sizeof(int16_t);
+      result->pointer = (int8_t*)&datum->smallintval;
+      break;
+    case kINT:
+      datum->intval = is_null ? NULL_INT : static_cast<int32_t>(val);
+      result->length = sizeof(int32_t);
+      result->pointer = (int8_t*)&datum->intval;
+      break;
+    default:
+      datum->bigintval = is_null ? NULL_BIGINT : val;
+      result->length = sizeof(int64_t);
+      result->pointer = (int8_t*)&datum->bigintval;
+  }
+  result->is_null = it->type_info.is_null(*datum);
+}
+
 void ChunkIter_reset(ChunkIter* it) {
   it->current_pos = it->start_pos;
 }
@@ -159,7 +238,10 @@ DEVICE void ChunkIter_get_next(ChunkIter* it,
 
   if (it->skip_size > 0) {
     // for fixed-size
-    if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
+    if (it->type_info.is_packed_int()) {
+      // Decoded either way, the positions don't point to the values of packed formats.
+      decode_packed_int(it, it->current_pos, result, &it->datum);
+    } else if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
       decompress(it->type_info, it->current_pos, result, &it->datum);
     } else {
       result->length = static_cast<size_t>(it->skip_size);
@@ -195,7 +277,9 @@ DEVICE void ChunkIter_get_nth(ChunkIter* it,
   if (it->skip_size > 0) {
     // for fixed-size
     int8_t* current_pos = it->start_pos + n * it->skip_size;
-    if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
+    if (it->type_info.is_packed_int()) {
+      decode_packed_int(it, current_pos, result, &it->datum);
+    } else if (uncompress && (it->type_info.get_compression() != kENCODING_NONE)) {
       decompress(it->type_info, current_pos, result, &it->datum);
     } else {
       result->length = static_cast<size_t>(it->skip_size);
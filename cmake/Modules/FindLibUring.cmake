@@ -0,0 +1,70 @@
+#.rst:
+# FindLibUring.cmake
+# -------------
+#
+# Find a liburing installation.
+#
+# This module finds if liburing is installed and selects a default
+# configuration to use.
+#
+# find_package(LibUring ...)
+#
+#
+# The following variables control which libraries are found::
+#
+#   LibUring_USE_STATIC_LIBS  - Set to ON to force use of static libraries.
+#
+# The following are set after the configuration is done:
+#
+# ::
+#
+#   LibUring_FOUND            - Set to TRUE if liburing was found.
+#   LibUring_LIBRARIES        - Path to the liburing libraries.
+#   LibUring_LIBRARY_DIRS     - compile time link directories
+#   LibUring_INCLUDE_DIRS     - compile time include directories
+#
+#
+# Sample usage:
+#
+# ::
+#
+#    find_package(LibUring)
+#    if(LibUring_FOUND)
+#      target_link_libraries(<YourTarget> ${LibUring_LIBRARIES})
+#    endif()
+
+if(LibUring_USE_STATIC_LIBS)
+  set(_CMAKE_FIND_LIBRARY_SUFFIXES ${CMAKE_FIND_LIBRARY_SUFFIXES})
+  set(CMAKE_FIND_LIBRARY_SUFFIXES .lib .a ${CMAKE_FIND_LIBRARY_SUFFIXES})
+endif()
+
+
+find_library(LibUring_LIBRARY
+  NAMES uring
+  HINTS
+  ENV LD_LIBRARY_PATH
+  PATHS
+  /usr/lib
+  /usr/local/lib)
+
+if(LibUring_USE_STATIC_LIBS)
+  set(CMAKE_FIND_LIBRARY_SUFFIXES ${_CMAKE_FIND_LIBRARY_SUFFIXES})
+endif()
+
+find_path(LibUring_INCLUDE_DIR
+  NAMES liburing.h
+  HINTS
+  ${LibUring_LIBRARY}/../../include
+  PATHS
+  /usr/include
+  /usr/local/include)
+
+get_filename_component(LibUring_LIBRARY_DIR ${LibUring_LIBRARY} DIRECTORY)
+
+# Set standard CMake FindPackage variables if found.
+set(LibUring_LIBRARIES ${LibUring_LIBRARY})
+set(LibUring_LIBRARY_DIRS ${LibUring_LIBRARY_DIR})
+set(LibUring_INCLUDE_DIRS ${LibUring_INCLUDE_DIR})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LibUring REQUIRED_VARS LibUring_LIBRARY LibUring_INCLUDE_DIR)
@@ -33,7 +33,8 @@ enum TEncodingType {
   DICT,
   SPARSE,
   GEOINT,
-  DATE_IN_DAYS
+  DATE_IN_DAYS,
+  BITPACK
 }
 
 enum TExecuteMode {
@@ -163,6 +164,10 @@ struct TQueryResult {
   2: i64 execution_time_ms
   3: i64 total_time_ms
   4: string nonce
+  5: i64 kernel_fetch_time_ms
+  6: i64 kernel_compute_time_ms
+  7: i64 prefetch_time_ms
+  8: i64 compile_time_saved_ms
 }
 
 struct TDataFrame {
@@ -248,6 +253,11 @@ struct TServerStatus {
   5: string edition
   6: string host_name
   7: bool poly_rendering_enabled
+  8: i64 task_pool_workers
+  9: i64 task_pool_queue_depth
+  10: i64 task_pool_executed_count
+  11: i64 task_pool_steal_count
+  12: i64 task_pool_cancelled_count
 }
 
 struct TPixel {
@@ -304,6 +314,23 @@ struct TMemoryData {
   7: bool is_free
 }
 
+struct TTableMemoryStats {
+  1: i32 db_id
+  2: i32 table_id
+  3: i64 hits
+  4: i64 misses
+  5: i64 evictions
+}
+
+struct TStringDictCacheStats {
+  1: i32 db_id
+  2: i32 dict_id
+  3: i64 hits
+  4: i64 misses
+  5: i64 num_entries
+  6: i64 num_bytes
+}
+
 struct TNodeMemoryInfo {
   1: string host_name
   2: i64 page_size
@@ -311,6 +338,9 @@ struct TNodeMemoryInfo {
   4: i64 num_pages_allocated
   5: bool is_allocation_capped
   6: list<TMemoryData> node_memory_data
+  7: string eviction_policy
+  8: list<TTableMemoryStats> table_stats
+  9: list<TStringDictCacheStats> string_dict_cache_stats
 }
 
 struct TTableMeta {